@@ -50,17 +50,26 @@ CORFIL *corfile_create_r(CSOUND *csound, const char *text)
     return ans;
 }
 
+/* grow the body by half as much again (at least 100 bytes), so that
+   writing a long score a character at a time does not copy it over and
+   over */
+
+static void corfile_grow(CSOUND *csound, CORFIL *f)
+{
+    char *new = (char*) csound->ReAlloc(csound, f->body,
+                                        f->len += 100 + (f->len >> 1));
+    if (UNLIKELY(new==NULL)) {
+      fprintf(stderr, Str("Out of Memory\n"));
+      exit(7);
+    }
+    f->body = new;
+}
+
 void corfile_putc(CSOUND *csound, int c, CORFIL *f)
 {
     f->body[f->p++] = c;
-    if (UNLIKELY(f->p >= f->len)) {
-      char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
-      if (UNLIKELY(new==NULL)) {
-        fprintf(stderr, Str("Out of Memory\n"));
-        exit(7);
-      }
-      f->body = new;
-    }
+    if (UNLIKELY(f->p >= f->len))
+      corfile_grow(csound, f);
     f->body[f->p] = '\0';
 }
 
@@ -73,27 +82,15 @@ void corfile_puts(CSOUND *csound, const char *s, CORFIL *f)
     /* append the string */
     for (c = s; *c != '\0'; c++) {
       f->body[f->p++] = *c;
-      if (UNLIKELY(f->p >= f->len)) {
-        char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
-        if (UNLIKELY(new==NULL)) {
-          fprintf(stderr, Str("Out of Memory\n"));
-          exit(7);
-        }
-        f->body = new;
-      }
+      if (UNLIKELY(f->p >= f->len))
+        corfile_grow(csound, f);
     }
     if (n > 0) {
       /* put the extra NULL chars to the end */
       while (--n >= 0) {
         f->body[f->p++] = '\0';
-        if (UNLIKELY(f->p >= f->len)) {
-          char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
-          if (UNLIKELY(new==NULL)) {
-            fprintf(stderr, Str("Out of Memory\n"));
-            exit(7);
-          }
-          f->body = new;
-        }
+        if (UNLIKELY(f->p >= f->len))
+          corfile_grow(csound, f);
       }
     }
     f->body[f->p] = '\0';
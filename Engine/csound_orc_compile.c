@@ -970,8 +970,10 @@ void free_instrtxt(CSOUND *csound, INSTRTXT *instrtxt) {
     if (active->auxchp != NULL)
       auxchfree(csound, active);
     free_instr_var_memory(csound, active);
-    if (active->opcod_iobufs != NULL)
+    if (active->opcod_iobufs != NULL) {
+      csound->Free(csound, ((OPCOD_IOBUFS*) active->opcod_iobufs)->bind);
       csound->Free(csound, active->opcod_iobufs);
+    }
     csound->Free(csound, active);
     active = nxt;
   }
@@ -1263,6 +1265,9 @@ void named_instr_assign_numbers(CSOUND *csound, ENGINE_STATE *engineState) {
   }
   cs_hash_table_remove(csound, engineState->instrumentNames,
                        (char *)INSTR_NAME_FIRST);
+  /* names resolved before this are looked up again */
+  if (++csound->instrNameGen == 0)
+    csound->instrNameGen = 1;
 }
 
 /**
@@ -1759,6 +1759,317 @@ int verify_xin_xout(CSOUND *csound, TREE *udoTree, TYPE_TABLE *typeTable) {
     return 1;
 }
 
+/* Compile time inlining of user defined opcodes.
+
+   When a UDO definition is verified an unverified copy of its body is
+   kept in its OPCODINFO.  A call from an instrument or another UDO
+   that needs no local ksmps is then replaced by a copy of that body,
+   with the local variables and labels renamed into the caller's
+   namespace, xin turned into assignments from the call arguments and
+   xout into assignments to the call outputs.  The copy is verified in
+   the caller's context like any other code, so nested calls are
+   inlined in turn.  This removes the useropcd1/useropcd2 dispatch and
+   the argument copying of the call.  UDOs that depend on having their
+   own instance (setksmps, reinit, p-fields, ...), take arrays, or are
+   recursive are left as calls, as is everything with --no-udo-inline.
+*/
+
+extern OPCODINFO *find_opcode_info(CSOUND *, char *, char *, char *);
+extern ORCTOKEN *make_token(CSOUND *, char *);
+
+static const char *udo_noinline[] = {
+    "setksmps", "oversample", "undersample", "reinit", "rigoto", "rireturn",
+    "tigoto", "xtratim", "release", "turnoff", "passign", "pcount",
+    "pindex", "p", "timeinstk", "timeinsts", NULL
+};
+
+static TREE *copy_tree(CSOUND *csound, TREE *tree)
+{
+    TREE *head = NULL, *last = NULL, *ans;
+
+    for ( ; tree != NULL; tree = tree->next) {
+      ans = (TREE*) csound->Malloc(csound, sizeof(TREE));
+      memcpy(ans, tree, sizeof(TREE));
+      if (tree->value != NULL) {
+        ans->value = (ORCTOKEN*) csound->Malloc(csound, sizeof(ORCTOKEN));
+        memcpy(ans->value, tree->value, sizeof(ORCTOKEN));
+        ans->value->next = NULL;
+        if (tree->value->lexeme != NULL)
+          ans->value->lexeme = cs_strdup(csound, tree->value->lexeme);
+        if (tree->value->optype != NULL)
+          ans->value->optype = cs_strdup(csound, tree->value->optype);
+      }
+      ans->left = copy_tree(csound, tree->left);
+      ans->right = copy_tree(csound, tree->right);
+      ans->next = NULL;
+      if (last == NULL) head = ans;
+      else last->next = ans;
+      last = ans;
+    }
+    return head;
+}
+
+static int is_opcode_node(TREE *tree)
+{
+    return ((tree->type == T_OPCODE || tree->type == T_OPCODE0 ||
+             tree->type == T_FUNCTION) &&
+            tree->value != NULL && tree->value->lexeme != NULL);
+}
+
+/* can the body run as part of the caller's instance? */
+static int udo_body_ok(TREE *tree)
+{
+    int i;
+
+    for ( ; tree != NULL; tree = tree->next) {
+      if (is_opcode_node(tree)) {
+        for (i = 0; udo_noinline[i] != NULL; i++)
+          if (!strcmp(tree->value->lexeme, udo_noinline[i]))
+            return 0;
+      }
+      else if ((tree->type == T_IDENT || tree->type == T_ARRAY_IDENT) &&
+               tree->value != NULL && pnum(tree->value->lexeme) >= 0)
+        return 0;
+      if (!udo_body_ok(tree->left) || !udo_body_ok(tree->right))
+        return 0;
+    }
+    return 1;
+}
+
+static int udo_types_ok(char *types, char *allowed)
+{
+    if (!strcmp(types, "0"))
+      return 1;
+    for ( ; *types != '\0'; types++)
+      if (strchr(allowed, *types) == NULL)
+        return 0;
+    return 1;
+}
+
+static void udo_store_body(CSOUND *csound, TREE *udo)
+{
+    OPCODINFO *inm;
+
+    if (udo->right == NULL)
+      return;
+    inm = find_opcode_info(csound, udo->left->value->lexeme,
+                           udo->left->left->value->lexeme,
+                           udo->left->right->value->lexeme);
+    if (inm == NULL)
+      return;
+    if (inm->body != NULL) {    /* defined twice in the same orchestra */
+      inm->inlinable = 0;
+      return;
+    }
+    inm->body = copy_tree(csound, udo->right);
+    inm->inlinable = (udo_types_ok(inm->intypes, "ikaSfKOJPVojp") &&
+                      udo_types_ok(inm->outtypes, "ikaSf") &&
+                      udo_body_ok(inm->body));
+}
+
+/* does the code call the UDO name, directly or through other UDOs? */
+static int udo_calls(CSOUND *csound, TREE *tree, char *name,
+                     CONS_CELL **seen)
+{
+    OPCODINFO *inm;
+    CONS_CELL *c;
+
+    for ( ; tree != NULL; tree = tree->next) {
+      if (is_opcode_node(tree)) {
+        if (!strcmp(tree->value->lexeme, name))
+          return 1;
+        for (inm = csound->opcodeInfo; inm != NULL; inm = inm->prv) {
+          if (inm->body == NULL || strcmp(inm->name, tree->value->lexeme))
+            continue;
+          for (c = *seen; c != NULL && c->value != inm; c = c->next);
+          if (c != NULL)
+            continue;
+          *seen = cs_cons(csound, inm, *seen);
+          if (udo_calls(csound, inm->body, name, seen))
+            return 1;
+        }
+      }
+      if (udo_calls(csound, tree->left, name, seen) ||
+          udo_calls(csound, tree->right, name, seen))
+        return 1;
+    }
+    return 0;
+}
+
+static int is_local_name(CSOUND *csound, TYPE_TABLE *typeTable, char *s)
+{
+    if (*s == 'g' || argtyp2(s) == 'r' || !strcmp(s, "A4"))
+      return 0;
+    return (csoundFindVariableWithName(csound, typeTable->globalPool,
+                                       s) == NULL &&
+            csoundFindVariableWithName(csound, csound->engineState.varPool,
+                                       s) == NULL);
+}
+
+/* append a suffix that cannot occur in orchestra code to local names,
+   keeping the type prefix */
+static void udo_rename(CSOUND *csound, TREE *tree, TYPE_TABLE *typeTable,
+                       int n)
+{
+    char *s;
+
+    for ( ; tree != NULL; tree = tree->next) {
+      if ((tree->type == T_IDENT || tree->type == T_ARRAY_IDENT ||
+           tree->type == LABEL_TOKEN) && tree->value != NULL &&
+          tree->value->lexeme != NULL &&
+          is_local_name(csound, typeTable, tree->value->lexeme)) {
+        size_t len = strlen(tree->value->lexeme) + 16;
+        s = csound->Malloc(csound, len);
+        snprintf(s, len, "%s#%d", tree->value->lexeme, n);
+        csound->Free(csound, tree->value->lexeme);
+        tree->value->lexeme = s;
+      }
+      udo_rename(csound, tree->left, typeTable, n);
+      udo_rename(csound, tree->right, typeTable, n);
+    }
+}
+
+static TREE *udo_assign(CSOUND *csound, TREE *at, TREE *lhs, TREE *rhs)
+{
+    TREE *ans = make_leaf(csound, at->line, at->locn, '=',
+                          make_token(csound, "="));
+    ans->left = lhs;
+    ans->right = rhs;
+    return ans;
+}
+
+static TREE *copy_arg(CSOUND *csound, TREE *arg)
+{
+    TREE *next = arg->next, *ans;
+
+    arg->next = NULL;
+    ans = copy_tree(csound, arg);
+    arg->next = next;
+    return ans;
+}
+
+/* xin: assign the call arguments to the input variables; k-rate inputs
+   are also set at init time, as xin does */
+static TREE *udo_xin(CSOUND *csound, TREE *xin, TREE *call, OPCODINFO *inm)
+{
+    TREE *head = NULL, *last = NULL, *var, *next, *arg = call->right, *t;
+    char *type = inm->intypes;
+
+    for (var = xin->left; var != NULL && arg != NULL;
+         var = next, arg = arg->next, type++) {
+      next = var->next;
+      var->next = NULL;
+      if (strchr("kKOJPV", *type) != NULL) {
+        t = make_leaf(csound, xin->line, xin->locn, T_OPCODE,
+                      make_token(csound, "init"));
+        t->left = copy_tree(csound, var);
+        t->right = make_leaf(csound, xin->line, xin->locn, T_FUNCTION,
+                             make_token(csound, "i"));
+        t->right->right = copy_arg(csound, arg);
+        if (last == NULL) head = t;
+        else last->next = t;
+        last = t;
+      }
+      t = udo_assign(csound, xin, var, copy_arg(csound, arg));
+      if (last == NULL) head = t;
+      else last->next = t;
+      last = t;
+    }
+    return head;
+}
+
+/* xout: assign the output values to the call outputs */
+static TREE *udo_xout(CSOUND *csound, TREE *xout, TREE *call)
+{
+    TREE *head = NULL, *last = NULL, *val, *next, *out = call->left, *t;
+
+    for (val = xout->right; val != NULL && out != NULL;
+         val = next, out = out->next) {
+      next = val->next;
+      val->next = NULL;
+      t = udo_assign(csound, xout, copy_arg(csound, out), val);
+      if (last == NULL) head = t;
+      else last->next = t;
+      last = t;
+    }
+    return head;
+}
+
+static void udo_expand_io(CSOUND *csound, TREE **link, TREE *call,
+                          OPCODINFO *inm)
+{
+    TREE *cur, *repl;
+
+    while ((cur = *link) != NULL) {
+      if ((cur->type == T_OPCODE || cur->type == T_OPCODE0) &&
+          cur->value != NULL && cur->value->lexeme != NULL &&
+          (!strcmp(cur->value->lexeme, "xin") ||
+           !strcmp(cur->value->lexeme, "xout"))) {
+        repl = (!strcmp(cur->value->lexeme, "xin") ?
+                udo_xin(csound, cur, call, inm) : udo_xout(csound, cur, call));
+        if (repl == NULL) {
+          *link = cur->next;
+          continue;
+        }
+        *link = repl;
+        while (repl->next != NULL) repl = repl->next;
+        repl->next = cur->next;
+        link = &repl->next;
+        continue;
+      }
+      udo_expand_io(csound, &cur->left, call, inm);
+      udo_expand_io(csound, &cur->right, call, inm);
+      link = &cur->next;
+    }
+}
+
+/* Replace a verified UDO call by a copy of the UDO body.  Returns the
+   first statement of the copy, linked to the statements following the
+   call, or the call itself if it is not inlined. */
+static TREE *inline_udo_call(CSOUND *csound, TREE *call,
+                             TYPE_TABLE *typeTable)
+{
+    OENTRY *ep = (OENTRY*) call->markup;
+    OPCODINFO *inm;
+    CONS_CELL *seen = NULL;
+    TREE *body, *last, *arg;
+    int i, nin, recursive;
+
+    if ((call->type != T_OPCODE && call->type != T_OPCODE0) ||
+        ep == NULL || ep->useropinfo == NULL ||
+        typeTable->localPool == typeTable->instr0LocalPool)
+      return call;
+    inm = (OPCODINFO*) ep->useropinfo;
+    if (!inm->inlinable || inm->body == NULL)
+      return call;
+    /* an extra argument sets the local ksmps of the call */
+    nin = (strcmp(inm->intypes, "0") ? (int) strlen(inm->intypes) : 0);
+    for (i = 0, arg = call->right; i < nin && arg != NULL; i++)
+      arg = arg->next;
+    if (arg != NULL &&
+        (arg->next != NULL ||
+         !((arg->type == INTEGER_TOKEN && arg->value->value == 0) ||
+           (arg->type == NUMBER_TOKEN && arg->value->fvalue == 0.0))))
+      return call;
+    recursive = udo_calls(csound, inm->body, inm->name, &seen);
+    cs_cons_free(csound, seen);
+    if (recursive)
+      return call;
+
+    body = copy_tree(csound, inm->body);
+    udo_rename(csound, body, typeTable, typeTable->udoInlines++);
+    udo_expand_io(csound, &body, call, inm);
+    if (UNLIKELY(body == NULL))
+      return call;
+    typeTable->labelList =
+      cs_cons_append(typeTable->labelList, get_label_list(csound, body));
+    for (last = body; last->next != NULL; last = last->next);
+    last->next = call->next;
+    if (UNLIKELY(PARSER_DEBUG))
+      print_tree(csound, "inlined UDO\n", body);
+    return body;
+}
+
 TREE* verify_tree(CSOUND * csound, TREE *root, TYPE_TABLE* typeTable)
 {
     TREE *anchor = NULL;
@@ -1804,6 +2115,7 @@ TREE* verify_tree(CSOUND * csound, TREE *root, TYPE_TABLE* typeTable)
 
         typeTable->localPool = csoundCreateVarPool(csound);
         current->markup = typeTable->localPool;
+        udo_store_body(csound, current);
 
         if (current->right != NULL) {
 
@@ -1916,6 +2228,16 @@ TREE* verify_tree(CSOUND * csound, TREE *root, TYPE_TABLE* typeTable)
           continue;
         } else {
           handle_optional_args(csound, current);
+          if (!csound->oparms->noudoinline) {
+            TREE *inlined = inline_udo_call(csound, current, typeTable);
+            if (inlined != current) {
+              current = inlined;
+              if (previous != NULL) {
+                previous->next = current;
+              }
+              continue;
+            }
+          }
         }
       }
 
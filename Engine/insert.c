@@ -43,7 +43,7 @@ void    timexpire(CSOUND *, double);
 static  void    instance(CSOUND *, int);
 extern int argsRequired(char* argString);
 static int insert_midi(CSOUND *csound, int insno, MCHNBLK *chn,
-                       MEVENT *mep);
+                       MEVENT *mep, int offset);
 static int insert_event(CSOUND *csound, int insno, EVTBLK *newevtp);
 
 static void print_messages(CSOUND *csound, int attr, const char *str){
@@ -203,7 +203,8 @@ uintptr_t event_insert_thread(void *p) {
         }
         if(inst[rp].type == 1) {
           csoundSpinLock(&csound->alloc_spinlock);
-          insert_midi(csound, inst[rp].insno, inst[rp].chn, &inst[rp].mep);
+          insert_midi(csound, inst[rp].insno, inst[rp].chn, &inst[rp].mep,
+                      inst[rp].offset);
           csoundSpinUnLock(&csound->alloc_spinlock);
         }
        if(inst[rp].type == 0)  {
@@ -489,12 +490,17 @@ int insert_event(CSOUND *csound, int insno, EVTBLK *newevtp)
 
   /* new code for sample-accurate timing, not for tied notes */
   if (O->sampleAccurate && !tie) {
-    int64_t start_time_samps, start_time_kcycles;
+    int64_t start_time_samps;
     double duration_samps;
-    start_time_samps = (int64_t) (ip->p2.value * csound->esr);
+    /* the onset is placed within the k-period about to be performed;
+       events dispatched after their start time (real-time events that
+       arrive late) begin at its first sample */
+    start_time_samps = (int64_t) (((double) ip->p2.value + csound->timeOffs)
+                                  * csound->esr) - csound->icurTime;
     duration_samps =  ip->p3.value * csound->esr;
-    start_time_kcycles = start_time_samps/csound->ksmps;
-    ip->ksmps_offset = start_time_samps - start_time_kcycles*csound->ksmps;
+    ip->ksmps_offset = (start_time_samps > 0 &&
+                        start_time_samps < (int64_t) csound->ksmps ?
+                        (uint32_t) start_time_samps : 0);
     /* with no p3 or xtratim values, can't set the sample accur duration */
     if (ip->p3.value > 0 && ip->xtratim == 0 ){
       int tmp = ((int)duration_samps+ip->ksmps_offset)%csound->ksmps;
@@ -572,21 +578,27 @@ int insert_event(CSOUND *csound, int insno, EVTBLK *newevtp)
 /*  then run an init pass                    */
 int MIDIinsert(CSOUND *csound, int insno, MCHNBLK *chn, MEVENT *mep) {
 
+  /* sample offset of messages queued with csoundPushMidiMessage() */
+  int offset = (csound->oparms->sampleAccurate ?
+                csound->midiGlobals->evtOffset : 0);
+
   if(csound->oparms->realtime) {
     unsigned long wp = csound->alloc_queue_wp;
     csound->alloc_queue[wp].insno = insno;
     csound->alloc_queue[wp].chn = chn;
     csound->alloc_queue[wp].mep = *mep;
+    csound->alloc_queue[wp].offset = offset;
     csound->alloc_queue[wp].type = 1;
     csound->alloc_queue_wp = wp + 1 < MAX_ALLOC_QUEUE ? wp + 1 : 0;
     ATOMIC_INCR(csound->alloc_queue_items);
     return 0;
   }
-  else return insert_midi(csound, insno, chn, mep);
+  else return insert_midi(csound, insno, chn, mep, offset);
 
 }
 
-int insert_midi(CSOUND *csound, int insno, MCHNBLK *chn, MEVENT *mep)
+int insert_midi(CSOUND *csound, int insno, MCHNBLK *chn, MEVENT *mep,
+                int offset)
 {
   INSTRTXT  *tp;
   INSDS     *ip, **ipp, *prvp, *nxtp;
@@ -681,6 +693,8 @@ int insert_midi(CSOUND *csound, int insno, MCHNBLK *chn, MEVENT *mep)
   ip->relesing     = 0;
   ip->offbet       = -1.0;
   ip->offtim       = -1.0;              /* set indef duration */
+  ip->no_end       = 0;                 /* no sample-accurate ending */
+  ip->ksmps_offset = offset;            /* start within the k-period */
   ip->opcod_iobufs = NULL;              /* IV - Sep 8 2002:            */
   ip->p1.value     = (MYFLT) insno;     /* set these required p-fields */
   ip->p2.value     = (MYFLT) (csound->icurTime/csound->esr - csound->timeOffs);
@@ -1052,8 +1066,10 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
       do {
         if (!ip->actflg) {
           cnt++;
-          if (ip->opcod_iobufs && ip->insno > csound->engineState.maxinsno)
+          if (ip->opcod_iobufs && ip->insno > csound->engineState.maxinsno) {
+            csound->Free(csound, ((OPCOD_IOBUFS*) ip->opcod_iobufs)->bind);
             csound->Free(csound, ip->opcod_iobufs);   /* IV - Nov 10 2002 */
+          }
           if (ip->fdchp != NULL)
             fdchclose(csound, ip);
           if (ip->auxchp != NULL)
@@ -1389,6 +1405,259 @@ int subinstrset(CSOUND *csound, SUBINST *p){
 */
 int useropcd1(CSOUND *, UOPCODE*), useropcd2(CSOUND *, UOPCODE*);
 
+/* Argument binding: an input that the UDO body never writes, or an output
+   that nothing else in the caller writes, is served by pointing the body's
+   argument slots at the caller's variable, so useropcd2 does not have to
+   copy it in and out every cycle.  The slots are found once per instance
+   and re-pointed at every init, as an instance can serve different callers.
+*/
+
+/* opcodes flagged WI write their input arguments */
+#define writes_inputs(ep)       ((ep)->flags & WI)
+static const char *udo_array_readers[] = {
+  "##array_get", "lenarray", "sumarray", "maxarray", "minarray",
+  "printarray", "=", NULL
+};
+
+static int opname_in(const char *opname, const char **list)
+{
+  size_t len;
+
+  for ( ; *list != NULL; list++) {
+    len = strlen(*list);
+    if (!strncmp(opname, *list, len) &&
+        (opname[len] == '\0' || opname[len] == '.'))
+      return 1;
+  }
+  return 0;
+}
+
+/* step through the opcodes of an instance, in the layout of instance() */
+static OPDS *opds_next(OPTXT **optxt, char **mem)
+{
+  const OENTRY *ep;
+  OPDS *opds;
+
+  while ((*optxt = (*optxt)->nxtop) != NULL) {
+    ep = (*optxt)->t.oentry;
+    opds = (OPDS*) *mem;
+    *mem += ep->dsblksiz;
+    if (strcmp(ep->opname, "endin") == 0 || strcmp(ep->opname, "endop") == 0)
+      break;
+    if (strcmp(ep->opname, "pset") != 0 && strcmp(ep->opname, "$label") != 0)
+      return opds;
+  }
+  return NULL;
+}
+
+static char *opds_base(INSDS *ip)
+{
+  CS_VAR_POOL *pool = ip->instr->varPool;
+
+  return (char*) ip->lclbas + pool->poolSize +
+    (pool->varCount * CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET));
+}
+
+static MYFLT **opds_args(OPDS *opds)
+{
+  if (opds->optext->t.oentry->useropinfo == NULL)
+    return (MYFLT**) ((char*) opds + sizeof(OPDS));
+  return ((UOPCODE*) opds)->ar;
+}
+
+/* index of the first input argument */
+static int opds_inarg(OPDS *opds)
+{
+  TEXT *t = &opds->optext->t;
+  int n = (t->oentry->outypes != NULL ? argsRequired(t->oentry->outypes) : 0);
+
+  return (n > (int) t->outArgCount ? n : (int) t->outArgCount);
+}
+
+static int is_xin(const char *opname)
+{
+  return (!strcmp(opname, "xin") || !strcmp(opname, "##xin64") ||
+          !strcmp(opname, "##xin256"));
+}
+
+static UDO_ARGBIND *udo_bind_setup(CSOUND *csound, INSDS *ip,
+                                   OPCODINFO *inm)
+{
+  int nout = inm->outchns, nch = inm->inchns + inm->outchns;
+  int ok = 1, nxin = 0, nxout = 0, pass, total, c, k, n0, n;
+  UDO_ARGBIND *bind;
+  CS_VARIABLE *current;
+  OPTXT *optxt;
+  OPDS *opds;
+  MYFLT **args, ***slots = NULL;
+  char *mem;
+
+  bind = (UDO_ARGBIND*) csound->Calloc(csound,
+                                       (nch + 1) * sizeof(UDO_ARGBIND));
+  if (ip->lclbas == NULL || nch == 0)
+    return bind;
+  /* the UDO's own variables are the arguments of xin and xout */
+  optxt = (OPTXT*) ip->instr; mem = opds_base(ip);
+  while ((opds = opds_next(&optxt, &mem)) != NULL) {
+    const char *opname = opds->optext->t.oentry->opname;
+    args = opds_args(opds);
+    if (is_xin(opname)) {
+      nxin++;
+      for (c = 0; c < inm->inchns; c++)
+        bind[nout + c].self = args[c];
+    }
+    else if (!strcmp(opname, "xout")) {
+      nxout++;
+      for (c = 0; c < nout; c++)
+        bind[c].self = args[c];
+    }
+    else if (!strcmp(opname, "setksmps"))
+      ok = 0;
+  }
+  if (!ok || nxin > 1 || nxout > 1)
+    return bind;
+
+  for (current = inm->out_arg_pool->head, c = 0; c < nout && current != NULL;
+       c++, current = current->next)
+    bind[c].bindable = (bind[c].self != NULL &&
+                        (current->varType == &CS_VAR_TYPE_K ||
+                         current->varType == &CS_VAR_TYPE_A));
+  for (current = inm->in_arg_pool->head, c = nout; c < nch && current != NULL;
+       c++, current = current->next) {
+    bind[c].bindable = (bind[c].self != NULL &&
+                        (current->varType == &CS_VAR_TYPE_K ||
+                         current->varType == &CS_VAR_TYPE_A ||
+                         current->varType == &CS_VAR_TYPE_S ||
+                         current->varType == &CS_VAR_TYPE_ARRAY));
+    /* an input passed on to xout shares the variable with an output */
+    for (k = 0; k < nout; k++)
+      if (bind[k].self == bind[c].self)
+        bind[c].bindable = bind[k].bindable = 0;
+  }
+  for (c = 0; c < nout; c++)
+    for (k = c + 1; k < nout; k++)
+      if (bind[k].self == bind[c].self)
+        bind[c].bindable = bind[k].bindable = 0;
+
+  /* first pass: find writes to inputs and count slots, second: fill in */
+  for (pass = 0; pass < 2; pass++) {
+    optxt = (OPTXT*) ip->instr; mem = opds_base(ip);
+    while ((opds = opds_next(&optxt, &mem)) != NULL) {
+      TEXT *t = &opds->optext->t;
+      if (is_xin(t->oentry->opname) || !strcmp(t->oentry->opname, "xout"))
+        continue;
+      args = opds_args(opds);
+      n0 = opds_inarg(opds);
+      n = n0 + (int) t->inArgCount;
+      for (k = 0; k < n; k++) {
+        if (k >= (int) t->outArgCount && k < n0)
+          continue;                     /* padding */
+        for (c = 0; c < nch; c++) {
+          if (args[k] != bind[c].self)
+            continue;
+          if (pass) {
+            if (bind[c].slots != NULL)
+              bind[c].slots[bind[c].nslots++] = &args[k];
+            continue;
+          }
+          bind[c].nslots++;
+          if (c < nout)
+            continue;
+          if (k < n0 || writes_inputs(t->oentry) ||
+              (csoundGetTypeForArg(bind[c].self) == &CS_VAR_TYPE_ARRAY &&
+               !opname_in(t->oentry->opname, udo_array_readers)))
+            bind[c].bindable = 0;
+        }
+      }
+    }
+    if (pass)
+      break;
+    for (c = 0, total = 0; c < nch; c++)
+      if (bind[c].bindable)
+        total += bind[c].nslots;
+    bind = (UDO_ARGBIND*)
+      csound->ReAlloc(csound, bind, (nch + 1) * sizeof(UDO_ARGBIND) +
+                      total * sizeof(MYFLT**));
+    slots = (MYFLT***) &bind[nch + 1];
+    for (c = 0; c < nch; c++) {
+      if (bind[c].bindable) {
+        bind[c].slots = slots;
+        slots += bind[c].nslots;
+      }
+      else
+        bind[c].slots = NULL;
+      bind[c].nslots = 0;
+    }
+  }
+  return bind;
+}
+
+/* does the argument live in the memory of the instance ip (p-fields or
+   local variables)? */
+static int owned_by(INSDS *ip, MYFLT *arg)
+{
+  return ((char*) arg >= (char*) ip &&
+          (char*) arg < (char*) ip->lclbas + ip->instr->varPool->poolSize);
+}
+
+/* is the caller's output variable written by anything but this call? */
+static int written_elsewhere(INSDS *ip, OPDS *self, MYFLT *arg)
+{
+  OPTXT *optxt = (OPTXT*) ip->instr;
+  char *mem = opds_base(ip);
+  OPDS *opds;
+  MYFLT **args;
+  int k, n;
+
+  while ((opds = opds_next(&optxt, &mem)) != NULL) {
+    if (opds == self)
+      continue;
+    args = opds_args(opds);
+    for (k = 0; k < (int) opds->optext->t.outArgCount; k++)
+      if (args[k] == arg)
+        return 1;
+    if (writes_inputs(opds->optext->t.oentry)) {
+      n = opds_inarg(opds);
+      for (k = 0; k < (int) opds->optext->t.inArgCount; k++)
+        if (args[n + k] == arg)
+          return 1;
+    }
+  }
+  return 0;
+}
+
+static void udo_bind(CSOUND *csound, UOPCODE *p, INSDS *lcurip,
+                     OPCODINFO *inm, int own_ksmps)
+{
+  OPCOD_IOBUFS *buf = p->buf;
+  INSDS *parent_ip = p->parent_ip;
+  int nout = inm->outchns, nch = inm->inchns + inm->outchns, c, k, bound;
+  MYFLT *target;
+
+  if (buf->bind == NULL)
+    buf->bind = udo_bind_setup(csound, lcurip, inm);
+  for (c = 0; c < nch; c++) {
+    UDO_ARGBIND *b = &buf->bind[c];
+    if (!b->bindable)
+      continue;
+    bound = (!own_ksmps && parent_ip->lclbas != NULL &&
+             owned_by(parent_ip, p->ar[c]));
+    if (bound && c < nout) {
+      /* the output must not alias another argument of the call */
+      for (k = 0; k < nch; k++)
+        if (k != c && p->ar[k] == p->ar[c])
+          bound = 0;
+      if (bound)
+        bound = !written_elsewhere(parent_ip, &p->h, p->ar[c]);
+    }
+    b->bound = bound;
+    target = (bound ? p->ar[c] : b->self);
+    for (k = 0; k < b->nslots; k++)
+      *b->slots[k] = target;
+  }
+}
+
+
 int useropcdset(CSOUND *csound, UOPCODE *p)
 {
     OPDS         *saved_ids = csound->ids;
@@ -1466,6 +1735,7 @@ int useropcdset(CSOUND *csound, UOPCODE *p)
 
     /* copy parameters from the caller instrument into our subinstrument */
     lcurip = p->ip;
+    udo_bind(csound, p, lcurip, inm, local_ksmps != CS_KSMPS);
 
     /* set the local ksmps values */
     if (local_ksmps != CS_KSMPS) {
@@ -2260,6 +2530,7 @@ int useropcd2(CSOUND *csound, UOPCODE *p)
 
   MYFLT** internal_ptrs = tmp;
   MYFLT** external_ptrs = p->ar;
+  UDO_ARGBIND *bind = p->buf->bind;
 
   /* copy inputs */
   current = inm->in_arg_pool->head;
@@ -2268,7 +2539,8 @@ int useropcd2(CSOUND *csound, UOPCODE *p)
     //change to use generic code...
     if (current->varType != &CS_VAR_TYPE_I &&
         current->varType != &CS_VAR_TYPE_b &&
-        current->subType != &CS_VAR_TYPE_I) {
+        current->subType != &CS_VAR_TYPE_I &&
+        !bind[i + inm->outchns].bound) {
       if (current->varType == &CS_VAR_TYPE_A && CS_KSMPS == 1) {
         *internal_ptrs[i + inm->outchns] = *external_ptrs[i + inm->outchns];
       } else {
@@ -2305,7 +2577,8 @@ int useropcd2(CSOUND *csound, UOPCODE *p)
     // use generic code...
     if (current->varType != &CS_VAR_TYPE_I &&
         current->varType != &CS_VAR_TYPE_b &&
-        current->subType != &CS_VAR_TYPE_I) {
+        current->subType != &CS_VAR_TYPE_I &&
+        !bind[i].bound) {
       if (current->varType == &CS_VAR_TYPE_A && CS_KSMPS == 1) {
         *external_ptrs[i] = *internal_ptrs[i];
       } else {
@@ -2417,6 +2690,7 @@ static void instance(CSOUND *csound, int insno)
     size_t pcnt = sizeof(OPCOD_IOBUFS) +
       sizeof(MYFLT*) * (info->inchns + info->outchns);
     ip->opcod_iobufs = (void*) csound->Malloc(csound, pcnt);
+    ((OPCOD_IOBUFS*) ip->opcod_iobufs)->bind = NULL;
   }
 
   /* gbloffbas = csound->globalVarPool; */
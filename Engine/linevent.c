@@ -23,6 +23,7 @@
 
 #include "csoundCore.h"     /*                              LINEVENT.C      */
 #include <ctype.h>
+#include <stddef.h>
 
 #ifdef MSVC
 #include <fcntl.h>
@@ -228,6 +229,112 @@ void csoundInputMessageInternal(CSOUND *csound, const char *message)
     STA(Linep) += size;
 }
 
+/* Binary realtime events, from csoundInputEvent().  Any thread appends
+   them to binbuf, holding only binlock; at the start of each control
+   period the buffers are swapped and the events inserted, without going
+   through the text parser of sensLine(). */
+
+typedef struct {
+    int64_t handle;         /* from csoundGetInstrumentHandle(), or 0 */
+    int32   pcnt;
+    char    opcod;
+} LINEBINEVT;               /* followed by pcnt p-fields */
+
+/* rounded up so that the next record is aligned for its handle */
+#define BINEVT_SIZE(n)  \
+    ((int32) ((sizeof(LINEBINEVT) + (n) * sizeof(MYFLT) + 7) & ~((size_t) 7)))
+
+static void sensBinEvents(CSOUND *csound, void *userData)
+{
+    char    *buf, *end;
+    int32   len, siz;
+    IGN(userData);
+
+    csoundSpinLock(&STA(binlock));
+    buf = STA(binbuf);
+    len = STA(binlen);
+    siz = STA(binsiz);
+    STA(binbuf) = STA(binbuf2);
+    STA(binsiz) = STA(binsiz2);
+    STA(binlen) = 0;
+    STA(binbuf2) = buf;
+    STA(binsiz2) = siz;
+    csoundSpinUnLock(&STA(binlock));
+
+    for (end = buf + len; buf < end; ) {
+      LINEBINEVT *b = (LINEBINEVT*) buf;
+      MYFLT   *pf = (MYFLT*) (b + 1);
+      EVTBLK  evt;
+      buf += BINEVT_SIZE(b->pcnt);
+      /* p-fields past pcnt are not read, only up to p3 need clearing */
+      memset(&evt, 0, offsetof(EVTBLK, p) + 4 * sizeof(MYFLT));
+      evt.opcod = b->opcod;
+      evt.pcnt = (int16) b->pcnt;
+      memcpy(&evt.p[1], pf, b->pcnt * sizeof(MYFLT));
+      if (b->handle != 0) {
+        MYFLT insno;
+        if (UNLIKELY((uint32_t) (b->handle >> 32) != csound->instrNameGen)) {
+          csound->ErrorMsg(csound,
+                           Str("event for a renumbered instrument ignored\n"));
+          continue;
+        }
+        /* p1 gives the sign and the fractional part */
+        insno = FABS(pf[0]);
+        insno = (MYFLT) (int32) b->handle + (insno - FLOOR(insno));
+        evt.p[1] = (pf[0] < FL(0.0) ? -insno : insno);
+      }
+      insert_score_event_at_sample(csound, &evt, csound->icurTime);
+    }
+}
+
+PUBLIC int csoundInputEvent(CSOUND *csound, char type, int64_t handle,
+                            const MYFLT *pfields, long numFields)
+{
+    LINEBINEVT *b;
+    int32   size;
+
+    if (UNLIKELY((type != 'a' && type != 'i' && type != 'q' && type != 'f' &&
+                  type != 'e' && type != 'd') ||
+                 numFields < 0 || numFields > PMAX))
+      return CSOUND_ERROR;
+    if (handle != 0 &&
+        UNLIKELY((type != 'i' && type != 'q' && type != 'd') ||
+                 numFields < 1 ||
+                 (uint32_t) (handle >> 32) != csound->instrNameGen))
+      return CSOUND_ERROR;
+    if (UNLIKELY(!STA(binreg))) {
+      csoundLockMutex(csound->API_lock);
+      if (!STA(binreg)) {
+        csound->RegisterSenseEventCallback(csound, sensBinEvents, NULL);
+        STA(binreg) = 1;
+      }
+      csoundUnlockMutex(csound->API_lock);
+    }
+    size = BINEVT_SIZE(numFields);
+    csoundSpinLock(&STA(binlock));
+    if (UNLIKELY(STA(binlen) + size > STA(binsiz))) {
+      int32 siz = (STA(binsiz) > 0 ? STA(binsiz) : 4096);
+      char  *buf;
+      while (siz < STA(binlen) + size)
+        siz <<= 1;
+      buf = (char*) csound->ReAlloc(csound, STA(binbuf), siz);
+      if (UNLIKELY(buf == NULL)) {
+        csoundSpinUnLock(&STA(binlock));
+        return CSOUND_MEMORY;
+      }
+      STA(binbuf) = buf;
+      STA(binsiz) = siz;
+    }
+    b = (LINEBINEVT*) (STA(binbuf) + STA(binlen));
+    b->handle = handle;
+    b->pcnt = (int32) numFields;
+    b->opcod = type;
+    memcpy(b + 1, pfields, numFields * sizeof(MYFLT));
+    STA(binlen) += size;
+    csoundSpinUnLock(&STA(binlock));
+    return CSOUND_SUCCESS;
+}
+
 /* accumlate RT Linein buffer, & place completed events in EVTBLK */
 /* does more syntax checking than rdscor, since not preprocessed  */
 
@@ -443,12 +550,21 @@ static const char *errmsg_1 =
 static const char *errmsg_2 =
   Str_noop("event: string name is allowed only for \"i\", \"d\", and \"q\" events");
 
+/* instrument number for the name s, resolved through the cache of the
+   opcode (or of the schedule opcode that called us) */
+static int32 event_insno(CSOUND *csound, LINEVENT *p, char *s)
+{
+    return strarg2insno_cached(csound, (p->cache != NULL ?
+                                        p->cache : &p->namecache), s, 0);
+}
+
 int eventOpcode_(CSOUND *csound, LINEVENT *p, int insname, char p1)
 {
     EVTBLK  evt;
     int     i;
     char    opcod;
-    memset(&evt, 0, sizeof(EVTBLK));
+    /* p-fields past pcnt are not read, only up to p3 need clearing */
+    memset(&evt, 0, offsetof(EVTBLK, p) + 4 * sizeof(MYFLT));
 
     if (p1==0)
          opcod = *((STRINGDAT*) p->args[0])->data;
@@ -470,7 +586,7 @@ int eventOpcode_(CSOUND *csound, LINEVENT *p, int insname, char p1)
         int res;
         if (UNLIKELY(evt.opcod != 'i' && evt.opcod != 'q' && opcod != 'd'))
           return csound->PerfError(csound, &(p->h), "%s", Str(errmsg_2));
-        res = csound->strarg2insno(csound, ((STRINGDAT*) p->args[1])->data, 1);
+        res = event_insno(csound, p, ((STRINGDAT*) p->args[1])->data);
         if (UNLIKELY(res == NOT_AN_INSTRUMENT)) return NOTOK;
         evt.p[1] = (MYFLT) res;
         evt.strarg = NULL; evt.scnt = 0;
@@ -478,8 +594,7 @@ int eventOpcode_(CSOUND *csound, LINEVENT *p, int insname, char p1)
       else {
         int res;
         if (csound->ISSTRCOD(*p->args[1])) {
-          res = csound->strarg2insno(csound,
-                                     get_arg_string(csound, *p->args[1]), 1);
+          res = event_insno(csound, p, get_arg_string(csound, *p->args[1]));
           if (UNLIKELY(res == NOT_AN_INSTRUMENT)) return NOTOK;
           evt.p[1] = (MYFLT)res;
         } else {                  /* Should check for valid instr num here */
@@ -530,7 +645,7 @@ int eventOpcodeI_(CSOUND *csound, LINEVENT *p, int insname, char p1)
     EVTBLK  evt;
     int     i, err = 0;
     char    opcod;
-    memset(&evt, 0, sizeof(EVTBLK));
+    memset(&evt, 0, offsetof(EVTBLK, p) + 4 * sizeof(MYFLT));
 
     if (p1==0)
          opcod = *((STRINGDAT*) p->args[0])->data;
@@ -550,7 +665,7 @@ int eventOpcodeI_(CSOUND *csound, LINEVENT *p, int insname, char p1)
         int res;
         if (UNLIKELY(evt.opcod != 'i' && evt.opcod != 'q' && opcod != 'd'))
           return csound->InitError(csound, "%s", Str(errmsg_2));
-        res = csound->strarg2insno(csound,((STRINGDAT *)p->args[1])->data, 1);
+        res = event_insno(csound, p, ((STRINGDAT *)p->args[1])->data);
         if (UNLIKELY(res == NOT_AN_INSTRUMENT)) return NOTOK;
         evt.p[1] = (MYFLT)res;
         evt.strarg = NULL; evt.scnt = 0;
@@ -560,8 +675,8 @@ int eventOpcodeI_(CSOUND *csound, LINEVENT *p, int insname, char p1)
       else {
         evt.strarg = NULL; evt.scnt = 0;
         if (csound->ISSTRCOD(*p->args[1])) {
-          int res = csound->strarg2insno(csound,
-                                         get_arg_string(csound, *p->args[1]), 1);
+          int res = event_insno(csound, p,
+                                get_arg_string(csound, *p->args[1]));
           if (UNLIKELY(evt.p[1] == NOT_AN_INSTRUMENT)) return NOTOK;
           evt.p[1] = (MYFLT)res;
         }
@@ -29,7 +29,9 @@
 #include "oload.h"
 #include "remote.h"
 #include <math.h>
+#include <stddef.h>
 #include "corfile.h"
+#include "fftlib.h"
 
 #include "csdebug.h"
 
@@ -425,50 +427,248 @@ static void deactivate_all_notes(CSOUND *csound)
     }
 }
 
+/* Queued realtime events are stored compactly, in records holding only
+   the p-fields and string arguments they have.  Records are cut from
+   EVT_CHUNKSIZE byte chunks in multiples of EVT_GRAIN bytes; a freed
+   record goes on the free list of its size for reuse.  Records larger
+   than the largest size class are allocated singly. */
+
+#define EVT_GRAIN       64
+#define EVT_NCLASSES    32
+#define EVT_CHUNKSIZE   65536
+
+typedef struct {
+  EVTNODE *free[EVT_NCLASSES];    /* free records of each size class */
+  void    *chunks;                /* chunks, linked through their start */
+  char    *cur, *end;             /* unused part of the newest chunk */
+  int32   count, peakcount;       /* records in use */
+  size_t  bytes, peakbytes;       /*   and their size */
+  size_t  allocated;              /* chunks and single records */
+  EVTBLK  evt;                    /* the record of the event being started */
+} EVTPOOL;
+
+static EVTNODE *evtnode_alloc(CSOUND *csound, size_t size)
+{
+  EVTPOOL *pool = (EVTPOOL*) csound->evtPool;
+  EVTNODE *e;
+  size_t  c = (size + EVT_GRAIN - 1) / EVT_GRAIN;
+
+  if (UNLIKELY(pool == NULL)) {
+    pool = (EVTPOOL*) csound->Calloc(csound, sizeof(EVTPOOL));
+    csound->evtPool = (void*) pool;
+  }
+  size = c * EVT_GRAIN;           /* evtnode_free() finds the class */
+  if (c < EVT_NCLASSES) {
+    if ((e = pool->free[c]) != NULL)
+      pool->free[c] = e->nxt;
+    else {
+      if (UNLIKELY(pool->cur + size > pool->end)) {
+        char *chunk = (char*) csound->Malloc(csound, EVT_CHUNKSIZE);
+        if (UNLIKELY(chunk == NULL))
+          return NULL;
+        *(void**) chunk = pool->chunks;
+        pool->chunks = (void*) chunk;
+        pool->cur = chunk + EVT_GRAIN;
+        pool->end = chunk + EVT_CHUNKSIZE;
+        pool->allocated += EVT_CHUNKSIZE;
+      }
+      e = (EVTNODE*) pool->cur;
+      pool->cur += size;
+    }
+  }
+  else {
+    if (UNLIKELY((e = (EVTNODE*) csound->Malloc(csound, size)) == NULL))
+      return NULL;
+    pool->allocated += size;
+  }
+  e->size = (uint32) size;
+  pool->bytes += size;
+  if (pool->bytes > pool->peakbytes)
+    pool->peakbytes = pool->bytes;
+  if (++pool->count > pool->peakcount)
+    pool->peakcount = pool->count;
+  return e;
+}
+
+static void evtnode_free(CSOUND *csound, EVTNODE *e)
+{
+  EVTPOOL *pool = (EVTPOOL*) csound->evtPool;
+  size_t  c = e->size / EVT_GRAIN;
+
+  pool->count--;
+  pool->bytes -= e->size;
+  if (c < EVT_NCLASSES) {
+    e->nxt = pool->free[c];
+    pool->free[c] = e;
+  }
+  else {
+    pool->allocated -= e->size;
+    csound->Free(csound, e);
+  }
+}
+
+static void evtpool_stats(CSOUND *csound)
+{
+  EVTPOOL *pool = (EVTPOOL*) csound->evtPool;
+  if (pool == NULL || (csound->oparms->msglevel & CS_TIMEMSG) == 0)
+    return;
+  csound->ErrorMsg(csound, Str("realtime event queue: peak %d events, "
+                               "%lu bytes (%lu allocated)\n"),
+                   (int) pool->peakcount, (unsigned long) pool->peakbytes,
+                   (unsigned long) pool->allocated);
+}
+
+static void evtpool_destroy(CSOUND *csound)
+{
+  EVTPOOL *pool = (EVTPOOL*) csound->evtPool;
+  if (pool == NULL)
+    return;
+  while (pool->chunks != NULL) {
+    void *nxt = *(void**) pool->chunks;
+    csound->Free(csound, pool->chunks);
+    pool->chunks = nxt;
+  }
+  csound->Free(csound, pool);
+  csound->evtPool = NULL;
+}
+
+/* the number of p-fields stored for an event: up to p3 are always kept,
+   as they are read before pcnt is checked */
+static inline int evtnode_npfields(int pcnt)
+{
+  return (pcnt < 3 ? 3 : pcnt < PMAX ? pcnt : PMAX);
+}
+
+/* the event in e, as an EVTBLK for process_score_event() */
+static void evtnode_expand(const EVTNODE *e, EVTBLK *evt)
+{
+  int np = evtnode_npfields(e->pcnt);
+  evt->strarg = e->strarg;
+  evt->scnt = e->scnt;
+  evt->pinstance = e->pinstance;
+  evt->opcod = e->opcod;
+  evt->pcnt = e->pcnt;
+  evt->p2orig = e->p2orig;
+  evt->p3orig = e->p3orig;
+  memcpy(evt->p, e->p, sizeof(MYFLT) * (np + 1));
+  evt->c.extra = e->extra;
+}
+
+/* Pending realtime events (csound->OrcTrigEvts) are kept in a pairing
+   heap ordered on start_kcnt and, for equal start times, on the order of
+   insertion, so they are started in the same order as from a sorted list.
+   The root is the next event due.  A node's children are linked from its
+   child field, and through nxt from one sibling to the next.  Insertion
+   is O(1); removing the root is O(log n) amortised. */
+
+static inline int evtnode_before(const EVTNODE *a, const EVTNODE *b)
+{
+  return (a->start_kcnt < b->start_kcnt ||
+          (a->start_kcnt == b->start_kcnt && a->seqno < b->seqno));
+}
+
+/* join two heaps; roots have nxt == NULL */
+static inline EVTNODE *evtheap_meld(EVTNODE *a, EVTNODE *b)
+{
+  EVTNODE *t;
+  if (a == NULL) return b;
+  if (b == NULL) return a;
+  if (evtnode_before(b, a)) {
+    t = a; a = b; b = t;
+  }
+  b->nxt = a->child;
+  a->child = b;
+  return a;
+}
+
+static inline void evtheap_insert(CSOUND *csound, EVTNODE *e)
+{
+  e->nxt = e->child = NULL;
+  csound->OrcTrigEvts = evtheap_meld(csound->OrcTrigEvts, e);
+}
+
+/* remove the root, melding its children in pairs from left to right,
+   then the pairs from right to left */
+static EVTNODE *evtheap_pop(CSOUND *csound)
+{
+  EVTNODE *e = csound->OrcTrigEvts, *c, *a, *b, *pairs = NULL;
+
+  c = e->child;
+  e->child = NULL;
+  while (c != NULL) {
+    a = c;
+    b = c->nxt;
+    if (b != NULL) {
+      c = b->nxt;
+      b->nxt = NULL;
+    }
+    else c = NULL;
+    a->nxt = NULL;
+    a = evtheap_meld(a, b);
+    a->nxt = pairs;
+    pairs = a;
+  }
+  c = NULL;
+  while (pairs != NULL) {
+    a = pairs;
+    pairs = a->nxt;
+    a->nxt = NULL;
+    c = evtheap_meld(c, a);
+  }
+  csound->OrcTrigEvts = c;
+  return e;
+}
+
+/* empty the heap, returning its nodes as a list linked through nxt */
+static EVTNODE *evtheap_unlink_all(CSOUND *csound)
+{
+  EVTNODE *stack = csound->OrcTrigEvts, *list = NULL, *e, *c;
+
+  while (stack != NULL) {
+    e = stack;
+    stack = e->nxt;
+    for (c = e->child; c != NULL; ) {
+      EVTNODE *nxt = c->nxt;
+      c->nxt = stack;
+      stack = c;
+      c = nxt;
+    }
+    e->child = NULL;
+    e->nxt = list;
+    list = e;
+  }
+  csound->OrcTrigEvts = NULL;
+  return list;
+}
+
 static void delete_pending_rt_events(CSOUND *csound)
 {
-  EVTNODE *ep = csound->OrcTrigEvts;
+  EVTNODE *ep = evtheap_unlink_all(csound);
 
   while (ep != NULL) {
     EVTNODE *nxt = ep->nxt;
-    if (ep->evt.strarg != NULL) {
-      csound->Free(csound,ep->evt.strarg);
-      ep->evt.strarg = NULL;
-    }
-    /* push to stack of free event nodes */
-    ep->nxt = csound->freeEvtNodes;
-    csound->freeEvtNodes = ep;
+    evtnode_free(csound, ep);
     ep = nxt;
   }
-  csound->OrcTrigEvts = NULL;
 }
 
 void delete_selected_rt_events(CSOUND *csound, MYFLT instr)
 {
-  EVTNODE *ep = csound->OrcTrigEvts;
-  EVTNODE *last = NULL;
+  /* the events kept are queued again, in their original order */
+  EVTNODE *ep = evtheap_unlink_all(csound);
   while (ep != NULL) {
     EVTNODE *nxt = ep->nxt;
     //printf("*** delete_selected_rt_events: instr = %f, p[1] = %f\n",
-    //instr, ep->evt.p[1]);
-    if (ep->evt.opcod=='i' &&
-        (((int)(ep->evt.p[1]) == instr) || (ep->evt.p[1] == instr))) {
+    //instr, ep->p[1]);
+    if (ep->opcod=='i' &&
+        (((int)(ep->p[1]) == instr) || (ep->p[1] == instr))) {
       //printf(" ** found\n");
       // Found an event to cancel
-      if (ep->evt.strarg != NULL) {
-        // clearstring if necessary
-        csound->Free(csound,ep->evt.strarg);
-        ep->evt.strarg = NULL;
-      }
-      if (last) last->nxt = nxt; else csound->OrcTrigEvts = nxt;
-      /* push to stack of free event nodes */
-      ep->nxt = csound->freeEvtNodes;
-      csound->freeEvtNodes = ep;
+      evtnode_free(csound, ep);
     }
-    else last = ep;
+    else evtheap_insert(csound, ep);
     ep = nxt;
   }
-  //csound->OrcTrigEvts = NULL;
 }
 
 static inline void cs_beep(CSOUND *csound)
@@ -521,15 +721,10 @@ PUBLIC int csoundCleanup(CSOUND *csound)
     }
 #endif
 
-    while (csound->freeEvtNodes != NULL) {
-      p = (void*) csound->freeEvtNodes;
-      csound->freeEvtNodes = ((EVTNODE*) p)->nxt;
-      csound->Free(csound,p);
-    }
-
     orcompact(csound);
 
     corfile_rm(csound, &csound->scstr);
+    scobin_close(csound);
 
     /* print stats only if musmon was actually run */
     /* NOT SURE HOW   ************************** */
@@ -554,8 +749,11 @@ PUBLIC int csoundCleanup(CSOUND *csound)
       csound->ErrorMsg(csound, Str("\n%d errors in performance\n"),
                       csound->perferrcnt);
       print_benchmark_info(csound, Str("end of performance"));
+      csoundFFTPlanCacheStats(csound);
+      evtpool_stats(csound);
       if (csound->print_version) print_csound_version(csound);
     }
+    evtpool_destroy(csound);
     /* close line input (-L) */
     RTclose(csound);
     /* close MIDI input */
@@ -941,8 +1139,10 @@ static int process_rt_event(CSOUND *csound, int sensType)
   }
   if (sensType == 4) {                  /* RM: Realtime orc event   */
     EVTNODE *e = csound->OrcTrigEvts;
-    /* RM: Events are sorted on insertion, so just check the first */
-    evt = &(e->evt);
+    /* RM: the next event due is at the root of the heap; it is expanded
+       into the pool's EVTBLK, too large for the stack */
+    evt = &((EVTPOOL*) csound->evtPool)->evt;
+    evtnode_expand(e, evt);
     insno = MYFLT2LONG(evt->p[1]);
     if ((rfd = getRemoteInsRfd(csound, insno))) {
       if (rfd == GLOBAL_REMOT)
@@ -951,16 +1151,11 @@ static int process_rt_event(CSOUND *csound, int sensType)
         insSendevt(csound, evt, rfd);  /* RM: or send to single remote Csound */
       return 0;
     }
-    /* pop from the list */
-    csound->OrcTrigEvts = e->nxt;
+    /* pop from the heap */
+    evtheap_pop(csound);
     retval = process_score_event(csound, evt, 1);
-    if (evt->strarg != NULL) {
-      csound->Free(csound, evt->strarg);
-      evt->strarg = NULL;
-    }
-    /* push back to free alloc stack so it can be reused later */
-    e->nxt = csound->freeEvtNodes;
-    csound->freeEvtNodes = e;
+    /* return the record to the pool so it can be reused later */
+    evtnode_free(csound, e);
   }
   else if (sensType == 2) {                      /* Midievent:    */
     MEVENT *mep;
@@ -1268,6 +1463,16 @@ static inline uint64_t time2kcnt(CSOUND *csound, double tval)
   return 0UL;
 }
 
+/* with sample-accurate timing, the k-period that contains the start
+   sample, so that insert() can place the onset within it */
+
+static inline uint64_t time2kcnt_sa(CSOUND *csound, double tval)
+{
+  if (tval > 0.0)
+    return (uint64_t) (tval * csound->esr) / csound->ksmps;
+  return 0UL;
+}
+
 
 /* Schedule new score event to be played. 'time_ofs' is the amount of */
 /* time in seconds to add to evt->p[2] to get the actual start time   */
@@ -1287,92 +1492,100 @@ static inline uint64_t time2kcnt(CSOUND *csound, double tval)
 int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
 {
   double        start_time;
-  EVTNODE       *e, *prv;
+  EVTNODE       *e;
   CSOUND        *st = csound;
   MYFLT         *p;
   uint32        start_kcnt;
-  int           i, retval;
+  size_t        ns;
+  int           i, np, nx, retval;
 
   retval = -1;
-  /* make a copy of the event... */
-  if (csound->freeEvtNodes != NULL) {             /* pop alloc from stack */
-    e = csound->freeEvtNodes;                     /*   if available       */
-    csound->freeEvtNodes = e->nxt;
-  }
-  else {
-    e = (EVTNODE*) csound->Calloc(csound, sizeof(EVTNODE)); /* or alloc new one */
-    if (UNLIKELY(e == NULL))
-      return CSOUND_MEMORY;
-  }
-  if (evt->strarg != NULL) {  /* copy string argument if present */
+  /* make a compact copy of the event... */
+  np = evtnode_npfields(evt->pcnt);
+  nx = (evt->pcnt > PMAX && evt->c.extra != NULL ?
+        (int) evt->c.extra[0] + 1 : 0);
+  ns = 0;
+  if (evt->strarg != NULL) {  /* copy string arguments if present */
     /* NEED TO COPY WHOLE STRING STRUCTURE */
     int n = evt->scnt;
-    char *p = evt->strarg;
-    while (n--) { p += strlen(p)+1; };
-    e->evt.strarg = (char*) csound->Malloc(csound, (size_t) (p-evt->strarg)+1);
-    if (UNLIKELY(e->evt.strarg == NULL)) {
-      csound->Free(csound, e);
-      return CSOUND_MEMORY;
-    }
-    memcpy(e->evt.strarg, evt->strarg, p-evt->strarg+1 );
-    e->evt.scnt = evt->scnt;
+    char *s = evt->strarg;
+    while (n--) { s += strlen(s)+1; };
+    ns = (size_t) (s - evt->strarg) + 1;
+  }
+  e = evtnode_alloc(csound, offsetof(EVTNODE, p) +
+                            sizeof(MYFLT) * (np + 1 + nx) + ns);
+  if (UNLIKELY(e == NULL))
+    return CSOUND_MEMORY;
+  p = e->p;
+  i = (evt->pcnt < 0 ? 0 : evt->pcnt < np ? evt->pcnt : np);
+  memcpy(p, evt->p, sizeof(MYFLT) * (i + 1));
+  while (i < np)
+    p[++i] = FL(0.0);
+  e->extra = NULL;
+  if (nx) {
+    e->extra = p + np + 1;
+    memcpy(e->extra, evt->c.extra, sizeof(MYFLT) * nx);
   }
-  e->evt.pinstance = evt->pinstance;
-  e->evt.opcod = evt->opcod;
-  e->evt.pcnt = evt->pcnt;
-  p = &(e->evt.p[0]);
-  i = 0;
-  while (++i <= evt->pcnt)    /* copy p-field list */
-    p[i] = evt->p[i];
+  e->strarg = NULL;
+  e->scnt = 0;
+  if (ns) {
+    e->strarg = (char*) (p + np + 1 + nx);
+    memcpy(e->strarg, evt->strarg, ns);
+    e->scnt = evt->scnt;
+  }
+  e->pinstance = evt->pinstance;
+  e->opcod = evt->opcod;
+  e->pcnt = evt->pcnt;
   /* ...and use the copy from now on */
-  evt = &(e->evt);
 
   /* check for required p-fields */
-  switch (evt->opcod) {
+  switch (e->opcod) {
   case 'f':
-    if (UNLIKELY((evt->pcnt < 4) && (p[1]>0)))
+    if (UNLIKELY((e->pcnt < 4) && (p[1]>0)))
       goto pfld_err;
     goto cont;
   case 'i':
   case 'q':
   case 'a':
-    if (UNLIKELY(evt->pcnt < 3))
+    if (UNLIKELY(e->pcnt < 3))
       goto pfld_err;
     /* fall through */
   case 'd':
   cont:
     /* calculate actual start time in seconds and k-periods */
     start_time = (double) p[2] + (double)time_ofs/csound->esr;
-    start_kcnt = time2kcnt(csound, start_time);
+    start_kcnt = (csound->oparms->sampleAccurate ?
+                  time2kcnt_sa(csound, start_time) :
+                  time2kcnt(csound, start_time));
     /* correct p2 value for section offset */
     p[2] = (MYFLT) (start_time - st->timeOffs);
     if (p[2] < FL(0.0))
       p[2] = FL(0.0);
     /* start beat: this is possibly wrong */
-    evt->p2orig = (MYFLT) (((start_time - st->icurTime/st->esr) /
-                            st->ibeatTime)
-                           + (st->curBeat - st->beatOffs));
-    if (evt->p2orig < FL(0.0))
-      evt->p2orig = FL(0.0);
-    evt->p3orig = p[3];
+    e->p2orig = (MYFLT) (((start_time - st->icurTime/st->esr) /
+                          st->ibeatTime)
+                         + (st->curBeat - st->beatOffs));
+    if (e->p2orig < FL(0.0))
+      e->p2orig = FL(0.0);
+    e->p3orig = p[3];
     break;
   default:
     start_kcnt = 0UL;   /* compiler only */
   }
 
-  switch (evt->opcod) {
+  switch (e->opcod) {
   case 'i':                         /* note event */
   case 'd':
     /* calculate the length in beats */
-    if (evt->p3orig > FL(0.0))
-      evt->p3orig = (MYFLT) ((double) evt->p3orig / st->ibeatTime);
+    if (e->p3orig > FL(0.0))
+      e->p3orig = (MYFLT) ((double) e->p3orig / st->ibeatTime);
     /* fall through */
   case 'q':                         /* mute instrument */
     /* check for a valid instrument number or name */
-    if (evt->opcod=='d') {
-      if (evt->strarg != NULL && csound->ISSTRCOD(p[1])) {
-        i = (int) named_instr_find(csound, evt->strarg);
-        //printf("d opcode %s -> %d\n", evt->strarg, i);
+    if (e->opcod=='d') {
+      if (e->strarg != NULL && csound->ISSTRCOD(p[1])) {
+        i = (int) named_instr_find(csound, e->strarg);
+        //printf("d opcode %s -> %d\n", e->strarg, i);
         p[1] = -i;
       }
       else {
@@ -1380,8 +1593,8 @@ int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
         p[1] = -i;
       }
     }
-    else if (evt->strarg != NULL && csound->ISSTRCOD(p[1])) {
-      MYFLT n = named_instr_find(csound, evt->strarg);
+    else if (e->strarg != NULL && csound->ISSTRCOD(p[1])) {
+      MYFLT n = named_instr_find(csound, e->strarg);
       p[1] = n;
       i =(int) n;
       if (n<0) {i= -i;}
@@ -1402,7 +1615,7 @@ int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
     break;
   case 'a':                         /* advance score time */
     /* calculate the length in beats */
-    evt->p3orig = (MYFLT) ((double) evt->p3orig *csound->esr/ st->ibeatTime);
+    e->p3orig = (MYFLT) ((double) e->p3orig *csound->esr/ st->ibeatTime);
     /* fall through */
   case 'f':                         /* function table */
     break;
@@ -1410,30 +1623,20 @@ int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
   case 'l':                         /*   lplay list, */
   case 's':                         /*   section:    */
     start_time = (double)time_ofs/csound->esr;
-    if (evt->pcnt >= 2)
+    if (e->pcnt >= 2)
       start_time += (double) p[2];
-    evt->pcnt = 0;
+    e->pcnt = 0;
     start_kcnt = time2kcnt(csound, start_time);
     break;
   default:
     csoundErrorMsg(csound, Str("insert_score_event(): unknown opcode: %c\n"),
-                  evt->opcod);
+                  e->opcod);
     goto err_return;
   }
-  /* queue new event */
+  /* queue new event, after any others with the same start time */
   e->start_kcnt = start_kcnt;
-  prv = csound->OrcTrigEvts;
-  /* if list is empty, or at beginning of list: */
-  if (prv == NULL || start_kcnt < prv->start_kcnt) {
-    e->nxt = prv;
-    csound->OrcTrigEvts = e;
-  }
-  else {                                      /* otherwise sort by time */
-    while (prv->nxt != NULL && start_kcnt >= prv->nxt->start_kcnt)
-      prv = prv->nxt;
-    e->nxt = prv->nxt;
-    prv->nxt = e;
-  }
+  e->seqno = STA(evtseqno)++;
+  evtheap_insert(csound, e);
   /* Make sure sensevents() looks for RT events */
   csound->oparms->RTevents = 1;
   return 0;
@@ -1442,11 +1645,7 @@ int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
   csoundErrorMsg(csound, Str("insert_score_event(): insufficient p-fields\n"));
  err_return:
   /* clean up */
-  if (e->evt.strarg != NULL)
-    csound->Free(csound, e->evt.strarg);
-  e->evt.strarg = NULL;
-  e->nxt = csound->freeEvtNodes;
-  csound->freeEvtNodes = e;
+  evtnode_free(csound, e);
   return retval;
 }
 
@@ -1491,8 +1690,12 @@ void musmon_rewind_score(CSOUND *csound)
   csound->advanceCnt = 0;
   if (csound->csoundScoreOffsetSeconds_ > FL(0.0))
     csoundSetScoreOffsetSeconds(csound, csound->csoundScoreOffsetSeconds_);
-  if (csound->scstr)
-    corfile_rewind(csound->scstr);
+  if (csound->scoreBin != NULL)
+    scobin_rewind(csound);
+  else if (csound->scstr) {
+    if (!scsort_rewind(csound))         /* sorted in windows: sort again */
+      corfile_rewind(csound->scstr);
+  }
   else csound->Warning(csound, Str("cannot rewind score: no score in memory\n"));
 }
 
@@ -114,6 +114,26 @@ int32 strarg2insno_p(CSOUND *csound, char *s)
     return insno;
 }
 
+/* strarg2insno for a string argument (strarg2insno_p if perf is */
+/* non-zero), through the cache c: the name is only looked up when */
+/* it differs from the one last resolved, or when named instruments */
+/* have been numbered since */
+int32 strarg2insno_cached(CSOUND *csound, INSNAME_CACHE *c, char *s,
+                          int perf)
+{
+    int32    insno;
+
+    if (c->gen == csound->instrNameGen && strcmp(c->name, s) == 0)
+      return c->insno;
+    insno = (perf ? strarg2insno_p(csound, s) : strarg2insno(csound, s, 1));
+    if (insno != NOT_AN_INSTRUMENT && strlen(s) < sizeof(c->name)) {
+      strcpy(c->name, s);
+      c->insno = insno;
+      c->gen = csound->instrNameGen;
+    }
+    return insno;
+}
+
 /* convert opcode string argument to instrument number */
 /* (also allows user defined opcode names); if the integer */
 /* argument is non-zero, only opcode names are searched */
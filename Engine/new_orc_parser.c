@@ -268,6 +268,7 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
 
       typeTable->localPool = typeTable->instr0LocalPool;
       typeTable->labelList = NULL;
+      typeTable->udoInlines = 0;
 
       astTree = verify_tree(csound, astTree, typeTable);
 //      csound->Free(csound, typeTable->instr0LocalPool);
@@ -144,6 +144,8 @@ int rdscor(CSOUND *csound, EVTBLK *e) /* read next score-line from scorefile */
     int     c;
 
     e->pinstance = NULL;
+    if (csound->scoreBin != NULL)           /* binary score: no parsing */
+      return scobin_read(csound, e);
     if (csound->scstr == NULL ||
         csound->scstr->body[0] == '\0') {   /* if no concurrent scorefile  */
       e->opcod = 'f';             /*     return an 'f 0 3600'    */
@@ -198,6 +200,8 @@ int rdscor(CSOUND *csound, EVTBLK *e) /* read next score-line from scorefile */
         e->pcnt = 0;
         return(1);
       case EOF:                          /* necessary for cscoreGetEvent */
+        if (scsort_more(csound))         /* next window of a long score */
+          continue;
         return(0);
       default:                                /* WARPED scorefile:       */
         if (!csound->warped) goto unwarped;
@@ -0,0 +1,364 @@
+/*
+    scobin.c:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"                                  /*   SCOBIN.C  */
+#include "corfile.h"
+#if !defined(WIN32)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+/* Binary sorted scores.  A sorted score is stored as the events rdscor()
+   reads from its text, so that playing it needs no parsing:
+
+     header     "CSSCOBIN", version, byte order mark
+     events     a SCOBIN_EVT each, followed by its p-fields p1... and its
+                overflow p-fields (c.extra, count first) as doubles, then
+                the numbers of its string p-fields, padded to 8 bytes
+     strings    the string arguments of the events, NUL separated
+     trailer    event count, offset and size of the strings, "CSSCOEND"
+
+   A string p-field holds the number of the string among those of its
+   event.  Values are doubles whatever MYFLT is.  Files are read on
+   machines of the byte order they were written on.  When played, the
+   file is mapped into memory and rdscor() fills its EVTBLKs from it. */
+
+extern void *fopen_path(CSOUND *, FILE **, char *, char *, char *, int);
+
+#define SCOBIN_VERSION  2
+#define SCOBIN_MARK     0x01020304
+
+typedef struct {
+    char        magic[8];
+    uint32_t    version, mark;
+} SCOBIN_HDR;
+
+typedef struct {
+    uint64_t    nevents;
+    uint64_t    stroffs, strsize;   /* the string table */
+    char        magic[8];
+} SCOBIN_END;
+
+typedef struct {
+    char        opcod;
+    char        pad;
+    int16_t     pcnt;               /* as rdscor() sets it */
+    uint16_t    nstr;               /* string p-fields */
+    uint16_t    np;                 /* p-fields p1... stored */
+    uint32_t    nextra;             /* overflow p-fields, with their count */
+    uint32_t    scnt;               /* strings, in the string table */
+    uint64_t    stroffs;
+    double      p2orig, p3orig;
+} SCOBIN_EVT;
+
+typedef struct {
+    char        *data;              /* the whole file */
+    size_t      size;
+    int         mapped;
+    char        *evt, *evtend;      /* next event, end of events */
+    char        *str;               /* string table */
+    size_t      strsize;
+} SCOBIN;
+
+static size_t evtsize(const SCOBIN_EVT *ev)
+{
+    return (sizeof(SCOBIN_EVT) + (ev->np + ev->nextra) * sizeof(double)
+            + ((ev->nstr * sizeof(uint16_t) + 7) & ~((size_t) 7)));
+}
+
+/* Write the sorted score text sco to out as a binary score.  The text is
+   read with rdscor(), as it would be when played.  Returns 0 on success. */
+
+int scobin_write(CSOUND *csound, CORFIL *sco, FILE *out)
+{
+    CORFIL      *scstr = csound->scstr;
+    int         pending = csound->csoundIsScorePending_;
+    int         warped = csound->warped;
+    SCOBIN_HDR  h;
+    SCOBIN_END  end;
+    SCOBIN_EVT  ev;
+    EVTBLK      *e;
+    double      v[PMAX + 1];
+    uint16_t    sp[PMAX + 4];
+    char        *strs = NULL;
+    size_t      strmax = 0;
+    int         i, err = 0;
+
+    memset(&h, 0, sizeof(SCOBIN_HDR));
+    memcpy(h.magic, "CSSCOBIN", 8);
+    h.version = SCOBIN_VERSION;
+    h.mark = SCOBIN_MARK;
+    memset(&end, 0, sizeof(SCOBIN_END));
+    memcpy(end.magic, "CSSCOEND", 8);
+    if (UNLIKELY(fwrite(&h, sizeof(SCOBIN_HDR), 1, out) != 1))
+      return -1;
+    end.stroffs = sizeof(SCOBIN_HDR);
+
+    e = (EVTBLK*) csound->Calloc(csound, sizeof(EVTBLK));
+    csound->scstr = sco;
+    csound->csoundIsScorePending_ = 1;
+    csound->warped = 0;
+    corfile_rewind(sco);
+    while (!err && sco->body[0] != '\0' && rdscor(csound, e)) {
+      memset(&ev, 0, sizeof(SCOBIN_EVT));
+      ev.opcod = e->opcod;
+      ev.p2orig = (double) e->p2orig;
+      ev.p3orig = (double) e->p3orig;
+      if (e->opcod != 'e') {
+        ev.pcnt = e->pcnt;
+        ev.np = (e->pcnt < PMAX ? e->pcnt : PMAX);
+        if (e->pcnt >= PMAX && e->c.extra != NULL)
+          ev.nextra = (uint32_t) e->c.extra[0] + 1;     /* and the count */
+      }
+      for (i = 1; i <= (int) ev.np; i++) {
+        v[i] = (double) e->p[i];
+        if (csound->ISSTRCOD(e->p[i])) {
+          union { MYFLT d; int32 i; } ch;
+          ch.d = e->p[i];
+          v[i] = (double) (ch.i & 0xffff);
+          sp[ev.nstr++] = (uint16_t) i;
+        }
+      }
+      while ((ev.nstr * sizeof(uint16_t)) & 7)
+        sp[ev.nstr++] = 0;
+      if (e->strarg != NULL && e->scnt > 0) {
+        size_t  n = 0;
+        for (i = 0; i < e->scnt; i++)
+          n += strlen(e->strarg + n) + 1;
+        if (end.strsize + n > strmax) {
+          strmax = 2 * (end.strsize + n);
+          strs = (char*) csound->ReAlloc(csound, strs, strmax);
+        }
+        memcpy(strs + end.strsize, e->strarg, n);
+        ev.scnt = (uint32_t) e->scnt;
+        ev.stroffs = end.strsize;
+        end.strsize += n;
+      }
+      if (UNLIKELY(fwrite(&ev, sizeof(SCOBIN_EVT), 1, out) != 1 ||
+                   fwrite(&v[1], sizeof(double), ev.np, out) != ev.np))
+        err = -1;
+      for (i = 0; !err && i < (int) ev.nextra; i++) {
+        double  x = (double) e->c.extra[i];
+        if (UNLIKELY(fwrite(&x, sizeof(double), 1, out) != 1))
+          err = -1;
+      }
+      if (UNLIKELY(!err &&
+                   fwrite(sp, sizeof(uint16_t), ev.nstr, out) != ev.nstr))
+        err = -1;
+      end.stroffs += evtsize(&ev);
+      end.nevents++;
+      csound->Free(csound, e->strarg);
+      e->strarg = NULL;
+      e->scnt = 0;
+      if (e->opcod == 'e')
+        break;
+    }
+    if (!err && end.strsize > 0 &&
+        UNLIKELY(fwrite(strs, 1, end.strsize, out) != end.strsize))
+      err = -1;
+    if (!err && UNLIKELY(fwrite(&end, sizeof(SCOBIN_END), 1, out) != 1))
+      err = -1;
+    csound->Free(csound, e->c.extra);
+    csound->Free(csound, e);
+    csound->Free(csound, strs);
+    csound->scstr = scstr;
+    csound->csoundIsScorePending_ = pending;
+    csound->warped = warped;
+    return err;
+}
+
+/* Open the score file name for playing if it is a binary score: returns
+   1 if it is, 0 if it is not (or cannot be opened) and -1 on errors. */
+
+int scobin_open(CSOUND *csound, const char *name)
+{
+    SCOBIN      *sb;
+    SCOBIN_HDR  h;
+    SCOBIN_END  end;
+    FILE        *f;
+    void        *fd;
+    char        *data;
+    size_t      size;
+    int         mapped = 0;
+
+    fd = fopen_path(csound, &f, (char*) name, NULL, NULL, 1);
+    if (fd == NULL || f == NULL)
+      return 0;
+    if (fread(&h, sizeof(SCOBIN_HDR), 1, f) != 1 ||
+        memcmp(h.magic, "CSSCOBIN", 8) != 0) {
+      csound->FileClose(csound, fd);
+      return 0;
+    }
+    if (UNLIKELY(h.mark != SCOBIN_MARK || h.version != SCOBIN_VERSION)) {
+      csound->FileClose(csound, fd);
+      csound->ErrorMsg(csound, Str("%s: binary score of another version "
+                                   "or byte order\n"), name);
+      return -1;
+    }
+    fseek(f, 0L, SEEK_END);
+    size = (size_t) ftell(f);
+#if !defined(WIN32)
+    data = (char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (data != (char*) MAP_FAILED) {
+      madvise(data, size, MADV_SEQUENTIAL);
+      mapped = 1;
+    }
+    else
+#endif
+    {
+      data = (char*) csound->Malloc(csound, size);
+      fseek(f, 0L, SEEK_SET);
+      if (UNLIKELY(fread(data, 1, size, f) != size)) {
+        csound->Free(csound, data);
+        csound->FileClose(csound, fd);
+        csound->ErrorMsg(csound, Str("%s: cannot read binary score\n"), name);
+        return -1;
+      }
+    }
+    csound->FileClose(csound, fd);
+    if (size >= sizeof(SCOBIN_HDR) + sizeof(SCOBIN_END))
+      memcpy(&end, data + size - sizeof(SCOBIN_END), sizeof(SCOBIN_END));
+    if (UNLIKELY(size < sizeof(SCOBIN_HDR) + sizeof(SCOBIN_END) ||
+                 memcmp(end.magic, "CSSCOEND", 8) != 0 ||
+                 end.stroffs + end.strsize + sizeof(SCOBIN_END) != size)) {
+#if !defined(WIN32)
+      if (mapped) munmap(data, size); else
+#endif
+      csound->Free(csound, data);
+      csound->ErrorMsg(csound, Str("%s: binary score is truncated\n"), name);
+      return -1;
+    }
+    scobin_close(csound);
+    sb = (SCOBIN*) csound->Calloc(csound, sizeof(SCOBIN));
+    sb->data = data;
+    sb->size = size;
+    sb->mapped = mapped;
+    sb->evt = data + sizeof(SCOBIN_HDR);
+    sb->evtend = data + end.stroffs;
+    sb->str = data + end.stroffs;
+    sb->strsize = (size_t) end.strsize;
+    csound->scoreBin = sb;
+    return 1;
+}
+
+void scobin_close(CSOUND *csound)
+{
+    SCOBIN  *sb = (SCOBIN*) csound->scoreBin;
+    if (sb == NULL)
+      return;
+#if !defined(WIN32)
+    if (sb->mapped)
+      munmap(sb->data, sb->size);
+    else
+#endif
+      csound->Free(csound, sb->data);
+    csound->Free(csound, sb);
+    csound->scoreBin = NULL;
+}
+
+void scobin_rewind(CSOUND *csound)
+{
+    SCOBIN  *sb = (SCOBIN*) csound->scoreBin;
+    if (sb != NULL)
+      sb->evt = sb->data + sizeof(SCOBIN_HDR);
+}
+
+/* rdscor() for a binary score: fill e with the next event */
+
+int scobin_read(CSOUND *csound, EVTBLK *e)
+{
+    SCOBIN      *sb = (SCOBIN*) csound->scoreBin;
+    SCOBIN_EVT  ev;
+    const char  *p;
+    int         i;
+
+    if (sb->evt + sizeof(SCOBIN_EVT) > sb->evtend)
+      return 0;
+    memcpy(&ev, sb->evt, sizeof(SCOBIN_EVT));
+    if (UNLIKELY(sb->evt + evtsize(&ev) > sb->evtend ||
+                 ev.np > PMAX || ev.stroffs > sb->strsize)) {
+      csound->ErrorMsg(csound, Str("binary score: bad event\n"));
+      return 0;
+    }
+    p = sb->evt + sizeof(SCOBIN_EVT);
+    sb->evt += evtsize(&ev);
+
+    e->pinstance = NULL;
+    e->opcod = ev.opcod;
+    if (ev.opcod == 'e') {
+      e->pcnt = 0;
+      return 1;
+    }
+    if (ev.opcod == 's' || ev.opcod == 't' || ev.opcod == 'y')
+      csound->warped = 0;
+    else if (ev.opcod == 'w')
+      csound->warped = 1;
+    e->p2orig = (MYFLT) ev.p2orig;
+    e->p3orig = (MYFLT) ev.p3orig;
+#if defined(USE_DOUBLE)
+    memcpy(&e->p[1], p, ev.np * sizeof(double));
+    p += ev.np * sizeof(double);
+#else
+    for (i = 1; i <= (int) ev.np; i++, p += sizeof(double)) {
+      double  x;
+      memcpy(&x, p, sizeof(double));
+      e->p[i] = (MYFLT) x;
+    }
+#endif
+    csound->Free(csound, e->c.extra);
+    e->c.extra = NULL;
+    if (ev.nextra > 0) {
+      e->c.extra = (MYFLT*) csound->Malloc(csound, sizeof(MYFLT) *
+                                           (ev.nextra > PMAX ?
+                                            ev.nextra : PMAX));
+      for (i = 0; i < (int) ev.nextra; i++, p += sizeof(double)) {
+        double  x;
+        memcpy(&x, p, sizeof(double));
+        e->c.extra[i] = (MYFLT) x;
+      }
+    }
+    for (i = 0; i < (int) ev.nstr; i++, p += sizeof(uint16_t)) {
+      uint16_t n;
+      union { MYFLT d; int32 i; } ch;
+      memcpy(&n, p, sizeof(uint16_t));
+      if (n == 0 || n > ev.np)
+        continue;                       /* padding */
+      ch.d = SSTRCOD; ch.i += (int32) e->p[n];
+      e->p[n] = ch.d;
+    }
+    if (!csound->csoundIsScorePending_ && e->opcod == 'i') {
+      /* FIXME: should pause and not mute */
+      e->opcod = 'f'; e->p[1] = FL(0.0); e->pcnt = 2; e->scnt = 0;
+      return 1;
+    }
+    e->pcnt = ev.pcnt;
+    if (ev.scnt > 0) {
+      size_t  n = 0;
+      for (i = 0; i < (int) ev.scnt && ev.stroffs + n < sb->strsize; i++)
+        n += strlen(sb->str + ev.stroffs + n) + 1;
+      e->strarg = (char*) csound->Malloc(csound, n);
+      memcpy(e->strarg, sb->str + ev.stroffs, n);
+      e->scnt = (int) ev.scnt;
+    }
+    else { e->strarg = NULL; e->scnt = 0; }
+    return 1;
+}
@@ -26,21 +26,187 @@
 #include <ctype.h>
 
 extern void sort(CSOUND*);
-extern void twarp(CSOUND*);
+extern int  twarp(CSOUND*);
+extern void twarp_window(CSOUND*);
 extern void swritestr(CSOUND*, CORFIL *sco, int first);
+extern void swritestr_window(CSOUND*, CORFIL *sco, int first, int cont);
 extern void sfree(CSOUND *csound);
 //extern void sread_init(CSOUND *csound);
 extern int  sread(CSOUND *csound);
+extern void sread_rewind(CSOUND *csound);
+
+/* With --score-window=N, the score loaded before performance is read,
+   sorted and written a window of N statements at a time, and the next
+   window only when rdscor() has used up the text of the last one, so
+   that playing starts after the first window and the sorter holds one
+   window at a time.  Events are sorted within their window only: one
+   that belongs before the end of an earlier window of its section is
+   played late, and counted.  Ramps and next/previous p-field references
+   do not see past the window. */
+
+typedef struct {
+    MYFLT   last;               /* latest time written in this section  */
+    int     cont;               /* next window continues a section      */
+    int     warp;               /* this section has a tempo statement   */
+    int     done;               /* score read to its end                */
+    int     fills;              /* times scstr was filled               */
+    int32   windows, late;
+} SCSTREAM;
+
+/* a score of just an e statement is made to last for ever */
+
+static int foreverIfEmpty(CSOUND *csound, CORFIL *sco)
+{
+    int i = 0;
+    while (isspace(sco->body[i])) i++;
+    if (sco->body[i] == 'e' && sco->body[i+1] == '\n' && sco->body[i+2] != 'e') {
+      corfile_rewind(sco);
+      corfile_puts(csound, "f0 800000000000.0\ne\n", sco); /* ~25367 years */
+      return 1;
+    }
+    return 0;
+}
+
+/* count the events of this window that start before the end of an earlier
+   window of the section, and move the end on */
+
+static int32 lateEvents(CSOUND *csound, SCSTREAM *st)
+{
+    SRTBLK  *bp;
+    MYFLT   last = st->last;
+    int32   n = 0;
+
+    for (bp = csound->frstbp; bp != NULL; bp = bp->nxtblk) {
+      switch (bp->text[0]) {
+      case 'i': case 'd': case 'f': case 'a': case 'q':
+        if (bp->newp2 < st->last)
+          n++;
+        if (bp->newp2 > last)
+          last = bp->newp2;
+      }
+    }
+    st->last = last;
+    return n;
+}
+
+/* sort windows of the score into scstr until there is something to play */
+
+static void sortWindows(CSOUND *csound, SCSTREAM *st)
+{
+    CORFIL  *sco = csound->scstr;
+    int32   late;
+    int     n;
+
+    corfile_reset(sco);
+    while (!st->done && sco->p == 0) {
+      if ((n = sread(csound)) <= 0) {
+        st->done = 1;
+        if (st->fills > 0 || !foreverIfEmpty(csound, sco))
+          corfile_puts(csound, "e\n", sco);
+        sfree(csound);
+        if (st->late > 0 || (csound->oparms->msglevel & CS_TIMEMSG))
+          csound->Message(csound,
+                          Str("score sorted in %d windows, "
+                              "%d events played late\n"),
+                          (int) st->windows, (int) st->late);
+        break;
+      }
+      if (!st->cont && csound->frstbp->text[0] == 's')
+        continue;                       /* ignore empty segment */
+      sort(csound);
+      if (!st->cont) {
+        st->warp = twarp(csound);
+        st->last = -FL(1.0);
+      }
+      else if (st->warp)
+        twarp_window(csound);
+      if (UNLIKELY((late = lateEvents(csound, st)) > 0 && st->late == 0))
+        csound->Warning(csound,
+                        Str("score events out of order by more than the "
+                            "sorting window, section %d"), csound->sectcnt);
+      st->late += late;
+      swritestr_window(csound, sco, 1, st->cont);
+      st->cont = (n == 2);
+      st->windows++;
+    }
+    if (st->fills++ == 0 && !st->done)
+      foreverIfEmpty(csound, sco);
+    corfile_rewind(sco);
+}
+
+/* called by rdscor() at the end of the sorted text: 1 if there is more */
+
+int scsort_more(CSOUND *csound)
+{
+    SCSTREAM *st = (SCSTREAM*) csound->scoreStream;
+    if (st == NULL || st->done || csound->scstr == NULL)
+      return 0;
+    sortWindows(csound, st);
+    return 1;
+}
+
+/* start a score sorted in windows again from its beginning */
+
+int scsort_rewind(CSOUND *csound)
+{
+    SCSTREAM *st = (SCSTREAM*) csound->scoreStream;
+    if (st == NULL || csound->scstr == NULL)
+      return 0;
+    sread_rewind(csound);
+    csound->sread.window = csound->oparms->scorewindow;
+    memset(st, 0, sizeof(SCSTREAM));
+    sortWindows(csound, st);
+    return 1;
+}
 
 /* called from smain.c or some other main */
 /* reads,sorts,timewarps each score sect in turn */
 
 extern void sread_initstr(CSOUND *, CORFIL *sco);
+void print_benchmark_info(CSOUND *, const char *);
+
+/* real time spent reading, sorting, warping and writing, with CS_TIMEMSG */
+#define SCORE_PHASE(i)                                                  \
+    do {                                                                \
+      if (timing) {                                                     \
+        double t1 = csoundGetRealTime(csound->csRtClock);               \
+        tphase[i] += t1 - t; t = t1;                                    \
+      }                                                                 \
+    } while (0)
+
 char *scsortstr(CSOUND *csound, CORFIL *scin)
 {
     int     n;
-    int     first = 0;
+    int     first = 0, timing;
+    double  t, tphase[4] = { 0.0, 0.0, 0.0, 0.0 };
     CORFIL *sco;
+    SCSTREAM *st = (SCSTREAM*) csound->scoreStream;
+
+    if (st != NULL && !st->done) {
+      /* a score sorted in windows is being played: sort this one with
+         a sorter space and tempo map of its own */
+      struct sread__ sread = csound->sread;
+      CORFIL  *xsco = csound->expanded_sco;
+      SRTBLK  *frstbp = csound->frstbp;
+      void    *tseg = csound->tseg, *tpsave = csound->tpsave;
+      int     sectcnt = csound->sectcnt;
+      char    *str;
+      csound->sread.curmem = csound->sread.memend = NULL;
+      csound->sread.histmem = NULL;
+      csound->sread.window = 0;
+      csound->tseg = NULL;
+      csound->scoreStream = NULL;
+      str = scsortstr(csound, scin);
+      csound->Free(csound, csound->tseg);
+      corfile_rm(csound, &csound->expanded_sco);
+      csound->sread = sread;
+      csound->expanded_sco = xsco;
+      csound->frstbp = frstbp;
+      csound->tseg = tseg; csound->tpsave = tpsave;
+      csound->sectcnt = sectcnt;
+      csound->scoreStream = st;
+      return str;
+    }
 
     csound->scoreout = NULL;
     if (csound->scstr == NULL && (csound->engineStatus & CS_STATE_COMP) == 0) {
@@ -51,26 +217,44 @@ char *scsortstr(CSOUND *csound, CORFIL *scin)
     csound->sectcnt = 0;
     sread_initstr(csound, scin);
 
+    if (first && csound->oparms->scorewindow > 0 && !csound->keep_tmp &&
+        csound->xfilename == NULL && !csound->oparms->usingcscore) {
+      SCSTREAM *st = (SCSTREAM*) csound->Calloc(csound, sizeof(SCSTREAM));
+      csound->scoreStream = st;
+      csound->sread.window = csound->oparms->scorewindow;
+      sortWindows(csound, st);
+      return sco->body;
+    }
+    timing = (first && (csound->oparms->msglevel & CS_TIMEMSG) &&
+              csound->csRtClock != NULL);
+    if (timing)
+      print_benchmark_info(csound, Str("end of score preprocessing"));
+    t = (timing ? csoundGetRealTime(csound->csRtClock) : 0.0);
     while ((n = sread(csound)) > 0) {
+      SCORE_PHASE(0);
       if (csound->frstbp->text[0] == 's') { // ignore empty segment
         // should this free memory?
         //printf("repeated 's'\n");
         continue;
       }
       sort(csound);
+      SCORE_PHASE(1);
       twarp(csound);
+      SCORE_PHASE(2);
       swritestr(csound, sco, first);
+      SCORE_PHASE(3);
       //printf("sorted: >>>%s<<<\n", sco->body);
     }
+    if (timing) {
+      SCORE_PHASE(0);
+      csound->Message(csound, Str("Score sort: read %.3fs, sort %.3fs, "
+                                  "time warp %.3fs, write %.3fs (real)\n"),
+                      tphase[0], tphase[1], tphase[2], tphase[3]);
+    }
     //printf("**** first = %d body = >>%s<<\n", first, sco->body);
     if (first) {
-      int i = 0;
-      while (isspace(sco->body[i])) i++;
-      if (sco->body[i] == 'e' && sco->body[i+1] == '\n' && sco->body[i+2] != 'e') {
-        corfile_rewind(sco);
-        corfile_puts(csound, "f0 800000000000.0\ne\n", sco); /* ~25367 years */
-      }
-      else corfile_puts(csound, "e\n", sco);
+      if (!foreverIfEmpty(csound, sco))
+        corfile_puts(csound, "e\n", sco);
       //printf("body >>%s<<\n", sco->body);
     }
     corfile_flush(csound, sco);
@@ -84,4 +268,3 @@ char *scsortstr(CSOUND *csound, CORFIL *scin)
       return str;
     }
 }
-
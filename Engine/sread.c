@@ -57,7 +57,7 @@ extern void cs_init_smacros(CSOUND*, PRS_PARM*, NAMES*);
 
 static intptr_t expand_nxp(CSOUND *csound)
 {
-    char      *oldp;
+    char      *oldp, *oldend;
     SRTBLK    *p;
     intptr_t  offs;
     size_t    nbytes;
@@ -70,6 +70,7 @@ static intptr_t expand_nxp(CSOUND *csound)
     /* calculate the number of bytes to allocate */
     nbytes = (size_t) ((csound->sread.memend) -
                        (csound->sread.curmem));
+    oldend = (csound->sread.memend) + MARGIN;
     nbytes = nbytes + (nbytes >> 3) + (size_t) (MEMSIZ - 1);
     nbytes &= ~((size_t) (MEMSIZ - 1));
     /* extend allocated memory */
@@ -82,31 +83,27 @@ static intptr_t expand_nxp(CSOUND *csound)
     /* did the pointer change ? */
     if ((csound->sread.curmem) == oldp)
       return (intptr_t) 0;      /* no, nothing to do */
-    /* correct all pointers for the change */
+    /* correct all pointers for the change; in a window after the first
+       of a section, some point to the notes kept from earlier windows */
     offs = (intptr_t) ((uintptr_t)(csound->sread.curmem) - (uintptr_t) oldp);
-    if ((csound->sread.bp) != NULL)
-      (csound->sread.bp) =
-        (SRTBLK*) ((uintptr_t) (csound->sread.bp) + (intptr_t) offs);
-    if ((csound->sread.prvibp) != NULL)
-      (csound->sread.prvibp) =
-        (SRTBLK*) ((uintptr_t) (csound->sread.prvibp) + (intptr_t) offs);
-    if ((csound->sread.sp) != NULL)
-      (csound->sread.sp) =
-        (char*) ((uintptr_t) (csound->sread.sp) + (intptr_t) offs);
-    if ((csound->sread.nxp) != NULL)
-      (csound->sread.nxp) =
-        (char*) ((uintptr_t) (csound->sread.nxp) + (intptr_t) offs);
+#define RELOC(x)  if ((char*) (x) >= oldp && (char*) (x) < oldend)     \
+                    (x) = (void*) ((uintptr_t) (x) + (intptr_t) offs)
+    RELOC(csound->sread.bp);
+    RELOC(csound->sread.prvibp);
+    RELOC(csound->sread.sp);
+    RELOC(csound->sread.nxp);
     if (csound->frstbp == NULL)
       return offs;
+    RELOC(csound->frstbp);
     p = csound->frstbp;
-    csound->frstbp = p = (SRTBLK*) ((uintptr_t) p + (intptr_t) offs);
+    RELOC(p->prvblk);
     do {
-      if (p->prvblk != NULL)
-        p->prvblk = (SRTBLK*) ((uintptr_t) p->prvblk + (intptr_t) offs);
+      RELOC(p->nxtblk);
       if (p->nxtblk != NULL)
-        p->nxtblk = (SRTBLK*) ((uintptr_t) p->nxtblk + (intptr_t) offs);
+        p->nxtblk->prvblk = p;
       p = p->nxtblk;
     } while (p != NULL);
+#undef RELOC
     /* return pointer change in bytes */
     return offs;
 }
@@ -268,18 +265,91 @@ void sread_initstr(CSOUND *csound, CORFIL *sco)
     }
 }
 
+/* Size of a sortblock, from the start of the next one as read.  The notes
+   kept for carrying into the next window are laid out the same way. */
+
+static size_t srtblk_size(CSOUND *csound, SRTBLK *p)
+{
+    char    *end;
+    if ((char*) p >= STA(curmem) && (char*) p < STA(memend) + MARGIN)
+      end = (p->nxtblk != NULL && (char*) p->nxtblk > (char*) p ?
+             (char*) p->nxtblk : STA(nxp));
+    else
+      end = (p == STA(hist) ? STA(histend) : (char*) p->nxtblk);
+    return (size_t) (end - (char*) p);
+}
+
+/* At the end of a window, copy the statement read last and the last note
+   of each instrument out of the sorter space, which the next window of
+   the section reuses; carried p-fields and '+' times are taken from them. */
+
+static void keep_history(CSOUND *csound)
+{
+    unsigned char seen[8192];
+    SRTBLK  *p, *q, *nxt, *tail = NULL;
+    char    *mem = NULL, *end;
+    size_t  size, total = 0;
+    int     pass;
+
+    for (pass = 0; pass < 2; pass++) {
+      memset(seen, 0, sizeof(seen));
+      nxt = NULL;
+      end = (pass ? mem + total : NULL);
+      for (p = STA(bp); p != NULL; p = p->prvblk) {
+        uint16_t n = (uint16_t) p->insno;
+        if (p != STA(bp) &&
+            ((p->text[0] != 'i' && p->text[0] != 'd') ||
+             (seen[n >> 3] & (1 << (n & 7)))))
+          continue;
+        seen[n >> 3] |= (1 << (n & 7));
+        size = (srtblk_size(csound, p) + 7) & ~((size_t) 7);
+        if (!pass) {
+          total += size;
+          continue;
+        }
+        end -= size;
+        q = (SRTBLK*) end;
+        memcpy(q, p, srtblk_size(csound, p));
+        q->prvblk = NULL;
+        q->nxtblk = nxt;
+        if (nxt != NULL)
+          nxt->prvblk = q;
+        else
+          tail = q;
+        nxt = q;
+      }
+      if (!pass)
+        mem = (char*) csound->Malloc(csound, total);
+    }
+    if (STA(histmem) != NULL)
+      csound->Free(csound, STA(histmem));
+    STA(histmem) = mem;
+    STA(histend) = mem + total;
+    STA(hist) = tail;
+}
+
 int sread(CSOUND *csound)       /*  called from main,  reads from SCOREIN   */
 {                               /*  each score statement gets a sortblock   */
     int  rtncod;                /* return code to calling program:      */
                                 /*   1 = section read                   */
+                                /*   2 = window read, section goes on   */
                                 /*   0 = end of file                    */
+    int  nblk = 0;
     /* sread_alloc_globals(csound); */
-    (csound->sread.bp) =
+    if (STA(inwindow)) {        /* next window of this section:         */
+      (csound->sread.bp) = STA(hist);   /* chained after the kept notes */
       (csound->sread.prvibp) = csound->frstbp = NULL;
-    (csound->sread.nxp) = NULL;
-    (csound->sread.warpin) = 0;
-    (csound->sread.lincnt) = 1;
-    csound->sectcnt++;
+      (csound->sread.nxp) = NULL;
+      STA(inwindow) = 0;
+    }
+    else {
+      (csound->sread.bp) =
+        (csound->sread.prvibp) = csound->frstbp = NULL;
+      (csound->sread.nxp) = NULL;
+      (csound->sread.warpin) = 0;
+      (csound->sread.lincnt) = 1;
+      csound->sectcnt++;
+    }
     rtncod = 0;
     salcinit(csound);           /* init the mem space for this section  */
 #ifdef never
@@ -293,10 +363,18 @@ int sread(CSOUND *csound)       /*  called from main,  reads from SCOREIN   */
     }
 #endif
     //printf("sread starts with >>%s<<\n", csound->expanded_sco->body);
-    while (((csound->sread.op) = getop(csound)) != EOF) {
+    while (1) {
+      if (STA(window) > 0 && nblk >= STA(window)) {
+        keep_history(csound);   /* window full, more of section to come */
+        STA(inwindow) = 1;
+        return 2;
+      }
       /* read next op from scorefile */
+      if (((csound->sread.op) = getop(csound)) == EOF)
+        break;
       rtncod = 1;
       salcblk(csound);          /* build a line structure; init bp,nxp  */
+      nblk++;
     again:
       //printf("*** reading: %c (%.2x)\n",
       //       (csound->sread.op), (csound->sread.op));
@@ -937,6 +1015,13 @@ void sfree(CSOUND *csound)       /* free all sorter allocated space */
       csound->Free(csound, (csound->sread.curmem));
       (csound->sread.curmem) = NULL;
     }
+    if (STA(histmem) != NULL) {
+      csound->Free(csound, STA(histmem));
+      STA(histmem) = NULL;
+    }
+    STA(hist) = NULL;
+    STA(inwindow) = 0;
+    STA(window) = 0;
     while ((csound->sread.str) != &(csound->sread.inputs)[0]) {
       //corfile_rm(&((csound->sread.str)->cf));
       (csound->sread.str)--;
@@ -944,6 +1029,18 @@ void sfree(CSOUND *csound)       /* free all sorter allocated space */
     corfile_rm(csound, &(csound->scorestr));
 }
 
+void sread_rewind(CSOUND *csound)
+{                               /* read the expanded score again from the */
+    sfree(csound);              /*   start, for a score read in windows   */
+    corfile_rewind(csound->expanded_sco);
+    STA(input_cnt) = 0;
+    STA(clock_base) = FL(0.0);
+    STA(warp_factor) = FL(1.0);
+    STA(prvp2) = -FL(1.0);
+    STA(nocarry) = 0;
+    csound->sectcnt = 0;
+}
+
 static void flushlin(CSOUND *csound)
 {                                   /* flush input to end-of-line; inc lincnt */
     int c;
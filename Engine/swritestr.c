@@ -27,6 +27,9 @@
 #include <ctype.h>
 #include "corfile.h"
 
+void   swritestr_window(CSOUND *, CORFIL *, int, int);
+static void   swrite_blocks(CSOUND *, SRTBLK *, SRTBLK *, CORFIL *, int, int);
+static int    swrite_threads(CSOUND *, SRTBLK *, CORFIL *, int, int);
 static SRTBLK *nxtins(SRTBLK *), *prvins(SRTBLK *);
 static char   *pfout(CSOUND *,SRTBLK *, char *, int, int, CORFIL *sco);
 static char   *nextp(CSOUND *,SRTBLK *, char *, int, int, CORFIL *sco);
@@ -37,10 +40,40 @@ static char   *randramp(CSOUND *,SRTBLK *, char *, int, int, CORFIL *sco);
 static char   *pfStr(CSOUND *,char *, int, int, CORFIL *sco);
 static char   *fpnum(CSOUND *,char *, int, int, CORFIL *sco);
 
+/* Values are written as C99 hexadecimal floats, as "%a" formats them
+   with the GNU C library: subnormals as 0x0.<mantissa>p-1022, and
+   infinities and NaNs as inf and nan, with their sign.  They are all
+   formatted here: that needs no locale, so it is safe in the writer
+   threads, and it is quicker. */
+
 static void fltout(CSOUND *csound, MYFLT n, CORFIL *sco)
 {
-    char *c, buffer[1024];
-    CS_SPRINTF(buffer, "%a", (double)n);
+    static const char hex[] = "0123456789abcdef";
+    char    *c, buffer[32];
+    double  x = (double) n;
+    uint64_t bits, mant;
+    int     e;
+
+    memcpy(&bits, &x, sizeof(double));
+    mant = bits & ((((uint64_t) 1) << 52) - 1);
+    e = (int) ((bits >> 52) & 0x7ff);
+    c = buffer;
+    if (bits >> 63) *c++ = '-';
+    if (e == 0x7ff)
+      strcpy(c, (mant != 0 ? "nan" : "inf"));
+    else {
+      *c++ = '0'; *c++ = 'x'; *c++ = (e == 0 ? '0' : '1');
+      e = (e != 0 ? e - 1023 : mant != 0 ? -1022 : 0);
+      if (mant != 0) {
+        *c++ = '.';
+        while (mant != 0) {
+          *c++ = hex[(mant >> 48) & 0xf];
+          mant = (mant << 4) & ((((uint64_t) 1) << 52) - 1);
+        }
+      }
+      *c++ = 'p'; *c++ = (e < 0 ? '-' : '+');
+      snprintf(c, 8, "%d", (e < 0 ? -e : e));
+    }
     /* corfile_puts(buffer, sco); */
     for (c = buffer; *c != '\0'; c++)
       corfile_putc(csound, *c, sco);
@@ -62,10 +95,18 @@ static void fltout(CSOUND *csound, MYFLT n, CORFIL *sco)
 */
 
 void swritestr(CSOUND *csound, CORFIL *sco, int first)
+{
+    swritestr_window(csound, sco, first, 0);
+}
+
+/* A section sorted in windows has its warp-format indicator, if any,
+   written with its first window only: 'cont' is set for the others. */
+
+void swritestr_window(CSOUND *csound, CORFIL *sco, int first, int cont)
 {
     SRTBLK *bp;
-    char   *p, c, isntAfunc;
-    int    lincnt, pcnt=0;
+    char   c;
+    int    lincnt;
 
     if (UNLIKELY((bp = csound->frstbp) == NULL))
       return;
@@ -74,9 +115,99 @@ void swritestr(CSOUND *csound, CORFIL *sco, int first)
     if ((c = bp->text[0]) != 'w'
         && c != 's' && c != 'e') {      /*   if no warp stmnt but real data,  */
       /* create warp-format indicator */
-      if (first) corfile_puts(csound, "w 0 60\n", sco);
+      if (first && !cont) corfile_puts(csound, "w 0 60\n", sco);
       lincnt++;
     }
+    if (csound->oparms->numThreads < 2 ||
+        !swrite_threads(csound, bp, sco, first, lincnt))
+      swrite_blocks(csound, bp, NULL, sco, first, lincnt);
+}
+
+/* With -j N, a long section is written in up to N consecutive runs of
+   statements at once, each into a text of its own; the texts are then
+   joined in order, so the sorted score is the same as when it is written
+   by one thread.  Sections with random ramps (~) are written in one run,
+   as each value takes the next number from the score's generator. */
+
+#define SWRITE_MINBLKS  4096    /* fewest statements per run */
+#define SWRITE_MAXTHREADS 16
+
+typedef struct {
+    CSOUND  *csound;
+    SRTBLK  *bp, *end;          /* statements from bp to before end */
+    CORFIL  *sco;
+    int     first, lincnt;
+    void    *thread;
+} SWRITE_RUN;
+
+static uintptr_t swrite_thread(void *data)
+{
+    SWRITE_RUN *r = (SWRITE_RUN*) data;
+    swrite_blocks(r->csound, r->bp, r->end, r->sco, r->first, r->lincnt);
+    return 0;
+}
+
+static int swrite_threads(CSOUND *csound, SRTBLK *bp, CORFIL *sco,
+                          int first, int lincnt)
+{
+    SWRITE_RUN run[SWRITE_MAXTHREADS];
+    SRTBLK  *p, *last = bp;
+    char    *t;
+    int     i, n, nblks = 0, nruns;
+
+    for (p = bp; p != NULL; p = p->nxtblk) {
+      for (t = p->text; *t != LF && *t != '\0'; t++)
+        if (*t == '~')
+          return 0;
+      last = p;
+      nblks++;
+    }
+    /* the statement ending the section is written here afterwards: it
+       may be formatted by the C library, which can change the locale */
+    nblks--;
+    nruns = nblks / SWRITE_MINBLKS;
+    if (nruns > csound->oparms->numThreads)
+      nruns = csound->oparms->numThreads;
+    if (nruns > SWRITE_MAXTHREADS)
+      nruns = SWRITE_MAXTHREADS;
+    if (nruns < 2)
+      return 0;
+    for (i = 0, p = bp; i < nruns; i++) {
+      run[i].csound = csound;
+      run[i].bp = p;
+      run[i].first = first;
+      run[i].lincnt = lincnt;
+      run[i].sco = (i == 0 ? sco : corfile_create_w(csound));
+      run[i].thread = NULL;
+      n = (i == nruns - 1 ? nblks - (nruns - 1) * (nblks / nruns)
+                          : nblks / nruns);
+      lincnt += n;
+      while (n--)
+        p = p->nxtblk;
+      run[i].end = p;
+    }
+    for (i = 1; i < nruns; i++)
+      run[i].thread = csound->CreateThread(swrite_thread, &run[i]);
+    swrite_thread(&run[0]);
+    for (i = 1; i < nruns; i++) {
+      if (run[i].thread != NULL)
+        csound->JoinThread(run[i].thread);
+      else swrite_thread(&run[i]);
+      corfile_puts(csound, corfile_body(run[i].sco), sco);
+      corfile_rm(csound, &run[i].sco);
+    }
+    swrite_blocks(csound, last, NULL, sco, first, lincnt);
+    return 1;
+}
+
+/* write the statements from bp to before end */
+
+static void swrite_blocks(CSOUND *csound, SRTBLK *bp, SRTBLK *end,
+                          CORFIL *sco, int first, int lincnt)
+{
+    char   *p, c, isntAfunc;
+    int    pcnt=0;
+
  nxtlin:
     lincnt++;                           /* now for each line:           */
     p = bp->text;
@@ -164,7 +295,7 @@ void swritestr(CSOUND *csound, CORFIL *sco, int first)
                       c, csound->sectcnt, lincnt);
       break;
     }
-    if ((bp = bp->nxtblk) != NULL)
+    if ((bp = bp->nxtblk) != end)
       goto nxtlin;
 }
 
@@ -32,22 +32,39 @@ typedef struct {
 
 int     realtset(CSOUND *, SRTBLK *);
 MYFLT   realt(CSOUND *, MYFLT);
+static void warp(CSOUND *);
 
-void twarp(CSOUND *csound) /* time-warp a score section acc to T-statement */
-{
+int twarp(CSOUND *csound)  /* time-warp a score section acc to T-statement */
+{                          /*   returns 1 if the section was warped      */
     SRTBLK  *bp;
-    MYFLT   absp3;
-    MYFLT   endtime;
-    int     negp3;
 
     if (UNLIKELY((bp = csound->frstbp) == NULL))      /* if null file,         */
-      return;
+      return 0;
     while (bp->text[0] != 't')              /*  or cannot find a t,  */
       if (UNLIKELY((bp = bp->nxtblk) == NULL))
-        return;                             /*      we are done      */
+        return 0;                           /*      we are done      */
     bp->text[0] = 'w';                      /* else mark the t used  */
     if (!realtset(csound, bp))              /*  and init the t-array */
-      return;                               /* (done if t0 60 or err) */
+      return 0;                             /* (done if t0 60 or err) */
+    warp(csound);
+    return 1;
+}
+
+void twarp_window(CSOUND *csound)   /* warp a later window of a section   */
+{                                   /*   by the t-array of its first one  */
+    if (csound->frstbp == NULL)
+      return;
+    csound->tpsave = csound->tseg;
+    warp(csound);
+}
+
+static void warp(CSOUND *csound)
+{
+    SRTBLK  *bp;
+    MYFLT   absp3;
+    MYFLT   endtime;
+    int     negp3;
+
     bp  = csound->frstbp;
     negp3 = 0;
     do {
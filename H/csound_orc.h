@@ -44,6 +44,7 @@ typedef struct type_table {
     CS_VAR_POOL* instr0LocalPool;
     CS_VAR_POOL* localPool;
     CONS_CELL* labelList;
+    int udoInlines;             /* UDO bodies inlined so far */
 } TYPE_TABLE;
 
 
@@ -0,0 +1,260 @@
+/*
+    dline.h:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Interpolating reads from circular delay buffers, shared by the vdelay
+   family, multitap and the delayr taps.  A DLINE is a view of a buffer;
+   when its length is a power of two, positions are wrapped with a mask,
+   otherwise (delayr) with a compare.  Reads at a fixed delay walk the
+   buffer in contiguous spans, so the inner loops carry no wrap tests;
+   reads at per-sample delays take precomputed base positions and are
+   gathered four at a time when compiling for SSE2.
+
+   The interpolators are those of the original opcodes.  y0 is the point
+   at the base position i, y1 the one at i + s and ym1, y2 those at i - s
+   and i + 2s, where the step s is +1 or -1. */
+
+#ifndef DLINE_H
+#define DLINE_H
+
+#include "oscsimd.h"
+
+/* samples per pass of the per-sample position loops */
+#define DLINE_CHUNK     64
+
+typedef struct {
+    MYFLT   *buf;
+    int32_t size;       /* length of buf */
+    int32_t mask;       /* size - 1 if size is a power of two, else 0 */
+} DLINE;
+
+/* the smallest power of two not less than n */
+static inline uint32_t dline_pow2(uint32_t n)
+{
+    uint32_t s = 1;
+    while (s < n) s <<= 1;
+    return s;
+}
+
+static inline void dline_view(DLINE *d, MYFLT *buf, int32_t size)
+{
+    d->buf = buf;
+    d->size = size;
+    d->mask = (size > 1 && !(size & (size - 1)) ? size - 1 : 0);
+}
+
+/* wrap a position at most one buffer length outside the buffer */
+static inline int32_t dline_wrap(const DLINE *d, int32_t i)
+{
+    if (d->mask) return i & d->mask;
+    if (UNLIKELY(i < 0)) return i + d->size;
+    if (UNLIKELY(i >= d->size)) return i - d->size;
+    return i;
+}
+
+/* copy n samples into the buffer at i; returns the position after them */
+static inline int32_t dline_write(const DLINE *d, int32_t i,
+                                  const MYFLT *in, int32_t n)
+{
+    while (n > 0) {
+      int32_t run = d->size - i;
+      if (run > n) run = n;
+      memcpy(d->buf + i, in, run * sizeof(MYFLT));
+      in += run; n -= run; i += run;
+      if (i >= d->size) i = 0;
+    }
+    return i;
+}
+
+static inline MYFLT dline_lin1(MYFLT y0, MYFLT y1, MYFLT f)
+{
+    return y0 + f * (y1 - y0);
+}
+
+/* cubic interpolation, optimized by Istvan Varga (Oct 2001) */
+static inline MYFLT dline_cub1(MYFLT ym1, MYFLT y0, MYFLT y1, MYFLT y2,
+                               MYFLT f)
+{
+    MYFLT w, x, y, z;
+    z = f * f; z--; z *= FL(0.1666666667);
+    y = f; y++; w = (y *= FL(0.5)); w--;
+    x = FL(3.0) * z; y -= x; w -= z; x -= f;
+    return (w*ym1 + x*y0 + y*y1 + z*y2) * f + y0;
+}
+
+/* linear reads at a fixed delay: i advances by one sample per output */
+static inline void dline_lin_k(const DLINE *d, int32_t i, int32_t s,
+                               MYFLT f, MYFLT *out, int32_t n)
+{
+    const MYFLT *buf = d->buf;
+    while (n > 0) {
+      int32_t lo = (s > 0 ? i : i + s), hi = (s > 0 ? i + s : i);
+      int32_t run, k;
+      if (LIKELY(lo >= 0 && hi < d->size)) {
+        const MYFLT *y0 = buf + i, *y1 = buf + i + s;
+        run = d->size - hi;
+        if (run > n) run = n;
+        for (k = 0; k < run; k++)
+          out[k] = y0[k] + f * (y1[k] - y0[k]);
+      }
+      else {
+        run = 1;
+        out[0] = dline_lin1(buf[i], buf[dline_wrap(d, i + s)], f);
+      }
+      out += run; n -= run;
+      i = dline_wrap(d, i + run);
+    }
+}
+
+/* cubic reads at a fixed delay */
+static inline void dline_cub_k(const DLINE *d, int32_t i, int32_t s,
+                               MYFLT f, MYFLT *out, int32_t n)
+{
+    const MYFLT *buf = d->buf;
+    MYFLT   w, x, y, z;
+    z = f * f; z--; z *= FL(0.1666666667);
+    y = f; y++; w = (y *= FL(0.5)); w--;
+    x = FL(3.0) * z; y -= x; w -= z; x -= f;
+    while (n > 0) {
+      int32_t lo = (s > 0 ? i - 1 : i - 2), hi = (s > 0 ? i + 2 : i + 1);
+      int32_t run, k;
+      if (LIKELY(lo >= 0 && hi < d->size)) {
+        const MYFLT *ym1 = buf + i - s, *y0 = buf + i;
+        const MYFLT *y1 = buf + i + s, *y2 = buf + i + 2*s;
+        run = d->size - hi;
+        if (run > n) run = n;
+        for (k = 0; k < run; k++)
+          out[k] = (w*ym1[k] + x*y0[k] + y*y1[k] + z*y2[k]) * f + y0[k];
+      }
+      else {
+        run = 1;
+        out[0] = (w*buf[dline_wrap(d, i - s)] + x*buf[i] +
+                  y*buf[dline_wrap(d, i + s)] +
+                  z*buf[dline_wrap(d, dline_wrap(d, i + s) + s)]) * f + buf[i];
+      }
+      out += run; n -= run;
+      i = dline_wrap(d, i + run);
+    }
+}
+
+/* add g times the samples from i on to out: one multitap tap */
+static inline void dline_tap_k(const DLINE *d, int32_t i, MYFLT g,
+                               MYFLT *out, int32_t n)
+{
+    while (n > 0) {
+      const MYFLT *y = d->buf + i;
+      int32_t run = d->size - i, k;
+      if (run > n) run = n;
+      for (k = 0; k < run; k++)
+        out[k] += y[k] * g;
+      out += run; n -= run;
+      i = dline_wrap(d, i + run);
+    }
+}
+
+#if defined(__SSE2__)
+static inline __m128i dline_wrap4(const DLINE *d, __m128i i)
+{
+    if (d->mask)
+      return _mm_and_si128(i, _mm_set1_epi32(d->mask));
+    else {
+      __m128i size = _mm_set1_epi32(d->size);
+      i = _mm_add_epi32(i, _mm_and_si128(_mm_cmplt_epi32(i, _mm_setzero_si128()),
+                                         size));
+      return _mm_sub_epi32(i, _mm_and_si128(_mm_cmpgt_epi32(i,
+                                     _mm_set1_epi32(d->size - 1)), size));
+    }
+}
+#endif
+
+/* linear reads at per-sample base positions ndx[] and fractions f[] */
+static inline void dline_lin_a(const DLINE *d, const int32_t *ndx,
+                               const MYFLT *f, int32_t s, MYFLT *out,
+                               int32_t n)
+{
+    int32_t k = 0;
+#if defined(__SSE2__)
+    __m128i step = _mm_set1_epi32(s);
+    for ( ; k + 4 <= n; k += 4) {
+      __m128i i0 = _mm_loadu_si128((const __m128i*) (ndx + k));
+      __m128i i1 = dline_wrap4(d, _mm_add_epi32(i0, step));
+      oscv_store(out + k, oscv_lerp(oscv_gather(d->buf, i0),
+                                    oscv_gather(d->buf, i1),
+                                    oscv_load(f + k)));
+    }
+#endif
+    for ( ; k < n; k++)
+      out[k] = dline_lin1(d->buf[ndx[k]],
+                          d->buf[dline_wrap(d, ndx[k] + s)], f[k]);
+}
+
+/* cubic reads at per-sample base positions */
+static inline void dline_cub_a(const DLINE *d, const int32_t *ndx,
+                               const MYFLT *f, int32_t s, MYFLT *out,
+                               int32_t n)
+{
+    int32_t k = 0;
+#if defined(__SSE2__)
+    __m128i step = _mm_set1_epi32(s);
+    OSCV    one = oscv_set1(FL(1.0)), half = oscv_set1(FL(0.5));
+    OSCV    three = oscv_set1(FL(3.0)), sixth = oscv_set1(FL(0.1666666667));
+    for ( ; k + 4 <= n; k += 4) {
+      __m128i i0 = _mm_loadu_si128((const __m128i*) (ndx + k));
+      __m128i im1 = dline_wrap4(d, _mm_sub_epi32(i0, step));
+      __m128i i1 = dline_wrap4(d, _mm_add_epi32(i0, step));
+      __m128i i2 = dline_wrap4(d, _mm_add_epi32(i1, step));
+      OSCV    fr = oscv_load(f + k), y0 = oscv_gather(d->buf, i0);
+      OSCV    w, x, y, z, v;
+      z = oscv_mul(oscv_sub(oscv_mul(fr, fr), one), sixth);
+      y = oscv_mul(oscv_add(fr, one), half);
+      w = oscv_sub(y, one);
+      x = oscv_mul(three, z); y = oscv_sub(y, x); w = oscv_sub(w, z);
+      x = oscv_sub(x, fr);
+      v = oscv_add(oscv_mul(w, oscv_gather(d->buf, im1)), oscv_mul(x, y0));
+      v = oscv_add(v, oscv_mul(y, oscv_gather(d->buf, i1)));
+      v = oscv_add(v, oscv_mul(z, oscv_gather(d->buf, i2)));
+      oscv_store(out + k, oscv_add(oscv_mul(v, fr), y0));
+    }
+#endif
+    for ( ; k < n; k++) {
+      int32_t i1 = dline_wrap(d, ndx[k] + s);
+      out[k] = dline_cub1(d->buf[dline_wrap(d, ndx[k] - s)], d->buf[ndx[k]],
+                          d->buf[i1], d->buf[dline_wrap(d, i1 + s)], f[k]);
+    }
+}
+
+/* sum of the n samples from i on, weighted by wt[] */
+static inline double dline_dot(const DLINE *d, int32_t i,
+                               const double *wt, int32_t n)
+{
+    double  sum = 0.0;
+    while (n > 0) {
+      const MYFLT *y = d->buf + i;
+      int32_t run = d->size - i, k;
+      if (run > n) run = n;
+      for (k = 0; k < run; k++)
+        sum += (double)y[k] * wt[k];
+      wt += run; n -= run;
+      i = dline_wrap(d, i + run);
+    }
+    return sum;
+}
+
+#endif  /* DLINE_H */
@@ -0,0 +1,105 @@
+/*
+    fcoef.h:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Coefficient cache for filters with k-rate parameters, used when
+   --smooth-filters is set.  The functions of the normalised frequency x
+   (cycles per sample) that filter designs need are tabulated once per
+   instance of Csound, and read with linear interpolation; arguments
+   outside 0 <= x <= 0.5 (tan: 0.45) are computed directly.  Since the
+   tables are in normalised frequency they hold for any sample rate.
+   cos(2 pi x) is found as 1 - 2 sin(pi x)^2, which keeps its distance
+   from 1, and so the centre frequency of a resonator, accurate at low
+   frequencies where interpolating a cosine table would not.
+   The filters also ramp their coefficients per sample from one k-cycle
+   to the next. */
+
+#ifndef FCOEF_H
+#define FCOEF_H
+
+#include <math.h>
+
+#define FCOEF_SIZE      4096            /* table points for 0 <= x < 0.5 */
+#define FCOEF_TANMAX    0.45
+
+typedef struct {
+    double  exp2pi[FCOEF_SIZE + 2];     /* exp(-2 pi x)                 */
+    double  sinpi[FCOEF_SIZE + 2];      /* sin(pi x)                    */
+    double  tanpi[FCOEF_SIZE + 2];      /* tan(pi x), up to FCOEF_TANMAX */
+} FCOEF_TABLES;
+
+/* the tables of this instance, or NULL without --smooth-filters */
+
+static inline FCOEF_TABLES *fcoef_tables(CSOUND *csound)
+{
+    FCOEF_TABLES *t;
+    int32_t i;
+    double  x;
+
+    if (!csound->oparms->smoothfilters) return NULL;
+    t = (FCOEF_TABLES*) csound->QueryGlobalVariable(csound, "::fcoef");
+    if (t != NULL) return t;
+    if (csound->CreateGlobalVariable(csound, "::fcoef",
+                                     sizeof(FCOEF_TABLES)) != 0)
+      return NULL;
+    t = (FCOEF_TABLES*) csound->QueryGlobalVariable(csound, "::fcoef");
+    for (i = 0; i < FCOEF_SIZE + 2; i++) {
+      x = (double) i * (0.5 / FCOEF_SIZE);
+      t->exp2pi[i] = exp(-TWOPI * x);
+      t->sinpi[i] = sin(PI * x);
+      t->tanpi[i] = (x <= FCOEF_TANMAX + 0.01 ? tan(PI * x) : 0.0);
+    }
+    return t;
+}
+
+static inline double fcoef_read(const double *tab, double x)
+{
+    double  fi = x * (2.0 * FCOEF_SIZE);
+    int32_t i = (int32_t) fi;
+
+    return tab[i] + (tab[i + 1] - tab[i]) * (fi - (double) i);
+}
+
+static inline double fcoef_cos2pi(const FCOEF_TABLES *t, double x)
+{
+    double  s;
+
+    if (x < 0.0 || x > 0.5) return cos(TWOPI * x);
+    s = fcoef_read(t->sinpi, x);
+    return 1.0 - 2.0 * s * s;
+}
+
+static inline double fcoef_exp2pi(const FCOEF_TABLES *t, double x)
+{
+    return (x >= 0.0 && x <= 0.5 ? fcoef_read(t->exp2pi, x) : exp(-TWOPI * x));
+}
+
+static inline double fcoef_sinpi(const FCOEF_TABLES *t, double x)
+{
+    return (x >= 0.0 && x <= 0.5 ? fcoef_read(t->sinpi, x) : sin(PI * x));
+}
+
+static inline double fcoef_tanpi(const FCOEF_TABLES *t, double x)
+{
+    return (x >= 0.0 && x <= FCOEF_TANMAX ?
+            fcoef_read(t->tanpi, x) : tan(PI * x));
+}
+
+#endif  /* FCOEF_H */
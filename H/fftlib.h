@@ -126,7 +126,10 @@ extern "C" {
    * d:       direction (FFT_FWD or FFT_INV). Scaling by 1/FFTsize is done on
    *          the inverse direction (as with the other RealFFT functions above).
    *
-   *  returns: a pointer to the FFT setup.
+   *  returns: a pointer to the FFT setup.  Setups are shared by all
+   *           callers with the same size, direction and FFT library, and
+   *           stay cached until the instance is reset; they are never
+   *           released by the caller.
    */
   void *csoundRealFFT2Setup(CSOUND *csound, int FFTsize, int d);
 
@@ -141,6 +144,29 @@ extern "C" {
    */
   void csoundRealFFT2(CSOUND *csound, void *setup, MYFLT *sig);
 
+  /**
+   * New Real FFT interface
+   * Compute in-place real FFTs of several signals of the same size.
+   *
+   * sigs:    array of nsigs pointers to buffers in the format used by
+   *          csoundRealFFT2()
+   * setup:   an FFT setup created with csoundRealFFT2Setup()
+   */
+  void csoundRealFFT2Batch(CSOUND *csound, void *setup,
+                           MYFLT **sigs, int nsigs);
+
+  /**
+   * Creates the FFT plan cache of a Csound instance
+   * (called from csoundReset()).
+   */
+  void csoundFFTPlanCacheInit(CSOUND *csound);
+
+  /**
+   * Prints the number of cached FFT plans and the plan
+   * cache hit/miss counts (with the CS_TIMEMSG message level).
+   */
+  void csoundFFTPlanCacheStats(CSOUND *csound);
+
 #ifdef __cplusplus
 }
 #endif
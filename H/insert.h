@@ -57,10 +57,21 @@ typedef struct {
 /* the number of optional outputs defined in entry.c */
 #define SUBINSTNUMOUTS  8
 
+/* An argument of a UDO instance that may refer to the caller's variable
+   directly instead of being copied every cycle */
+typedef struct {
+    MYFLT   *self;          /* the UDO's own variable (xin/xout argument) */
+    MYFLT   ***slots;       /* argument pointers of the body that refer to it */
+    int     nslots;
+    int     bindable;       /* never written (input) or not aliased (output) */
+    int     bound;          /* slots currently point to the caller's memory */
+} UDO_ARGBIND;
+
 typedef struct {
     OPCODINFO *opcode_info;
     void    *uopcode_struct;
     INSDS   *parent_ip;
+    UDO_ARGBIND *bind;      /* one per output and input, set up at first init */
     MYFLT   *iobufp_ptrs[12];  /* expandable IV - Oct 26 2002 */ /* was 8 */
 } OPCOD_IOBUFS;
 
@@ -24,6 +24,8 @@
 #ifndef CSOUND_LINEVENT_H
 #define CSOUND_LINEVENT_H
 
+#include "namedins.h"
+
 /*****************************************************************/
 /* linevent                                                      */
 /* Dec 2001 by matt ingalls                                      */
@@ -33,6 +35,8 @@ typedef struct {
     MYFLT  *args[VARGMAX];
     int argno;
     int flag;
+    INSNAME_CACHE namecache;
+    INSNAME_CACHE *cache;   /* if not NULL, used instead of namecache */
 } LINEVENT;
 
 
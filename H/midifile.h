@@ -28,7 +28,7 @@
 extern "C" {
 #endif
 
-/* open MIDI file, read all tracks, and create event list */
+/* open MIDI file, check and index all tracks, and read tempo changes */
 
 int csoundMIDIFileOpen(CSOUND *csound, const char *name);
 
@@ -54,6 +54,21 @@ int32 strarg2insno(CSOUND *, void *, int);
 
 int32 strarg2insno_p(CSOUND *, char *);
 
+/* an instrument name resolved by an opcode, kept in the opcode's data */
+/* and reused while the name and the numbering of named instruments */
+/* (csound->instrNameGen) stay the same */
+
+typedef struct {
+    uint32_t  gen;              /* instrNameGen when resolved, 0: unused */
+    int32     insno;
+    char      name[32];
+} INSNAME_CACHE;
+
+/* strarg2insno for a string argument, or strarg2insno_p if perf is */
+/* non-zero, through the cache c */
+
+int32 strarg2insno_cached(CSOUND *, INSNAME_CACHE *c, char *, int perf);
+
 /* convert opcode string argument to instrument number */
 /* (also allows user defined opcode names); if the integer */
 /* argument is non-zero, only opcode names are searched */
@@ -0,0 +1,231 @@
+/*
+    oscsimd.h:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Four-lane MYFLT vectors for the table oscillators.  A vector holds
+   four consecutive samples; in double precision it is a pair of SSE2
+   registers.  Table lookups are gathered lane by lane, or with the AVX2
+   gather instructions when those are available.  Only defined when
+   compiling for SSE2; callers keep their scalar loops for the rest of
+   the block and for other targets. */
+
+#ifndef OSCSIMD_H
+#define OSCSIMD_H
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(USE_DOUBLE)
+
+typedef struct { __m128d lo, hi; } OSCV;
+
+static inline OSCV oscv_set1(MYFLT x)
+{
+    OSCV r; r.lo = r.hi = _mm_set1_pd(x); return r;
+}
+
+static inline OSCV oscv_set4(MYFLT a, MYFLT b, MYFLT c, MYFLT d)
+{
+    OSCV r; r.lo = _mm_set_pd(b, a); r.hi = _mm_set_pd(d, c); return r;
+}
+
+static inline OSCV oscv_load(const MYFLT *x)
+{
+    OSCV r; r.lo = _mm_loadu_pd(x); r.hi = _mm_loadu_pd(x + 2); return r;
+}
+
+static inline void oscv_store(MYFLT *x, OSCV a)
+{
+    _mm_storeu_pd(x, a.lo); _mm_storeu_pd(x + 2, a.hi);
+}
+
+static inline OSCV oscv_add(OSCV a, OSCV b)
+{
+    OSCV r; r.lo = _mm_add_pd(a.lo, b.lo); r.hi = _mm_add_pd(a.hi, b.hi);
+    return r;
+}
+
+static inline OSCV oscv_sub(OSCV a, OSCV b)
+{
+    OSCV r; r.lo = _mm_sub_pd(a.lo, b.lo); r.hi = _mm_sub_pd(a.hi, b.hi);
+    return r;
+}
+
+static inline OSCV oscv_mul(OSCV a, OSCV b)
+{
+    OSCV r; r.lo = _mm_mul_pd(a.lo, b.lo); r.hi = _mm_mul_pd(a.hi, b.hi);
+    return r;
+}
+
+static inline OSCV oscv_div(OSCV a, OSCV b)
+{
+    OSCV r; r.lo = _mm_div_pd(a.lo, b.lo); r.hi = _mm_div_pd(a.hi, b.hi);
+    return r;
+}
+
+/* lanes of a 32-bit integer vector, converted exactly */
+static inline OSCV oscv_cvti(__m128i x)
+{
+    OSCV r;
+    r.lo = _mm_cvtepi32_pd(x);
+    r.hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    return r;
+}
+
+/* lanes truncated to 32-bit integers */
+static inline __m128i oscv_cvttrunc(OSCV a)
+{
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(a.lo), _mm_cvttpd_epi32(a.hi));
+}
+
+/* four doubles, rounded to MYFLT */
+static inline OSCV oscv_frompd(__m128d lo, __m128d hi)
+{
+    OSCV r; r.lo = lo; r.hi = hi; return r;
+}
+
+static inline OSCV oscv_gather(const MYFLT *t, __m128i ndx)
+{
+    OSCV r;
+#if defined(__AVX2__)
+    r.lo = _mm_i32gather_pd(t, ndx, 8);
+    r.hi = _mm_i32gather_pd(t, _mm_shuffle_epi32(ndx,
+                                                 _MM_SHUFFLE(1, 0, 3, 2)), 8);
+#else
+    int32_t i[4];
+    _mm_storeu_si128((__m128i*) i, ndx);
+    r.lo = _mm_set_pd(t[i[1]], t[i[0]]);
+    r.hi = _mm_set_pd(t[i[3]], t[i[2]]);
+#endif
+    return r;
+}
+
+#else   /* !USE_DOUBLE */
+
+typedef struct { __m128 v; } OSCV;
+
+static inline OSCV oscv_set1(MYFLT x)
+{
+    OSCV r; r.v = _mm_set1_ps(x); return r;
+}
+
+static inline OSCV oscv_set4(MYFLT a, MYFLT b, MYFLT c, MYFLT d)
+{
+    OSCV r; r.v = _mm_set_ps(d, c, b, a); return r;
+}
+
+static inline OSCV oscv_load(const MYFLT *x)
+{
+    OSCV r; r.v = _mm_loadu_ps(x); return r;
+}
+
+static inline void oscv_store(MYFLT *x, OSCV a)
+{
+    _mm_storeu_ps(x, a.v);
+}
+
+static inline OSCV oscv_add(OSCV a, OSCV b)
+{
+    OSCV r; r.v = _mm_add_ps(a.v, b.v); return r;
+}
+
+static inline OSCV oscv_sub(OSCV a, OSCV b)
+{
+    OSCV r; r.v = _mm_sub_ps(a.v, b.v); return r;
+}
+
+static inline OSCV oscv_mul(OSCV a, OSCV b)
+{
+    OSCV r; r.v = _mm_mul_ps(a.v, b.v); return r;
+}
+
+static inline OSCV oscv_div(OSCV a, OSCV b)
+{
+    OSCV r; r.v = _mm_div_ps(a.v, b.v); return r;
+}
+
+static inline OSCV oscv_cvti(__m128i x)
+{
+    OSCV r; r.v = _mm_cvtepi32_ps(x); return r;
+}
+
+static inline __m128i oscv_cvttrunc(OSCV a)
+{
+    return _mm_cvttps_epi32(a.v);
+}
+
+static inline OSCV oscv_frompd(__m128d lo, __m128d hi)
+{
+    OSCV r;
+    r.v = _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    return r;
+}
+
+static inline OSCV oscv_gather(const MYFLT *t, __m128i ndx)
+{
+    OSCV r;
+#if defined(__AVX2__)
+    r.v = _mm_i32gather_ps(t, ndx, 4);
+#else
+    int32_t i[4];
+    _mm_storeu_si128((__m128i*) i, ndx);
+    r.v = _mm_set_ps(t[i[3]], t[i[2]], t[i[1]], t[i[0]]);
+#endif
+    return r;
+}
+
+#endif  /* USE_DOUBLE */
+
+/* linear interpolation v0 + (v1 - v0) * fract, as in the scalar code */
+static inline OSCV oscv_lerp(OSCV v0, OSCV v1, OSCV fract)
+{
+    return oscv_add(v0, oscv_mul(oscv_sub(v1, v0), fract));
+}
+
+/* the cubic interpolation of oscil3 and poscil3, with the operations in
+   the same order as the scalar code */
+static inline OSCV oscv_cubic(OSCV ym1, OSCV y0, OSCV y1, OSCV y2,
+                              OSCV fract)
+{
+    OSCV half = oscv_set1(FL(0.5)), three = oscv_set1(FL(3.0));
+    OSCV six = oscv_set1(FL(6.0));
+    OSCV frsq = oscv_mul(fract, fract);
+    OSCV frcu = oscv_mul(frsq, ym1);
+    OSCV t1 = oscv_add(oscv_add(oscv_add(y2, y0), y0), y0);
+    OSCV v;
+
+    v = oscv_add(y0, oscv_mul(half, frcu));
+    v = oscv_add(v, oscv_mul(fract,
+                             oscv_sub(oscv_sub(oscv_sub(y1,
+                                                        oscv_div(frcu, six)),
+                                               oscv_div(t1, six)),
+                                      oscv_div(ym1, three))));
+    v = oscv_add(v, oscv_mul(oscv_mul(frsq, fract),
+                             oscv_sub(oscv_div(t1, six),
+                                      oscv_mul(half, y1))));
+    return oscv_add(v, oscv_mul(frsq, oscv_sub(oscv_mul(half, y1), y0)));
+}
+
+#endif  /* __SSE2__ */
+
+#endif  /* OSCSIMD_H */
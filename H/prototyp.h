@@ -61,6 +61,13 @@ void    dispinit(CSOUND *);
 int     init0(CSOUND *);
 void    scsort(CSOUND *, FILE *, FILE *);
 char    *scsortstr(CSOUND *, CORFIL *);
+int     scsort_more(CSOUND *);
+int     scsort_rewind(CSOUND *);
+int     scobin_write(CSOUND *, CORFIL *, FILE *);
+int     scobin_open(CSOUND *, const char *);
+int     scobin_read(CSOUND *, EVTBLK *);
+void    scobin_rewind(CSOUND *);
+void    scobin_close(CSOUND *);
 int     scxtract(CSOUND *, CORFIL *, FILE *);
 int     rdscor(CSOUND *, EVTBLK *);
 int     musmon(CSOUND *);
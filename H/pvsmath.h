@@ -0,0 +1,338 @@
+/*
+    pvsmath.h:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Conversion of spectral frames between (re, im) and (magnitude, phase)
+   pairs, for the phase vocoder analysis and resynthesis.  By default the
+   libm functions are used, and the results are those of the bin by bin
+   code.  With --pvs-fast-math the arctangent, sine and cosine are
+   polynomials instead, evaluated four bins at a time when compiling for
+   SSE2: the arctangent is good to 3e-10 rad, and the sine and cosine
+   to about an ulp after reduction of the argument, which is exact for
+   arguments up to about 1e6 rad.  The phase errors add up in pvsynth,
+   so that a pvsanal/pvsynth round trip differs from the libm one by
+   less than 2e-7 of full scale over the first second, and by more over
+   longer sounds (4e-7 after 16 s at N = 256).  In single precision
+   builds the vector code runs in single precision. */
+
+#ifndef PVSMATH_H
+#define PVSMATH_H
+
+#include <math.h>
+#include "oscsimd.h"
+
+/* atan(a)/a as a polynomial in a*a, for 0 <= a <= 1, and the sine and
+   cosine of |r| <= pi/4 as polynomials in r*r (Cephes), highest
+   coefficients first */
+static const double pvs_atan_c[11] = {
+    1.0844926512800156e-03, -7.1661643913830623e-03, 2.2203453826587064e-02,
+    -4.4273666972021605e-02, 6.7101138952177730e-02, -8.7961175152992163e-02,
+    1.1053784741520430e-01, -1.4279048414937046e-01, 1.9999595853985655e-01,
+    -3.3333323665617731e-01, 9.9999999961452435e-01
+};
+static const double pvs_sin_c[6] = {
+    1.58962301576546568060e-10, -2.50507477628578072866e-08,
+    2.75573136213857245213e-06, -1.98412698295895385996e-04,
+    8.33333333332211858878e-03, -1.66666666666666307295e-01
+};
+static const double pvs_cos_c[6] = {
+    -1.13585365213876817300e-11, 2.08757008419747316778e-09,
+    -2.75573141792967388112e-07, 2.48015872888517045348e-05,
+    -1.38888888888730564116e-03, 4.16666666666665929218e-02
+};
+
+/* pi/2 in two parts, the first with a short mantissa, so that q * hi is
+   exact for the quadrant numbers q that occur */
+#define PVS_PIO2_HI     1.57079632673412561417e+00
+#define PVS_PIO2_LO     6.07710050650619224932e-11
+/* adding and subtracting this rounds to an integer */
+#define PVS_RNDMAGIC    6755399441055744.0
+
+static inline double pvs_poly(double x, const double *c, int32_t n)
+{
+    double  r = c[0];
+    int32_t i;
+    for (i = 1; i < n; i++)
+      r = r * x + c[i];
+    return r;
+}
+
+static inline double pvs_atan2_fast(double y, double x)
+{
+    double  ax = fabs(x), ay = fabs(y);
+    double  mx = (ax > ay ? ax : ay), mn = (ax > ay ? ay : ax);
+    double  a = (mx > 0.0 ? mn / mx : 0.0), s = a * a;
+    double  r = a * pvs_poly(s, pvs_atan_c, 11);
+
+    r = (ay > ax ? HALFPI - r : r);
+    r = (signbit(x) ? PI - r : r);      /* as atan2(+-0, -0) = +-pi */
+    return copysign(r, y);
+}
+
+static inline void pvs_sincos_fast(double x, double *sn, double *cs)
+{
+    double  q = (x * (1.0 / HALFPI) + PVS_RNDMAGIC) - PVS_RNDMAGIC;
+    double  r = (x - q * PVS_PIO2_HI) - q * PVS_PIO2_LO;
+    double  z = r * r;
+    double  s = r + r * z * pvs_poly(z, pvs_sin_c, 6);
+    double  c = 1.0 - 0.5 * z + z * z * pvs_poly(z, pvs_cos_c, 6);
+    int32_t iq = (int32_t) q;
+
+    if (iq & 1) {
+      double t = s; s = c; c = t;
+    }
+    *sn = (iq & 2 ? -s : s);
+    *cs = ((iq + 1) & 2 ? -c : c);
+}
+
+/* x wrapped to [-pi, pi] */
+static inline double pvs_wrap_fast(double x)
+{
+    double  q = (x * (1.0 / TWOPI) + PVS_RNDMAGIC) - PVS_RNDMAGIC;
+    return x - q * TWOPI;
+}
+
+#if defined(__SSE2__)
+
+#if defined(USE_DOUBLE)
+
+#define PVSV_BINOP(name, op)                                            \
+static inline OSCV name(OSCV a, OSCV b)                                 \
+{                                                                       \
+    OSCV r; r.lo = op(a.lo, b.lo); r.hi = op(a.hi, b.hi); return r;     \
+}
+PVSV_BINOP(pvsv_max, _mm_max_pd)
+PVSV_BINOP(pvsv_min, _mm_min_pd)
+PVSV_BINOP(pvsv_and, _mm_and_pd)
+PVSV_BINOP(pvsv_andnot, _mm_andnot_pd)
+PVSV_BINOP(pvsv_or, _mm_or_pd)
+PVSV_BINOP(pvsv_xor, _mm_xor_pd)
+PVSV_BINOP(pvsv_cmplt, _mm_cmplt_pd)
+PVSV_BINOP(pvsv_cmpgt, _mm_cmpgt_pd)
+#undef PVSV_BINOP
+
+static inline OSCV pvsv_sqrt(OSCV a)
+{
+    OSCV r; r.lo = _mm_sqrt_pd(a.lo); r.hi = _mm_sqrt_pd(a.hi); return r;
+}
+
+/* lanes of 32-bit all-ones or zero masks, as MYFLT lane masks */
+static inline OSCV pvsv_imask(__m128i m)
+{
+    OSCV r;
+    r.lo = _mm_castsi128_pd(_mm_unpacklo_epi32(m, m));
+    r.hi = _mm_castsi128_pd(_mm_unpackhi_epi32(m, m));
+    return r;
+}
+
+/* four (x, y) pairs from p[0..7] */
+static inline void pvsv_load2(const MYFLT *p, OSCV *x, OSCV *y)
+{
+    __m128d a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2);
+    __m128d c = _mm_loadu_pd(p + 4), d = _mm_loadu_pd(p + 6);
+    x->lo = _mm_unpacklo_pd(a, b); y->lo = _mm_unpackhi_pd(a, b);
+    x->hi = _mm_unpacklo_pd(c, d); y->hi = _mm_unpackhi_pd(c, d);
+}
+
+static inline void pvsv_store2(MYFLT *p, OSCV x, OSCV y)
+{
+    _mm_storeu_pd(p, _mm_unpacklo_pd(x.lo, y.lo));
+    _mm_storeu_pd(p + 2, _mm_unpackhi_pd(x.lo, y.lo));
+    _mm_storeu_pd(p + 4, _mm_unpacklo_pd(x.hi, y.hi));
+    _mm_storeu_pd(p + 6, _mm_unpackhi_pd(x.hi, y.hi));
+}
+
+#define PVSV_RNDMAGIC   PVS_RNDMAGIC
+
+#else   /* !USE_DOUBLE */
+
+#define PVSV_BINOP(name, op)                                            \
+static inline OSCV name(OSCV a, OSCV b)                                 \
+{                                                                       \
+    OSCV r; r.v = op(a.v, b.v); return r;                               \
+}
+PVSV_BINOP(pvsv_max, _mm_max_ps)
+PVSV_BINOP(pvsv_min, _mm_min_ps)
+PVSV_BINOP(pvsv_and, _mm_and_ps)
+PVSV_BINOP(pvsv_andnot, _mm_andnot_ps)
+PVSV_BINOP(pvsv_or, _mm_or_ps)
+PVSV_BINOP(pvsv_xor, _mm_xor_ps)
+PVSV_BINOP(pvsv_cmplt, _mm_cmplt_ps)
+PVSV_BINOP(pvsv_cmpgt, _mm_cmpgt_ps)
+#undef PVSV_BINOP
+
+static inline OSCV pvsv_sqrt(OSCV a)
+{
+    OSCV r; r.v = _mm_sqrt_ps(a.v); return r;
+}
+
+static inline OSCV pvsv_imask(__m128i m)
+{
+    OSCV r; r.v = _mm_castsi128_ps(m); return r;
+}
+
+static inline void pvsv_load2(const MYFLT *p, OSCV *x, OSCV *y)
+{
+    __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4);
+    x->v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    y->v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static inline void pvsv_store2(MYFLT *p, OSCV x, OSCV y)
+{
+    _mm_storeu_ps(p, _mm_unpacklo_ps(x.v, y.v));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(x.v, y.v));
+}
+
+#define PVSV_RNDMAGIC   12582912.0
+
+#endif  /* USE_DOUBLE */
+
+static inline OSCV pvsv_select(OSCV m, OSCV a, OSCV b)
+{
+    return pvsv_or(pvsv_and(m, a), pvsv_andnot(m, b));
+}
+
+/* the polynomials, in Horner form from the highest coefficient */
+static inline OSCV pvsv_poly(OSCV x, const double *c, int32_t n)
+{
+    OSCV    r = oscv_set1((MYFLT) c[0]);
+    int32_t i;
+    for (i = 1; i < n; i++)
+      r = oscv_add(oscv_mul(r, x), oscv_set1((MYFLT) c[i]));
+    return r;
+}
+
+static inline OSCV pvsv_atan2(OSCV y, OSCV x)
+{
+    OSCV    sign = oscv_set1(-FL(0.0)), zero = oscv_set1(FL(0.0));
+    OSCV    ax = pvsv_andnot(sign, x), ay = pvsv_andnot(sign, y);
+    OSCV    mx = pvsv_max(ax, ay), mn = pvsv_min(ax, ay);
+    OSCV    a, r, xneg;
+
+    /* a = mn/mx, or 0 where both are 0 */
+    a = pvsv_and(pvsv_cmpgt(mx, zero), oscv_div(mn, pvsv_max(mx,
+                                          oscv_set1(FL(1.0e-30)))));
+    r = oscv_mul(a, pvsv_poly(oscv_mul(a, a), pvs_atan_c, 11));
+    r = pvsv_select(pvsv_cmpgt(ay, ax),
+                    oscv_sub(oscv_set1((MYFLT) HALFPI), r), r);
+    /* x with its sign bit set, -0 included, as atan2() takes it */
+    xneg = pvsv_cmplt(pvsv_or(pvsv_and(sign, x), oscv_set1(FL(1.0))), zero);
+    r = pvsv_select(xneg, oscv_sub(oscv_set1((MYFLT) PI), r), r);
+    return pvsv_or(r, pvsv_and(sign, y));
+}
+
+static inline void pvsv_sincos(OSCV x, OSCV *sn, OSCV *cs)
+{
+    OSCV    magic = oscv_set1((MYFLT) PVSV_RNDMAGIC);
+    OSCV    q = oscv_sub(oscv_add(oscv_mul(x, oscv_set1((MYFLT)
+                                                        (1.0 / HALFPI))),
+                                  magic), magic);
+    __m128i iq = oscv_cvttrunc(q);
+    OSCV    r, z, s, c, swap, sign;
+
+#if defined(USE_DOUBLE)
+    r = oscv_sub(oscv_sub(x, oscv_mul(q, oscv_set1(PVS_PIO2_HI))),
+                 oscv_mul(q, oscv_set1(PVS_PIO2_LO)));
+#else
+    r = oscv_sub(x, oscv_mul(q, oscv_set1(1.5703125f)));
+    r = oscv_sub(r, oscv_mul(q, oscv_set1(4.837512969970703125e-4f)));
+    r = oscv_sub(r, oscv_mul(q, oscv_set1(7.54978995489188216e-8f)));
+#endif
+    z = oscv_mul(r, r);
+    s = oscv_add(r, oscv_mul(oscv_mul(r, z), pvsv_poly(z, pvs_sin_c, 6)));
+    c = oscv_add(oscv_sub(oscv_set1(FL(1.0)), oscv_mul(oscv_set1(FL(0.5)), z)),
+                 oscv_mul(oscv_mul(z, z), pvsv_poly(z, pvs_cos_c, 6)));
+    swap = pvsv_imask(_mm_cmpeq_epi32(_mm_and_si128(iq, _mm_set1_epi32(1)),
+                                      _mm_set1_epi32(1)));
+    *sn = pvsv_select(swap, c, s);
+    *cs = pvsv_select(swap, s, c);
+    sign = oscv_set1(-FL(0.0));
+    *sn = pvsv_xor(*sn, pvsv_and(sign, pvsv_imask(
+              _mm_cmpeq_epi32(_mm_and_si128(iq, _mm_set1_epi32(2)),
+                              _mm_set1_epi32(2)))));
+    *cs = pvsv_xor(*cs, pvsv_and(sign, pvsv_imask(
+              _mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(iq,
+                                                          _mm_set1_epi32(1)),
+                                            _mm_set1_epi32(2)),
+                              _mm_set1_epi32(2)))));
+}
+
+#endif  /* __SSE2__ */
+
+/* in place, the (re, im) pairs of n bins become (magnitude, phase) */
+static inline void pvs_polar(MYFLT *p, int32_t n, int32_t fast)
+{
+    int32_t i = 0;
+
+    if (fast) {
+#if defined(__SSE2__)
+      for ( ; i + 4 <= n; i += 4) {
+        OSCV    re, im;
+        pvsv_load2(p + 2*i, &re, &im);
+        pvsv_store2(p + 2*i,
+                    pvsv_sqrt(oscv_add(oscv_mul(re, re), oscv_mul(im, im))),
+                    pvsv_atan2(im, re));
+      }
+#endif
+      for ( ; i < n; i++) {
+        double  re = (double) p[2*i], im = (double) p[2*i + 1];
+        p[2*i] = (MYFLT) sqrt(re * re + im * im);
+        p[2*i + 1] = (MYFLT) pvs_atan2_fast(im, re);
+      }
+      return;
+    }
+    for ( ; i < n; i++) {
+      MYFLT   re = p[2*i], im = p[2*i + 1];
+      p[2*i] = HYPOT(re, im);
+      p[2*i + 1] = (MYFLT) atan2((double) im, (double) re);
+    }
+}
+
+/* in place, the (magnitude, phase) pairs of n bins become (re, im) */
+static inline void pvs_rect(MYFLT *p, int32_t n, int32_t fast)
+{
+    int32_t i = 0;
+
+    if (fast) {
+#if defined(__SSE2__)
+      for ( ; i + 4 <= n; i += 4) {
+        OSCV    mag, ph, s, c;
+        pvsv_load2(p + 2*i, &mag, &ph);
+        pvsv_sincos(ph, &s, &c);
+        pvsv_store2(p + 2*i, oscv_mul(mag, c), oscv_mul(mag, s));
+      }
+#endif
+      for ( ; i < n; i++) {
+        double  s, c, mag = (double) p[2*i];
+        pvs_sincos_fast((double) p[2*i + 1], &s, &c);
+        p[2*i] = (MYFLT) (mag * c);
+        p[2*i + 1] = (MYFLT) (mag * s);
+      }
+      return;
+    }
+    for ( ; i < n; i++) {
+      MYFLT   mag = p[2*i], phase = p[2*i + 1];
+      p[2*i] = (MYFLT) ((double) mag * cos((double) phase));
+      p[2*i + 1] = (MYFLT) ((double) mag * sin((double) phase));
+    }
+}
+
+#endif  /* PVSMATH_H */
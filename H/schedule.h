@@ -22,12 +22,15 @@
     02110-1301 USA
 */
 
+#include "namedins.h"
+
 typedef struct {
         OPDS   h;
         MYFLT  *which, *when, *dur;
         MYFLT  *argums[VARGMAX-3];
         int    midi;
         INSDS  *kicked;
+        INSNAME_CACHE namecache;
 } SCHED;
 
 typedef struct {
@@ -39,6 +42,7 @@ typedef struct {
         MYFLT  abs_when;
         int    midi;
         INSDS  *kicked;
+        INSNAME_CACHE namecache;
 } WSCHED;
 
 typedef struct {
@@ -62,6 +66,7 @@ typedef struct {
         MYFLT  *args[PMAX+1];
         MYFLT  prvmintim;
         int32   timrem, prvktim, kadjust;
+        INSNAME_CACHE namecache;
 } TRIGINSTR;
 
 /*****************************************************************/
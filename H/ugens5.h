@@ -22,6 +22,7 @@
 */
 
 #include "lpc.h"        /*                               UGENS5.H        */
+#include "fcoef.h"
 
 typedef struct {
         OPDS    h;
@@ -42,6 +43,7 @@ typedef struct {
         int     scale;
         double  c1, c2, c3, yt1, yt2, cosf, prvcf, prvbw;
         int     asigf, asigw;
+        FCOEF_TABLES *fct;      /* --smooth-filters */
 } RESON;
 
 typedef struct {
@@ -30,6 +30,9 @@
 #ifdef HAVE_SYS_TYPES_H
 # include <sys/types.h>
 #endif
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
 
 #ifdef PIPES
 # if defined(SGI) || defined(LINUX) || defined(__BEOS__) || defined(NeXT) ||  \
@@ -184,76 +187,373 @@ static void spoutsf_noscale(CSOUND *csound)
     csound->libsndStatics.nframes = nframes;
 }
 
-/* diskfile write option for audtran's */
-/*      assigned during sfopenout()    */
+/* Vectorised versions of spoutsf and spoutsf_noscale (used unless
+   --scalar-spout is given), with identical results.  The peak and range
+   scan covers the whole spout block at once, with channels in the SIMD
+   lanes; mono and odd channel counts are folded so that each vector holds
+   whole frames.  Only a new per-channel maximum needs a scalar search, to
+   find its position.  The limiter is not vectorised. */
 
-static void writesf(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+#define SPOUT_VCH   (MAXCHNLS * 4)
+
+static void spout_scan_frames(const MYFLT *sp, int vch, int vfr, MYFLT lim,
+                              MYFLT *pk, int64_t *cnt)
 {
-    OPARMS  *O = csound->oparms;
-    int     n;
+    int     c = 0, f;
+
+#if defined(__SSE2__) && defined(USE_DOUBLE)
+    const __m128d absmask = _mm_castsi128_pd(_mm_set1_epi64x(INT64_MAX));
+    const __m128d vlim = _mm_set1_pd(lim);
+    for (; c < (vch & ~1); c += 2) {
+      __m128d vpk = _mm_setzero_pd();
+      __m128i vcnt = _mm_setzero_si128();
+      const MYFLT *p = sp + c;
+      for (f = 0; f < vfr; f++, p += vch) {
+        __m128d a = _mm_and_pd(_mm_loadu_pd(p), absmask);
+        vpk = _mm_max_pd(a, vpk);
+        vcnt = _mm_sub_epi64(vcnt, _mm_castpd_si128(_mm_cmpgt_pd(a, vlim)));
+      }
+      _mm_storeu_pd(&pk[c], vpk);
+      _mm_storeu_si128((__m128i*) &cnt[c], vcnt);
+    }
+#elif defined(__SSE2__)
+    const __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(INT32_MAX));
+    const __m128 vlim = _mm_set1_ps(lim);
+    for (; c < (vch & ~3); c += 4) {
+      __m128 vpk = _mm_setzero_ps();
+      __m128i vcnt = _mm_setzero_si128();
+      int32_t  tmp[4];
+      const MYFLT *p = sp + c;
+      for (f = 0; f < vfr; f++, p += vch) {
+        __m128 a = _mm_and_ps(_mm_loadu_ps(p), absmask);
+        vpk = _mm_max_ps(a, vpk);
+        vcnt = _mm_sub_epi32(vcnt, _mm_castps_si128(_mm_cmpgt_ps(a, vlim)));
+      }
+      _mm_storeu_ps(&pk[c], vpk);
+      _mm_storeu_si128((__m128i*) tmp, vcnt);
+      cnt[c] = tmp[0]; cnt[c + 1] = tmp[1];
+      cnt[c + 2] = tmp[2]; cnt[c + 3] = tmp[3];
+    }
+#endif
+    /* remaining lanes, or everything without SSE2 */
+    for (; c < vch; c++) {
+      MYFLT   m = FL(0.0);
+      int64_t n = 0;
+      for (f = 0; f < vfr; f++) {
+        MYFLT a = FABS(sp[f * vch + c]);
+        m = (a > m ? a : m);
+        n += (a > lim);
+      }
+      pk[c] = m;
+      cnt[c] = n;
+    }
+}
 
-    if (UNLIKELY(STA(outfile) == NULL))
+/* update maxamp, maxpos, and (if 'lim' is not NULL) the out of range
+   counts from 'nfr' frames of 'nch' channels starting at frame 'nframes' */
+
+static void spout_peaks(CSOUND *csound, const MYFLT *sp, int nch, int nfr,
+                        uint32 nframes, const MYFLT *lim)
+{
+    MYFLT   vpk[SPOUT_VCH];
+    int64_t vcnt[SPOUT_VCH];
+    MYFLT   range = (lim != NULL ? *lim : FL(0.0));
+    int     r = 1, vch, vfr, c, k, f;
+
+    /* fold frames so that a vector of lanes always holds whole frames */
+    while ((nch * r) & 3)
+      r <<= 1;
+    vch = nch * r;
+    vfr = nfr / r;
+    spout_scan_frames(sp, vch, vfr, range, vpk, vcnt);
+    for (c = 0; c < nch; c++) {
+      MYFLT   m = vpk[c];
+      int64_t n = vcnt[c];
+      for (k = 1; k < r; k++) {
+        MYFLT a = vpk[c + k * nch];
+        m = (a > m ? a : m);
+        n += vcnt[c + k * nch];
+      }
+      for (f = vfr * r; f < nfr; f++) {     /* frames left over by folding */
+        MYFLT a = FABS(sp[f * nch + c]);
+        m = (a > m ? a : m);
+        n += (a > range);
+      }
+      if (UNLIKELY(m > csound->maxamp[c])) {    /* new maxamp this seg */
+        for (f = 0; FABS(sp[f * nch + c]) != m; f++)
+          ;
+        csound->maxamp[c] = m;
+        csound->maxpos[c] = nframes + (uint32) f;
+      }
+      if (lim != NULL && UNLIKELY(n)) {         /* out of range?     */
+        csound->rngcnt[c] += (int32) n;         /*  report it        */
+        csound->rngflg = 1;
+      }
+    }
+}
+
+/* copy nspout samples, scaled, to the output buffer, flushing it with
+   audtran whenever it fills up */
+
+static inline void spout_copy(CSOUND *csound, MYFLT scale)
+{
+    int     i, n, spoutrem = csound->nspout;
+    MYFLT   *sp = csound->spout;
+
+    do {
+      n = spoutrem;
+      if (n > (int) csound->libsndStatics.outbufrem)
+        n = (int) csound->libsndStatics.outbufrem;
+      spoutrem -= n;
+      csound->libsndStatics.outbufrem -= n;
+      if (csound->libsndStatics.osfopen) {
+        MYFLT *op = csound->libsndStatics.outbufp;
+        if (scale == FL(1.0))
+          memcpy(op, sp, n * sizeof(MYFLT));
+        else
+          for (i = 0; i < n; i++)
+            op[i] = sp[i] * scale;
+        csound->libsndStatics.outbufp += n;
+      }
+      sp += n;
+      if (!csound->libsndStatics.outbufrem) {
+        if (csound->libsndStatics.osfopen) {
+          csound->nrecs++;
+          csound->audtran(csound, csound->libsndStatics.outbuf,
+                          csound->libsndStatics.outbufsiz); /* Flush buffer */
+          csound->libsndStatics.outbufp =
+            (MYFLT*) csound->libsndStatics.outbuf;
+        }
+        csound->libsndStatics.outbufrem = csound->oparms_.outbufsamps;
+      }
+    } while (spoutrem);
+}
+
+static void spoutsf_vec(CSOUND *csound)
+{
+    int     nch = (csound->multichan ? (int) csound->nchnls : 1);
+    int     nfr = csound->nspout / nch;
+
+    if (csound->oparms->limiter) {
+      spoutsf(csound);
       return;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader((void *)STA(outfile));
-    switch (O->heartbeat) {
-      case 1:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME,
-                                 "%c\010", "|/-\\"[csound->nrecs & 3]);
-        break;
-      case 2:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, ".");
-        break;
-      case 3:
-        {
-          char    s[512];
-          CS_SPRINTF(s, "%ld(%.3f)%n", (long) csound->nrecs,
-                  csound->icurTime/csound->esr, &n);
-          if (n > 0) {
-            memset(&(s[n]), '\b', n);
-            s[n + n] = '\0';
-            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s",  s);
-          }
+    }
+    spout_peaks(csound, csound->spout, nch, nfr,
+                csound->libsndStatics.nframes, &(csound->e0dbfs));
+    spout_copy(csound, csound->dbfs_to_float);
+    csound->libsndStatics.nframes += (uint32) nfr;
+}
+
+static void spoutsf_noscale_vec(CSOUND *csound)
+{
+    int     nch = (int) csound->nchnls;
+    int     nfr = csound->nspout / nch;
+
+    spout_peaks(csound, csound->spout, nch, nfr,
+                csound->libsndStatics.nframes, NULL);
+    spout_copy(csound, FL(1.0));
+    csound->libsndStatics.nframes += (uint32) nfr;
+}
+
+/* Optional sound file writer thread (--sf-writer=N).  spoutsf fills the
+   slots of a ring of N buffers in place, and audtran queues each full slot
+   instead of writing it, so that a stalling disk only blocks the
+   performance once all N slots are waiting.  The ring is single producer
+   (performance thread), single consumer (writer thread); the two only
+   share the slot counters, and use thread locks to sleep when the ring
+   is empty or full. */
+
+typedef struct {
+    MYFLT     *buf;                     /* depth slots of outbufsamps each  */
+    int       *nbytes;                  /* bytes queued in each slot        */
+    double    *qtime;                   /* time each slot was queued        */
+    uint32_t  depth;
+    uint32_t  wp, rp;                   /* slots queued, slots written      */
+    int       running;
+    int       werr, wret, wput;         /* write error, reported by perf    */
+    void      *thread, *dataReady, *spaceReady;
+    RTCLOCK   clock;
+    /* statistics */
+    uint32_t  maxqueued, stalls, nwritten;
+    double    latsum, latmax;
+} SF_WRITER;
+
+static inline MYFLT *sfwriter_slot(CSOUND *csound, SF_WRITER *w, uint32_t n)
+{
+    return w->buf + (size_t) (n % w->depth) * csound->oparms->outbufsamps;
+}
+
+static uintptr_t sfwriter_thread(void *data)
+{
+    CSOUND    *csound = (CSOUND*) data;
+    OPARMS    *O = csound->oparms;
+    SF_WRITER *w = (SF_WRITER*) STA(writer);
+    uint32_t  rp = w->rp;
+
+    for (;;) {
+      MYFLT   *buf;
+      int     n, nbytes;
+      double  t;
+
+      if (rp == ATOMIC_GET(w->wp)) {
+        if (!ATOMIC_GET(w->running))
+          break;
+        csound->WaitThreadLock(w->dataReady, (size_t) 100);
+        continue;
+      }
+      buf = sfwriter_slot(csound, w, rp);
+      nbytes = w->nbytes[rp % w->depth];
+      if (LIKELY(!w->werr)) {
+        n = (int) sf_write_MYFLT(STA(outfile), buf, nbytes / sizeof(MYFLT))
+            * (int) sizeof(MYFLT);
+        if (UNLIKELY(n < nbytes)) {
+          w->wret = n;
+          w->wput = nbytes;
+          ATOMIC_SET(w->werr, 1);
         }
-        break;
-      case 4:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s", "\a");
-        break;
+        if (UNLIKELY(O->rewrt_hdr))
+          rewriteheader((void *)STA(outfile));
+        if (O->sfsync == 2)
+          sf_write_sync(STA(outfile));
+      }
+      t = csound->GetRealTime(&(w->clock)) - w->qtime[rp % w->depth];
+      w->latsum += t;
+      if (t > w->latmax)
+        w->latmax = t;
+      w->nwritten++;
+      rp++;
+      ATOMIC_SET(w->rp, rp);
+      csound->NotifyThreadLock(w->spaceReady);
     }
+    return (uintptr_t) 0;
 }
 
-static void writesf_dither_16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+static void sfwriter_start(CSOUND *csound)
+{
+    OPARMS    *O = csound->oparms;
+    SF_WRITER *w;
+    uint32_t  depth = (uint32_t) O->sfwriter;
+
+    w = (SF_WRITER*) csound->Calloc(csound, sizeof(SF_WRITER));
+    w->depth = depth;
+    w->buf = (MYFLT*) csound->Calloc(csound, (size_t) depth * STA(outbufsiz));
+    w->nbytes = (int*) csound->Calloc(csound, depth * sizeof(int));
+    w->qtime = (double*) csound->Calloc(csound, depth * sizeof(double));
+    csound->InitTimerStruct(&(w->clock));
+    w->dataReady = csound->CreateThreadLock();
+    w->spaceReady = csound->CreateThreadLock();
+    w->running = 1;
+    STA(writer) = (void*) w;
+    w->thread = csound->CreateThread(sfwriter_thread, (void*) csound);
+    if (UNLIKELY(w->thread == NULL || w->dataReady == NULL ||
+                 w->spaceReady == NULL)) {
+      csound->Warning(csound, Str("could not start sound file writer thread,"
+                                  " writing synchronously"));
+      if (w->thread != NULL) {
+        ATOMIC_SET(w->running, 0);
+        csound->JoinThread(w->thread);
+      }
+      if (w->dataReady != NULL)
+        csound->DestroyThreadLock(w->dataReady);
+      if (w->spaceReady != NULL)
+        csound->DestroyThreadLock(w->spaceReady);
+      csound->Free(csound, w->buf);
+      csound->Free(csound, w->nbytes);
+      csound->Free(csound, w->qtime);
+      csound->Free(csound, w);
+      STA(writer) = NULL;
+      return;
+    }
+    csound->Free(csound, STA(outbuf));
+    STA(outbufp) = STA(outbuf) = w->buf;
+}
+
+/* queue the slot that spoutsf has just filled, and move spoutsf on to
+   the next one, waiting for the writer thread if the ring is full */
+
+static void sfwriter_queue(CSOUND *csound, SF_WRITER *w, int nbytes)
+{
+    uint32_t  wp = w->wp, queued;
+
+    w->nbytes[wp % w->depth] = nbytes;
+    w->qtime[wp % w->depth] = csound->GetRealTime(&(w->clock));
+    wp++;
+    ATOMIC_SET(w->wp, wp);
+    csound->NotifyThreadLock(w->dataReady);
+    queued = wp - ATOMIC_GET(w->rp);
+    if (queued > w->maxqueued)
+      w->maxqueued = queued;
+    if (queued >= w->depth) {
+      w->stalls++;
+      do {
+        csound->WaitThreadLock(w->spaceReady, (size_t) 100);
+      } while (wp - ATOMIC_GET(w->rp) >= w->depth);
+    }
+    STA(outbuf) = sfwriter_slot(csound, w, wp);
+}
+
+/* wait for all queued buffers to be written, stop the thread and
+   report statistics; returns non-zero if a write failed, with the byte
+   counts in *wret and *wput */
+
+static int sfwriter_stop(CSOUND *csound, int *wret, int *wput)
+{
+    SF_WRITER *w = (SF_WRITER*) STA(writer);
+    int       err;
+
+    if (w == NULL)
+      return 0;
+    ATOMIC_SET(w->running, 0);
+    csound->NotifyThreadLock(w->dataReady);
+    csound->JoinThread(w->thread);
+    csound->DestroyThreadLock(w->dataReady);
+    csound->DestroyThreadLock(w->spaceReady);
+    if (csound->oparms->msglevel & CS_TIMEMSG)
+      csound->Message(csound,
+                      Str("sound file writer: %u buffers, max queued %u of %u,"
+                          " %u stalls, write latency avg %.3f ms,"
+                          " max %.3f ms\n"),
+                      w->nwritten, w->maxqueued, w->depth, w->stalls,
+                      (w->nwritten ? 1000.0 * w->latsum / w->nwritten : 0.0),
+                      1000.0 * w->latmax);
+    err = w->werr;
+    *wret = w->wret;
+    *wput = w->wput;
+    csound->Free(csound, w->buf);
+    csound->Free(csound, w->nbytes);
+    csound->Free(csound, w->qtime);
+    csound->Free(csound, w);
+    STA(writer) = NULL;
+    STA(outbufp) = STA(outbuf) = NULL;
+    return err;
+}
+
+/* write (or queue) one buffer of output, after any dithering */
+
+static void sfwrite_block(CSOUND *csound, const MYFLT *outbuf, int nbytes)
 {
     OPARMS  *O = csound->oparms;
     int     n;
-    int m = nbytes / sizeof(MYFLT);
-    MYFLT *buf = (MYFLT*) outbuf;
-    int    dith;
 
-    if (UNLIKELY(STA(outfile) == NULL))
-      return;
-    dith = STA(dither);
-    for (n=0; n<m; n++) {
-      int   tmp = ((dith * 15625) + 1) & 0xFFFF;
-      int   rnd = ((tmp * 15625) + 1) & 0xFFFF;
-      MYFLT result;
-      dith = rnd;
-      rnd = (rnd+tmp)>>1;           /* triangular distribution */
-      result = (MYFLT) (rnd - 0x8000)  / ((MYFLT) 0x10000);
-      result /= ((MYFLT) 0x7fff);
-      buf[n] += result;
+    if (STA(writer) != NULL) {
+      SF_WRITER *w = (SF_WRITER*) STA(writer);
+      if (UNLIKELY(ATOMIC_GET(w->werr))) {
+        int wret, wput;
+        sfwriter_stop(csound, &wret, &wput);
+        sndwrterr(csound, wret, wput);
+      }
+      sfwriter_queue(csound, w, nbytes);
+    }
+    else {
+      n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
+                               nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
+      if (UNLIKELY(n < nbytes))
+        sndwrterr(csound, n, nbytes);
+      if (UNLIKELY(O->rewrt_hdr))
+        rewriteheader((void *)STA(outfile));
+      if (O->sfsync == 2)
+        sf_write_sync(STA(outfile));
     }
-    STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -270,125 +570,118 @@ static void writesf_dither_16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
           if (n > 0) {
             memset(&(s[n]), '\b', n);
             s[n + n] = '\0';
-            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s", s);
+            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s",  s);
           }
         }
         break;
       case 4:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, "\a");
+        csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s", "\a");
         break;
     }
 }
 
-static void writesf_dither_8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
-{
-    OPARMS  *O = csound->oparms;
-    int     n;
-    int m = nbytes / sizeof(MYFLT);
-    MYFLT *buf = (MYFLT*) outbuf;
-    int dith;
+/* add the dither of writesf_dither_* (triangular if 'tri' is non-zero,
+   otherwise rectangular) scaled by 1/'scale' to 'm' samples of buf, and
+   return the new generator state.  Unless 'serial' is set, the 16 bit
+   generator is run as four interleaved lanes, each advanced four samples
+   at a time, so that the loop carries no serial dependency. */
 
-    if (UNLIKELY(STA(outfile) == NULL))
-      return;
-    dith = STA(dither);
-    for (n=0; n<m; n++) {
+static int dither_block(MYFLT *buf, int m, int dith, int tri, MYFLT scale,
+                        int serial)
+{
+    uint32_t  a, c, a4 = 1U, c4 = 0U, d[4];
+    int       n = 0, k;
+
+    if (!serial && m >= 8) {
+      /* one sample advances the generator once, or twice if triangular */
+      a = (tri ? (15625U * 15625U) & 0xFFFFU : 15625U);
+      c = (tri ? 15626U : 1U);
+      for (k = 0; k < 4; k++) {
+        c4 = (a * c4 + c) & 0xFFFFU;
+        a4 = (a * a4) & 0xFFFFU;
+      }
+      d[0] = (uint32_t) dith;
+      for (k = 1; k < 4; k++)
+        d[k] = (a * d[k - 1] + c) & 0xFFFFU;
+      for ( ; n <= m - 4; n += 4) {
+        for (k = 0; k < 4; k++) {
+          int   tmp = (int) ((d[k] * 15625U) + 1U) & 0xFFFF;
+          int   rnd;
+          MYFLT result;
+          if (tri) {
+            rnd = ((tmp * 15625) + 1) & 0xFFFF;
+            rnd = (rnd+tmp)>>1;         /* triangular distribution */
+          }
+          else
+            rnd = tmp;
+          result = (MYFLT) (rnd - 0x8000)  / ((MYFLT) 0x10000);
+          result /= scale;
+          buf[n + k] += result;
+          d[k] = (a4 * d[k] + c4) & 0xFFFFU;
+        }
+      }
+      dith = (int) d[0];
+    }
+    for ( ; n < m; n++) {
       int   tmp = ((dith * 15625) + 1) & 0xFFFF;
-      int   rnd = ((tmp * 15625) + 1) & 0xFFFF;
+      int   rnd;
       MYFLT result;
-      dith = rnd;
-      rnd = (rnd+tmp)>>1;           /* triangular distribution */
+      if (tri) {
+        rnd = ((tmp * 15625) + 1) & 0xFFFF;
+        dith = rnd;
+        rnd = (rnd+tmp)>>1;             /* triangular distribution */
+      }
+      else
+        dith = rnd = tmp;
       result = (MYFLT) (rnd - 0x8000)  / ((MYFLT) 0x10000);
-      result /= ((MYFLT) 0x7f);
+      result /= scale;
       buf[n] += result;
     }
-    STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
-    switch (O->heartbeat) {
-      case 1:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME,
-                                 "%c\010", "|/-\\"[csound->nrecs & 3]);
-        break;
-      case 2:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, ".");
-        break;
-      case 3:
-        {
-          char    s[512];
-          CS_SPRINTF(s, "%ld(%.3f)%n", (long) csound->nrecs,
-                  csound->icurTime/csound->esr, &n);
-          if (n > 0) {
-            memset(&(s[n]), '\b', n);
-            s[n + n] = '\0';
-            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s", s);
-          }
-        }
-        break;
-      case 4:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, "\a");
-        break;
-    }
+    return dith;
 }
 
-static void writesf_dither_u16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+/* diskfile write option for audtran's */
+/*      assigned during sfopenout()    */
+
+static void writesf(CSOUND *csound, const MYFLT *outbuf, int nbytes)
 {
-    OPARMS  *O = csound->oparms;
-    int     n;
-    int m = nbytes / sizeof(MYFLT);
-    MYFLT *buf = (MYFLT*) outbuf;
-    int dith;
+    if (UNLIKELY(STA(outfile) == NULL))
+      return;
+    sfwrite_block(csound, outbuf, nbytes);
+}
 
+static void writesf_dither_16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+{
     if (UNLIKELY(STA(outfile) == NULL))
       return;
-    dith = STA(dither);
-    for (n=0; n<m; n++) {
-      int   rnd = ((dith * 15625) + 1) & 0xFFFF;
-      MYFLT result;
-      dith =  rnd;
-      result = (MYFLT) (rnd - 0x8000)  / ((MYFLT) 0x10000);
-      result /= ((MYFLT) 0x7fff);
-      buf[n] += result;
-    }
-    STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
-    switch (O->heartbeat) {
-      case 1:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME,
-                                 "%c\010", "|/-\\"[csound->nrecs & 3]);
-        break;
-      case 2:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, ".");
-        break;
-      case 3:
-        {
-          char    s[512];
-          CS_SPRINTF(s, "%ld(%.3f)%n", (long) csound->nrecs,
-                  csound->icurTime/csound->esr, &n);
-          if (n > 0) {
-            memset(&(s[n]), '\b', n);
-            s[n + n] = '\0';
-            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s",  s);
-          }
-        }
-        break;
-      case 4:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s",  "\a");
-        break;
-    }
+    STA(dither) = dither_block((MYFLT*) outbuf, nbytes / sizeof(MYFLT),
+                               STA(dither), 1, (MYFLT) 0x7fff,
+                               csound->oparms->scalarspout);
+    sfwrite_block(csound, outbuf, nbytes);
+}
+
+static void writesf_dither_8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+{
+    if (UNLIKELY(STA(outfile) == NULL))
+      return;
+    STA(dither) = dither_block((MYFLT*) outbuf, nbytes / sizeof(MYFLT),
+                               STA(dither), 1, (MYFLT) 0x7f,
+                               csound->oparms->scalarspout);
+    sfwrite_block(csound, outbuf, nbytes);
+}
+
+static void writesf_dither_u16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+{
+    if (UNLIKELY(STA(outfile) == NULL))
+      return;
+    STA(dither) = dither_block((MYFLT*) outbuf, nbytes / sizeof(MYFLT),
+                               STA(dither), 0, (MYFLT) 0x7fff,
+                               csound->oparms->scalarspout);
+    sfwrite_block(csound, outbuf, nbytes);
 }
 
 static void writesf_dither_u8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
 {
-    OPARMS  *O = csound->oparms;
     int     n;
     int m = nbytes / sizeof(MYFLT);
     MYFLT *buf = (MYFLT*) outbuf;
@@ -406,36 +699,7 @@ static void writesf_dither_u8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
       buf[n] += result;
     }
     STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
-    switch (O->heartbeat) {
-      case 1:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME,
-                                 "%c\010", "|/-\\"[csound->nrecs & 3]);
-        break;
-      case 2:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, ".");
-        break;
-      case 3:
-        {
-          char    s[512];
-          CS_SPRINTF(s, "%ld(%.3f)%n", (long) csound->nrecs,
-                  csound->icurTime/csound->esr, &n);
-          if (n > 0) {
-            memset(&(s[n]), '\b', n);
-            s[n + n] = '\0';
-            csound->MessageS(csound, CSOUNDMSG_REALTIME, "%s", s);
-          }
-        }
-        break;
-      case 4:
-        csound->MessageS(csound, CSOUNDMSG_REALTIME, "\a");
-        break;
-    }
+    sfwrite_block(csound, outbuf, nbytes);
 }
 
 static int readsf(CSOUND *csound, MYFLT *inbuf, int inbufsize)
@@ -750,7 +1014,7 @@ void sfopenout(CSOUND *csound)                  /* init for sound out       */
         parm.nChannels    = csound->nchnls;
         parm.sampleFormat = O->outformat;
         parm.sampleRate   = (float) csound->esr;
-        csound->spoutran  = spoutsf;
+        csound->spoutran  = (O->scalarspout ? spoutsf : spoutsf_vec);
         /* open devaudio for output */
         if (UNLIKELY(csound->playopen_callback(csound, &parm) != 0))
           csoundDie(csound, Str("Failed to initialise real time audio output"));
@@ -866,9 +1130,11 @@ void sfopenout(CSOUND *csound)                  /* init for sound out       */
     if (!(O->outformat == AE_FLOAT || O->outformat == AE_DOUBLE) ||
         (O->filetyp == TYP_WAV || O->filetyp == TYP_AIFF ||
          O->filetyp == TYP_W64))
-      csound->spoutran = spoutsf;       /* accumulate output */
+      csound->spoutran = (O->scalarspout ?      /* accumulate output */
+                          spoutsf : spoutsf_vec);
     else
-      csound->spoutran = spoutsf_noscale;
+      csound->spoutran = (O->scalarspout ?
+                          spoutsf_noscale : spoutsf_noscale_vec);
     if (csound->dither_output && csound->oparms->outformat!=AE_FLOAT &&
         csound->oparms->outformat!=AE_DOUBLE) {
       if (csound->oparms->outformat==AE_SHORT)
@@ -912,6 +1178,8 @@ void sfopenout(CSOUND *csound)                  /* init for sound out       */
     /* calc outbuf size & alloc bufspace */
     STA(outbufsiz) = O->outbufsamps * sizeof(MYFLT);
     STA(outbufp)   = STA(outbuf) = csound->Malloc(csound, STA(outbufsiz));
+    if (O->sfwriter > 0 && STA(outfile) != NULL && STA(pipdevout) != 2)
+      sfwriter_start(csound);
     if (STA(pipdevout) == 2) {
       csound->Message(csound,
                       Str("writing %d sample blks of %lu-bit floats to %s\n"),
@@ -959,7 +1227,7 @@ void sfclosein(CSOUND *csound)
 void sfcloseout(CSOUND *csound)
 {
     OPARMS  *O = csound->oparms;
-    int     nb;
+    int     nb, wret, wput;
 
     alloc_globals(csound);
     if (!STA(osfopen))
@@ -969,6 +1237,10 @@ void sfcloseout(CSOUND *csound)
       csound->nrecs++;
       csound->audtran(csound, STA(outbuf), nb);
     }
+    if (UNLIKELY(sfwriter_stop(csound, &wret, &wput)))
+      csound->ErrorMsg(csound,
+                       Str("soundfile write returned bytecount of %d, not %d"),
+                       wret, wput);
     if (STA(pipdevout) == 2 && (!STA(isfopen) || STA(pipdevin) != 2)) {
       /* close only if not open for input too */
       csound->rtclose_callback(csound);
@@ -978,6 +1250,8 @@ void sfcloseout(CSOUND *csound)
     if (STA(outfile) != NULL) {
       if (!STA(pipdevout) && O->outformat != AE_VORBIS)
         sf_command(STA(outfile), SFC_UPDATE_HEADER_NOW, NULL, 0);
+      if (O->sfsync)
+        sf_write_sync(STA(outfile));
       sf_close(STA(outfile));
       STA(outfile) = NULL;
     }
@@ -1086,7 +1360,7 @@ void iotranset(CSOUND *csound)
     OPARMS  *O;
 
     csound->spinrecv = sndfilein;
-    csound->spoutran = spoutsf;
+    csound->spoutran = (csound->oparms->scalarspout ? spoutsf : spoutsf_vec);
     if (!csound->enableHostImplementedAudioIO)
       return;
     alloc_globals(csound);
@@ -24,23 +24,32 @@
 #include "csoundCore.h"
 #include "midifile.h"
 #include <errno.h>
+#if !defined(WIN32)
+#include <sys/mman.h>
+#endif
+
+/* The file is mapped (or read) into memory as a whole.  When it is
+   opened, the tracks are checked and indexed, and the tempo changes are
+   collected; channel events are decoded a few at a time from each track
+   as they are played, and the tracks are merged with a heap ordered on
+   the time of their next event. */
 
 static const char *midiFile_ID = "MThd";
 static const char *midiTrack_ID = "MTrk";
 /* default tempo in beats per minute */
 static const double default_tempo = 120.0;
+/* number of events decoded from a track at a time */
+#define MF_DECODE_EVENTS    32
 
 typedef struct tempoEvent_s {
-    unsigned long   kcnt;               /* time (in ticks while reading     */
-                                        /*   MIDI file, will be converted   */
-                                        /*   to kperiods once file is read) */
+    unsigned long   kcnt;               /* time in kperiods                 */
+    unsigned long   tick;               /* time in ticks                    */
     double          tempoVal;           /* tempo value in beats per minute  */
 } tempoEvent_t;
 
 typedef struct midiEvent_s {
-    unsigned long   kcnt;               /* time (in ticks while reading     */
-                                        /*   MIDI file, will be converted   */
-                                        /*   to kperiods once file is read) */
+    unsigned long   kcnt;               /* time in ticks (converted to      */
+                                        /*   kperiods as events are played) */
 #if 0
     unsigned char   *data;              /* pointer to sysex or meta event   */
                                         /*   data (currently not used)      */
@@ -50,6 +59,30 @@ typedef struct midiEvent_s {
     unsigned char   d2;                 /* data byte 2 (0x00-0x7F)          */
 } midiEvent_t;
 
+typedef struct midiData_s {
+    const unsigned char *p;             /* next byte to read                */
+    const unsigned char *end;           /* end of file data                 */
+} midiData_t;
+
+typedef struct midiTrack_s {
+    midiData_t      f;                  /* read position in track data      */
+    const unsigned char *data;          /* start of track data              */
+    int             len;                /* track length in bytes            */
+    int             tlen;               /* bytes not yet decoded            */
+    int             mute;               /* track is muted                   */
+    unsigned long   tickCnt;            /* time of last decoded event       */
+    int             saved_st;           /* status byte for running status   */
+    int             nEvents;            /* number of decoded events         */
+    int             maxEvents;          /* event array size                 */
+    int             eventIndex;         /* index of next event to play      */
+    midiEvent_t     *eventList;         /* decoded events                   */
+} midiTrack_t;
+
+typedef struct midiHeap_s {
+    unsigned long   tick;               /* time of next event in ticks      */
+    int             track;              /* track number                     */
+} midiHeap_t;
+
 typedef struct midiFile_s {
     /* static file data, not changed at performance */
     double          timeCode;           /* > 0: ticks per beat              */
@@ -57,32 +90,42 @@ typedef struct midiFile_s {
     unsigned long   totalKcnt;          /* total duration of file           */
                                         /*   (in ticks while reading file,  */
                                         /*   converted to kperiods)         */
-    int             nEvents;            /* number of events                 */
-    int             maxEvents;          /* event array size                 */
     int             nTempo;             /* number of tempo changes          */
     int             maxTempo;           /* tempo change array size          */
-    midiEvent_t     *eventList;         /* array of MIDI events             */
     tempoEvent_t    *tempoList;         /* array of tempo changes           */
+    int             nTracks;            /* number of tracks                 */
+    midiTrack_t     *tracks;            /* array of tracks                  */
+    unsigned char   *data;              /* file contents                    */
+    size_t          size;               /* file size in bytes               */
+    int             mapped;             /* data is mapped, not allocated    */
+    int             scanning;           /* checking tracks on opening       */
     /* performance time state variables */
     double          currentTempo;       /* current tempo in BPM             */
-    int             eventListIndex;     /* index of next MIDI event in list */
     int             tempoListIndex;     /* index of next tempo change       */
+    midiHeap_t      *heap;              /* tracks, by time of next event    */
+    int             nHeap;              /* number of tracks in heap         */
+    int             nextValid;          /* nextKcnt is set                  */
+    unsigned long   nextKcnt;           /* time of next event in kperiods   */
+    int             convIndex;          /* next tempo change to convert     */
+    unsigned long   curTicks;           /* time of last converted event     */
+    double          timeVal;            /*   and the same in kperiods       */
+    double          tickVal;            /* kperiods per tick                */
 } midiFile_t;
 
 #define MIDIFILE    (csound->midiGlobals->midiFileData)
 #define MF(x)       (((midiFile_t*) MIDIFILE)->x)
 
-static int getCh(CSOUND *csound, FILE *f, int *bytesLeft)
+static int getCh(CSOUND *csound, midiData_t *f, int *bytesLeft)
 {
     int c;
 
     if (f == NULL)
       return -1;
-    c = getc(f);
-    if (UNLIKELY(c == EOF)) {
+    if (UNLIKELY(f->p >= f->end)) {
       csound->Message(csound, Str(" *** unexpected end of MIDI file\n"));
       return -1;
     }
+    c = *(f->p++);
     if (bytesLeft != NULL) {
       if (UNLIKELY(--(*bytesLeft) < 0)) {
         csound->Message(csound, Str(" *** unexpected end of MIDI track\n"));
@@ -92,7 +135,7 @@ static int getCh(CSOUND *csound, FILE *f, int *bytesLeft)
     return (c & 0xFF);
 }
 
-static int getVLenData(CSOUND *csound, FILE *f, int *bytesLeft)
+static int getVLenData(CSOUND *csound, midiData_t *f, int *bytesLeft)
 {
     int c, n, cnt;
 
@@ -150,24 +193,27 @@ static int msgDataBytes(int c)
     return -1;
 }
 
-static int alloc_event(CSOUND *csound, unsigned long kcnt, unsigned char *data,
-                                       int st, int d1, int d2)
+/* store a decoded event in the track's list; nothing is stored while */
+/* the tracks are checked on opening the file                          */
+
+static int alloc_event(CSOUND *csound, midiTrack_t *t, unsigned long kcnt,
+                       unsigned char *data, int st, int d1, int d2)
 {
     midiEvent_t *tmp;
     IGN(data);
+    if (MF(scanning))
+      return 0;
     /* expand array if necessary */
-    if (MF(nEvents) >= MF(maxEvents)) {
-      MF(maxEvents) += (MF(maxEvents) >> 3);
-      MF(maxEvents) = (MF(maxEvents) + 64) & (~63);
-      tmp = (midiEvent_t*) csound->ReAlloc(csound, MF(eventList),
-                                    sizeof(midiEvent_t) * MF(maxEvents));
-      MF(eventList) = tmp;
-      tmp = &(MF(eventList)[MF(nEvents)]);
-      memset(tmp, 0, sizeof(midiEvent_t) * (MF(maxEvents) - MF(nEvents)));
+    if (t->nEvents >= t->maxEvents) {
+      t->maxEvents += (t->maxEvents >> 3);
+      t->maxEvents = (t->maxEvents + 16) & (~15);
+      tmp = (midiEvent_t*) csound->ReAlloc(csound, t->eventList,
+                                    sizeof(midiEvent_t) * t->maxEvents);
+      t->eventList = tmp;
     }
     /* store new event */
-    tmp = &(MF(eventList)[MF(nEvents)]);
-    MF(nEvents)++;
+    tmp = &(t->eventList[t->nEvents]);
+    t->nEvents++;
     tmp->kcnt = kcnt;
  /* tmp->data = data; */        /* not used yet */
     tmp->st = (unsigned char) st;
@@ -180,6 +226,8 @@ static int alloc_event(CSOUND *csound, unsigned long kcnt, unsigned char *data,
 static int alloc_tempo(CSOUND *csound, unsigned long kcnt, double tempoVal)
 {
     tempoEvent_t *tmp;
+    if (!MF(scanning))
+      return 0;                 /* already collected on opening */
     /* expand array if necessary */
     if (MF(nTempo) >= MF(maxTempo)) {
       MF(maxTempo) += (MF(maxTempo) >> 3);
@@ -193,16 +241,16 @@ static int alloc_tempo(CSOUND *csound, unsigned long kcnt, double tempoVal)
     /* store new event */
     tmp = &(MF(tempoList)[MF(nTempo)]);
     MF(nTempo)++;
-    tmp->kcnt = kcnt; tmp->tempoVal = tempoVal;
+    tmp->kcnt = tmp->tick = kcnt; tmp->tempoVal = tempoVal;
     /* done */
     return 0;
 }
 
-static int readEvent(CSOUND *csound, FILE *f, int *tlen,
-                     unsigned long tickCnt, int st, int *saved_st);
+static int readEvent(CSOUND *csound, midiTrack_t *t,
+                     unsigned long tickCnt, int st);
 
-static int checkRealTimeEvent(CSOUND *csound, FILE *f, int *tlen,
-                              unsigned long tickCnt, int st, int *saved_st)
+static int checkRealTimeEvent(CSOUND *csound, midiTrack_t *t,
+                              unsigned long tickCnt, int st)
 {
     if (st & 0x80) {
       if (UNLIKELY(st < 0xF8 || st > 0xFE)) {
@@ -211,17 +259,19 @@ static int checkRealTimeEvent(CSOUND *csound, FILE *f, int *tlen,
         return -1;
       }
       /* handle real time message (return code -2) */
-      if (readEvent(csound, f, tlen, tickCnt, st, saved_st) != 0)
+      if (readEvent(csound, t, tickCnt, st) != 0)
         return -1;
       return -2;
     }
     return st;
 }
 
-static int readEvent(CSOUND *csound, FILE *f, int *tlen,
-                     unsigned long tickCnt, int st, int *saved_st)
+static int readEvent(CSOUND *csound, midiTrack_t *t,
+                     unsigned long tickCnt, int st)
 {
-    int i, c, d, cnt, dataBytes[2];
+    midiData_t  *f = &(t->f);
+    int         *tlen = &(t->tlen), *saved_st = &(t->saved_st);
+    int         i, c, d, cnt, dataBytes[2];
 
     cnt = dataBytes[0] = dataBytes[1] = 0;
     if (st < 0x80) {
@@ -243,13 +293,13 @@ static int readEvent(CSOUND *csound, FILE *f, int *tlen,
         /* read data byte(s) */
         d = getCh(csound, f, tlen);
         if (d < 0 || *tlen < 0) return -1;
-        d = checkRealTimeEvent(csound, f, tlen, tickCnt, d, saved_st);
+        d = checkRealTimeEvent(csound, t, tickCnt, d);
         if (d == -2)    /* read real time event: continue with reading data */
           continue;
         if (d < 0) return -1;
         dataBytes[cnt++] = d;
       }
-      return alloc_event(csound, tickCnt, NULL, st,
+      return alloc_event(csound, t, tickCnt, NULL, st,
                          dataBytes[0], dataBytes[1]);
     }
     /* message is of unknown or special type */
@@ -268,7 +318,7 @@ static int readEvent(CSOUND *csound, FILE *f, int *tlen,
                                       "exclusive message\n"));
           return -1;
         }
-        d = checkRealTimeEvent(csound, f, tlen, tickCnt, d, saved_st);
+        d = checkRealTimeEvent(csound, t, tickCnt, d);
         if (d == -2)            /* if read real time event, */
           i++;                  /* continue with reading message bytes */
         else if (UNLIKELY(d < 0))
@@ -295,7 +345,7 @@ static int readEvent(CSOUND *csound, FILE *f, int *tlen,
       if (st < 0 || *tlen < 0) return -1;
       i = getVLenData(csound, f, tlen);         /* message length */
       if (i < 0 || *tlen < 0) return -1;
-      if (i > 0 &&
+      if (i > 0 && MF(scanning) &&
           ((st >= 1 && st <= 5 && (csound->oparms->msglevel & 7) == 7) ||
            (st == 3 && csound->oparms->msglevel != 0))) {
         /* print non-empty text meta events, depending on message level */
@@ -338,7 +388,7 @@ static int readEvent(CSOUND *csound, FILE *f, int *tlen,
             return -1;
           }
           /* update file length info */
-          if (tickCnt > MF(totalKcnt))
+          if (MF(scanning) && tickCnt > MF(totalKcnt))
             MF(totalKcnt) = tickCnt;
           return 0;
         default:                          /* skip any other meta event */
@@ -354,10 +404,12 @@ static int readEvent(CSOUND *csound, FILE *f, int *tlen,
     return -1;
 }
 
-static int readTrack(CSOUND *csound, FILE *f)
+/* check the track header at the read position of 'f', and index the */
+/* track data; 'f' is left at the end of the track                     */
+
+static int readTrack(CSOUND *csound, midiData_t *f, midiTrack_t *t)
 {
-    unsigned int    tickCnt;
-    int             i, c, tlen, st, saved_st;
+    int             i, c, tlen;
 
     /* check for track header */
     for (i = 0; i < 4; i++) {
@@ -377,57 +429,51 @@ static int readTrack(CSOUND *csound, FILE *f)
         return -1;
       tlen = (tlen << 8) | c;
     }
-    /* read track data */
-    tickCnt = 0UL;
-    saved_st = -1;
-    while (tlen > 0) {
+    t->data = f->p;
+    t->len = tlen;
+    /* check track data, collecting tempo changes */
+    t->f = *f;
+    t->tlen = tlen;
+    t->tickCnt = 0UL;
+    t->saved_st = -1;
+    while (t->tlen > 0) {
       /* get delta time */
-      c = getVLenData(csound, f, &tlen);
-      if (c < 0 || tlen < 0)
+      c = getVLenData(csound, &(t->f), &(t->tlen));
+      if (c < 0 || t->tlen < 0)
         return -1;
-      tickCnt += (unsigned long) c;
+      t->tickCnt += (unsigned long) c;
       /* get status byte */
-      st = getCh(csound, f, &tlen);
-      if (st < 0 || tlen < 0)
+      c = getCh(csound, &(t->f), &(t->tlen));
+      if (c < 0 || t->tlen < 0)
         return -1;
       /* process event */
-      if (readEvent(csound, f, &tlen, tickCnt, st, &saved_st) != 0)
+      if (readEvent(csound, t, t->tickCnt, c) != 0)
         return -1;
     }
+    *f = t->f;
     /* successfully read track */
     return 0;
 }
 
-/**
- * Sorts an array of midiEvent_t structures using merge sort algorithm
- * so that the order of events at the same time is preserved.
- * 'p' is the array to be sorted, and 'cnt' is the number of elements
- * (should be > 1). 'tmp' is temporary space of the same length as 'p'.
- */
+/* decode the next events of a track (up to MF_DECODE_EVENTS, fewer at */
+/* the end of the track); returns the number of events decoded          */
 
-static CS_NOINLINE void midiEvent_sort(midiEvent_t *p, midiEvent_t *tmp,
-                                       size_t cnt)
+static int decodeTrack(CSOUND *csound, midiTrack_t *t)
 {
-    size_t  p1, p2, dstp;
-    size_t  n = cnt >> 1;
+    int c;
 
-    if (n > (size_t) 1)
-      midiEvent_sort(p, tmp, n);
-    if (cnt > (size_t) 2)
-      midiEvent_sort(&(p[n]), tmp, cnt - n);
-    dstp = (size_t) 0;
-    p1 = (size_t) 0;
-    p2 = n;
-    do {
-      size_t  srcp;
-      if (p2 >= cnt || (p1 < n && p[p1].kcnt <= p[p2].kcnt))
-        srcp = p1++;
-      else
-        srcp = p2++;
-      tmp[dstp] = p[srcp];
-    } while (++dstp < cnt);
-    /* copy result back to original array */
-    memcpy(p, tmp, cnt * sizeof(midiEvent_t));
+    t->nEvents = t->eventIndex = 0;
+    while (t->nEvents < MF_DECODE_EVENTS && t->tlen > 0) {
+      c = getVLenData(csound, &(t->f), &(t->tlen));
+      if (UNLIKELY(c < 0 || t->tlen < 0))
+        break;
+      t->tickCnt += (unsigned long) c;
+      c = getCh(csound, &(t->f), &(t->tlen));
+      if (UNLIKELY(c < 0 || t->tlen < 0 ||
+                   readEvent(csound, t, t->tickCnt, c) != 0))
+        break;
+    }
+    return t->nEvents;
 }
 
 /**
@@ -462,57 +508,44 @@ static CS_NOINLINE void tempoEvent_sort(tempoEvent_t *p, tempoEvent_t *tmp,
     memcpy(p, tmp, cnt * sizeof(tempoEvent_t));
 }
 
-/* sort event lists by time and convert tick times to Csound k-periods */
+/* kperiods per tick at the start of the file */
+
+static double initialTickVal(CSOUND *csound)
+{
+    if (MF(timeCode) > 0.0)
+      return (double) csound->ekr / (default_tempo * MF(timeCode) / 60.0);
+    return (double) csound->ekr / -(MF(timeCode));
+}
+
+/* sort tempo changes by time and convert tick times to Csound k-periods */
 
-static void sortEventLists(CSOUND *csound)
+static void sortTempoList(CSOUND *csound)
 {
     double        timeVal, tempoVal;
-    unsigned long prvTicks, curTicks, tickEvent, tickTempo;
-    int           i, j;
-
-    /* sort events by time in ascending order */
-    if (MF(nEvents) > 1 || MF(nTempo) > 1) {
-      void    *tmp;
-      size_t  nbytes;
-      nbytes = (size_t) MF(nEvents) * sizeof(midiEvent_t);
-      if (((size_t) MF(nTempo) * sizeof(tempoEvent_t)) > nbytes)
-        nbytes = (size_t) MF(nTempo) * sizeof(tempoEvent_t);
-      tmp = csound->Malloc(csound, nbytes);
-      if (MF(nEvents) > 1)
-        midiEvent_sort(MF(eventList), (midiEvent_t *) tmp,
-                       (size_t) MF(nEvents));
-      if (MF(nTempo) > 1)
-        tempoEvent_sort(MF(tempoList), (tempoEvent_t *) tmp,
-                        (size_t) MF(nTempo));
+    unsigned long curTicks;
+    int           j;
+
+    /* sort tempo changes by time in ascending order */
+    if (MF(nTempo) > 1) {
+      tempoEvent_t  *tmp;
+      tmp = (tempoEvent_t*) csound->Malloc(csound, (size_t) MF(nTempo)
+                                                   * sizeof(tempoEvent_t));
+      tempoEvent_sort(MF(tempoList), tmp, (size_t) MF(nTempo));
       csound->Free(csound, tmp);
     }
+    /* k-periods per tick */
+    tempoVal = initialTickVal(csound);
     if (MF(timeCode) > 0.0) {
       /* tick values are in fractions of a beat */
       timeVal = 0.0;
-      tempoVal = default_tempo;
-      /* prvTicks = */ curTicks = 0UL;
-      /* k-periods per tick */
-      tempoVal = (double) csound->ekr / (tempoVal * MF(timeCode) / 60.0);
-      i = j = 0;
-      while (i < MF(nEvents) || j < MF(nTempo)) {
-        prvTicks = curTicks;
-        tickEvent = tickTempo = 0UL;
-        tickEvent--; tickTempo--;   /* will be max value for unsigned long */
-        if (i < MF(nEvents)) tickEvent = MF(eventList)[i].kcnt;
-        if (j < MF(nTempo)) tickTempo = MF(tempoList)[j].kcnt;
-        if (tickEvent < tickTempo) {
-          curTicks = tickEvent;
-          timeVal += ((double) ((long) (curTicks - prvTicks)) * tempoVal);
-          MF(eventList)[i++].kcnt = (unsigned long) (timeVal + 0.5);
-        }
-        else {
-          curTicks = tickTempo;
-          timeVal += ((double) ((long) (curTicks - prvTicks)) * tempoVal);
-          tempoVal = MF(tempoList)[j].tempoVal;     /* new tempo */
-          /* k-periods per tick */
-          tempoVal = (double) csound->ekr / (tempoVal * MF(timeCode) / 60.0);
-          MF(tempoList)[j++].kcnt = (unsigned long) (timeVal + 0.5);
-        }
+      curTicks = 0UL;
+      for (j = 0; j < MF(nTempo); j++) {
+        timeVal += ((double) ((long) (MF(tempoList)[j].tick - curTicks))
+                    * tempoVal);
+        curTicks = MF(tempoList)[j].tick;
+        MF(tempoList)[j].kcnt = (unsigned long) (timeVal + 0.5);
+        tempoVal = (double) csound->ekr /
+                   (MF(tempoList)[j].tempoVal * MF(timeCode) / 60.0);
       }
       /* calculate total file length in k-periods */
       timeVal += ((double) ((long) (MF(totalKcnt) - curTicks)) * tempoVal);
@@ -520,38 +553,146 @@ static void sortEventLists(CSOUND *csound)
     }
     else {
       /* simple case: time based tick values */
-      tempoVal = -(MF(timeCode));
-      /* k-periods per tick */
-      tempoVal = (double) csound->ekr / tempoVal;
-      i = -1;
-      while (++i < MF(nEvents)) {
-        curTicks = MF(eventList)[i].kcnt;
-        timeVal = (double) curTicks * tempoVal;
-        curTicks = (unsigned long) (timeVal + 0.5);
-        MF(eventList)[i].kcnt = curTicks;
-      }
-      i = -1;
-      while (++i < MF(nTempo)) {
-        curTicks = MF(tempoList)[i].kcnt;
-        timeVal = (double) curTicks * tempoVal;
-        curTicks = (unsigned long) (timeVal + 0.5);
-        MF(tempoList)[i].kcnt = curTicks;
-      }
+      for (j = 0; j < MF(nTempo); j++)
+        MF(tempoList)[j].kcnt =
+          (unsigned long) ((double) MF(tempoList)[j].tick * tempoVal + 0.5);
       /* calculate total file length in k-periods */
       MF(totalKcnt) = (unsigned long) ((double) MF(totalKcnt) * tempoVal + 0.5);
     }
 }
 
+/* convert the tick time of the next event (in the order in which events */
+/* are played) to Csound k-periods                                       */
+
+static unsigned long tickToKcnt(CSOUND *csound, midiFile_t *mf,
+                                unsigned long tick)
+{
+    if (mf->timeCode > 0.0) {
+      /* apply any tempo changes up to and including this time */
+      while (mf->convIndex < mf->nTempo &&
+             mf->tempoList[mf->convIndex].tick <= tick) {
+        tempoEvent_t  *tp = &(mf->tempoList[mf->convIndex++]);
+        mf->timeVal += ((double) ((long) (tp->tick - mf->curTicks))
+                        * mf->tickVal);
+        mf->curTicks = tp->tick;
+        mf->tickVal = (double) csound->ekr /
+                      (tp->tempoVal * mf->timeCode / 60.0);
+      }
+      mf->timeVal += ((double) ((long) (tick - mf->curTicks)) * mf->tickVal);
+      mf->curTicks = tick;
+      return (unsigned long) (mf->timeVal + 0.5);
+    }
+    return (unsigned long) ((double) tick * mf->tickVal + 0.5);
+}
+
+/* heap of tracks, ordered on the time of the next event, and for equal */
+/* times on track number, so that events are played in the same order  */
+/* as a stable sort of all tracks would give                            */
+
+static inline int trackBefore(const midiHeap_t *a, const midiHeap_t *b)
+{
+    return (a->tick < b->tick || (a->tick == b->tick && a->track < b->track));
+}
+
+static void heapDown(midiFile_t *mf, int i)
+{
+    midiHeap_t  *h = mf->heap, x = h[i];
+    int         n = mf->nHeap;
+
+    for (;;) {
+      int c = 2 * i + 1;
+      if (c >= n)
+        break;
+      if (c + 1 < n && trackBefore(&h[c + 1], &h[c]))
+        c++;
+      if (!trackBefore(&h[c], &x))
+        break;
+      h[i] = h[c];
+      i = c;
+    }
+    h[i] = x;
+}
+
+/* set all tracks to the start of the file */
+
+static void resetTracks(CSOUND *csound)
+{
+    midiFile_t  *mf = (midiFile_t*) MIDIFILE;
+    int         i;
+
+    mf->nHeap = 0;
+    for (i = 0; i < mf->nTracks; i++) {
+      midiTrack_t *t = &(mf->tracks[i]);
+      t->f.p = t->data;
+      t->tlen = t->len;
+      t->tickCnt = 0UL;
+      t->saved_st = -1;
+      if (!t->mute && decodeTrack(csound, t) > 0) {
+        mf->heap[mf->nHeap].tick = t->eventList[0].kcnt;
+        mf->heap[mf->nHeap++].track = i;
+      }
+    }
+    for (i = (mf->nHeap >> 1) - 1; i >= 0; i--)
+      heapDown(mf, i);
+    mf->nextValid = 0;
+    mf->convIndex = 0;
+    mf->curTicks = 0UL;
+    mf->timeVal = 0.0;
+    mf->tickVal = initialTickVal(csound);
+    mf->currentTempo = default_tempo;
+    mf->tempoListIndex = 0;
+}
+
+/* load the file into memory, mapping it if possible */
+
+static unsigned char *loadFile(CSOUND *csound, FILE *f, size_t *size,
+                               int *mapped)
+{
+    unsigned char *data;
+    size_t        n, len;
+    long          fsize = -1L;
+
+    *mapped = 0;
+    if (f != stdin && fseek(f, 0L, SEEK_END) == 0) {
+      fsize = ftell(f);
+      fseek(f, 0L, SEEK_SET);
+    }
+#if !defined(WIN32)
+    if (fsize > 0L) {
+      data = (unsigned char*) mmap(NULL, (size_t) fsize, PROT_READ,
+                                   MAP_PRIVATE, fileno(f), 0);
+      if (data != (unsigned char*) MAP_FAILED) {
+        *mapped = 1;
+        *size = (size_t) fsize;
+        return data;
+      }
+    }
+#endif
+    len = (fsize > 0L ? (size_t) fsize : (size_t) 65536);
+    data = (unsigned char*) csound->Malloc(csound, len);
+    n = 0;
+    for (;;) {
+      n += fread(data + n, 1, len - n, f);
+      if (n < len)
+        break;
+      len += (len >> 1);
+      data = (unsigned char*) csound->ReAlloc(csound, data, len);
+    }
+    *size = n;
+    return data;
+}
+
  /* ------------------------------------------------------------------------ */
 
-/* open MIDI file, read all tracks, and create event list */
+/* open MIDI file, check and index all tracks, and read tempo changes */
 
 int csoundMIDIFileOpen(CSOUND *csound, const char *name)
 {
-    FILE    *f = NULL;
+    FILE    *fp = NULL;
     void    *fd = NULL;
     char    *m;
-    int     i, c, hdrLen, fileFormat, nTracks, timeCode, saved_nEvents;
+    midiData_t  file, *f = &file;
+    int     i, c, hdrLen, fileFormat, nTracks, timeCode;
     int     mute_track;
 
     if (MIDIFILE != NULL)
@@ -561,9 +702,9 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
       return -1;
     //if (*name==3) name++;       /* Because of ETX added bt readOptions */
     if (strcmp(name, "stdin") == 0)
-      f = stdin;
+      fp = stdin;
     else {
-      fd = csound->FileOpen2(csound, &f, CSFILE_STD, name, "rb",
+      fd = csound->FileOpen2(csound, &fp, CSFILE_STD, name, "rb",
                              "SFDIR;SSDIR;MFDIR", CSFTYPE_STD_MIDI, 0);
       if (UNLIKELY(fd == NULL)) {
         csound->ErrorMsg(csound, Str(" *** error opening MIDI file '%s': %s"),
@@ -572,6 +713,14 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
       }
     }
     csound->Message(csound, Str("Reading MIDI file '%s'...\n"), name);
+    /* allocate structure, and load file */
+    MIDIFILE = (void*) csound->Calloc(csound, sizeof(midiFile_t));
+    MF(data) = loadFile(csound, fp, &(MF(size)), &(MF(mapped)));
+    if (fd != NULL)
+      csound->FileClose(csound, fd);
+    fd = NULL;
+    file.p = MF(data);
+    file.end = MF(data) + MF(size);
     /* check header */
     for (i = 0; i < 4; i++) {
       c = getCh(csound, f, NULL);
@@ -627,8 +776,6 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
       if (UNLIKELY(c < 0)) goto err_return;
       timeCode = (timeCode << 8) | c;
     }
-    /* allocate structure */
-    MIDIFILE = (void*) csound->Calloc(csound, sizeof(midiFile_t));
     /* calculate ticks per second or beat based on time code */
     if (UNLIKELY(timeCode < 1 || (timeCode >= 0x8000 && (timeCode & 0xFF) == 0))) {
       csound->Message(csound, Str(" *** invalid time code: %d\n"), timeCode);
@@ -655,17 +802,17 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
     }
     /* initialise structure data */
     MF(totalKcnt) = csound->global_kcounter;
-    MF(nEvents) = 0; MF(maxEvents) = 0;
     MF(nTempo) = 0; MF(maxTempo) = 0;
-    MF(eventList) = (midiEvent_t*) NULL;
     MF(tempoList) = (tempoEvent_t*) NULL;
-    MF(currentTempo) = default_tempo;
-    MF(eventListIndex) = 0;
-    MF(tempoListIndex) = 0;
-    /* read all tracks */
+    MF(nTracks) = nTracks;
+    MF(tracks) = (midiTrack_t*) csound->Calloc(csound, (size_t) nTracks
+                                                       * sizeof(midiTrack_t));
+    MF(heap) = (midiHeap_t*) csound->Calloc(csound, (size_t) nTracks
+                                                    * sizeof(midiHeap_t));
+    /* check all tracks */
+    MF(scanning) = 1;
     m = &(csound->midiGlobals->muteTrackList[0]);
     for (i = 0; i < nTracks; i++) {
-      saved_nEvents = MF(nEvents);
       mute_track = 0;
       if (*m != '\0') {             /* is this track muted ? */
         if (*m == '1')
@@ -680,15 +827,14 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
         csound->Message(csound, Str(" Track %2d\n"), i);
       else
         csound->Message(csound, Str(" Track %2d is muted\n"), i);
-      if (readTrack(csound, f) != 0)
+      if (readTrack(csound, f, &(MF(tracks)[i])) != 0)
         goto err_return;
-      if (mute_track)                   /* if track is muted, discard any */
-        MF(nEvents) = saved_nEvents;    /* non-tempo events read */
-    }
-    if (fd != NULL)
-      csound->FileClose(csound, fd);
-    /* prepare event and tempo list for reading */
-    sortEventLists(csound);
+      MF(tracks)[i].mute = mute_track;  /* if track is muted, only its */
+    }                                   /* tempo changes are used      */
+    MF(scanning) = 0;
+    /* prepare tempo list, and decode the first events of each track */
+    sortTempoList(csound);
+    resetTracks(csound);
     /* successfully read MIDI file */
     csound->Message(csound, Str("done.\n"));
     return 0;
@@ -706,14 +852,15 @@ int csoundMIDIFileOpen(CSOUND *csound, const char *name)
 int csoundMIDIFileRead(CSOUND *csound, unsigned char *buf, int nBytes)
 {
     midiFile_t  *mf;
-    int         i, j, n, nRead;
+    midiTrack_t *t;
+    midiEvent_t *ep;
+    int         j, n, nRead;
 
     mf = (midiFile_t*) MIDIFILE;
     if (mf == NULL)
       return 0;
-    i = mf->eventListIndex;
     j = mf->tempoListIndex;
-    if (i >= mf->nEvents && j >= mf->nTempo) {
+    if (mf->nHeap == 0 && j >= mf->nTempo) {
       /* there are no more events, */
       if ((unsigned long) csound->global_kcounter >= mf->totalKcnt &&
           !(csound->MTrkend)) {
@@ -739,34 +886,69 @@ int csoundMIDIFileRead(CSOUND *csound, unsigned char *buf, int nBytes)
     }
     mf->tempoListIndex = j;
     nRead = 0;
-    while (i < mf->nEvents &&
-           (unsigned long) csound->global_kcounter >= mf->eventList[i].kcnt) {
-      n = msgDataBytes((int) mf->eventList[i].st) + 1;
-      if (n < 1) {
-        i++; continue;        /* unknown or system event: skip */
+    while (mf->nHeap > 0) {
+      t = &(mf->tracks[mf->heap[0].track]);
+      ep = &(t->eventList[t->eventIndex]);
+      if (!mf->nextValid) {
+        mf->nextKcnt = tickToKcnt(csound, mf, ep->kcnt);
+        mf->nextValid = 1;
       }
-      nBytes -= n;
-      if (UNLIKELY(nBytes < 0)) {
-        csound->Message(csound, Str(" *** buffer overflow while reading "
-                                    "MIDI file events\n"));
-        break;      /* return with whatever has been read so far */
+      if ((unsigned long) csound->global_kcounter < mf->nextKcnt)
+        break;
+      n = msgDataBytes((int) ep->st) + 1;
+      if (n >= 1) {           /* unknown or system events are skipped */
+        nBytes -= n;
+        if (UNLIKELY(nBytes < 0)) {
+          csound->Message(csound, Str(" *** buffer overflow while reading "
+                                      "MIDI file events\n"));
+          break;    /* return with whatever has been read so far */
+        }
+        nRead += n;
+        *buf++ = ep->st;
+        if (n > 1) *buf++ = ep->d1;
+        if (n > 2) *buf++ = ep->d2;
       }
-      nRead += n;
-      *buf++ = mf->eventList[i].st;
-      if (n > 1) *buf++ = mf->eventList[i].d1;
-      if (n > 2) *buf++ = mf->eventList[i].d2;
-      i++;
+      /* next event of this track */
+      mf->nextValid = 0;
+      if (++(t->eventIndex) < t->nEvents || decodeTrack(csound, t) > 0)
+        mf->heap[0].tick = t->eventList[t->eventIndex].kcnt;
+      else
+        mf->heap[0] = mf->heap[--(mf->nHeap)];
+      if (mf->nHeap > 1)
+        heapDown(mf, 0);
     }
-    mf->eventListIndex = i;
     /* return the number of bytes read */
     return nRead;
 }
 
-/* destroy MIDI file event list */
+/* destroy MIDI file event list, and unmap or free the file data */
 
 int csoundMIDIFileClose(CSOUND *csound)
 {
-    /* nothing to do: memRESET() will free any allocated memory */
+    midiFile_t  *mf = (midiFile_t*) MIDIFILE;
+    int         i;
+
+    if (mf == NULL)
+      return 0;
+    if (mf->data != NULL) {
+#if !defined(WIN32)
+      if (mf->mapped)
+        munmap(mf->data, mf->size);
+      else
+#endif
+        csound->Free(csound, mf->data);
+    }
+    if (mf->tracks != NULL) {
+      for (i = 0; i < mf->nTracks; i++)
+        if (mf->tracks[i].eventList != NULL)
+          csound->Free(csound, mf->tracks[i].eventList);
+      csound->Free(csound, mf->tracks);
+    }
+    if (mf->heap != NULL)
+      csound->Free(csound, mf->heap);
+    if (mf->tempoList != NULL)
+      csound->Free(csound, mf->tempoList);
+    csound->Free(csound, mf);
     MIDIFILE = (void*) NULL;
     return 0;
 }
@@ -782,10 +964,8 @@ void midifile_rewind_score(CSOUND *csound)
     OPARMS *O = csound->oparms;
 
     if (MIDIFILE != NULL) {
-      /* reset event index and tempo */
-      MF(currentTempo) = default_tempo;
-      MF(eventListIndex) = 0;
-      MF(tempoListIndex) = 0;
+      /* go back to the start of all tracks, and reset tempo */
+      resetTracks(csound);
       csound->MTrkend = csound->Mxtroffs = csound->Mforcdecs = 0;
       /* reset controllers on all channels */
       for (i = 0; i < MAXCHAN; i++)
@@ -115,6 +115,108 @@ static const MYFLT dsctl_map[12] = {
 
 static const int16 datbyts[8] = { 2, 2, 2, 2, 1, 1, 2, 0 };
 
+/* Queue of timestamped MIDI messages, written by csoundPushMidiMessage()
+   from any number of threads without locking, and read by sensMidi() in
+   the performance thread.  Each slot carries a sequence number: a writer
+   claims a slot by advancing wpos when the slot's number equals its
+   position, and publishes the message by setting the number to position
+   + 1; the reader frees the slot by setting it to position + size.
+   Messages that arrived between the starts of the previous and of the
+   current k-period are read in the current one, at the corresponding
+   sample offset. */
+
+#define MIDIRING_SIZE   (1024)          /* must be a power of two */
+
+typedef struct {
+    volatile long   seq;                /* sequence number of slot */
+    double          time;               /* arrival time (real time clock) */
+    unsigned char   data[4];            /* message, data[3] = length */
+} MIDIRING_SLOT;
+
+typedef struct {
+    volatile long   wpos;               /* next slot to be written */
+    long            rpos;               /* next slot to be read */
+    uint64_t        kcnt;               /* k-period of curTime */
+    double          prvTime, curTime;   /* start of previous and current */
+                                        /*   k-period (real time clock) */
+    MIDIRING_SLOT   slot[MIDIRING_SIZE];
+} MIDIRING;
+
+static MIDIRING *midiRingCreate(CSOUND *csound)
+{
+    MIDIRING  *r = (MIDIRING*) csound->Calloc(csound, sizeof(MIDIRING));
+    long      i;
+
+    for (i = 0; i < MIDIRING_SIZE; i++)
+      r->slot[i].seq = i;
+    r->kcnt = ~((uint64_t) 0);
+    return r;
+}
+
+PUBLIC int csoundPushMidiMessage(CSOUND *csound,
+                                 const unsigned char *msg, int nbytes)
+{
+    MIDIRING      *r;
+    MIDIRING_SLOT *s;
+    long          pos, seq;
+
+    if (UNLIKELY(csound->midiGlobals == NULL ||
+                 (r = (MIDIRING*) csound->midiGlobals->midiRing) == NULL ||
+                 nbytes < 1 || nbytes > 3 || !(msg[0] & 0x80)))
+      return CSOUND_ERROR;
+    pos = ATOMIC_GET(r->wpos);
+    for (;;) {
+      s = &(r->slot[pos & (MIDIRING_SIZE - 1)]);
+      seq = ATOMIC_GET(s->seq);
+      if (seq == pos) {
+        long  next = pos + 1;
+        if (!ATOMIC_CMP_XCH(&(r->wpos), next, pos))
+          break;                        /* claimed the slot */
+        pos = ATOMIC_GET(r->wpos);
+      }
+      else if ((long) (seq - pos) < 0)
+        return CSOUND_ERROR;            /* queue is full */
+      else
+        pos = ATOMIC_GET(r->wpos);      /* taken by another writer */
+    }
+    s->time = csoundGetRealTime(csound->csRtClock);
+    memcpy(s->data, msg, (size_t) nbytes);
+    s->data[3] = (unsigned char) nbytes;
+    ATOMIC_SET(s->seq, pos + 1);
+    return CSOUND_SUCCESS;
+}
+
+/* copy the next queued message to the input buffer, and set the sample */
+/* offset of the message; returns the number of bytes copied            */
+
+static int midiRingRead(CSOUND *csound, MGLOBAL *p)
+{
+    MIDIRING      *r = (MIDIRING*) p->midiRing;
+    MIDIRING_SLOT *s = &(r->slot[r->rpos & (MIDIRING_SIZE - 1)]);
+    double        t;
+    int           n;
+
+    if (r->kcnt != csound->global_kcounter) {
+      r->kcnt = csound->global_kcounter;
+      r->prvTime = r->curTime;
+      r->curTime = csoundGetRealTime(csound->csRtClock);
+    }
+    if (ATOMIC_GET(s->seq) != r->rpos + 1 || s->time > r->curTime)
+      return 0;                 /* empty, or arrived in this k-period */
+    t = s->time - r->prvTime;
+    p->evtOffset = 0;
+    if (t > 0.0 && r->curTime > r->prvTime) {
+      p->evtOffset = (int) (t / (r->curTime - r->prvTime) * csound->ksmps);
+      if (p->evtOffset >= (int) csound->ksmps)
+        p->evtOffset = csound->ksmps - 1;
+    }
+    n = s->data[3];
+    memcpy(p->endatp, s->data, (size_t) n);
+    ATOMIC_SET(s->seq, r->rpos + MIDIRING_SIZE);
+    r->rpos++;
+    return n;
+}
+
 /* open a Midi event stream for reading, alloc bufs */
 /*     callable once from main.c                    */
 
@@ -137,6 +239,7 @@ void MidiOpen(CSOUND *csound)
         csound->Die(csound, Str(" *** error opening MIDI in device: %d (%s)"),
                             err, csoundExternalMidiErrorString(csound, err));
       }
+      p->midiRing = midiRingCreate(csound);
     }
     /* and file. */
     if (O->FMidiin && O->FMidiname != NULL) {
@@ -488,6 +591,7 @@ int sensMidi(CSOUND *csound)
     if (p->bufp >= p->endatp) {
       p->bufp = &(p->mbuf[0]);
       p->endatp = p->bufp;
+      p->evtOffset = 0;
       if (O->Midiin && !csound->advanceCnt) {   /* read MIDI device */
         n = p->MidiReadCallback(csound, p->midiInUserData, p->bufp, MBUFSIZ);
         if (n < 0)
@@ -502,6 +606,9 @@ int sensMidi(CSOUND *csound)
         if (n > 0)
           p->endatp += (int) n;
       }
+      if (p->endatp <= p->bufp && p->midiRing != NULL &&
+          !csound->advanceCnt)                  /* read queued messages */
+        p->endatp += midiRingRead(csound, p);
       if (p->endatp <= p->bufp)
         return 0;               /* no events were received */
     }
@@ -638,4 +745,8 @@ void MidiClose(CSOUND *csound)
       csoundCloseMidiOutFile(csound);
       p->midiOutFileData = NULL;
     }
+    if (p->midiRing != NULL) {
+      csound->Free(csound, p->midiRing);
+      p->midiRing = NULL;
+    }
 }
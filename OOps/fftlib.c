@@ -3357,10 +3357,10 @@ void csoundRealFFTMult(CSOUND *csound, MYFLT *outbuf,
 */
 static
 void pffft_execute(CSOUND_FFT_SETUP *setup,
-                   MYFLT *sig) {
+                   MYFLT *sig, MYFLT *buffer) {
   int32_t i, N = setup->N;
   float s, *buf;
-  buf = (float *) setup->buffer;
+  buf = (float *) buffer;
   for(i=0;i<N;i++)
     buf[i] = sig[i];
   pffft_transform_ordered((PFFFT_Setup *)
@@ -3377,7 +3377,7 @@ void pffft_execute(CSOUND_FFT_SETUP *setup,
 #include <Accelerate/Accelerate.h>
 static
 void vDSP_execute(CSOUND_FFT_SETUP *setup,
-                   MYFLT *sig){
+                   MYFLT *sig, MYFLT *buffer){
 #ifdef USE_DOUBLE
   DSPDoubleSplitComplex tmp;
 #else
@@ -3386,8 +3386,8 @@ void vDSP_execute(CSOUND_FFT_SETUP *setup,
   int32_t i,j;
   MYFLT s;
   int32_t N = setup->N;
-  tmp.realp = &setup->buffer[0];
-  tmp.imagp = &setup->buffer[N>>1];
+  tmp.realp = &buffer[0];
+  tmp.imagp = &buffer[N>>1];
   for(i=j=0;i<N;i+=2,j++){
     tmp.realp[j] = sig[i];
     tmp.imagp[j] = sig[i+1];
@@ -3420,10 +3420,49 @@ void *align_alloc(CSOUND *csound, size_t nb_bytes){
   return p;
 }
 
-int32_t setupDispose(CSOUND *csound, void *pp){
-  IGN(csound);
-  CSOUND_FFT_SETUP *setup =(CSOUND_FFT_SETUP *) pp;
-  switch(setup->lib){
+/*
+  FFT plan cache
+  Setups are shared by all callers asking for the same
+  (size, direction, library), so that opcodes initialised per note
+  do not rebuild twiddle tables. The transform work buffer cannot be
+  shared, so each plan keeps a pool of scratch buffers and every
+  concurrently running thread takes one for the duration of a transform.
+  Plans live until the Csound instance is reset.
+*/
+typedef struct fft_scratch_ {
+  MYFLT  *buffer;
+  struct fft_scratch_ *nxt;
+} FFT_SCRATCH;
+
+typedef struct fft_plan_ {
+  CSOUND_FFT_SETUP  setup;      /* must be first: this is the handle */
+  int32_t           dir, lib;   /* cache key (with setup.N) */
+  int32_t           bufsize;    /* scratch buffer size in MYFLTs */
+  spin_lock_t       lock;       /* protects the scratch pools */
+  FFT_SCRATCH       *scratch[2]; /* free buffers: single, batched */
+  MYFLT             *bcos, *bsin; /* batched transform twiddles */
+  int32_t           *brev;      /* batched transform bit reversal */
+  struct fft_plan_  *nxt;
+} FFT_PLAN;
+
+/* channels transformed together by csoundRealFFT2Batch() */
+#define FFT_BATCH_MAX 8
+/* sizes for which the interleaved transform beats one radix-8
+   transform per channel (outside this range the per-channel loop
+   is used: small sizes have special-cased kernels, and larger ones
+   no longer keep all channels in cache) */
+#define FFT_BATCH_MINSIZE 32
+#define FFT_BATCH_MAXSIZE 64
+
+typedef struct {
+  FFT_PLAN  *plans;
+  void      *mutex;             /* serialises lookups (init time only) */
+  int32_t   nplans;
+  uint64_t  hits, misses;
+} FFT_PLAN_CACHE;
+
+static void plan_destroy(FFT_PLAN *plan){
+  switch(plan->setup.lib){
 #if defined(__MACH__)
   case VDSP_LIB:
 #ifdef USE_DOUBLE
@@ -3431,35 +3470,111 @@ int32_t setupDispose(CSOUND *csound, void *pp){
 #else
      vDSP_destroy_fftsetup((FFTSetup)
 #endif
-                           setup->setup);
+                           plan->setup.setup);
     break;
 #endif
   case PFFT_LIB:
-    pffft_destroy_setup((PFFFT_Setup *)setup->setup);
+    pffft_destroy_setup((PFFFT_Setup *)plan->setup.setup);
     break;
   }
+}
+
+static int32_t fft_plan_cache_reset(CSOUND *csound, void *pp){
+  FFT_PLAN_CACHE *cache = (FFT_PLAN_CACHE *) pp;
+  FFT_PLAN *plan;
+  for(plan = cache->plans; plan != NULL; plan = plan->nxt)
+    plan_destroy(plan);
+  cache->plans = NULL;
+  csoundDestroyMutex(cache->mutex);
+  /* plan memory itself is released by the memory allocator */
+  if (csound->fftPlanCache == (void *) cache)
+    csound->fftPlanCache = NULL;
   return OK;
 }
 
+void csoundFFTPlanCacheInit(CSOUND *csound){
+  FFT_PLAN_CACHE *cache;
+  cache = (FFT_PLAN_CACHE *)
+    csound->Calloc(csound, sizeof(FFT_PLAN_CACHE));
+  cache->mutex = csoundCreateMutex(0);
+  csound->fftPlanCache = (void *) cache;
+  csound->RegisterResetCallback(csound, (void*) cache,
+                                (int32_t (*)(CSOUND *, void *))
+                                fft_plan_cache_reset);
+}
+
+void csoundFFTPlanCacheStats(CSOUND *csound){
+  FFT_PLAN_CACHE *cache = (FFT_PLAN_CACHE *) csound->fftPlanCache;
+  if (cache == NULL || (cache->hits + cache->misses) == 0) return;
+  if ((csound->oparms->msglevel & CS_TIMEMSG) == 0) return;
+  csound->ErrorMsg(csound,
+                   Str("FFT plan cache: %d plans, %llu hits, %llu misses\n"),
+                   cache->nplans,
+                   (unsigned long long) cache->hits,
+                   (unsigned long long) cache->misses);
+}
+
+static FFT_SCRATCH *plan_scratch_get(CSOUND *csound, FFT_PLAN *plan,
+                                     int32_t batch){
+  FFT_SCRATCH *s;
+  csoundSpinLock(&plan->lock);
+  s = plan->scratch[batch];
+  if (s != NULL) plan->scratch[batch] = s->nxt;
+  csoundSpinUnLock(&plan->lock);
+  if (UNLIKELY(s == NULL)) {
+    /* more threads than buffers: grow the pool by one */
+    size_t n = plan->bufsize * (batch ? FFT_BATCH_MAX : 1);
+    s = (FFT_SCRATCH *) csound->Calloc(csound, sizeof(FFT_SCRATCH));
+    s->buffer = (MYFLT *) align_alloc(csound, sizeof(MYFLT)*n);
+  }
+  return s;
+}
+
+static void plan_scratch_release(FFT_PLAN *plan, FFT_SCRATCH *s,
+                                 int32_t batch){
+  csoundSpinLock(&plan->lock);
+  s->nxt = plan->scratch[batch];
+  plan->scratch[batch] = s;
+  csoundSpinUnLock(&plan->lock);
+}
+
 int32_t isPowTwo(int32_t N) {
   return (N != 0) ? !(N & (N - 1)) : 0;
 }
 
-void *csoundRealFFT2Setup(CSOUND *csound,
-                         int32_t FFTsize,
-                         int32_t d){
-  CSOUND_FFT_SETUP *setup;
-  int32_t lib = csound->oparms->fft_lib;
-  if(lib == PFFT_LIB && FFTsize <= 16){
-    csound->Warning(csound,
-      "FFTsize %d \n"
-      "Cannot use PFFT with sizes <= 16\n"
-      "--defaulting to FFTLIB",
-        FFTsize);
-    lib = 0;
+/*
+  Tables for the batched transform: a real FFT of size N is done as a
+  complex FFT of size N/2 on all channels at once, with the channel
+  index innermost so that the butterflies vectorise across channels.
+*/
+static void batch_tables(CSOUND *csound, FFT_PLAN *plan){
+  int32_t i, j, k, N = plan->setup.N, M = N >> 1, bits = 0;
+  /* cos/sin(2*pi*i/N) for i < N/2 */
+  plan->bcos = (MYFLT *) csound->Malloc(csound, sizeof(MYFLT)*N);
+  plan->bsin = plan->bcos + M;
+  plan->brev = (int32_t *) csound->Malloc(csound, sizeof(int32_t)*M);
+  for (i = 0; i < M; i++) {
+    plan->bcos[i] = COS(TWOPI*i/N);
+    plan->bsin[i] = SIN(TWOPI*i/N);
+  }
+  while ((1 << bits) < M) bits++;
+  for (i = 0; i < M; i++) {
+    for (j = 0, k = 0; j < bits; j++)
+      k |= ((i >> j) & 1) << (bits - 1 - j);
+    plan->brev[i] = k;
   }
-  setup = (CSOUND_FFT_SETUP *)
-    csound->Calloc(csound, sizeof(CSOUND_FFT_SETUP));
+}
+
+static FFT_PLAN *plan_new(CSOUND *csound, int32_t FFTsize,
+                          int32_t d, int32_t lib){
+  FFT_PLAN *plan;
+  CSOUND_FFT_SETUP *setup;
+  plan = (FFT_PLAN *) csound->Calloc(csound, sizeof(FFT_PLAN));
+  csoundSpinLockInit(&plan->lock);
+  plan->bufsize = FFTsize;
+  plan->dir = d;
+  plan->lib = lib;
+  setup = &plan->setup;
   setup->N = FFTsize;
   setup->p2 = isPowTwo(FFTsize);
   switch(lib){
@@ -3489,27 +3604,74 @@ void *csoundRealFFT2Setup(CSOUND *csound,
   default:
     setup->lib = 0;
     setup->d = d;
-    return (void *) setup;
+    /* build the cosine and bit-reversal tables now, rather than
+       lazily from csoundRealFFT() on a performance thread */
+    if (setup->p2) {
+      MYFLT *ct;
+      int16 *bt;
+      int32_t M = ConvertFFTSize(csound, FFTsize);
+      getTablePointers(csound, &ct, &bt, M, (M - 1) / 2);
+      if (FFTsize >= FFT_BATCH_MINSIZE && FFTsize <= FFT_BATCH_MAXSIZE)
+        batch_tables(csound, plan);
+    }
   }
-  setup->buffer = (MYFLT *) align_alloc(csound, sizeof(MYFLT)*FFTsize);
-  csound->RegisterResetCallback(csound, (void*) setup,
-                                (int32_t (*)(CSOUND *, void *))
-                                setupDispose);
-  return (void *) setup;
+  return plan;
+}
+
+void *csoundRealFFT2Setup(CSOUND *csound,
+                         int32_t FFTsize,
+                         int32_t d){
+  FFT_PLAN_CACHE *cache;
+  FFT_PLAN *plan;
+  int32_t lib = csound->oparms->fft_lib;
+  if(lib == PFFT_LIB && FFTsize <= 16){
+    csound->Warning(csound,
+      "FFTsize %d \n"
+      "Cannot use PFFT with sizes <= 16\n"
+      "--defaulting to FFTLIB",
+        FFTsize);
+    lib = 0;
+  }
+#if !defined(__MACH__)
+  if (lib == VDSP_LIB) lib = 0;
+#endif
+  if (UNLIKELY(csound->fftPlanCache == NULL))
+    csoundFFTPlanCacheInit(csound);
+  cache = (FFT_PLAN_CACHE *) csound->fftPlanCache;
+  csoundLockMutex(cache->mutex);
+  for (plan = cache->plans; plan != NULL; plan = plan->nxt)
+    if (plan->setup.N == FFTsize && plan->dir == d && plan->lib == lib)
+      break;
+  if (plan != NULL)
+    cache->hits++;
+  else {
+    plan = plan_new(csound, FFTsize, d, lib);
+    plan->nxt = cache->plans;
+    cache->plans = plan;
+    cache->nplans++;
+    cache->misses++;
+  }
+  csoundUnlockMutex(cache->mutex);
+  return (void *) plan;
 }
 
 void csoundRealFFT2(CSOUND *csound,
                      void *p, MYFLT *sig){
-  CSOUND_FFT_SETUP *setup =
-        (CSOUND_FFT_SETUP *) p;
+  FFT_PLAN *plan = (FFT_PLAN *) p;
+  CSOUND_FFT_SETUP *setup = &plan->setup;
+  FFT_SCRATCH *s;
   switch(setup->lib) {
 #if defined(__MACH__)
   case VDSP_LIB:
-    vDSP_execute(setup,sig);
+    s = plan_scratch_get(csound, plan, 0);
+    vDSP_execute(setup,sig,s->buffer);
+    plan_scratch_release(plan, s, 0);
     break;
 #endif
   case PFFT_LIB:
-    pffft_execute(setup,sig);
+    s = plan_scratch_get(csound, plan, 0);
+    pffft_execute(setup,sig,s->buffer);
+    plan_scratch_release(plan, s, 0);
     break;
   default:
     (setup->d == FFT_FWD ?
@@ -3517,32 +3679,223 @@ void csoundRealFFT2(CSOUND *csound,
                      sig,setup->N) :
       csoundInverseRealFFT(csound,
                      sig,setup->N));
-    setup->lib = 0;
+  }
+}
+
+/*
+  Batched complex FFT of size M on B channels.
+  re/im hold M blocks of B values (one per channel); sign is -1 for
+  the forward and +1 for the inverse transform. Input is expected in
+  bit-reversed order. Pairs of radix-2 stages are done in one pass
+  over the data.
+*/
+static inline void batch_cfft(MYFLT *re, MYFLT *im, int32_t M, int32_t B,
+                              const MYFLT *ct, const MYFLT *st, MYFLT sign){
+  int32_t len = 1, half, i, j, c, s1, s2;
+  if (M & 0xAAAAAAAA) {
+    /* odd number of stages: first stage has unit twiddles */
+    for (i = 0; i < M; i += 2) {
+      MYFLT *ar = re + i*B, *ai = im + i*B;
+      MYFLT *br = ar + B, *bi = ai + B;
+      for (c = 0; c < B; c++) {
+        MYFLT tr = br[c], ti = bi[c];
+        br[c] = ar[c] - tr;
+        bi[c] = ai[c] - ti;
+        ar[c] += tr;
+        ai[c] += ti;
+      }
+    }
+    len = 2;
+  }
+  for (len <<= 1; len <= M; len <<= 2) {
+    /* stages of size len and 2*len */
+    half = len >> 1;
+    s1 = 2 * M / len;     /* tables are in steps of 2*pi/(2*M) */
+    s2 = M / len;
+    for (i = 0; i < M; i += (len << 1)) {
+      for (j = 0; j < half; j++) {
+        MYFLT w1r = ct[j*s1], w1i = sign*st[j*s1];
+        MYFLT w2r = ct[j*s2], w2i = sign*st[j*s2];
+        MYFLT *r0 = re + (i+j)*B, *i0 = im + (i+j)*B;
+        MYFLT *r1 = r0 + half*B, *i1 = i0 + half*B;
+        MYFLT *r2 = r0 + len*B, *i2 = i0 + len*B;
+        MYFLT *r3 = r2 + half*B, *i3 = i2 + half*B;
+        for (c = 0; c < B; c++) {
+          MYFLT ar, ai, br, bi, cr, ci, dr, di, tr, ti;
+          tr = w1r*r1[c] - w1i*i1[c];
+          ti = w1r*i1[c] + w1i*r1[c];
+          ar = r0[c] + tr;  ai = i0[c] + ti;
+          br = r0[c] - tr;  bi = i0[c] - ti;
+          tr = w1r*r3[c] - w1i*i3[c];
+          ti = w1r*i3[c] + w1i*r3[c];
+          cr = r2[c] + tr;  ci = i2[c] + ti;
+          dr = r2[c] - tr;  di = i2[c] - ti;
+          tr = w2r*cr - w2i*ci;
+          ti = w2r*ci + w2i*cr;
+          r0[c] = ar + tr;  i0[c] = ai + ti;
+          r2[c] = ar - tr;  i2[c] = ai - ti;
+          /* W(2len)^(j+half) = W(2len)^j * (sign * i) */
+          tr = -sign*(w2r*di + w2i*dr);
+          ti = sign*(w2r*dr - w2i*di);
+          r1[c] = br + tr;  i1[c] = bi + ti;
+          r3[c] = br - tr;  i3[c] = bi - ti;
+        }
+      }
+    }
+  }
+}
+
+static void batch_rfft_fwd(FFT_PLAN *plan, MYFLT **sigs, int32_t B,
+                           MYFLT *re, MYFLT *im){
+  int32_t k, c, M = plan->setup.N >> 1;
+  const MYFLT *ct = plan->bcos, *st = plan->bsin;
+  /* pack even/odd samples as complex values, in bit-reversed order */
+  for (k = 0; k < M; k++) {
+    MYFLT *r = re + plan->brev[k]*B, *i = im + plan->brev[k]*B;
+    for (c = 0; c < B; c++) {
+      r[c] = sigs[c][2*k];
+      i[c] = sigs[c][2*k+1];
+    }
+  }
+  /* a constant channel count lets the compiler unroll the lanes fully */
+  if (B == FFT_BATCH_MAX)
+    batch_cfft(re, im, M, FFT_BATCH_MAX, ct, st, -FL(1.0));
+  else
+    batch_cfft(re, im, M, B, ct, st, -FL(1.0));
+  /* split into the spectrum of the real signal */
+  for (c = 0; c < B; c++) {
+    MYFLT zr = re[c], zi = im[c];
+    re[c] = zr + zi;          /* DC */
+    im[c] = zr - zi;          /* Nyquist */
+  }
+  for (k = 1; k <= M/2; k++) {
+    /* W = exp(-i*pi*k/M) */
+    MYFLT wr = ct[k], wi = -st[k];
+    MYFLT *ar = re + k*B, *ai = im + k*B;
+    MYFLT *br = re + (M-k)*B, *bi = im + (M-k)*B;
+    for (c = 0; c < B; c++) {
+      MYFLT fer = FL(0.5)*(ar[c] + br[c]), fei = FL(0.5)*(ai[c] - bi[c]);
+      MYFLT for_ = FL(0.5)*(ai[c] + bi[c]), foi = -FL(0.5)*(ar[c] - br[c]);
+      MYFLT tr = wr*for_ - wi*foi, ti = wr*foi + wi*for_;
+      ar[c] = fer + tr;  ai[c] = fei + ti;
+      br[c] = fer - tr;  bi[c] = ti - fei;
+    }
+  }
+  for (c = 0; c < B; c++) {
+    sigs[c][0] = re[c];
+    sigs[c][1] = im[c];
+  }
+  for (k = 1; k < M; k++) {
+    MYFLT *r = re + k*B, *i = im + k*B;
+    for (c = 0; c < B; c++) {
+      sigs[c][2*k] = r[c];
+      sigs[c][2*k+1] = i[c];
+    }
+  }
+}
+
+static void batch_rfft_inv(FFT_PLAN *plan, MYFLT **sigs, int32_t B,
+                           MYFLT *re, MYFLT *im){
+  int32_t k, c, M = plan->setup.N >> 1;
+  const MYFLT *ct = plan->bcos, *st = plan->bsin;
+  MYFLT scal = FL(1.0)/M;
+  /* rebuild the half-size complex spectrum, bit-reversed */
+  for (c = 0; c < B; c++) {
+    MYFLT x0 = sigs[c][0], xn = sigs[c][1];
+    re[c] = FL(0.5)*(x0 + xn);
+    im[c] = FL(0.5)*(x0 - xn);
+  }
+  for (k = 1; k <= M/2; k++) {
+    /* W* = exp(i*pi*k/M) */
+    MYFLT wr = ct[k], wi = st[k];
+    int32_t ka = plan->brev[k], kb = plan->brev[M-k];
+    MYFLT *ar = re + ka*B, *ai = im + ka*B;
+    MYFLT *br = re + kb*B, *bi = im + kb*B;
+    for (c = 0; c < B; c++) {
+      MYFLT xr = sigs[c][2*k], xi = sigs[c][2*k+1];
+      MYFLT yr = sigs[c][2*(M-k)], yi = sigs[c][2*(M-k)+1];
+      MYFLT fer = FL(0.5)*(xr + yr), fei = FL(0.5)*(xi - yi);
+      MYFLT dr = FL(0.5)*(xr - yr), di = FL(0.5)*(xi + yi);
+      MYFLT for_ = wr*dr - wi*di, foi = wr*di + wi*dr;
+      /* Z[k] = Fe + i*Fo, Z[M-k] = conj(Fe) + i*conj(Fo) */
+      ar[c] = fer - foi;  ai[c] = fei + for_;
+      br[c] = fer + foi;  bi[c] = for_ - fei;
+    }
+  }
+  if (B == FFT_BATCH_MAX)
+    batch_cfft(re, im, M, FFT_BATCH_MAX, ct, st, FL(1.0));
+  else
+    batch_cfft(re, im, M, B, ct, st, FL(1.0));
+  for (k = 0; k < M; k++) {
+    MYFLT *r = re + k*B, *i = im + k*B;
+    for (c = 0; c < B; c++) {
+      sigs[c][2*k] = r[c]*scal;
+      sigs[c][2*k+1] = i[c]*scal;
+    }
+  }
+}
+
+/*
+  Transforms nsigs equally-sized signals with the same setup.
+  For the built-in library, small power-of-two sizes are computed
+  FFT_BATCH_MAX channels at a time with the channel loop innermost;
+  otherwise each channel is transformed in turn with one scratch buffer.
+*/
+void csoundRealFFT2Batch(CSOUND *csound,
+                         void *p, MYFLT **sigs, int32_t nsigs){
+  FFT_PLAN *plan = (FFT_PLAN *) p;
+  CSOUND_FFT_SETUP *setup = &plan->setup;
+  FFT_SCRATCH *s;
+  int32_t i, B;
+  switch(setup->lib) {
+#if defined(__MACH__)
+  case VDSP_LIB:
+    s = plan_scratch_get(csound, plan, 0);
+    for (i = 0; i < nsigs; i++)
+      vDSP_execute(setup,sigs[i],s->buffer);
+    plan_scratch_release(plan, s, 0);
+    break;
+#endif
+  case PFFT_LIB:
+    s = plan_scratch_get(csound, plan, 0);
+    for (i = 0; i < nsigs; i++)
+      pffft_execute(setup,sigs[i],s->buffer);
+    plan_scratch_release(plan, s, 0);
+    break;
+  default:
+    if (plan->brev == NULL || nsigs < 2) {
+      for (i = 0; i < nsigs; i++)
+        csoundRealFFT2(csound, p, sigs[i]);
+      break;
+    }
+    s = plan_scratch_get(csound, plan, 1);
+    for (i = 0; i < nsigs; i += B) {
+      MYFLT *re = s->buffer;
+      B = nsigs - i < FFT_BATCH_MAX ? nsigs - i : FFT_BATCH_MAX;
+      if (setup->d == FFT_FWD)
+        batch_rfft_fwd(plan, &sigs[i], B, re, re + (setup->N >> 1)*B);
+      else
+        batch_rfft_inv(plan, &sigs[i], B, re, re + (setup->N >> 1)*B);
+    }
+    plan_scratch_release(plan, s, 1);
   }
 }
 
 
 void *csoundDCTSetup(CSOUND *csound,
                      int32_t FFTsize, int32_t d){
- CSOUND_FFT_SETUP *setup;
- setup = (CSOUND_FFT_SETUP *)
-   csoundRealFFT2Setup(csound,
-                       FFTsize*4,d);
- if(setup->lib == 0){
-  setup->buffer = (MYFLT *)
-    csound->Calloc(csound, sizeof(MYFLT)*setup->N);
- }
- return setup;
+ /* the work buffer comes from the plan's scratch pool */
+ return csoundRealFFT2Setup(csound, FFTsize*4, d);
 }
 
 
 void pffft_DCT_execute(CSOUND *csound,
-                     void *p, MYFLT *sig){
+                       void *p, MYFLT *sig, MYFLT *buf){
   IGN(csound);
   CSOUND_FFT_SETUP *setup =
         (CSOUND_FFT_SETUP *) p;
   int32_t i,j, N= setup->N;
-  float *buffer = (float *)setup->buffer;
+  float *buffer = (float *)buf;
   if(setup->d == FFT_FWD){
   for(i=j = 0; i < N/2; i+=2, j++){
     buffer[i] = FL(0.0);
@@ -3583,7 +3936,7 @@ void pffft_DCT_execute(CSOUND *csound,
 
 #if defined(__MACH__)
 void vDSP_DCT_execute(CSOUND *csound,
-                     void *p, MYFLT *sig){
+                      void *p, MYFLT *sig, MYFLT *buffer){
   IGN(csound);
   CSOUND_FFT_SETUP *setup =
         (CSOUND_FFT_SETUP *) p;
@@ -3593,8 +3946,8 @@ void vDSP_DCT_execute(CSOUND *csound,
 #else
   DSPSplitComplex tmp;
 #endif
-  tmp.realp = &setup->buffer[0];
-  tmp.imagp = &setup->buffer[N>>1];
+  tmp.realp = &buffer[0];
+  tmp.imagp = &buffer[N>>1];
   if(setup->d ==  kFFTDirection_Forward){
   for(j=0;j<N/4;j++){
     tmp.realp[j] = FL(0.0);
@@ -3642,11 +3995,10 @@ void vDSP_DCT_execute(CSOUND *csound,
 #endif
 
 void DCT_execute(CSOUND *csound,
-                     void *p, MYFLT *sig){
+                 void *p, MYFLT *sig, MYFLT *buffer){
   CSOUND_FFT_SETUP *setup =
         (CSOUND_FFT_SETUP *) p;
   int32_t i,j, N= setup->N;
-  MYFLT *buffer = setup->buffer;
   if(setup->d == FFT_FWD){
   for(i=j = 0; i < N/2; i+=2, j++){
     buffer[i] = FL(0.0);
@@ -3681,21 +4033,21 @@ void DCT_execute(CSOUND *csound,
 
 void csoundDCT(CSOUND *csound,
                void *p, MYFLT *sig){
-CSOUND_FFT_SETUP *setup =
-        (CSOUND_FFT_SETUP *) p;
-  switch(setup->lib) {
+  FFT_PLAN *plan = (FFT_PLAN *) p;
+  FFT_SCRATCH *s = plan_scratch_get(csound, plan, 0);
+  switch(plan->setup.lib) {
 #if defined(__MACH__)
   case VDSP_LIB:
-    vDSP_DCT_execute(csound,setup,sig);
+    vDSP_DCT_execute(csound,plan,sig,s->buffer);
     break;
 #endif
   case PFFT_LIB:
-    pffft_DCT_execute(csound,setup,sig);
+    pffft_DCT_execute(csound,plan,sig,s->buffer);
     break;
   default:
-    DCT_execute(csound,setup,sig);
-    setup->lib = 0;
+    DCT_execute(csound,plan,sig,s->buffer);
   }
+  plan_scratch_release(plan, s, 0);
 }
 
 /* =======--====================*/
@@ -29,6 +29,7 @@
 #include <math.h>
 #include "csoundCore.h"
 #include "pstream.h"
+#include "pvsmath.h"
 
         double  besseli(double x);
 static  void    hamming(MYFLT *win, int32_t winLen, int32_t even);
@@ -282,8 +283,8 @@ static void generate_frame(CSOUND *csound, PVSANAL *p)
     MYFLT *input = (MYFLT *) (p->input.auxp);
     MYFLT *analWindow = (MYFLT *) (p->analwinbuf.auxp) + analWinLen;
     MYFLT *oldInPhase = (MYFLT *) (p->oldInPhase.auxp);
-    MYFLT angleDif,real,imag,phase;
-    double rratio;
+    MYFLT angleDif,phase;
+    MYFLT RoverTwoPi = p->RoverTwoPi, Fexact = p->Fexact;
 
     got = p->fsig->overlap;      /*always assume */
     fp = (MYFLT *) (p->overlapbuf.auxp);
@@ -373,30 +374,18 @@ static void generate_frame(CSOUND *csound, PVSANAL *p)
     }
 #endif
     /*if (format==PVS_AMP_FREQ) {*/
-    for (i=ii=0    /*,i0=anal,i1=anal+1,oi=oldInPhase*/;
-         i <= N2;
-         i++,ii+=2 /*i0+=2,i1+=2, oi++*/) {
-      real = anal[ii] /* *i0 */;
-      imag = anal[ii+1] /* *i1 */;
-      /**i0*/ anal[ii] = HYPOT(real, imag);
-      /* phase unwrapping */
-      /*if (*i0 == 0.)*/
-      if (UNLIKELY(/* *i0 */ anal[ii] < FL(1.0E-10)))
-        angleDif = FL(0.0);
-      else {
-        rratio =  atan2((double)imag,(double)real);
-        angleDif  = (phase = (MYFLT)rratio) - /**oi*/ oldInPhase[i];
-        /* *oi */ oldInPhase[i] = phase;
-      }
-
-      if (angleDif > PI_F)
-        angleDif = angleDif - TWOPI_F;
-      if (angleDif < -PI_F)
-        angleDif = angleDif + TWOPI_F;
-
+    pvs_polar(anal, N2 + 1, csound->oparms->pvsfastmath);
+    for (i=ii=0; i <= N2; i++,ii+=2) {
+      MYFLT mag = anal[ii];
+      /* phase unwrapping; bins without energy keep their old phase */
+      int32_t live = !(mag < FL(1.0E-10));
+      phase = anal[ii+1];
+      angleDif = live ? phase - oldInPhase[i] : FL(0.0);
+      oldInPhase[i] = live ? phase : oldInPhase[i];
+      angleDif = angleDif > PI_F ? angleDif - TWOPI_F : angleDif;
+      angleDif = angleDif < -PI_F ? angleDif + TWOPI_F : angleDif;
       /* add in filter center freq.*/
-      /* *i1 */ anal[ii+1]  = angleDif * p->RoverTwoPi + ((MYFLT) i * p->Fexact);
-
+      anal[ii+1]  = angleDif * RoverTwoPi + ((MYFLT) i * Fexact);
     }
     /* } */
     /* else must be PVOC_COMPLEX */
@@ -466,6 +455,7 @@ int32_t pvssanal(CSOUND *csound, PVSANAL *p)
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t i, nsmps = CS_KSMPS;
     int32_t wintype = p->fsig->wintype;
+    int32_t fastmath = csound->oparms->pvsfastmath;
     if (UNLIKELY(data==NULL)) {
       return csound->PerfError(csound,&(p->h),
                                Str("pvsanal: Not Initialised.\n"));
@@ -648,14 +638,23 @@ int32_t pvssanal(CSOUND *csound, PVSANAL *p)
 /*         for (j = 0; j < NB; j++) */
 /*           printf("%d: %f\t%f\n", j, ff[j].re, ff[j].im); */
 /*       } */
+      if (fastmath)
+        pvs_polar((MYFLT*) ff, NB, 1);
       for (j = 0; j < NB; j++) { /* Convert to AMP_FREQ */
-        double thismag = hypot(ff[j].re, ff[j].im);
-        double phase = atan2(ff[j].im, ff[j].re);
-        double angleDif  = phase -  h[j];
+        double thismag, phase, angleDif;
+        if (fastmath) {
+          thismag = ff[j].re;
+          phase = ff[j].im;
+        }
+        else {
+          thismag = hypot(ff[j].re, ff[j].im);
+          phase = atan2(ff[j].im, ff[j].re);
+        }
+        angleDif  = phase -  h[j];
         h[j] = phase;
             /*subtract expected phase difference */
         angleDif -= (double)j * TWOPI/N;
-        angleDif =  mod2Pi(angleDif);
+        angleDif =  fastmath ? pvs_wrap_fast(angleDif) : mod2Pi(angleDif);
         angleDif =  angleDif * N /TWOPI;
         ff[j].re = thismag;
         ff[j].im = csound->esr * (j + angleDif)/N;
@@ -861,7 +860,8 @@ static void process_frame(CSOUND *csound, PVSYNTH *p)
     MYFLT *oldOutPhase = (MYFLT *) (p->oldOutPhase.auxp);
     int32_t N = p->fsig->N;
     MYFLT *obufptr,*outbuf,*synWindow;
-    MYFLT mag,phase,angledif, the_phase;
+    MYFLT angledif, the_phase;
+    MYFLT TwoPioverR = p->TwoPioverR, Fexact = p->Fexact;
     int32_t synWinLen = p->fsig->winsize / 2;
     int32_t overlap = p->fsig->overlap;
     /*int32 format = p->fsig->format; */
@@ -904,22 +904,18 @@ static void process_frame(CSOUND *csound, PVSYNTH *p)
     }
     else if (format == PVS_AMP_FREQ) {
 #endif
-      for (i=ii=0 /*, i0=syn, i1=syn+1*/; i<= NO2; i++, ii+=2 /*i0+=2,  i1+=2*/) {
-        mag = syn[ii]; /* *i0; */
-        /* RWD variation to keep phase wrapped within +- TWOPI */
-        /* this is spread across several frame cycles, as the problem does not
-           develop for a while */
-
-        angledif = p->TwoPioverR * ( /* *i1 */ syn[ii+1] - ((MYFLT)i * p->Fexact));
-        the_phase = /* *(oldOutPhase + i) */ oldOutPhase[i] + angledif;
-        if (i== p->bin_index)
-          the_phase = (MYFLT) fmod(the_phase,TWOPI);
-        /* *(oldOutPhase + i) = the_phase; */
+      for (i=ii=0; i<= NO2; i++, ii+=2) {
+        angledif = TwoPioverR * (syn[ii+1] - ((MYFLT)i * Fexact));
+        the_phase = oldOutPhase[i] + angledif;
         oldOutPhase[i] = the_phase;
-        phase = the_phase;
-        /* *i0 */ syn[ii]  = (MYFLT)((double)mag * cos((double)phase));
-        /* *i1 */ syn[ii+1] = (MYFLT)((double)mag * sin((double)phase));
+        syn[ii+1] = the_phase;
       }
+      /* RWD variation to keep phase wrapped within +- TWOPI */
+      /* this is spread across several frame cycles, as the problem does not
+         develop for a while */
+      the_phase = (MYFLT) fmod(oldOutPhase[p->bin_index],TWOPI);
+      oldOutPhase[p->bin_index] = syn[2*p->bin_index+1] = the_phase;
+      pvs_rect(syn, NO2 + 1, csound->oparms->pvsfastmath);
 #ifdef NOTDEF
     }
 #endif
@@ -1017,6 +1013,7 @@ int32_t pvssynth(CSOUND *csound, PVSYNTH *p)
     CMPLX *ff;
     double *h = (double*)p->oldOutPhase.auxp;
     double *output = (double*)p->output.auxp;
+    int32_t fastmath = csound->oparms->pvsfastmath;
 
     /* Get real part from AMP/FREQ */
     for (i=0; i<ksmps; i++) {
@@ -1032,8 +1029,16 @@ int32_t pvssynth(CSOUND *csound, PVSYNTH *p)
         tmp *= TWOPI /csound->esr;
         /* add the overlap phase advance back in */
         tmp += (double)k*TWOPI/N;
-        h[k] = phase = mod2Pi(h[k] + tmp);
-        output[k] = ff[k].re*cos(phase);
+        if (fastmath) {
+          double s, c;
+          h[k] = phase = pvs_wrap_fast(h[k] + tmp);
+          pvs_sincos_fast(phase, &s, &c);
+          output[k] = ff[k].re*c;
+        }
+        else {
+          h[k] = phase = mod2Pi(h[k] + tmp);
+          output[k] = ff[k].re*cos(phase);
+        }
       }
       a = FL(0.0);
       for (k=1; k<NB-1; k++) {
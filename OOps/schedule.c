@@ -23,6 +23,7 @@
 */
 
 #include <math.h>
+#include <stddef.h>
 #include "csoundCore.h"
 #include "namedins.h"
 #include "linevent.h"
@@ -52,6 +53,7 @@ int32_t schedule_array(CSOUND *csound, SCHED *p)
       pp.args[i] = args+i-1;
     }
     pp.flag = 1;
+    pp.cache = &p->namecache;
     return eventOpcodeI_(csound, &pp, 0, 'i');
 }
 
@@ -72,6 +74,7 @@ int32_t schedule(CSOUND *csound, SCHED *p)
       pp.args[i] = p->argums[i-4];
     }
     pp.flag = 1;
+    pp.cache = &p->namecache;
     return eventOpcodeI_(csound, &pp, 0, 'i');
 }
 
@@ -157,6 +160,7 @@ int32_t schedule_S(CSOUND *csound, SCHED *p)
       pp.args[i] = p->argums[i-4];
     }
     pp.flag = 1;
+    pp.cache = &p->namecache;
     return eventOpcodeI_(csound, &pp, 1, 'i');
 }
 
@@ -186,6 +190,7 @@ int32_t kschedule(CSOUND *csound, WSCHED *p)
       }
       p->todo =0;
       pp.flag = 1;
+      pp.cache = &p->namecache;
       if (IS_STR_ARG(p->which)){
         return eventOpcode_(csound, &pp, 1, 'i');
       }
@@ -424,10 +429,11 @@ static int32_t get_absinsno(CSOUND *csound, TRIGINSTR *p, int32_t stringname)
     /* Get absolute instr num */
     /* IV - Oct 31 2002: allow string argument for named instruments */
     if (stringname)
-      insno = (int32_t)strarg2insno_p(csound, ((STRINGDAT*)p->args[0])->data);
+      insno = strarg2insno_cached(csound, &p->namecache,
+                                  ((STRINGDAT*)p->args[0])->data, 1);
     else if (csound->ISSTRCOD(*p->args[0])) {
       char *ss = get_arg_string(csound, *p->args[0]);
-      insno = (int32_t)strarg2insno_p(csound, ss);
+      insno = strarg2insno_cached(csound, &p->namecache, ss, 1);
     }
     else
       insno = (int32_t)FABS(*p->args[0]);
@@ -448,7 +454,8 @@ static int32_t ktriginstr_(CSOUND *csound, TRIGINSTR *p, int32_t stringname)
     int32_t     i, argnum;
     EVTBLK  evt;
     char    name[512];
-    memset(&evt, 0, sizeof(EVTBLK));
+    /* p-fields past pcnt are not read, only up to p3 need clearing */
+    memset(&evt, 0, offsetof(EVTBLK, p) + 4 * sizeof(MYFLT));
 
     if (p->timrem > 0)
       p->timrem--;
@@ -490,14 +497,15 @@ static int32_t ktriginstr_(CSOUND *csound, TRIGINSTR *p, int32_t stringname)
 
     /* Create the new event */
     if (stringname) {
-      evt.p[1] = csound->strarg2insno(csound,((STRINGDAT *)p->args[0])->data, 1);
+      evt.p[1] = strarg2insno_cached(csound, &p->namecache,
+                                     ((STRINGDAT *)p->args[0])->data, 0);
       evt.strarg = NULL; evt.scnt = 0;
       /*evt.strarg = ((STRINGDAT*)p->args[0])->data;
         evt.p[1] = SSTRCOD;*/
     }
     else if (csound->ISSTRCOD(*p->args[0])) {
       unquote(name, get_arg_string(csound, *p->args[0]), 512);
-      evt.p[1] = csound->strarg2insno(csound,name, 1);
+      evt.p[1] = strarg2insno_cached(csound, &p->namecache, name, 0);
       evt.strarg = NULL;
       /* evt.strarg = name; */
       evt.scnt = 0;
@@ -23,6 +23,7 @@
 
 #include "csoundCore.h" /*                              UGENS2.C        */
 #include "ugens2.h"
+#include "oscsimd.h"
 #include <math.h>
 
 /* Macro form of Istvan's speedup ; constant should be 3fefffffffffffff */
@@ -1203,6 +1204,87 @@ int32_t oscset(CSOUND *csound, OSC *p)
     return NOTOK;
 }
 
+#if defined(__SSE2__)
+/* Block core of the audio rate oscil family.  The phases of four
+   consecutive samples are computed at once: with a k-rate increment they
+   are phs + {0,1,2,3}*inc, with an a-rate increment a running sum of the
+   per-sample increments, formed in the lanes.  As PHMASK + 1 is a power
+   of two, masking the sums gives the same phases as the masked steps of
+   the scalar loop, and the phase left in *pphs continues the block
+   exactly.  mode 0 truncates,
+   1 interpolates linearly and 3 cubically; amp is used when ampp is NULL.
+   Returns the first sample left for the scalar loop. */
+static uint32_t osc_simd(FUNC *ftp, int32_t *pphs, int32_t inc,
+                         MYFLT *cpsp, MYFLT sicvt, MYFLT amp, MYFLT *ampp,
+                         MYFLT *ar, uint32_t n, uint32_t nsmps, int32_t mode)
+{
+    MYFLT    *ftab = ftp->ftable;
+    uint32_t phs = (uint32_t) *pphs, uinc = (uint32_t) inc;
+    int32_t  flen = (int32_t) ftp->flen;
+    __m128i  phmask = _mm_set1_epi32(PHMASK);
+    __m128i  lomask = _mm_set1_epi32(ftp->lomask);
+    __m128i  lobits = _mm_cvtsi32_si128(ftp->lobits);
+    __m128i  one = _mm_set1_epi32(1);
+    __m128i  ramp = _mm_set_epi32((int32_t) (3u * uinc), (int32_t) (2u * uinc),
+                                  (int32_t) uinc, 0);
+    OSCV     vamp = oscv_set1(amp), lodiv = oscv_set1(ftp->lodiv);
+    OSCV     vsicvt = oscv_set1(sicvt);
+
+    for (; n + 4 <= nsmps; n += 4) {
+      __m128i ph, ndx;
+      OSCV    fract, v;
+      if (cpsp != NULL) {
+#if defined(USE_LRINT)
+        __m128i incs = _mm_set_epi32(MYFLT2LONG(cpsp[n+3] * sicvt),
+                                     MYFLT2LONG(cpsp[n+2] * sicvt),
+                                     MYFLT2LONG(cpsp[n+1] * sicvt),
+                                     MYFLT2LONG(cpsp[n] * sicvt));
+#else
+        /* MYFLT2LONG truncates, as the SSE2 conversions do */
+        __m128i incs = oscv_cvttrunc(oscv_mul(oscv_load(&cpsp[n]), vsicvt));
+#endif
+        /* running sum of the increments, shifted up one lane */
+        incs = _mm_add_epi32(incs, _mm_slli_si128(incs, 4));
+        incs = _mm_add_epi32(incs, _mm_slli_si128(incs, 8));
+        ph = _mm_add_epi32(_mm_set1_epi32((int32_t) phs),
+                           _mm_slli_si128(incs, 4));
+        phs += (uint32_t) _mm_cvtsi128_si32(_mm_shuffle_epi32(incs, 0xff));
+      }
+      else {
+        ph = _mm_add_epi32(_mm_set1_epi32((int32_t) phs), ramp);
+        phs += 4u * uinc;
+      }
+      ph = _mm_and_si128(ph, phmask);
+      ndx = _mm_srl_epi32(ph, lobits);
+      if (mode == 0)
+        v = oscv_gather(ftab, ndx);
+      else {
+        fract = oscv_mul(oscv_cvti(_mm_and_si128(ph, lomask)), lodiv);
+        if (mode == 1)
+          v = oscv_lerp(oscv_gather(ftab, ndx),
+                        oscv_gather(ftab, _mm_add_epi32(ndx, one)), fract);
+        else {
+          int32_t x[4], k;
+          MYFLT   m1[4], p2[4];
+          _mm_storeu_si128((__m128i*) x, ndx);
+          for (k = 0; k < 4; k++) {
+            m1[k] = (x[k] > 0 ? ftab[x[k] - 1] : ftab[flen - 1]);
+            p2[k] = (x[k] + 2 > flen ? ftab[1] : ftab[x[k] + 2]);
+          }
+          v = oscv_cubic(oscv_set4(m1[0], m1[1], m1[2], m1[3]),
+                         oscv_gather(ftab, ndx),
+                         oscv_gather(ftab, _mm_add_epi32(ndx, one)),
+                         oscv_set4(p2[0], p2[1], p2[2], p2[3]), fract);
+        }
+      }
+      v = oscv_mul(v, ampp != NULL ? oscv_load(&ampp[n]) : vamp);
+      oscv_store(&ar[n], v);
+    }
+    *pphs = (int32_t) (phs & PHMASK);
+    return n;
+}
+#endif
+
 int32_t koscil(CSOUND *csound, OSC *p)
 {
     FUNC    *ftp;
@@ -1245,7 +1327,11 @@ int32_t osckk(CSOUND *csound, OSC *p)
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
 
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), amp, NULL, ar, n, nsmps, 0);
+#endif
+    for (; n<nsmps; n++) {
       ar[n] = ftbl[phs >> lobits] * amp;
       /* phs += inc; */
       /* phs &= PHMASK; */
@@ -1281,7 +1367,11 @@ int32_t oscka(CSOUND *csound, OSC *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, amp, NULL, ar, n, nsmps, 0);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc = MYFLT2LONG(cpsp[n] * sicvt);
       ar[n] = ftbl[phs >> lobits] * amp;
       phs += inc;
@@ -1316,7 +1406,11 @@ int32_t oscak(CSOUND *csound, OSC *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), FL(0.0), ampp, ar, n, nsmps, 0);
+#endif
+    for (; n<nsmps; n++) {
       ar[n] = ftbl[phs >> lobits] * ampp[n];
       phs = (phs+inc) & PHMASK;
     }
@@ -1350,7 +1444,11 @@ int32_t oscaa(CSOUND *csound, OSC *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, FL(0.0), ampp, ar, n, nsmps, 0);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc = MYFLT2LONG(cpsp[n] * sicvt);
       ar[n] = ftbl[phs >> lobits] * ampp[n];
       phs = (phs+inc) & PHMASK;
@@ -1406,7 +1504,11 @@ int32_t osckki(CSOUND *csound, OSC   *p)
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
     ft = ftp->ftable;
-    for (n=offset; n<nsmps; n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), amp, NULL, ar, n, nsmps, 1);
+#endif
+    for (; n<nsmps; n++) {
       fract = PFRAC(phs);
       ftab = ft + (phs >> lobits);
       v1 = ftab[0];
@@ -1443,7 +1545,11 @@ int32_t osckai(CSOUND *csound, OSC   *p)
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
     ft = ftp->ftable;
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, amp, NULL, ar, n, nsmps, 1);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc;
       inc = MYFLT2LONG(cpsp[n] * sicvt);
       fract = PFRAC(phs);
@@ -1482,7 +1588,11 @@ int32_t oscaki(CSOUND *csound, OSC   *p)
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
     ft = ftp->ftable;
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), FL(0.0), ampp, ar, n, nsmps, 1);
+#endif
+    for (; n<nsmps; n++) {
       fract = (MYFLT) PFRAC(phs);
       ftab = ft + (phs >> lobits);
       v1 = ftab[0];
@@ -1519,7 +1629,11 @@ int32_t oscaai(CSOUND *csound, OSC   *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, FL(0.0), ampp, ar, n, nsmps, 1);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc;
       inc = MYFLT2LONG(cpsp[n] * sicvt);
       fract = (MYFLT) PFRAC(phs);
@@ -1600,7 +1714,11 @@ int32_t osckk3(CSOUND *csound, OSC   *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), amp, NULL, ar, n, nsmps, 3);
+#endif
+    for (; n<nsmps; n++) {
       fract = PFRAC(phs);
       x0 = (phs >> lobits);
       x0--;
@@ -1660,7 +1778,11 @@ int32_t oscka3(CSOUND *csound, OSC   *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, amp, NULL, ar, n, nsmps, 3);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc;
       inc = MYFLT2LONG(cpsp[n] * sicvt);
       fract = PFRAC(phs);
@@ -1715,7 +1837,11 @@ int32_t oscak3(CSOUND *csound, OSC   *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, inc, NULL, FL(0.0), FL(0.0), ampp, ar, n, nsmps, 3);
+#endif
+    for (; n<nsmps; n++) {
       fract = (MYFLT) PFRAC(phs);
       x0 = (phs >> lobits);
       x0--;
@@ -1769,7 +1895,11 @@ int32_t oscaa3(CSOUND *csound, OSC   *p)
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset;n<nsmps;n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = osc_simd(ftp, &phs, 0, cpsp, sicvt, FL(0.0), ampp, ar, n, nsmps, 3);
+#endif
+    for (; n<nsmps; n++) {
       int32_t inc = MYFLT2LONG(cpsp[n] * sicvt);
       fract = (MYFLT) PFRAC(phs);
       x0 = (phs >> lobits);
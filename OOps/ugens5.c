@@ -299,10 +299,73 @@ int32_t rsnset(CSOUND *csound, RESON *p)
       p->yt1 = p->yt2 = 0.0;
     p->asigf = IS_ASIG_ARG(p->kcf);
     p->asigw = IS_ASIG_ARG(p->kbw);
+    p->fct = fcoef_tables(csound);
 
     return OK;
 }
 
+/* reson coefficients from the cosine of the centre frequency and c3 */
+
+static inline void reson_coefs(int32_t scale, double cosf, double c3,
+                               double *c1, double *c2)
+{
+    double  c3p1 = c3 + 1.0, c3t4 = c3 * 4.0, omc3 = 1.0 - c3, c2sqr;
+
+    *c2 = c3t4 * cosf / c3p1;                           /* -B, so + below */
+    c2sqr = *c2 * *c2;
+    if (scale == 1)
+      *c1 = omc3 * sqrt(1.0 - c2sqr / c3t4);
+    else if (scale == 2)
+      *c1 = sqrt((c3p1*c3p1-c2sqr) * omc3/c3p1);
+    else *c1 = 1.0;
+}
+
+/* reson with k-rate parameters and --smooth-filters: coefficients from
+   the cache, ramped over the cycle when the parameters change */
+
+static int32_t reson_smooth(CSOUND *csound, RESON *p)
+{
+    uint32_t    offset = p->h.insdshead->ksmps_offset;
+    uint32_t    early  = p->h.insdshead->ksmps_no_end;
+    uint32_t    n, nsmps = CS_KSMPS;
+    MYFLT       *ar = p->ar, *asig = p->asig;
+    double      yt0, yt1 = p->yt1, yt2 = p->yt2;
+    double      c1 = p->c1, c2 = p->c2, c3 = p->c3;
+    double      d1 = 0.0, d2 = 0.0, d3 = 0.0;
+
+    if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    if (*p->kcf != (MYFLT)p->prvcf || *p->kbw != (MYFLT)p->prvbw) {
+      int32_t first = (p->prvcf == -100.0);
+      double  t1, t2, t3;
+      p->prvcf = (double)*p->kcf;
+      p->prvbw = (double)*p->kbw;
+      p->cosf = fcoef_cos2pi(p->fct, p->prvcf * csound->onedsr);
+      t3 = fcoef_exp2pi(p->fct, p->prvbw * csound->onedsr);
+      reson_coefs(p->scale, p->cosf, t3, &t1, &t2);
+      if (first || nsmps <= offset) {
+        c1 = t1; c2 = t2; c3 = t3;
+      }
+      else {
+        double r = 1.0 / (double) (nsmps - offset);
+        d1 = (t1 - c1) * r; d2 = (t2 - c2) * r; d3 = (t3 - c3) * r;
+      }
+      p->c1 = t1; p->c2 = t2; p->c3 = t3;
+    }
+    for (n=offset; n<nsmps; n++) {
+      c1 += d1; c2 += d2; c3 += d3;
+      yt0 = c1 * ((double)asig[n]) + c2 * yt1 - c3 * yt2;
+      ar[n] = (MYFLT)yt0;
+      yt2 = yt1;
+      yt1 = yt0;
+    }
+    p->yt1 = yt1; p->yt2 = yt2; /* Write back for next cycle */
+    return OK;
+}
+
 int32_t krsnset(CSOUND *csound, RESON *p){ return rsnset(csound,p); }
 
 int32_t kreson(CSOUND *csound, RESON *p)
@@ -314,12 +377,16 @@ int32_t kreson(CSOUND *csound, RESON *p)
 
     if (*p->kcf != (MYFLT)p->prvcf) {
       p->prvcf = (double)*p->kcf;
-      p->cosf = cos(p->prvcf * (double)(CS_ONEDKR *TWOPI));
+      p->cosf = (p->fct != NULL ?
+                 fcoef_cos2pi(p->fct, p->prvcf * (double)CS_ONEDKR) :
+                 cos(p->prvcf * (double)(CS_ONEDKR *TWOPI)));
       flag = 1;                 /* Mark as changed */
     }
     if (*p->kbw != (MYFLT)p->prvbw) {
       p->prvbw = (double)*p->kbw;
-      c3 = p->c3 = exp(p->prvbw * (double)(-CS_ONEDKR *TWOPI));
+      c3 = p->c3 = (p->fct != NULL ?
+                    fcoef_exp2pi(p->fct, p->prvbw * (double)CS_ONEDKR) :
+                    exp(p->prvbw * (double)(-CS_ONEDKR *TWOPI)));
       flag = 1;                /* Mark as changed */
     }
     if (flag) {
@@ -354,6 +421,8 @@ int32_t reson(CSOUND *csound, RESON *p)
     int32_t     asigf = p->asigf;
     int32_t     asigw = p->asigw;
 
+    if (p->fct != NULL && !asigf && !asigw)
+      return reson_smooth(csound, p);
     asig = p->asig;
     ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
@@ -368,12 +437,16 @@ int32_t reson(CSOUND *csound, RESON *p)
       MYFLT bw = asigw ? p->kbw[n] : *p->kbw;
       if (cf != (MYFLT)p->prvcf) {
         p->prvcf = (double)cf;
-        p->cosf = cos(cf * (double)(csound->tpidsr));
+        p->cosf = (p->fct != NULL ?
+                   fcoef_cos2pi(p->fct, (double)cf * csound->onedsr) :
+                   cos(cf * (double)(csound->tpidsr)));
         flag = 1;                 /* Mark as changed */
       }
       if (bw != (MYFLT)p->prvbw) {
         p->prvbw = (double)bw;
-        c3 = p->c3 = exp(bw * (double)(csound->mtpdsr));
+        c3 = p->c3 = (p->fct != NULL ?
+                      fcoef_exp2pi(p->fct, (double)bw * csound->onedsr) :
+                      exp(bw * (double)(csound->mtpdsr)));
         flag = 1;                /* Mark as changed */
       }
       if (flag) {
@@ -24,6 +24,7 @@
 
 #include "csoundCore.h" /*                              UGENS6.C        */
 #include "ugens6.h"
+#include "dline.h"
 #include <math.h>
 
 #define log001 (-FL(6.9078))    /* log(.001) */
@@ -489,58 +490,71 @@ int32_t deltap(CSOUND *csound, DELTAP *p)
                              Str("deltap: not initialised"));
 }
 
-int32_t deltapi(CSOUND *csound, DELTAP *p)
+/* position i of the delayr buffer, wrapped */
+static inline int32_t tap_wrap(int32_t i, int32_t npts)
+{
+    while (UNLIKELY(i < 0)) i += npts;
+    while (UNLIKELY(i >= npts)) i -= npts;
+    return i;
+}
+
+/* deltapi and deltap3: interpolated taps towards the older sample,
+   through the shared delay line reads; NOTOK on an infinite delay */
+static int32_t deltap_interp(CSOUND *csound, DELTAP *p, int32_t cubic)
 {
     DELAYR      *q = p->delayr;
-    MYFLT       *ar, *tap, *prv, *begp, *endp;
+    MYFLT       *ar = p->ar;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
-    int32_t       idelsmps;
+    int32_t       idelsmps, curi;
     MYFLT       delsmps, delfrac;
+    DLINE       dl;
 
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1;
-    ar = p->ar;
     if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
     }
-    begp = (MYFLT *) q->auxch.auxp;
-    endp = (MYFLT *) q->auxch.endp;
+    if (UNLIKELY(offset >= nsmps)) return OK;
+    dline_view(&dl, (MYFLT *) q->auxch.auxp, (int32_t) q->npts);
+    curi = (int32_t) (q->curp - dl.buf);
     if (!IS_ASIG_ARG(p->xdlt)) {
-      if (*p->xdlt == INFINITY) goto err2;
+      if (UNLIKELY(*p->xdlt == INFINITY)) return NOTOK;
       delsmps = *p->xdlt * csound->esr;
       idelsmps = (int32_t)delsmps;
       delfrac = delsmps - idelsmps;
-      tap = q->curp - idelsmps;
-      while (tap < begp) tap += q->npts;
-      for (n=offset; n<nsmps; n++) {
-        if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        ar[n] = *tap + (*prv - *tap) * delfrac;
-        tap++;
-      }
+      curi = tap_wrap(curi - idelsmps, dl.size);
+      if (cubic)
+        dline_cub_k(&dl, curi, -1, delfrac, &ar[offset], nsmps - offset);
+      else
+        dline_lin_k(&dl, curi, -1, delfrac, &ar[offset], nsmps - offset);
     }
     else {
-      MYFLT *timp = p->xdlt, *curq = q->curp;
-      for (n=offset; n<nsmps; n++) {
-        if (timp[n] == INFINITY) goto err2;
-        delsmps = timp[n] * csound->esr;
-        idelsmps = (int32_t)delsmps;
-        delfrac = delsmps - idelsmps;
-        tap = curq++ - idelsmps;
-        if (UNLIKELY(tap < begp)) tap += q->npts;
-        else if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        ar[n] = *tap + (*prv - *tap) * delfrac;
+      MYFLT   *timp = p->xdlt, frac[DLINE_CHUNK];
+      int32_t ndx[DLINE_CHUNK];
+      for (n = offset; n < nsmps; n += DLINE_CHUNK) {
+        int32_t k, m = (int32_t) (nsmps - n);
+        if (m > DLINE_CHUNK) m = DLINE_CHUNK;
+        for (k = 0; k < m; k++) {
+          if (UNLIKELY(timp[n + k] == INFINITY)) return NOTOK;
+          delsmps = timp[n + k] * csound->esr;
+          idelsmps = (int32_t)delsmps;
+          frac[k] = delsmps - idelsmps;
+          ndx[k] = tap_wrap(curi++ - idelsmps, dl.size);
+        }
+        if (cubic) dline_cub_a(&dl, ndx, frac, -1, &ar[n], m);
+        else       dline_lin_a(&dl, ndx, frac, -1, &ar[n], m);
       }
     }
     return OK;
+}
+
+int32_t deltapi(CSOUND *csound, DELTAP *p)
+{
+    if (UNLIKELY(p->delayr->auxch.auxp==NULL)) goto err1;
+    if (UNLIKELY(deltap_interp(csound, p, 0) != OK)) goto err2;
+    return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
                               Str("deltapi: not initialised"));
@@ -605,83 +619,8 @@ int32_t deltapn(CSOUND *csound, DELTAP *p)
 /* **** JPff **** */
 int32_t deltap3(CSOUND *csound, DELTAP *p)
 {
-    DELAYR      *q = p->delayr;
-    MYFLT       *ar, *tap, *prv, *begp, *endp;
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t       idelsmps;
-    MYFLT       delsmps, delfrac;
-
-    if (UNLIKELY(q->auxch.auxp==NULL)) goto err1;
-    ar = p->ar;
-    if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
-    }
-    begp = (MYFLT *) q->auxch.auxp;
-    endp = (MYFLT *) q->auxch.endp;
-    if (!IS_ASIG_ARG(p->xdlt)) {
-      if (*p->xdlt == INFINITY) goto err2;
-      delsmps = *p->xdlt * csound->esr;
-      idelsmps = (int32_t)delsmps;
-      delfrac = delsmps - idelsmps;
-      tap = q->curp - idelsmps;
-      while (tap < begp) tap += q->npts;
-      for (n=offset; n<nsmps; n++) {
-        MYFLT ym1, y0, y1, y2;
-        if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        if (UNLIKELY(prv - 1 < begp))
-          y2 = *(prv-1+q->npts);
-        else
-          y2 = *(prv-1);
-        if (UNLIKELY(tap + 1 >= endp))
-          ym1 = *(tap+1-q->npts);
-        else
-          ym1 = *(tap+1);
-        y0 = *tap; y1 = *prv;
-        {
-          MYFLT w, x, y, z;
-          z = delfrac * delfrac; z--; z *= FL(0.16666666666667);
-          y = delfrac; y++; w = (y *= FL(0.5)); w--;
-          x = FL(3.0) * z; y -= x; w -= z; x -= delfrac;
-          ar[n] = (w*ym1 + x*y0 + y*y1 + z*y2) * delfrac + y0;
-        }
-        tap++;
-      }
-    }
-    else {
-      MYFLT *timp = p->xdlt, *curq = q->curp;
-      for (n=offset; n<nsmps; n++) {
-        MYFLT ym1, y0, y1, y2;
-        if (timp[n] == INFINITY) goto err2;
-        delsmps = *timp++ * csound->esr;
-        idelsmps = (int32_t)delsmps;
-        delfrac = delsmps - idelsmps;
-        if (UNLIKELY((tap = curq++ - idelsmps) < begp))
-          tap += q->npts;
-        else if (UNLIKELY(tap >= endp))
-          tap -= q->npts;
-        if (UNLIKELY((prv = tap - 1) < begp))
-          prv += q->npts;
-        if (UNLIKELY(prv - 1 < begp)) y2 = *(prv-1+q->npts);
-        else                          y2 = *(prv-1);
-        if (UNLIKELY(tap + 1 >= endp)) ym1 = *(tap+1-q->npts);
-        else                           ym1 = *(tap+1);
-        y0 = *tap; y1 = *prv;
-        {
-          MYFLT w, x, y, z;
-          z = delfrac * delfrac; z--; z *= FL(0.1666666667);
-          y = delfrac; y++; w = (y *= FL(0.5)); w--;
-          x = FL(3.0) * z; y -= x; w -= z; x -= delfrac;
-          ar[n] = (w*ym1 + x*y0 + y*y1 + z*y2) * delfrac + y0;
-        }
-      }
-    }
+    if (UNLIKELY(p->delayr->auxch.auxp==NULL)) goto err1;
+    if (UNLIKELY(deltap_interp(csound, p, 1) != OK)) goto err2;
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
@@ -689,7 +628,6 @@ int32_t deltap3(CSOUND *csound, DELTAP *p)
   err2:
     return csound->PerfError(csound, &(p->h),
                               Str("deltapi: INF delaytime"));
-
 }
 
 
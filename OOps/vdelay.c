@@ -30,20 +30,65 @@
 
 #include <math.h>
 #include "vdelay.h"
+#include "dline.h"
 
 //#define ESR     (csound->esr/FL(1000.0))
 #define ESR     (csound->esr*FL(0.001))
 
+/* The vdelay family keeps its samples in power-of-two lines (see
+   dline.h), long enough to take a block of writes ahead of the longest
+   delay.  Each block is written first and then read.  Delays still wrap
+   modulo the nominal length, as they did in the old ring buffers. */
+
+/* buffer position of the sample written age samples before position i,
+   the age taken modulo the nominal length len */
+static inline int32_t vdel_ndx(const DLINE *d, int32_t i, int32_t len,
+                               int32_t age)
+{
+    age %= len;
+    if (age < 0) age += len;
+    return (i - age) & d->mask;
+}
+
+/* a delay of dsmps samples, wrapped into [0, len), as a whole number of
+   samples back and a fraction towards the next newer sample */
+static inline int32_t vdel_age(MYFLT dsmps, int32_t len, MYFLT *frac)
+{
+    MYFLT   q = -dsmps;
+    int32_t ip;
+
+    while (UNLIKELY(q <= -(MYFLT)len)) q += (MYFLT)len;
+    while (UNLIKELY(q > FL(0.0))) q -= (MYFLT)len;
+    ip = (int32_t)q;
+    if ((MYFLT)ip > q) ip--;
+    *frac = q - (MYFLT)ip;
+    return -ip;
+}
+
+/* one output, for ages whose interpolation points wrap */
+static MYFLT vdel_wrapped(const DLINE *d, int32_t i, int32_t len,
+                          int32_t age, MYFLT frac, int32_t cubic)
+{
+    MYFLT y0 = d->buf[vdel_ndx(d, i, len, age)];
+    MYFLT y1 = d->buf[vdel_ndx(d, i, len, age - 1)];
+
+    if (!cubic)
+      return dline_lin1(y0, y1, frac);
+    return dline_cub1(d->buf[vdel_ndx(d, i, len, age + 1)], y0, y1,
+                      d->buf[vdel_ndx(d, i, len, age - 2)], frac);
+}
+
 int32_t vdelset(CSOUND *csound, VDEL *p)            /*  vdelay set-up   */
 {
     uint32 n = (int32_t)(*p->imaxd * ESR)+1;
+    uint32 size = dline_pow2(n + CS_KSMPS);
 
     if (!*p->istod) {
-      if (p->aux.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux.size)
+      if (p->aux.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux.size)
         /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux);
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux);
       else {     /*    make sure buffer is empty       */
-        memset(p->aux.auxp, '\0', n*sizeof(MYFLT));
+        memset(p->aux.auxp, '\0', p->aux.size);
       }
       p->left = 0;
     }
@@ -51,94 +96,75 @@ int32_t vdelset(CSOUND *csound, VDEL *p)            /*  vdelay set-up   */
     return OK;
 }
 
-int32_t vdelay(CSOUND *csound, VDEL *p)               /*      vdelay  routine */
+static int32_t vdel_perf(CSOUND *csound, VDEL *p, int32_t cubic)
 {
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t nn, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
+    int32_t  len, indx, lo, hi;
     MYFLT *out = p->sr;     /* assign object data to local variables   */
-    MYFLT *in = p->ain;
     MYFLT *del = p->adel;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
     MYFLT esr = ESR;
-
-    if (UNLIKELY(buf==NULL)) goto err1;        /* RWD fix */
-    maxd = p->maxd;
+    DLINE dl;
+
+    dline_view(&dl, (MYFLT *)p->aux.auxp,
+               (int32_t)(p->aux.size / sizeof(MYFLT)));
+    len = (p->maxd > 0 ? (int32_t)p->maxd : 1);  /* Degenerate case */
+    if (len < 4) cubic = 0;
+    lo = (cubic ? 2 : 1);                        /* ages read without wrap */
+    hi = (cubic ? len - 2 : len - 1);
     indx = p->left;
     if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
+    if (UNLIKELY(offset >= nsmps)) return OK;
+    p->left = dline_write(&dl, indx, &p->ain[offset], nsmps - offset);
 
     if (IS_ASIG_ARG(p->adel)) {          /*      if delay is a-rate      */
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1, fv2;
-        int32_t   v1, v2;
-
-        buf[indx] = in[nn];
-        fv1 = indx - (del[nn]) * esr;
-        /* Make sure Inside the buffer      */
-        /*
-         * The following has been fixed by adding a cast and making a
-         * ">=" instead of a ">" comparison. The order of the comparisons
-         * has been swapped as well (a bit of a nit, but comparing a
-         * possibly negative number to an unsigned isn't a good idea--and
-         * broke on Alpha).
-         * heh 981101
-         */
-        while (UNLIKELY(fv1 < FL(0.0)))
-          fv1 += (MYFLT)maxd;
-        while (UNLIKELY(fv1 >= (MYFLT)maxd))
-          fv1 -= (MYFLT)maxd;
-
-        if (LIKELY(fv1 < maxd - 1)) /* Find next sample for interpolation      */
-          fv2 = fv1 + FL(1.0);
-        else
-          fv2 = FL(0.0);
-
-        v1 = (int32_t)fv1;
-        v2 = (int32_t)fv2;
-        out[nn] = buf[v1] + (fv1 - v1) * ( buf[v2] - buf[v1]);
-
-        if (UNLIKELY(++indx == maxd))
-          indx = 0;             /* Advance current pointer */
-
+      int32_t ndx[DLINE_CHUNK], wrp[DLINE_CHUNK];
+      MYFLT   frac[DLINE_CHUNK], wval[DLINE_CHUNK];
+      for (nn = offset; nn < nsmps; nn += DLINE_CHUNK) {
+        int32_t k, m = (int32_t)(nsmps - nn), nw = 0;
+        if (m > DLINE_CHUNK) m = DLINE_CHUNK;
+        for (k = 0; k < m; k++, indx++) {
+          int32_t age = vdel_age(del[nn + k] * esr, len, &frac[k]);
+          ndx[k] = (indx - age) & dl.mask;
+          if (UNLIKELY(age < lo || age > hi)) {
+            wval[nw] = vdel_wrapped(&dl, indx, len, age, frac[k], cubic);
+            wrp[nw++] = k;
+          }
+        }
+        if (cubic) dline_cub_a(&dl, ndx, frac, 1, &out[nn], m);
+        else       dline_lin_a(&dl, ndx, frac, 1, &out[nn], m);
+        while (nw--)
+          out[nn + wrp[nw]] = wval[nw];
       }
     }
     else {                      /* and, if delay is k-rate */
-      MYFLT fdel=*del;
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1, fv2;
-        int32_t   v1, v2;
-
-        buf[indx] = in[nn];
-        fv1 = indx - fdel * esr;
-        /* Make sure inside the buffer      */
-        /*
-         * See comment above--same fix applied here.  heh 981101
-         */
-        while (UNLIKELY(fv1 < FL(0.0)))
-          fv1 += (MYFLT)maxd;
-        while (UNLIKELY(fv1 >= (MYFLT)maxd))
-          fv1 -= (MYFLT)maxd;
-
-        if (LIKELY(fv1 < maxd - 1)) /* Find next sample for interpolation      */
-          fv2 = fv1 + FL(1.0);
+      MYFLT   frac;
+      int32_t age = vdel_age(*del * esr, len, &frac);
+      if (LIKELY(age >= lo && age <= hi)) {
+        if (cubic)
+          dline_cub_k(&dl, (indx - age) & dl.mask, 1, frac, &out[offset],
+                      nsmps - offset);
         else
-          fv2 = FL(0.0);
-
-        v1 = (int32_t)fv1;
-        v2 = (int32_t)fv2;
-        out[nn] = buf[v1] + (fv1 - v1) * ( buf[v2] - buf[v1]);
-
-        if (UNLIKELY(++indx == maxd)) indx = 0;   /*      Advance current pointer */
-
+          dline_lin_k(&dl, (indx - age) & dl.mask, 1, frac, &out[offset],
+                      nsmps - offset);
+      }
+      else {
+        for (nn = offset; nn < nsmps; nn++, indx++)
+          out[nn] = vdel_wrapped(&dl, indx, len, age, frac, cubic);
       }
     }
-    p->left = indx;             /*      and keep track of where you are */
     return OK;
+}
+
+int32_t vdelay(CSOUND *csound, VDEL *p)               /*      vdelay  routine */
+{
+    if (UNLIKELY(p->aux.auxp==NULL)) goto err1;        /* RWD fix */
+    return vdel_perf(csound, p, 0);
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("vdelay: not initialised"));
@@ -146,110 +172,8 @@ int32_t vdelay(CSOUND *csound, VDEL *p)               /*      vdelay  routine */
 
 int32_t vdelay3(CSOUND *csound, VDEL *p)    /*  vdelay routine with cubic interp */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out = p->sr;  /* assign object data to local variables   */
-    MYFLT *in = p->ain;
-    MYFLT *del = p->adel;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
-    MYFLT esr = ESR;
-
-    if (UNLIKELY(buf==NULL)) goto err1;            /* RWD fix */
-    maxd = p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    if (IS_ASIG_ARG(p->adel)) {              /*      if delay is a-rate      */
-      for (nn=offset; nn<nsmps; nn++) {
-        MYFLT  fv1;
-        int32_t   v0, v1, v2, v3;
-
-        buf[indx] = in[nn];      /* IV Oct 2001 */
-        fv1 = del[nn] * (-esr);
-        v1 = (int32_t)fv1;
-        fv1 -= (MYFLT) v1;
-        v1 += (int32_t)indx;
-        /* Make sure Inside the buffer      */
-        if ((v1 < 0L) || (fv1 < FL(0.0))) {
-          fv1++; v1--; while (UNLIKELY(v1 < 0L)) v1 += (int32_t)maxd;
-        }
-        else {
-          while (UNLIKELY(v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-        }
-        /* Find next sample for interpolation      */
-        v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-
-        if (maxd<4) {
-          out[nn] = buf[v1] + fv1 * (buf[v2] - buf[v1]);
-        }
-        else {
-          v0 = (v1==0 ? maxd-1 : v1-1);
-          v3 = (v2==(int32_t)maxd-1 ? 0 : v2+1);
-          {                     /* optimized by Istvan Varga (Oct 2001) */
-            MYFLT w, x, y, z;
-            z = fv1 * fv1; z--; z *= FL(0.1666666667);
-            y = fv1; y++; w = (y *= FL(0.5)); w--;
-            x = FL(3.0) * z; y -= x; w -= z; x -= fv1;
-            out[nn] = (w*buf[v0] + x*buf[v1] + y*buf[v2] + z*buf[v3])
-              * fv1 + buf[v1];
-          }
-        }
-        if (UNLIKELY(++indx == maxd))
-          indx = 0;             /* Advance current pointer */
-
-      };
-    }
-    else {                      /* and, if delay is k-rate */
-      MYFLT  fv1, w, x, y, z;
-      int32_t   v0, v1, v2, v3;
-
-      fv1 = *del * -esr; v1 = (int32_t)fv1; fv1 -= (MYFLT) v1;
-      v1 += (int32_t)indx;
-      /* Make sure Inside the buffer      */
-      if ((v1 < 0L) || (fv1 < FL(0.0))) {
-        fv1++; v1--; while (UNLIKELY(v1 < 0L)) v1 += (int32_t)maxd;
-      }
-      else {
-        while (UNLIKELY(v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-      }
-
-      if (maxd<4) {
-        for (nn=offset; nn<nsmps; nn++) {
-          /* Find next sample for interpolation      */
-          v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-          out[nn] = buf[v1] + fv1 * (buf[v2] - buf[v1]);
-          if (UNLIKELY(++v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-              if (UNLIKELY(++indx >= maxd)) indx -= maxd;
-        }
-      }
-      else {
-        /* calculate interpolation coeffs */
-        z = fv1 * fv1; z--; z *= FL(0.1666666667);      /* IV Oct 2001 */
-        y = fv1; y++; w = (y *= FL(0.5)); w--;
-        x = FL(3.0) * z; y -= x; w -= z; x -= fv1;
-        for (nn=offset; nn<nsmps; nn++) {
-          buf[indx] = in[nn];
-          /* Find next sample for interpolation      */
-          v2 = (v1 == (int32_t)(maxd - 1UL) ? 0L : v1 + 1L);
-          v0 = (v1 == 0L ? (int32_t)(maxd - 1UL) : v1 - 1L);
-          v3 = (v2 == (int32_t)(maxd - 1UL) ? 0L : v2 + 1L);
-          out[nn] = (w*buf[v0] + x*buf[v1] + y*buf[v2] + z*buf[v3])
-                     * fv1 + buf[v1];
-          if (UNLIKELY(++v1 >= (int32_t)maxd)) v1 -= (int32_t)maxd;
-          if (UNLIKELY(++indx >= maxd))
-            indx -= maxd;     /* Advance current pointer */
-        }
-      }
-    }
-    p->left = indx;             /*      and keep track of where you are */
-    return OK;
+    if (UNLIKELY(p->aux.auxp==NULL)) goto err1;            /* RWD fix */
+    return vdel_perf(csound, p, 1);
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("vdelay3: not initialised"));
@@ -261,15 +185,17 @@ int32_t vdelay3(CSOUND *csound, VDEL *p)    /*  vdelay routine with cubic interp
 int32_t vdelxset(CSOUND *csound, VDELX *p)      /*  vdelayx set-up (1 channel) */
 {
     uint32_t n = (int32_t)(*p->imaxd * csound->esr);
+    uint32_t size;
 
     if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
+    size = dline_pow2(n + CS_KSMPS);
 
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
+      if (p->aux1.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux1.size)
         /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux1);
       else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
+        memset(p->aux1.auxp, 0, p->aux1.size);
       p->left = 0;
       p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
       p->interp_size = (p->interp_size < 4 ? 4 : p->interp_size);
@@ -282,19 +208,21 @@ int32_t vdelxset(CSOUND *csound, VDELX *p)      /*  vdelayx set-up (1 channel) *
 int32_t vdelxsset(CSOUND *csound, VDELXS *p)    /*  vdelayxs set-up (stereo) */
 {
     uint32_t n = (int32_t)(*p->imaxd * csound->esr);
+    uint32_t size;
 
     if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
+    size = dline_pow2(n + CS_KSMPS);
 
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
+      if (p->aux1.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux1.size)
         /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux1);
       else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux2.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux2.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux2);
+        memset(p->aux1.auxp, 0, p->aux1.size);
+      if (p->aux2.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux2.size)
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux2);
       else
-        memset(p->aux2.auxp, 0, n*sizeof(MYFLT));
+        memset(p->aux2.auxp, 0, p->aux2.size);
 
       p->left = 0;
       p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
@@ -308,27 +236,29 @@ int32_t vdelxsset(CSOUND *csound, VDELXS *p)    /*  vdelayxs set-up (stereo) */
 int32_t vdelxqset(CSOUND *csound, VDELXQ *p) /* vdelayxq set-up (quad channels) */
 {
     uint32_t n = (int32_t)(*p->imaxd * csound->esr);
+    uint32_t size;
 
     if (UNLIKELY(n == 0)) n = 1;          /* fix due to Troxler */
+    size = dline_pow2(n + CS_KSMPS);
 
     if (!*p->istod) {
-      if (p->aux1.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux1.size)
+      if (p->aux1.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux1.size)
         /* allocate space for delay buffer */
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux1);
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux1);
       else
-        memset(p->aux1.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux2.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux2.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux2);
+        memset(p->aux1.auxp, 0, p->aux1.size);
+      if (p->aux2.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux2.size)
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux2);
       else
-        memset(p->aux2.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux3.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux3.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux3);
+        memset(p->aux2.auxp, 0, p->aux2.size);
+      if (p->aux3.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux3.size)
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux3);
       else
-        memset(p->aux3.auxp, 0, n*sizeof(MYFLT));
-      if (p->aux4.auxp == NULL || (uint32_t)(n * sizeof(MYFLT)) > p->aux4.size)
-        csound->AuxAlloc(csound, n * sizeof(MYFLT), &p->aux4);
+        memset(p->aux3.auxp, 0, p->aux3.size);
+      if (p->aux4.auxp == NULL || (uint32_t)(size * sizeof(MYFLT)) > p->aux4.size)
+        csound->AuxAlloc(csound, size * sizeof(MYFLT), &p->aux4);
       else
-        memset(p->aux4.auxp, 0, n*sizeof(MYFLT));
+        memset(p->aux4.auxp, 0, p->aux4.size);
 
       p->left = 0;
       p->interp_size = 4 * (int32_t) (FL(0.5) + FL(0.25) * *(p->iquality));
@@ -339,72 +269,141 @@ int32_t vdelxqset(CSOUND *csound, VDELXQ *p) /* vdelayxq set-up (quad channels)
     return OK;
 }
 
-int32_t vdelayx(CSOUND *csound, VDELX *p)               /*      vdelayx routine  */
+/* window of the sinc interpolation: 2 * i2 weights with alternating
+   signs, the first for the sample i2 - 1 before the read position */
+static void vdelx_window(double *wt, int32_t i2, double x1, double d2x)
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t nn, nsmps = CS_KSMPS;
-    int32_t indx, maxd;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *in1 = p->ain1;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1;
-    int32_t   i, i2, xpos;
+    double  w, d = (double)(1 - i2) - x1;
+    int32_t i;
 
-    if (UNLIKELY(buf1 == NULL)) goto err1;                          /* RWD fix */
-    maxd = p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
+    for (i = 0; i < 2 * i2; i += 2) {
+      w = 1.0 - d*d*d2x; w *= (w / d++); wt[i] = w;
+      w = 1.0 - d*d*d2x; w *= (w / d++); wt[i + 1] = -w;
+    }
+}
+
+/* the windowed sums of all channels, accumulated together while the
+   window does not wrap */
+static inline void vdelx_dot(const DLINE *dl, int32_t nch, int32_t start,
+                             const double *wt, int32_t n, double *acc)
+{
+    int32_t c, i;
+
+    if (UNLIKELY(start + n > dl[0].size)) {
+      for (c = 0; c < nch; c++)
+        acc[c] = dline_dot(&dl[c], start, wt, n);
+      return;
+    }
+    if (nch == 1) {
+      const MYFLT *y1 = dl[0].buf + start;
+      double  n1 = 0.0;
+      for (i = 0; i < n; i++) n1 += (double)y1[i] * wt[i];
+      acc[0] = n1;
+    }
+    else if (nch == 2) {
+      const MYFLT *y1 = dl[0].buf + start, *y2 = dl[1].buf + start;
+      double  n1 = 0.0, n2 = 0.0;
+      for (i = 0; i < n; i++) {
+        n1 += (double)y1[i] * wt[i]; n2 += (double)y2[i] * wt[i];
+      }
+      acc[0] = n1; acc[1] = n2;
+    }
+    else {
+      const MYFLT *y1 = dl[0].buf + start, *y2 = dl[1].buf + start;
+      const MYFLT *y3 = dl[2].buf + start, *y4 = dl[3].buf + start;
+      double  n1 = 0.0, n2 = 0.0, n3 = 0.0, n4 = 0.0;
+      for (i = 0; i < n; i++) {
+        n1 += (double)y1[i] * wt[i]; n2 += (double)y2[i] * wt[i];
+        n3 += (double)y3[i] * wt[i]; n4 += (double)y4[i] * wt[i];
+      }
+      acc[0] = n1; acc[1] = n2; acc[2] = n3; acc[3] = n4;
+    }
+}
+
+/* the vdelayx, vdelayxs and vdelayxq reads: nch channels sharing one
+   delay */
+static int32_t vdelx_perf(CSOUND *csound, OPDS *h, int32_t nch,
+                          MYFLT **out, MYFLT **in, AUXCH **aux, MYFLT *del,
+                          uint32 maxd, int32_t wsize, int32 *left)
+{
+    uint32_t offset = h->insdshead->ksmps_offset;
+    uint32_t early  = h->insdshead->ksmps_no_end;
+    uint32_t n, nsmps = h->insdshead->ksmps;
+    int32_t  len, indx, i2, c;
+    double   d2x, esr = (double)csound->esr;
+    double   wt[1024];
+    DLINE    dl[4];
+
+    len = (maxd > 0 ? (int32_t)maxd : 1);   /* Degenerate case */
     i2 = (wsize >> 1);
     d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-    if (UNLIKELY(offset)) memset(out1, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
+    for (c = 0; c < nch; c++) {
+      if (UNLIKELY(offset)) memset(out[c], '\0', offset*sizeof(MYFLT));
+      if (UNLIKELY(early))
+        memset(&out[c][nsmps - early], '\0', early*sizeof(MYFLT));
     }
+    nsmps -= early;
+    if (UNLIKELY(offset >= nsmps)) return OK;
+    indx = *left;
+    for (c = 0; c < nch; c++) {
+      dline_view(&dl[c], (MYFLT *)aux[c]->auxp,
+                 (int32_t)(aux[c]->size / sizeof(MYFLT)));
+      dline_write(&dl[c], indx, &in[c][offset], nsmps - offset);
+    }
+    *left = (indx + (int32_t)(nsmps - offset)) & dl[0].mask;
 
-    for (nn=offset; nn<nsmps; nn++) {
-      buf1[indx] = in1[nn];
-      n1 = 0.0;
-
+    for (n = offset; n < nsmps; n++, indx++) {
       /* x1: fractional part of delay time */
       /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
+      /* age: whole samples back to the read position */
+      double  x1, x2, q = -((double)del[n] * esr);
+      int32_t ip, age;
 
-      x1 = (double)indx - ((double)del[nn] * (double)csound->esr);
-      while (x1 < 0.0) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (xpos >= maxd) xpos -= maxd;
+      while (UNLIKELY(q <= -(double)len)) q += (double)len;
+      while (UNLIKELY(q > 0.0)) q -= (double)len;
+      ip = (int32_t)q;
+      if ((double)ip > q) ip--;
+      x1 = q - (double)ip; age = -ip;
 
       if (x1 * (1.0 - x1) > 0.00000001) {
-        xpos += (1 - i2);
-        while (xpos < 0) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
+        x2 = sin (PI * x1) / PI;
+        vdelx_window(wt, i2, x1, d2x);
+        if (LIKELY(age >= i2 && age <= len - i2)) {
+          int32_t start = (indx - (age - 1 + i2)) & dl[0].mask;
+          double  acc[4];
+          vdelx_dot(dl, nch, start, wt, 2*i2, acc);
+          for (c = 0; c < nch; c++)
+            out[c][n] = (MYFLT)(acc[c] * x2);
+        }
+        else {                          /* window wraps the nominal length */
+          for (c = 0; c < nch; c++) {
+            double  n1 = 0.0;
+            int32_t i;
+            for (i = 0; i < 2*i2; i++)
+              n1 += (double)dl[c].buf[vdel_ndx(&dl[c], indx, len,
+                                                age - 1 + i2 - i)] * wt[i];
+            out[c][n] = (MYFLT)(n1 * x2);
+          }
         }
-        out1[nn] = (MYFLT) (n1 * x2);
       }
       else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);      /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[nn] = buf1[xpos];
+        int32_t i = vdel_ndx(&dl[0], indx, len, (x1 < 0.5 ? age : age - 1));
+        for (c = 0; c < nch; c++)
+          out[c][n] = dl[c].buf[i];
       }
-
-      if (UNLIKELY(++indx == maxd)) indx = 0;
     }
-
-    p->left = indx;
     return OK;
+}
+
+int32_t vdelayx(CSOUND *csound, VDELX *p)               /*      vdelayx routine  */
+{
+    MYFLT   *out[1] = { p->sr1 };
+    MYFLT   *in[1] = { p->ain1 };
+    AUXCH   *aux[1] = { &p->aux1 };
+
+    if (UNLIKELY(p->aux1.auxp == NULL)) goto err1;          /* RWD fix */
+    return vdelx_perf(csound, &(p->h), 1, out, in, aux, p->adel, p->maxd,
+                      p->interp_size, &p->left);
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("vdelay: not initialised"));
@@ -481,77 +480,13 @@ int32_t vdelayxw(CSOUND *csound, VDELX *p)      /*      vdelayxw routine  */
 
 int32_t vdelayxs(CSOUND *csound, VDELXS *p)     /*      vdelayxs routine  */
 {
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2;
-    int32_t   i, i2, xpos;
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL))) goto err1; /* RWD fix */
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=offset; n<nsmps; n++) {
-      buf1[indx] = in1[n]; buf2[indx] = in2[n];
-      n1 = 0.0; n2 = 0.0;
-
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx - ((double)del[n] * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (x1 * (1.0 - x1) > 0.00000001) {
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w; n2 += (double)buf2[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w; n2 -= (double)buf2[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-        out1[n] = (MYFLT) (n1 * x2); out2[n] = (MYFLT) (n2 * x2);
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);      /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[n] = buf1[xpos]; out2[n] = buf2[xpos];
-      }
+    MYFLT   *out[2] = { p->sr1, p->sr2 };
+    MYFLT   *in[2] = { p->ain1, p->ain2 };
+    AUXCH   *aux[2] = { &p->aux1, &p->aux2 };
 
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
-
-    p->left = indx;
-    return OK;
+    if (UNLIKELY((p->aux1.auxp == NULL) || (p->aux2.auxp == NULL))) goto err1;          /* RWD fix */
+    return vdelx_perf(csound, &(p->h), 2, out, in, aux, p->adel, p->maxd,
+                      p->interp_size, &p->left);
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("vdelay: not initialised"));
@@ -636,94 +571,13 @@ int32_t vdelayxws(CSOUND *csound, VDELXS *p)    /*      vdelayxws routine  */
 
 int32_t vdelayxq(CSOUND *csound, VDELXQ *p)     /*      vdelayxq routine  */
 {
-    uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps = CS_KSMPS;
-    int32_t  maxd, indx;
-    MYFLT *out1 = p->sr1;  /* assign object data to local variables   */
-    MYFLT *out2 = p->sr2;
-    MYFLT *out3 = p->sr3;
-    MYFLT *out4 = p->sr4;
-    MYFLT *in1 = p->ain1;
-    MYFLT *in2 = p->ain2;
-    MYFLT *in3 = p->ain3;
-    MYFLT *in4 = p->ain4;
-    MYFLT *del = p->adel;
-    MYFLT *buf1 = (MYFLT *)p->aux1.auxp;
-    MYFLT *buf2 = (MYFLT *)p->aux2.auxp;
-    MYFLT *buf3 = (MYFLT *)p->aux3.auxp;
-    MYFLT *buf4 = (MYFLT *)p->aux4.auxp;
-    int32_t   wsize = p->interp_size;
-    double x1, x2, w, d, d2x, n1, n2, n3, n4;
-    int32_t   i, i2, xpos;
-    /* RWD fix */
-    if (UNLIKELY((buf1 == NULL) || (buf2 == NULL) ||
-                 (buf3 == NULL) || (buf4 == NULL))) goto err1;
-    maxd =  p->maxd;
-    if (UNLIKELY(maxd == 0)) maxd = 1;    /* Degenerate case */
-    indx = p->left;
-    i2 = (wsize >> 1);
-    d2x = (1.0 - pow ((double)wsize * 0.85172, -0.89624)) / (double)(i2 * i2);
-
-    if (UNLIKELY(offset)) {
-      memset(out1, '\0', offset*sizeof(MYFLT));
-      memset(out2, '\0', offset*sizeof(MYFLT));
-      memset(out3, '\0', offset*sizeof(MYFLT));
-      memset(out4, '\0', offset*sizeof(MYFLT));
-    }
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out1[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out2[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out3[nsmps], '\0', early*sizeof(MYFLT));
-      memset(&out4[nsmps], '\0', early*sizeof(MYFLT));
-    }
-
-    for (n=offset; n<nsmps; n++) {
-      buf1[indx] = in1[n]; buf2[indx] = in2[n];
-      buf3[indx] = in3[n]; buf4[indx] = in4[n];
-      n1 = 0.0; n2 = 0.0; n3 = 0.0; n4 = 0.0;
-
-      /* x1: fractional part of delay time */
-      /* x2: sine of x1 (for interpolation) */
-      /* xpos: integer part of delay time (buffer position to read from) */
-
-      x1 = (double)indx - ((double)*del++ * (double)csound->esr);
-      while (UNLIKELY(x1 < 0.0)) x1 += (double)maxd;
-      xpos = (int32_t)x1;
-      x1 -= (double)xpos;
-      x2 = sin (PI * x1) / PI;
-      while (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-
-      if (LIKELY(x1 * (1.0 - x1) > 0.00000001)) {
-        xpos += (1 - i2);
-        while (UNLIKELY(xpos < 0)) xpos += maxd;
-        d = (double)(1 - i2) - x1;
-        for (i = i2; i--;) {
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 += (double)buf1[xpos] * w; n2 += (double)buf2[xpos] * w;
-          n3 += (double)buf3[xpos] * w; n4 += (double)buf4[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-          w = 1.0 - d*d*d2x; w *= (w / d++);
-          n1 -= (double)buf1[xpos] * w; n2 -= (double)buf2[xpos] * w;
-          n3 -= (double)buf3[xpos] * w; n4 -= (double)buf4[xpos] * w;
-          if (UNLIKELY(++xpos >= maxd)) xpos -= maxd;
-        }
-        out1[n] = (MYFLT) (n1 * x2); out2[n] = (MYFLT) (n2 * x2);
-        out3[n] = (MYFLT) (n3 * x2); out4[n] = (MYFLT) (n4 * x2);
-      }
-      else {                                            /* integer sample */
-        xpos = (int32_t)((double)xpos + x1 + 0.5);       /* position */
-        if (UNLIKELY(xpos >= maxd)) xpos -= maxd;
-        out1[n] = buf1[xpos]; out2[n] = buf2[xpos];
-        out3[n] = buf3[xpos]; out4[n] = buf4[xpos];
-      }
+    MYFLT   *out[4] = { p->sr1, p->sr2, p->sr3, p->sr4 };
+    MYFLT   *in[4] = { p->ain1, p->ain2, p->ain3, p->ain4 };
+    AUXCH   *aux[4] = { &p->aux1, &p->aux2, &p->aux3, &p->aux4 };
 
-      if (UNLIKELY(++indx == maxd)) indx = 0;
-    }
-
-    p->left = indx;
-    return OK;
+    if (UNLIKELY((p->aux1.auxp == NULL) || (p->aux2.auxp == NULL) || (p->aux3.auxp == NULL) || (p->aux4.auxp == NULL))) goto err1;          /* RWD fix */
+    return vdelx_perf(csound, &(p->h), 4, out, in, aux, p->adel, p->maxd,
+                      p->interp_size, &p->left);
  err1:
     return csound->PerfError(csound, &(p->h),
                              Str("vdelay: not initialised"));
@@ -826,7 +680,7 @@ int32_t vdelayxwq(CSOUND *csound, VDELXQ *p)    /*      vdelayxwq routine  */
 
 int32_t multitap_set(CSOUND *csound, MDEL *p)
 {
-    uint32_t n, i;
+    uint32_t n, i, size;
     MYFLT max = FL(0.0);
 
     //if (UNLIKELY(p->INOCOUNT/2 == (MYFLT)p->INOCOUNT*FL(0.5)))
@@ -838,12 +692,13 @@ int32_t multitap_set(CSOUND *csound, MDEL *p)
       if (max < *p->ndel[i]) max = *p->ndel[i];
     }
 
-    n = (uint32_t)(csound->esr * max * sizeof(MYFLT));
+    size = dline_pow2((uint32_t)(csound->esr * max) + CS_KSMPS);
+    n = size * sizeof(MYFLT);
     if (p->aux.auxp == NULL ||    /* allocate space for delay buffer */
         n > p->aux.size)
       csound->AuxAlloc(csound, n, &p->aux);
     else {
-      memset(p->aux.auxp, 0, n);
+      memset(p->aux.auxp, 0, p->aux.size);
     }
 
     p->left = 0;
@@ -853,13 +708,13 @@ int32_t multitap_set(CSOUND *csound, MDEL *p)
 
 int32_t multitap_play(CSOUND *csound, MDEL *p)
 {                               /* assign object data to local variables   */
-    int32_t  indx = p->left, delay;
+    int32_t  indx = p->left, len, age;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t i, n, nsmps = CS_KSMPS;
+    uint32_t i, nsmps = CS_KSMPS;
     MYFLT *out = p->sr, *in = p->ain;
     MYFLT *buf = (MYFLT *)p->aux.auxp;
-    MYFLT max = (MYFLT)p->max;
+    DLINE dl;
 
     if (UNLIKELY(buf==NULL)) goto err1;           /* RWD fix */
     if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
@@ -867,20 +722,19 @@ int32_t multitap_play(CSOUND *csound, MDEL *p)
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
-      MYFLT v = FL(0.0);
-      buf[indx] = in[n];        /*      Write input     */
-
-      if (UNLIKELY(++indx == max)) indx = 0;   /*      Advance input pointer   */
-      for (i = 0; i < p->INOCOUNT - 1; i += 2) {
-        delay = indx - (int32_t)(csound->esr * *p->ndel[i]);
-        if (UNLIKELY(delay < 0))
-          delay += (int32_t)max;
-        v += buf[delay] * *p->ndel[i+1]; /*      Write output    */
-      }
-      out[n] = v;
+    if (UNLIKELY(offset >= nsmps)) return OK;
+    dline_view(&dl, buf, (int32_t)(p->aux.size / sizeof(MYFLT)));
+    len = (p->max > 0 ? p->max : 1);
+    p->left = dline_write(&dl, indx, &in[offset], nsmps - offset);
+    memset(&out[offset], '\0', (nsmps - offset)*sizeof(MYFLT));
+    for (i = 0; i < p->INOCOUNT - 1; i += 2) {
+      /* a tap of d samples reads the sample written d - 1 samples
+         before the current one, wrapped to the longest tap */
+      age = ((int32_t)(csound->esr * *p->ndel[i]) - 1) % len;
+      if (age < 0) age += len;
+      dline_tap_k(&dl, (indx - age) & dl.mask, *p->ndel[i+1],
+                  &out[offset], nsmps - offset);
     }
-    p->left = indx;
     return OK;
  err1:
     return csound->PerfError(csound, &(p->h),
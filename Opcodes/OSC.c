@@ -67,20 +67,28 @@ typedef struct {
 } OSCSEND;
 
 
-typedef struct osc_pat {
-    struct osc_pat *next;
-    union {
-      MYFLT number;
-      STRINGDAT string;
-      void     *blob;
-    } args[ARG_CNT-1];
-} OSC_PAT;
+/* Messages for an OSClisten opcode are queued in a ring of OSC_RING
+   slots, each of as many arguments as the opcode's type list.  The ring
+   is written only by the listener thread of the port and read only by
+   the opcode, so neither side takes a lock; a message that arrives with
+   the ring full is dropped and counted.  The listeners of a port are
+   found by a hash of path and types computed when they start, and the
+   port mutex is held by the listener thread only to look them up. */
+
+#define OSC_RING        (1024)          /* slots, a power of two */
+#define OSC_HASH        (64)            /* buckets, a power of two */
+
+typedef union {
+    MYFLT     number;
+    STRINGDAT string;
+    void      *blob;
+} OSC_ARG;
 
 typedef struct {
     lo_server_thread thread;
     CSOUND  *csound;
     void    *mutex_;
-    void    *oplst;             /* list of opcodes listening on this port */
+    void    *oplst[OSC_HASH];   /* opcodes listening on this port */
 } OSC_PORT;
 
 /* structure for global variables */
@@ -90,8 +98,7 @@ typedef struct {
     /* for OSCinit/OSClisten */
     int32_t   nPorts;
     OSC_PORT  *ports;
-    int32_t   osccounter;
-    void      *mutex_;
+    volatile int32_t osccounter;
 } OSC_GLOBALS;
 
 /* opcode for starting the OSC listener (called once from orchestra header) */
@@ -112,8 +119,14 @@ typedef struct osclcommon {
     lo_method method;
     char    *saved_path;
     char    saved_types[ARG_CNT];    /* copy of type list */
-    OSC_PAT *patterns;          /* FIFO list of pending messages */
-    OSC_PAT *freePatterns;      /* free message stack */
+    int32_t nargs;              /* arguments per message */
+    uint32_t hash;              /* of saved_path and saved_types */
+    OSC_ARG *ring;              /* OSC_RING messages of nargs arguments */
+    lo_timetag *times;          /* bundle time of each message */
+    volatile long wpos;         /* next slot to be written by the port */
+    volatile long rpos;         /* next slot to be read by the opcode */
+    volatile long dropped;      /* messages lost with the ring full */
+    OSC_GLOBALS *g;
     struct osclcomon *nxt;       /* pointer to next opcode on the same port */
 } OSCLCOMMON;
 
@@ -435,7 +448,6 @@ static CS_NOINLINE OSC_GLOBALS *alloc_globals(CSOUND *csound)
     }
     pp = (OSC_GLOBALS*) csound->QueryGlobalVariable(csound, "_OSC_globals");
     pp->csound = csound;
-    pp->mutex_ = csound->Create_Mutex(0);
     csound->RegisterResetCallback(csound, (void*) pp,
                                   (int32_t (*)(CSOUND *, void *)) OSC_reset);
     return pp;
@@ -445,29 +457,32 @@ static CS_NOINLINE OSC_GLOBALS *alloc_globals(CSOUND *csound)
 
  /* ------------------------------------------------------------------------ */
 
-static CS_NOINLINE OSC_PAT *alloc_pattern(CSOUND *csound)
+/* FNV-1a hash of an OSC path and type list */
+
+static uint32_t OSC_hash(const char *path, const char *types)
 {
-    OSC_PAT *p;
-    size_t  nbytes;
+    uint32_t h = 2166136261U;
+
+    while (*path != '\0')
+      h = (h ^ (unsigned char) *path++) * 16777619U;
+    h = (h ^ (unsigned char) ',') * 16777619U;
+    while (*types != '\0')
+      h = (h ^ (unsigned char) *types++) * 16777619U;
+    return h;
+}
 
-    /* number of bytes to allocate */
-    nbytes = sizeof(OSC_PAT);
-    /* allocate and initialise structure */
-    p = (OSC_PAT*) csound->Calloc(csound, nbytes);
+/* arguments of the message in ring position pos */
 
-    return p;
+static inline OSC_ARG *OSC_slot(OSCLCOMMON *o, long pos)
+{
+    return o->ring + (size_t) (pos & (OSC_RING - 1)) * o->nargs;
 }
 
-static inline OSC_PAT *get_pattern(CSOUND *csound,OSCLCOMMON *pp)
-{
-    OSC_PAT *p;
+/* a message not in a bundle, or in a bundle to be read at once */
 
-    if (pp->freePatterns != NULL) {
-      p = pp->freePatterns;
-      pp->freePatterns = p->next;
-      return p;
-    }
-    return alloc_pattern(csound);
+static inline int32_t OSC_immediate(lo_timetag t)
+{
+    return (t.sec == 0 && t.frac == 1);
 }
 
 typedef struct {
@@ -485,87 +500,78 @@ static int32_t OSCcounter(CSOUND *csound, OSCcount *p)
 static int32_t OSC_handler(const char *path, const char *types,
                        lo_arg **argv, int32_t argc, void *data, void *p)
 {
-    IGN(argc);  IGN(data);
+    IGN(argc);
     OSC_PORT  *pp = (OSC_PORT*) p;
     OSCLCOMMON *o;
     CSOUND    *csound = (CSOUND *) pp->csound;
-    int32_t       retval = 1;
+    uint32_t  h = OSC_hash(path, types);
+    int32_t   retval = 1;
 
     pp->csound->LockMutex(pp->mutex_);
-    o = (OSCLCOMMON*) pp->oplst;
-    //printf("opst=%p\n", o);
+    o = (OSCLCOMMON*) pp->oplst[h & (OSC_HASH - 1)];
     while (o != NULL) {
-      //printf("Looking at %s/%s against %s/%s\n",
-      //       o->saved_path, path,o->saved_types, types);
-      if (strcmp(o->saved_path, path) == 0 &&
+      if (o->hash == h && strcmp(o->saved_path, path) == 0 &&
           strcmp(o->saved_types, types) == 0) {
         /* Message is for this guy */
         int32_t     i;
-        OSC_PAT *m;
-        OSC_GLOBALS *g = alloc_globals(csound);
-        pp->csound->LockMutex(g->mutex_);
-        g->osccounter++;
-        pp->csound->UnlockMutex(g->mutex_);
-        m = get_pattern(csound, o);
-        if (m != NULL) {
-          /* queue message for being read by OSClisten opcode */
-          m->next = NULL;
-          if (o->patterns == NULL)
-            o->patterns = m;
-          else {
-            OSC_PAT *mm;
-            for (mm = o->patterns; mm->next != NULL; mm = mm->next)
-              ;
-            mm->next = m;
-          }
-          /* copy argument list */
-          for (i = 0; o->saved_types[i] != '\0'; i++) {
-            switch (types[i]) {
-            default:              /* Should not happen */
-            case 'i':
-              m->args[i].number = (MYFLT) argv[i]->i; break;
-            case 'h':
-              m->args[i].number = (MYFLT) argv[i]->i64; break;
-            case 'c':
-               m->args[i].number= (MYFLT) argv[i]->c; break;
-            case 'f':
-               m->args[i].number = (MYFLT) argv[i]->f; break;
-            case 'd':
-               m->args[i].number= (MYFLT) argv[i]->d; break;
-            case 's':
-              { // ***NO CHECK THAT m->args[i] IS A STRING
-                char  *src = (char*) &(argv[i]->s), *dst = m->args[i].string.data;
-                if (m->args[i].string.size <= (int32_t) strlen(src)) {
-                  if (dst != NULL) csound->Free(csound, dst);
-                  dst = csound->Strdup(csound, src);
-                  // who sets m->args[i].string.size ??
-                  m->args[i].string.data = dst;
-                  m->args[i].string.size = strlen(dst)+1;
-                }
-                else strcpy(dst, src);
-                break;
+        long        w = o->wpos;
+        OSC_ARG     *m;
+        retval = 0;
+        if (UNLIKELY(w - ATOMIC_GET(o->rpos) >= OSC_RING)) {
+          ATOMIC_INCR(o->dropped);      /* opcode is not keeping up */
+          break;
+        }
+        m = OSC_slot(o, w);
+        /* copy argument list */
+        for (i = 0; o->saved_types[i] != '\0'; i++) {
+          switch (types[i]) {
+          default:              /* Should not happen */
+          case 'i':
+            m[i].number = (MYFLT) argv[i]->i; break;
+          case 'h':
+            m[i].number = (MYFLT) argv[i]->i64; break;
+          case 'c':
+             m[i].number= (MYFLT) argv[i]->c; break;
+          case 'f':
+             m[i].number = (MYFLT) argv[i]->f; break;
+          case 'd':
+             m[i].number= (MYFLT) argv[i]->d; break;
+          case 's':
+            {
+              char  *src = (char*) &(argv[i]->s), *dst = m[i].string.data;
+              if (m[i].string.size <= (int32_t) strlen(src)) {
+                if (dst != NULL) csound->Free(csound, dst);
+                dst = csound->Strdup(csound, src);
+                m[i].string.data = dst;
+                m[i].string.size = strlen(dst)+1;
               }
-            case 'b':
-              {
-                int32_t len =
-                  lo_blobsize((lo_blob*)argv[i]);
-                m->args[i].blob =
-                  csound->Malloc(csound,len);
-                memcpy(m->args[i].blob, argv[i], len);
+              else strcpy(dst, src);
+              break;
+            }
+          case 'b':
+            {
+              int32_t len =
+                lo_blobsize((lo_blob*)argv[i]);
+              m[i].blob =
+                csound->Malloc(csound,len);
+              memcpy(m[i].blob, argv[i], len);
 #ifdef OSC_DEBUG
-                {
-                  lo_blob *bb = (lo_blob*)m->args[i].blob;
-                  int32_t size = lo_blob_datasize(bb);
-                  MYFLT *data = lo_blob_dataptr(bb);
-                  int32_t   *idata = (int32_t*)data;
-                  printf("size=%d data=%.8x %.8x ...\n",size, idata[0], idata[1]);
-                }
-#endif
+              {
+                lo_blob *bb = (lo_blob*)m[i].blob;
+                int32_t size = lo_blob_datasize(bb);
+                MYFLT *data = lo_blob_dataptr(bb);
+                int32_t   *idata = (int32_t*)data;
+                printf("size=%d data=%.8x %.8x ...\n",
+                       size, idata[0], idata[1]);
               }
+#endif
             }
           }
-          retval = 0;
         }
+        o->times[w & (OSC_RING - 1)] = lo_message_get_timestamp(data);
+        /* queue message for being read by OSClisten opcode */
+        ATOMIC_SET(o->wpos, w + 1);
+        ATOMIC_INCR(o->g->osccounter);
         break;
       }
       o = (OSCLCOMMON*) o->nxt;
@@ -611,13 +617,17 @@ static int32_t osc_listener_init(CSOUND *csound, OSCINIT *p)
                                         sizeof(OSC_PORT) * (n + 1));
     ports[n].csound = csound;
     ports[n].mutex_ = csound->Create_Mutex(0);
-    ports[n].oplst = NULL;
+    memset(ports[n].oplst, 0, sizeof(ports[n].oplst));
     snprintf(buff, 32, "%d", (int32_t) *(p->port));
     ports[n].thread = lo_server_thread_new(buff, OSC_error);
     if (UNLIKELY(ports[n].thread==NULL))
       return csound->InitError(csound,
                                Str("cannot start OSC listener on port %s\n"),
                                buff);
+#ifdef HAVE_LO_SERVER_ENABLE_QUEUE
+    /* pass on bundles at once: OSClisten holds them until their time */
+    lo_server_enable_queue(lo_server_thread_get_server(ports[n].thread), 0, 1);
+#endif
     ///if (lo_server_thread_start(ports[n].thread)<0)
     ///  return csound->InitError(csound,
     ///                           Str("cannot start OSC listener on port %s\n"),
@@ -646,7 +656,7 @@ static int32_t osc_listener_initMulti(CSOUND *csound, OSCINITM *p)
                                         sizeof(OSC_PORT) * (n + 1));
     ports[n].csound = csound;
     ports[n].mutex_ = csound->Create_Mutex(0);
-    ports[n].oplst = NULL;
+    memset(ports[n].oplst, 0, sizeof(ports[n].oplst));
     snprintf(buff, 32, "%d", (int32_t) *(p->port));
     ports[n].thread = lo_server_thread_new_multicast(p->group->data,
                                                      buff, OSC_error);
@@ -654,6 +664,10 @@ static int32_t osc_listener_initMulti(CSOUND *csound, OSCINITM *p)
       return csound->InitError(csound,
                                Str("cannot start OSC listener on port %s\n"),
                                buff);
+#ifdef HAVE_LO_SERVER_ENABLE_QUEUE
+    /* pass on bundles at once: OSClisten holds them until their time */
+    lo_server_enable_queue(lo_server_thread_get_server(ports[n].thread), 0, 1);
+#endif
     ///if (lo_server_thread_start(ports[n].thread)<0)
     ///  return csound->InitError(csound,
     ///                           Str("cannot start OSC listener on port %s\n"),
@@ -672,14 +686,17 @@ static int32_t osc_listener_initMulti(CSOUND *csound, OSCINITM *p)
 
 static int32_t OSC_listendeinit(CSOUND *csound, OSC_PORT *port, OSCLCOMMON *p)
 {
-    OSC_PAT *m;
+    void    **head;
+    long    r;
+    int32_t i;
 
     if (port->mutex_==NULL) return NOTOK;
+    head = &port->oplst[p->hash & (OSC_HASH - 1)];
     csound->LockMutex(port->mutex_);
-    if (port->oplst == (void*)p)
-      port->oplst = p->nxt;
+    if (*head == (void*)p)
+      *head = p->nxt;
     else {
-      OSCLCOMMON *o = (OSCLCOMMON*) port->oplst;
+      OSCLCOMMON *o = (OSCLCOMMON*) *head;
       for ( ; o->nxt != (void*) p; o = (OSCLCOMMON*) o->nxt)
         ;
       o->nxt = p->nxt;
@@ -691,23 +708,31 @@ static int32_t OSC_listendeinit(CSOUND *csound, OSC_PORT *port, OSCLCOMMON *p)
 #else
     lo_server_thread_del_method(port->thread, p->saved_path, p->saved_types);
 #endif
+    if (UNLIKELY(p->dropped > 0))
+      csound->Warning(csound, Str("OSClisten %s %s: %ld messages dropped"),
+                      p->saved_path, p->saved_types, (long) p->dropped);
+    /* the port no longer writes to the ring: unread messages are gone */
+    ATOMIC_SUB(p->g->osccounter, (int32_t) (p->wpos - p->rpos));
     csound->Free(csound, p->saved_path);
     p->saved_path = NULL;
     p->nxt = NULL;
-    m = p->patterns;
-    p->patterns = NULL;
-    while (m != NULL) {
-      OSC_PAT *mm = m->next;
-      csound->Free(csound, m);
-      m = mm;
+    /* free unread blobs, and the strings of all slots */
+    for (r = p->rpos; r != p->wpos; r++) {
+      OSC_ARG *m = OSC_slot(p, r);
+      for (i = 0; i < p->nargs; i++)
+        if (p->saved_types[i] == 'b')
+          csound->Free(csound, m[i].blob);
     }
-    m = p->freePatterns;
-    p->freePatterns = NULL;
-    while (m != NULL) {
-      OSC_PAT *mm = m->next;
-      csound->Free(csound, m);
-      m = mm;
+    for (r = 0; r < OSC_RING; r++) {
+      OSC_ARG *m = OSC_slot(p, r);
+      for (i = 0; i < p->nargs; i++)
+        if (p->saved_types[i] == 's' && m[i].string.data != NULL)
+          csound->Free(csound, m[i].string.data);
     }
+    csound->Free(csound, p->ring);
+    csound->Free(csound, p->times);
+    p->ring = NULL;
+    p->times = NULL;
     return OK;
 }
 
@@ -723,6 +748,83 @@ static int32_t OSC_listadeinit(CSOUND *csound, OSCLISTENA *p)
     return OSC_listendeinit(csound, port, &p->c);
 }
 
+/* set up the ring of a listening opcode, and add it to its port */
+
+static void OSC_listenstart(CSOUND *csound, OSC_GLOBALS *pp, OSC_PORT *port,
+                            OSCLCOMMON *c)
+{
+    void    **head;
+
+    c->nargs = (int32_t) strlen(c->saved_types);
+    c->ring = (OSC_ARG*) csound->Calloc(csound, (size_t) OSC_RING *
+                                        (c->nargs > 0 ? c->nargs : 1) *
+                                        sizeof(OSC_ARG));
+    c->times = (lo_timetag*) csound->Calloc(csound,
+                                            OSC_RING * sizeof(lo_timetag));
+    c->wpos = c->rpos = c->dropped = 0;
+    c->g = pp;
+    c->hash = OSC_hash(c->saved_path, c->saved_types);
+    head = &port->oplst[c->hash & (OSC_HASH - 1)];
+    csound->LockMutex(port->mutex_);
+    c->nxt = *head;
+    *head = (void*) c;
+    csound->UnlockMutex(port->mutex_);
+}
+
+/* move the message in ring position j to position r, before the held
+   messages from r on, which keep their order; the slots from rpos to
+   wpos belong to the opcode, so the port does not see this */
+
+static void OSC_tohead(OSCLCOMMON *c, long r, long j)
+{
+    OSC_ARG     m[ARG_CNT];
+    lo_timetag  t = c->times[j & (OSC_RING - 1)];
+    size_t      n = (size_t) c->nargs * sizeof(OSC_ARG);
+
+    memcpy(m, OSC_slot(c, j), n);
+    for ( ; j != r; j--) {
+      memcpy(OSC_slot(c, j), OSC_slot(c, j - 1), n);
+      c->times[j & (OSC_RING - 1)] = c->times[(j - 1) & (OSC_RING - 1)];
+    }
+    memcpy(OSC_slot(c, r), m, n);
+    c->times[r & (OSC_RING - 1)] = t;
+}
+
+/* the arguments of the next message that is due, or NULL; a bundle is
+   due once its time is less than a k-period away, and messages that are
+   due are read before bundles still held for a later time */
+
+static OSC_ARG *OSC_next(OSCLCOMMON *c, MYFLT onedkr)
+{
+    long    r = c->rpos, w = ATOMIC_GET(c->wpos), j;
+    lo_timetag t, now;
+    int32_t havenow = 0;
+
+    for (j = r; j != w; j++) {
+      t = c->times[j & (OSC_RING - 1)];
+      if (OSC_immediate(t))
+        break;
+      if (!havenow) {
+        lo_timetag_now(&now);
+        havenow = 1;
+      }
+      if (lo_timetag_diff(t, now) < (double) onedkr)
+        break;
+    }
+    if (j == w)
+      return NULL;
+    if (j != r)
+      OSC_tohead(c, r, j);
+    return OSC_slot(c, r);
+}
+
+/* release the message read with OSC_next() */
+
+static inline void OSC_release(OSCLCOMMON *c)
+{
+    ATOMIC_SET(c->rpos, c->rpos + 1);
+    ATOMIC_DECR(c->g->osccounter);
+}
 
 static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
 {
@@ -781,10 +883,7 @@ static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
         return csound->InitError(csound, "%s", Str("invalid type"));
       }
     }
-    csound->LockMutex(p->port->mutex_);
-    p->c.nxt = p->port->oplst;
-    p->port->oplst = (void*) &p->c;
-    csound->UnlockMutex(p->port->mutex_);
+    OSC_listenstart(csound, pp, p->port, &p->c);
     p->c.method = lo_server_thread_add_method(p->port->thread,
                                               p->c.saved_path, p->c.saved_types,
                                               OSC_handler, p->port);
@@ -795,26 +894,16 @@ static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
 
 static int32_t OSC_list(CSOUND *csound, OSCLISTEN *p)
 {
-    OSC_PAT *m;
+    OSC_ARG *m = OSC_next(&p->c, CS_ONEDKR);
 
-    /* quick check for empty queue */
-    if (p->c.patterns == NULL) {
-      *p->kans = 0;
-      return OK;
-    }
-    csound->LockMutex(p->port->mutex_);
-    m = p->c.patterns;
-    /* check again for thread safety */
     if (m != NULL) {
       int32_t i;
-      /* unlink from queue */
-      p->c.patterns = m->next;
       /* copy arguments */
       //printf("copying args\n");
       for (i = 0; p->c.saved_types[i] != '\0'; i++) {
         //printf("%d: type %c\n", i, p->c.saved_types[i]);
         if (p->c.saved_types[i] == 's') {
-          char *src = m->args[i].string.data;
+          char *src = m[i].string.data;
           char *dst = ((STRINGDAT*) p->args[i])->data;
           if (src != NULL) {
             if (((STRINGDAT*) p->args[i])->size <= (int32_t) strlen(src)){
@@ -829,10 +918,10 @@ static int32_t OSC_list(CSOUND *csound, OSCLISTEN *p)
         }
         else if (p->c.saved_types[i]=='b') {
           char c = p->type->data[i];
-          int32_t len =  lo_blob_datasize(m->args[i].blob);
-          //printf("blob found %p type %c\n", m->args[i].blob, c);
-          //printf("length = %d\n", lo_blob_datasize(m->args[i].blob));
-          int32_t *idata = lo_blob_dataptr(m->args[i].blob);
+          int32_t len =  lo_blob_datasize(m[i].blob);
+          //printf("blob found %p type %c\n", m[i].blob, c);
+          //printf("length = %d\n", lo_blob_datasize(m[i].blob));
+          int32_t *idata = lo_blob_dataptr(m[i].blob);
           if (c == 'D') {
             int32_t j;
             MYFLT *data = (MYFLT *) idata;
@@ -941,92 +1030,21 @@ static int32_t OSC_list(CSOUND *csound, OSCLISTEN *p)
           else if (c == 'S') {
           }
           else return csound->PerfError(csound,  &(p->h), "Oh dear");
-          csound->Free(csound, m->args[i].blob);
+          csound->Free(csound, m[i].blob);
         }
         else
-          *(p->args[i]) = m->args[i].number;
+          *(p->args[i]) = m[i].number;
       }
-      /* push to stack of free message structures */
-      m->next = p->c.freePatterns;
-      p->c.freePatterns = m;
+      OSC_release(&p->c);
       *p->kans = 1;
-      OSC_GLOBALS *g = alloc_globals(csound);
-      csound->LockMutex(g->mutex_);
-      g->osccounter--;
-      csound->UnlockMutex(g->mutex_);
     }
     else
       *p->kans = 0;
-    csound->UnlockMutex(p->port->mutex_);
     return OK;
 }
 
 /* ******** ARRAY VERSION **** EXPERIMENTAL *** */
 
-static int32_t OSC_ahandler(const char *path, const char *types,
-                       lo_arg **argv, int32_t argc, void *data, void *p)
-{
-    IGN(argc);  IGN(data);
-    OSC_PORT  *pp = (OSC_PORT*) p;
-    OSCLCOMMON *o;
-    CSOUND    *csound = (CSOUND *) pp->csound;
-    int32_t   retval = 1;
-    //printf("***in ahandler\n");
-    csound->LockMutex(pp->mutex_);
-    o = (OSCLCOMMON*) pp->oplst;
-    //printf("opst=%p\n", o);
-    while (o != NULL) {
-      //printf("Looking at %s/%s against %s/%s\n",
-      //       o->saved_path, path,o->saved_types, types);
-      if (strcmp(o->saved_path, path) == 0 &&
-          strcmp(o->saved_types, types) == 0) {
-        /* Message is for this guy */
-        int32_t     i;
-        OSC_PAT *m;
-        OSC_GLOBALS *g = alloc_globals(csound);
-        csound->LockMutex(g->mutex_);
-        g->osccounter++;
-        csound->UnlockMutex(g->mutex_);
-        //printf("handler found message\n");
-        m = get_pattern(csound, o);
-        if (m != NULL) {
-          /* queue message for being read by OSClisten opcode */
-          m->next = NULL;
-          if (o->patterns == NULL)
-            o->patterns = m;
-          else {
-            OSC_PAT *mm;
-            for (mm = o->patterns; mm->next != NULL; mm = mm->next)
-              ;
-            mm->next = m;
-          }
-          /* copy argument list */
-          for (i = 0; o->saved_types[i] != '\0'; i++) {
-            switch (types[i]) {
-            default:              /* Should not happen */
-            case 'i':
-              m->args[i].number = (MYFLT) argv[i]->i; break;
-            case 'h':
-              m->args[i].number = (MYFLT) argv[i]->i64; break;
-            case 'c':
-              m->args[i].number= (MYFLT) argv[i]->c; break;
-            case 'f':
-              m->args[i].number = (MYFLT) argv[i]->f; break;
-            case 'd':
-              m->args[i].number= (MYFLT) argv[i]->d; break;
-            }
-          }
-          retval = 0;
-        }
-        break;
-      }
-      o = (OSCLCOMMON*) o->nxt;
-    }
-
-    pp->csound->UnlockMutex(pp->mutex_);
-    return retval;
-}
-
 #include "arrays.h"
 
 static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
@@ -1061,13 +1079,10 @@ static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
         return csound->InitError(csound, "%s", Str("invalid type"));
       }
     }
-    csound->LockMutex(p->port->mutex_);
-    p->c.nxt = p->port->oplst;
-    p->port->oplst = (void*) &p->c;
-    csound->UnlockMutex(p->port->mutex_);
+    OSC_listenstart(csound, pp, p->port, &p->c);
     p->c.method = lo_server_thread_add_method(p->port->thread,
                                               p->c.saved_path, p->c.saved_types,
-                                              OSC_ahandler, p->port);
+                                              OSC_handler, p->port);
     csound->RegisterDeinitCallback(csound, p,
                                    (int32_t (*)(CSOUND *, void *)) OSC_listadeinit);
     return OK;
@@ -1075,37 +1090,21 @@ static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
 
 static int32_t OSC_alist(CSOUND *csound, OSCLISTENA *p)
 {
-    OSC_PAT *m;
-    /* quick check for empty queue */
-    if (p->c.patterns == NULL) {
-      *p->kans = 0;
-      return OK;
-    }
-    csound->LockMutex(p->port->mutex_);
-    m = p->c.patterns;
-    /* check again for thread safety */
+    OSC_ARG *m = OSC_next(&p->c, CS_ONEDKR);
+
     if (m != NULL) {
       int32_t i;
-      /* unlink from queue */
-      p->c.patterns = m->next;
       /* copy arguments */
       //printf("copying args\n");
       for (i = 0; p->c.saved_types[i] != '\0'; i++) {
         //printf("%d: type %c\n", i, p->c.saved_types[i]);
-        ((MYFLT*)p->args->data)[i] = m->args[i].number;
+        ((MYFLT*)p->args->data)[i] = m[i].number;
       }
-      /* push to stack of free message structures */
-      m->next = p->c.freePatterns;
-      p->c.freePatterns = m;
+      OSC_release(&p->c);
       *p->kans = 1;
-      OSC_GLOBALS *g = alloc_globals(csound);
-      csound->LockMutex(g->mutex_);
-      g->osccounter--;
-      csound->UnlockMutex(g->mutex_);
     }
     else
       *p->kans = 0;
-    csound->UnlockMutex(p->port->mutex_);
     return OK;
 }
 
@@ -129,6 +129,8 @@ static int32_t moogvcfset(CSOUND *csound, MOOGVCF *p)
     p->fcocod = IS_ASIG_ARG(p->fco) ? 1 : 0;
     p->rezcod = IS_ASIG_ARG(p->res) ? 1 : 0;
     if ((p->maxint = *p->max)==FL(0.0)) p->maxint = csound->e0dbfs;
+    p->fct = fcoef_tables(csound);
+    p->lfco = -1.0;
 
     return OK;
 }
@@ -143,6 +145,7 @@ static int32_t moogvcf(CSOUND *csound, MOOGVCF *p)
     MYFLT *fcoptr, *resptr;
     /* Fake initialisations to stop compiler warnings!! */
     double fco, res, kp=0.0, pp1d2=0.0, scale=0.0, k=0.0;
+    double dkp = 0.0, dpp1d2 = 0.0, dk = 0.0;
     double max = (double)p->maxint;
     double dmax = 1.0/max;
     double xnm1 = p->xnm1, y1nm1 = p->y1nm1, y2nm1 = p->y2nm1, y3nm1 = p->y3nm1;
@@ -156,8 +159,34 @@ static int32_t moogvcf(CSOUND *csound, MOOGVCF *p)
     fco     = (double)*fcoptr;
     res     = (double)*resptr;
 
+    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
+    }
   /* Only need to calculate once */
-    if (UNLIKELY((p->rezcod==0) && (p->fcocod==0))) {
+    if (p->fct != NULL && p->rezcod==0 && p->fcocod==0) {
+      /* cached; on a change ramp from the old values over the cycle */
+      kp = p->kp; pp1d2 = p->pp1d2; k = p->k;
+      if (fco != p->lfco || res != p->lres) {
+        double fcon, r;
+        int32_t first = (p->lfco < 0.0 || nsmps <= offset);
+        p->lfco = fco; p->lres = res;
+        fcon  = 2.0*fco*(double)csound->onedsr;
+        p->kp    = 3.6*fcon-1.6*fcon*fcon-1.0;
+        p->pp1d2 = (p->kp+1.0)*0.5;
+        p->k     = res*exp((1.0-p->pp1d2)*1.386249);
+        if (first) {
+          kp = p->kp; pp1d2 = p->pp1d2; k = p->k;
+        }
+        else {
+          r = 1.0 / (double) (nsmps - offset);
+          dkp = (p->kp - kp) * r; dpp1d2 = (p->pp1d2 - pp1d2) * r;
+          dk = (p->k - k) * r;
+        }
+      }
+    }
+    else if (UNLIKELY((p->rezcod==0) && (p->fcocod==0))) {
       double fcon;
       fcon  = 2.0*fco*(double)csound->onedsr; /* normalised freq. 0 to Nyquist */
       kp    = 3.6*fcon-1.6*fcon*fcon-1.0;     /* Emperical tuning   */
@@ -165,11 +194,6 @@ static int32_t moogvcf(CSOUND *csound, MOOGVCF *p)
       scale = exp((1.0-pp1d2)*1.386249);      /* Scaling factor     */
       k     = res*scale;
     }
-    if (UNLIKELY(offset)) memset(out, '\0', offset*sizeof(MYFLT));
-    if (UNLIKELY(early)) {
-      nsmps -= early;
-      memset(&out[nsmps], '\0', early*sizeof(MYFLT));
-    }
     for (n=offset; n<nsmps; n++) {
       /* Handle a-rate modulation of fco & res. */
       if (p->fcocod) {
@@ -186,6 +210,7 @@ static int32_t moogvcf(CSOUND *csound, MOOGVCF *p)
         scale = exp((1.0-pp1d2)*1.386249);      /* Scaling factor */
         k     = res*scale;
       }
+      kp += dkp; pp1d2 += dpp1d2; k += dk;      /* ramps (if any) */
       xn = (double)in[n] * dmax/zerodb;
       xn = xn - k * y4n; /* Inverted feed back for corner peaking */
 
@@ -1670,6 +1695,411 @@ int mvmfilter(CSOUND *csound, MVMFILT *p) {
 }
 
 
+/* ---- filter banks: biquadbank, svfbank ---- */
+
+/* N independent second order sections, all fed from one audio input or
+   each from its own element of an audio array, with one output per
+   section in an audio array.  The sections run four at a time, one per
+   SSE2 lane, in double precision like biquad.  Coefficients are updated
+   at k-rate and, unless ismooth is zero, ramp linearly from the old to
+   the new values over the k-cycle. */
+
+#include "arrays.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+typedef struct { __m128d lo, hi; } FBV;         /* four sections */
+
+static inline FBV fbv_load(const double *x)
+{
+    FBV r; r.lo = _mm_loadu_pd(x); r.hi = _mm_loadu_pd(x + 2); return r;
+}
+
+static inline void fbv_store(double *x, FBV a)
+{
+    _mm_storeu_pd(x, a.lo); _mm_storeu_pd(x + 2, a.hi);
+}
+
+static inline FBV fbv_set4(double a, double b, double c, double d)
+{
+    FBV r; r.lo = _mm_set_pd(b, a); r.hi = _mm_set_pd(d, c); return r;
+}
+
+static inline FBV fbv_set1(double a)
+{
+    FBV r; r.lo = r.hi = _mm_set1_pd(a); return r;
+}
+
+static inline FBV fbv_add(FBV a, FBV b)
+{
+    FBV r; r.lo = _mm_add_pd(a.lo, b.lo); r.hi = _mm_add_pd(a.hi, b.hi);
+    return r;
+}
+
+static inline FBV fbv_sub(FBV a, FBV b)
+{
+    FBV r; r.lo = _mm_sub_pd(a.lo, b.lo); r.hi = _mm_sub_pd(a.hi, b.hi);
+    return r;
+}
+
+static inline FBV fbv_mul(FBV a, FBV b)
+{
+    FBV r; r.lo = _mm_mul_pd(a.lo, b.lo); r.hi = _mm_mul_pd(a.hi, b.hi);
+    return r;
+}
+#endif
+
+/* Each bank keeps nlanes doubles per field in p->v: the filter state,
+   the current coefficients, their per-sample increments and the targets
+   for the end of the cycle.  FBANK(p, f) is the array of field f. */
+
+#define FBANK(p, f)     ((p)->v + (size_t) (f) * (p)->nlanes)
+
+enum { BQ_Z1, BQ_Z2, BQ_C,                      /* b0 b1 b2 a1 a2 */
+       BQ_D = BQ_C + 5, BQ_T = BQ_D + 5, BQ_NFIELDS = BQ_T + 5 };
+enum { SVF_IC1, SVF_IC2, SVF_C,                 /* a1 a2 a3 m1 */
+       SVF_D = SVF_C + 4, SVF_T = SVF_D + 4,
+       SVF_F = SVF_T + 4, SVF_Q, SVF_NFIELDS };
+
+static int32_t fbank_setup(CSOUND *csound, OPDS *h, ARRAYDAT *out,
+                           void *in, int32_t inarr, ARRAYDAT *sizer,
+                           int32_t nfields, int32_t *nsect, int32_t *nlanes,
+                           double **v, AUXCH *aux)
+{
+    size_t  n;
+
+    if (UNLIKELY(sizer->dimensions != 1 || sizer->sizes == NULL ||
+                 sizer->sizes[0] < 1))
+      return csound->InitError(csound, Str("%s: coefficient arrays must be "
+                                           "one-dimensional and non-empty"),
+                               csound->GetOpcodeName(h));
+    *nsect = sizer->sizes[0];
+    if (UNLIKELY(inarr && (((ARRAYDAT*) in)->dimensions != 1 ||
+                           ((ARRAYDAT*) in)->sizes == NULL ||
+                           ((ARRAYDAT*) in)->sizes[0] < *nsect)))
+      return csound->InitError(csound, Str("%s: input array has fewer "
+                                           "elements than the bank"),
+                               csound->GetOpcodeName(h));
+    *nlanes = (*nsect + 3) & ~3;
+    n = (size_t) nfields * *nlanes * sizeof(double);
+    if (aux->auxp == NULL || aux->size < n)
+      csound->AuxAlloc(csound, n, aux);
+    else
+      memset(aux->auxp, 0, n);
+    *v = (double*) aux->auxp;
+    tabinit(csound, out, *nsect);
+    return OK;
+}
+
+static inline int32_t fbank_check(ARRAYDAT *a, int32_t nsect)
+{
+    return (a->sizes != NULL && a->sizes[0] >= nsect);
+}
+
+/* start the ramps of ncoef coefficients towards their targets, or jump
+   to the targets in the first cycle and without smoothing */
+
+static void fbank_ramp(double *c, double *d, double *t, int32_t nlanes,
+                       int32_t ncoef, int32_t jump, uint32_t nsmps)
+{
+    int32_t i, n = ncoef * nlanes;
+    double  r = 1.0 / (double) nsmps;
+
+    if (jump) {
+      memcpy(c, t, n * sizeof(double));
+      memset(d, 0, n * sizeof(double));
+    }
+    else
+      for (i = 0; i < n; i++)
+        d[i] = (t[i] - c[i]) * r;
+}
+
+/* input and output pointers of the sections g..g+3; padding lanes read
+   the input of section g and are not written */
+
+static int32_t fbank_io(MYFLT **xin, MYFLT **yout, void *in, int32_t inarr,
+                        ARRAYDAT *out, int32_t g, int32_t nsect,
+                        uint32_t ksmps)
+{
+    int32_t l, nact = (nsect - g < 4 ? nsect - g : 4);
+
+    for (l = 0; l < 4; l++) {
+      int32_t s = (l < nact ? g + l : g);
+      xin[l] = (inarr ? ((ARRAYDAT*) in)->data + (size_t) s * ksmps
+                      : (MYFLT*) in);
+      yout[l] = out->data + (size_t) s * ksmps;
+    }
+    return nact;
+}
+
+static void fbank_clear(ARRAYDAT *out, int32_t nsect, uint32_t ksmps,
+                        uint32_t offset, uint32_t early)
+{
+    int32_t s;
+
+    for (s = 0; s < nsect; s++) {
+      MYFLT *y = out->data + (size_t) s * ksmps;
+      if (offset) memset(y, '\0', offset*sizeof(MYFLT));
+      if (early) memset(&y[ksmps - early], '\0', early*sizeof(MYFLT));
+    }
+}
+
+/* transposed direct form II: y = b0 x + z1, z1 = b1 x - a1 y + z2,
+   z2 = b2 x - a2 y */
+
+static void bqbank_group(BQBANK *p, int32_t g, MYFLT **xin, MYFLT **yout,
+                         int32_t nact, uint32_t offset, uint32_t nsmps)
+{
+    int32_t  nl = p->nlanes;
+    double   *z1p = FBANK(p, BQ_Z1) + g, *z2p = FBANK(p, BQ_Z2) + g;
+    double   *c = FBANK(p, BQ_C) + g, *d = FBANK(p, BQ_D) + g;
+    uint32_t n;
+    int32_t  l;
+#if defined(__SSE2__)
+    FBV     z1 = fbv_load(z1p), z2 = fbv_load(z2p), x, y;
+    FBV     b0 = fbv_load(c), b1 = fbv_load(c + nl), b2 = fbv_load(c + 2*nl);
+    FBV     a1 = fbv_load(c + 3*nl), a2 = fbv_load(c + 4*nl);
+    FBV     db0 = fbv_load(d), db1 = fbv_load(d + nl);
+    FBV     db2 = fbv_load(d + 2*nl), da1 = fbv_load(d + 3*nl);
+    FBV     da2 = fbv_load(d + 4*nl);
+    double  yv[4];
+
+    for (n = offset; n < nsmps; n++) {
+      x = fbv_set4(xin[0][n], xin[1][n], xin[2][n], xin[3][n]);
+      b0 = fbv_add(b0, db0); b1 = fbv_add(b1, db1); b2 = fbv_add(b2, db2);
+      a1 = fbv_add(a1, da1); a2 = fbv_add(a2, da2);
+      y = fbv_add(fbv_mul(b0, x), z1);
+      z1 = fbv_add(fbv_sub(fbv_mul(b1, x), fbv_mul(a1, y)), z2);
+      z2 = fbv_sub(fbv_mul(b2, x), fbv_mul(a2, y));
+      fbv_store(yv, y);
+      for (l = 0; l < nact; l++) yout[l][n] = (MYFLT) yv[l];
+    }
+    fbv_store(z1p, z1); fbv_store(z2p, z2);
+#else
+    for (l = 0; l < nact; l++) {
+      double z1 = z1p[l], z2 = z2p[l], x, y;
+      double b0 = c[l], b1 = c[nl + l], b2 = c[2*nl + l];
+      double a1 = c[3*nl + l], a2 = c[4*nl + l];
+
+      for (n = offset; n < nsmps; n++) {
+        x = (double) xin[l][n];
+        b0 += d[l]; b1 += d[nl + l]; b2 += d[2*nl + l];
+        a1 += d[3*nl + l]; a2 += d[4*nl + l];
+        y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        yout[l][n] = (MYFLT) y;
+      }
+      z1p[l] = z1; z2p[l] = z2;
+    }
+#endif
+}
+
+static int32_t bqbankset_(CSOUND *csound, BQBANK *p, int32_t inarr)
+{
+    p->inarr = inarr;
+    p->init_k = 1;
+    return fbank_setup(csound, &(p->h), p->out, p->in, inarr, p->b0,
+                       BQ_NFIELDS, &(p->nsect), &(p->nlanes), &(p->v),
+                       &(p->aux));
+}
+
+static int32_t bqbankset(CSOUND *csound, BQBANK *p)
+{
+    return bqbankset_(csound, p, 0);
+}
+
+static int32_t bqbankset_arr(CSOUND *csound, BQBANK *p)
+{
+    return bqbankset_(csound, p, 1);
+}
+
+static int32_t bqbank(CSOUND *csound, BQBANK *p)
+{
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t ksmps = CS_KSMPS, nsmps = ksmps - early;
+    int32_t  s, g, nl = p->nlanes, nsect = p->nsect;
+    double   *t = FBANK(p, BQ_T), a0;
+    MYFLT    *xin[4], *yout[4];
+
+    if (UNLIKELY(!fbank_check(p->b0, nsect) || !fbank_check(p->b1, nsect) ||
+                 !fbank_check(p->b2, nsect) || !fbank_check(p->a0, nsect) ||
+                 !fbank_check(p->a1, nsect) || !fbank_check(p->a2, nsect) ||
+                 (p->inarr && !fbank_check((ARRAYDAT*) p->in, nsect))))
+      return csound->PerfError(csound, &(p->h),
+                               Str("biquadbank: array shorter than the "
+                                   "bank"));
+    /* new coefficients, normalised by a0 as in biquad */
+    for (s = 0; s < nsect; s++) {
+      a0 = 1.0 / (double) p->a0->data[s];
+      t[s]          = a0 * (double) p->b0->data[s];
+      t[nl + s]     = a0 * (double) p->b1->data[s];
+      t[2*nl + s]   = a0 * (double) p->b2->data[s];
+      t[3*nl + s]   = a0 * (double) p->a1->data[s];
+      t[4*nl + s]   = a0 * (double) p->a2->data[s];
+    }
+    fbank_ramp(FBANK(p, BQ_C), FBANK(p, BQ_D), t, nl, 5,
+               p->init_k || *p->ismooth == FL(0.0) || nsmps <= offset,
+               nsmps - offset);
+    p->init_k = 0;
+    fbank_clear(p->out, nsect, ksmps, offset, early);
+    for (g = 0; g < nsect; g += 4) {
+      int32_t nact = fbank_io(xin, yout, p->in, p->inarr, p->out, g, nsect,
+                              ksmps);
+      bqbank_group(p, g, xin, yout, nact, offset, nsmps);
+    }
+    /* end the ramps exactly on the targets */
+    memcpy(FBANK(p, BQ_C), t, 5 * nl * sizeof(double));
+    return OK;
+}
+
+/* trapezoidal state variable filter (A. Simper):
+     v3 = x - ic2, v1 = a1 ic1 + a2 v3, v2 = ic2 + a2 ic1 + a3 v3,
+     ic1 = 2 v1 - ic1, ic2 = 2 v2 - ic2,
+   with the response selected as y = m0 x + m1 v1 + m2 v2; imode 0 to 5
+   gives low-pass, high-pass, band-pass, band-reject, peak (high-pass
+   minus low-pass) and all-pass */
+
+static const double svf_m0[6] = { 0.0, 1.0, 0.0, 1.0, 1.0, 1.0 };
+static const double svf_m2[6] = { 1.0, -1.0, 0.0, 0.0, -2.0, 0.0 };
+
+static void svfbank_group(SVFBANK *p, int32_t g, MYFLT **xin, MYFLT **yout,
+                          int32_t nact, uint32_t offset, uint32_t nsmps)
+{
+    int32_t  nl = p->nlanes;
+    double   *ic1p = FBANK(p, SVF_IC1) + g, *ic2p = FBANK(p, SVF_IC2) + g;
+    double   *c = FBANK(p, SVF_C) + g, *d = FBANK(p, SVF_D) + g;
+    uint32_t n;
+    int32_t  l;
+#if defined(__SSE2__)
+    FBV     ic1 = fbv_load(ic1p), ic2 = fbv_load(ic2p), x, v1, v2, v3, y;
+    FBV     a1 = fbv_load(c), a2 = fbv_load(c + nl), a3 = fbv_load(c + 2*nl);
+    FBV     m1 = fbv_load(c + 3*nl);
+    FBV     da1 = fbv_load(d), da2 = fbv_load(d + nl);
+    FBV     da3 = fbv_load(d + 2*nl), dm1 = fbv_load(d + 3*nl);
+    FBV     m0 = fbv_set1(svf_m0[p->mode]), m2 = fbv_set1(svf_m2[p->mode]);
+    double  yv[4];
+
+    for (n = offset; n < nsmps; n++) {
+      x = fbv_set4(xin[0][n], xin[1][n], xin[2][n], xin[3][n]);
+      a1 = fbv_add(a1, da1); a2 = fbv_add(a2, da2); a3 = fbv_add(a3, da3);
+      m1 = fbv_add(m1, dm1);
+      v3 = fbv_sub(x, ic2);
+      v1 = fbv_add(fbv_mul(a1, ic1), fbv_mul(a2, v3));
+      v2 = fbv_add(fbv_add(ic2, fbv_mul(a2, ic1)), fbv_mul(a3, v3));
+      ic1 = fbv_sub(fbv_add(v1, v1), ic1);
+      ic2 = fbv_sub(fbv_add(v2, v2), ic2);
+      y = fbv_add(fbv_add(fbv_mul(m0, x), fbv_mul(m1, v1)), fbv_mul(m2, v2));
+      fbv_store(yv, y);
+      for (l = 0; l < nact; l++) yout[l][n] = (MYFLT) yv[l];
+    }
+    fbv_store(ic1p, ic1); fbv_store(ic2p, ic2);
+#else
+    double  m0 = svf_m0[p->mode], m2 = svf_m2[p->mode];
+
+    for (l = 0; l < nact; l++) {
+      double ic1 = ic1p[l], ic2 = ic2p[l], x, v1, v2, v3;
+      double a1 = c[l], a2 = c[nl + l], a3 = c[2*nl + l], m1 = c[3*nl + l];
+
+      for (n = offset; n < nsmps; n++) {
+        x = (double) xin[l][n];
+        a1 += d[l]; a2 += d[nl + l]; a3 += d[2*nl + l]; m1 += d[3*nl + l];
+        v3 = x - ic2;
+        v1 = a1 * ic1 + a2 * v3;
+        v2 = ic2 + a2 * ic1 + a3 * v3;
+        ic1 = (v1 + v1) - ic1;
+        ic2 = (v2 + v2) - ic2;
+        yout[l][n] = (MYFLT) (m0 * x + m1 * v1 + m2 * v2);
+      }
+      ic1p[l] = ic1; ic2p[l] = ic2;
+    }
+#endif
+}
+
+static int32_t svfbankset_(CSOUND *csound, SVFBANK *p, int32_t inarr)
+{
+    int32_t s;
+
+    p->inarr = inarr;
+    p->init_k = 1;
+    p->mode = (int32_t) *p->imode;
+    if (UNLIKELY(p->mode < 0 || p->mode > 5))
+      return csound->InitError(csound, Str("svfbank: invalid mode %d"),
+                               p->mode);
+    if (UNLIKELY(fbank_setup(csound, &(p->h), p->out, p->in, inarr,
+                             p->kfreq, SVF_NFIELDS, &(p->nsect),
+                             &(p->nlanes), &(p->v), &(p->aux)) != OK))
+      return NOTOK;
+    for (s = 0; s < p->nsect; s++)      /* no cached design yet */
+      FBANK(p, SVF_F)[s] = -1.0;
+    return OK;
+}
+
+static int32_t svfbankset(CSOUND *csound, SVFBANK *p)
+{
+    return svfbankset_(csound, p, 0);
+}
+
+static int32_t svfbankset_arr(CSOUND *csound, SVFBANK *p)
+{
+    return svfbankset_(csound, p, 1);
+}
+
+static int32_t svfbank(CSOUND *csound, SVFBANK *p)
+{
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t ksmps = CS_KSMPS, nsmps = ksmps - early;
+    int32_t  s, g, nl = p->nlanes, nsect = p->nsect;
+    double   *t = FBANK(p, SVF_T), *of = FBANK(p, SVF_F);
+    double   *oq = FBANK(p, SVF_Q), f, q, w, k, a1;
+    double   fmax = 0.49 * (double) CS_ESR;
+    MYFLT    *xin[4], *yout[4];
+
+    if (UNLIKELY(!fbank_check(p->kfreq, nsect) ||
+                 !fbank_check(p->kq, nsect) ||
+                 (p->inarr && !fbank_check((ARRAYDAT*) p->in, nsect))))
+      return csound->PerfError(csound, &(p->h),
+                               Str("svfbank: array shorter than the bank"));
+    /* redesign the sections whose frequency or Q changed */
+    for (s = 0; s < nsect; s++) {
+      f = (double) p->kfreq->data[s];
+      q = (double) p->kq->data[s];
+      if (f == of[s] && q == oq[s]) continue;
+      of[s] = f; oq[s] = q;
+      if (f < 1.0) f = 1.0;
+      if (f > fmax) f = fmax;
+      if (q < 0.01) q = 0.01;
+      w = tan((double) csound->pidsr * f);
+      k = 1.0 / q;
+      a1 = 1.0 / (1.0 + w * (w + k));
+      t[s] = a1;
+      t[nl + s] = w * a1;
+      t[2*nl + s] = w * w * a1;
+      switch (p->mode) {                  /* m1 for the response */
+      case 0: t[3*nl + s] = 0.0; break;   /* low-pass */
+      case 2: t[3*nl + s] = k; break;     /* band-pass, unity peak */
+      case 5: t[3*nl + s] = -2.0 * k; break; /* all-pass */
+      default: t[3*nl + s] = -k;          /* high-pass, notch, peak */
+      }
+    }
+    fbank_ramp(FBANK(p, SVF_C), FBANK(p, SVF_D), t, nl, 4,
+               p->init_k || *p->ismooth == FL(0.0) || nsmps <= offset,
+               nsmps - offset);
+    p->init_k = 0;
+    fbank_clear(p->out, nsect, ksmps, offset, early);
+    for (g = 0; g < nsect; g += 4) {
+      int32_t nact = fbank_io(xin, yout, p->in, p->inarr, p->out, g, nsect,
+                              ksmps);
+      svfbank_group(p, g, xin, yout, nact, offset, nsmps);
+    }
+    memcpy(FBANK(p, SVF_C), t, 4 * nl * sizeof(double));
+    return OK;
+}
+
+
 #define S(x)    sizeof(x)
 
 static OENTRY localops[] = {
@@ -1697,6 +2127,14 @@ static OENTRY localops[] = {
 { "mode",  S(MODE),   0, 3,      "a", "axxo", (SUBR)modeset,  (SUBR)mode   },
 { "mvmfilter", S(MVMFILT), 0, 3, "a", "axxo",
                                   (SUBR) mvmfilterset, (SUBR) mvmfilter },
+{ "biquadbank", S(BQBANK), 0, 3, "a[]", "ak[]k[]k[]k[]k[]k[]p",
+                                  (SUBR) bqbankset, (SUBR) bqbank },
+{ "biquadbank.A", S(BQBANK), 0, 3, "a[]", "a[]k[]k[]k[]k[]k[]k[]p",
+                                  (SUBR) bqbankset_arr, (SUBR) bqbank },
+{ "svfbank", S(SVFBANK), 0, 3, "a[]", "ak[]k[]op",
+                                  (SUBR) svfbankset, (SUBR) svfbank },
+{ "svfbank.A", S(SVFBANK), 0, 3, "a[]", "a[]k[]k[]op",
+                                  (SUBR) svfbankset_arr, (SUBR) svfbank },
 };
 
 int32_t biquad_init_(CSOUND *csound)
@@ -25,6 +25,7 @@
 
                                                         /* biquad.h */
 #include "stdopcod.h"
+#include "fcoef.h"
 
                                 /* Structure for biquadratic filter */
 typedef struct {
@@ -40,6 +41,8 @@ typedef struct {
     double  xnm1, y1nm1, y2nm1, y3nm1, y1n, y2n, y3n, y4n;
     MYFLT   maxint;
     int16   fcocod, rezcod;
+    FCOEF_TABLES *fct;          /* --smooth-filters: k-rate coefficients */
+    double  lfco, lres, kp, pp1d2, k;   /* cached, and ramped on change  */
 } MOOGVCF;
 
                                 /* Structure for rezzy filter */
@@ -133,3 +136,28 @@ typedef struct {
   MYFLT *in, *f0, *tau, *reinit;
   MYFLT x, y;
 } MVMFILT;
+
+/* Structures for the filter banks: N second order sections in parallel,
+   the state and coefficients of each stored as arrays of doubles, padded
+   to a multiple of four sections (see FBANK_* for the layout) */
+typedef struct {
+    OPDS    h;
+    ARRAYDAT *out;
+    void    *in;                /* a, or a[] with one input per section */
+    ARRAYDAT *b0, *b1, *b2, *a0, *a1, *a2;
+    MYFLT   *ismooth;
+    int32_t nsect, nlanes, inarr, init_k;
+    double  *v;
+    AUXCH   aux;
+} BQBANK;
+
+typedef struct {
+    OPDS    h;
+    ARRAYDAT *out;
+    void    *in;
+    ARRAYDAT *kfreq, *kq;
+    MYFLT   *imode, *ismooth;
+    int32_t nsect, nlanes, inarr, init_k, mode;
+    double  *v;
+    AUXCH   aux;
+} SVFBANK;
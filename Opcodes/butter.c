@@ -26,12 +26,14 @@
 /*              Copyright (c) May 1994.  All rights reserved            */
 
 #include "stdopcod.h"
+#include "fcoef.h"
 
 typedef struct  {
         OPDS    h;
         MYFLT   *sr, *ain, *kfc, *istor;
         MYFLT   lkf;
         double  a[8];
+        FCOEF_TABLES *fct;      /* --smooth-filters */
 } BFIL;
 
 typedef struct  {
@@ -45,14 +47,16 @@ typedef struct  {
 //#define ROOT2 (1.4142135623730950488)
 
 static void butter_filter(uint32_t, uint32_t, MYFLT *, MYFLT *, double *);
+static void butter_filter_ramp(uint32_t, uint32_t, MYFLT *, MYFLT *,
+                               double *, double *);
 
 int32_t butset(CSOUND *csound, BFIL *p)      /*      Hi/Lo pass set-up   */
 {
-     IGN(csound);
     if (*p->istor==FL(0.0)) {
       p->a[6] = p->a[7] = 0.0;
       p->lkf = FL(0.0);
     }
+    p->fct = fcoef_tables(csound);
     return OK;
 }
 
@@ -77,17 +81,25 @@ static int32_t hibut(CSOUND *csound, BFIL *p)       /*      Hipass filter
     }
 
     if (*p->kfc != p->lkf)      {
-      double    *a, c;
+      double    *a, c, old[6];
+      int32_t   ramp = (p->fct != NULL && p->lkf > FL(0.0) && nsmps > offset);
 
       a = p->a;
+      if (ramp) memcpy(old, a, 6*sizeof(double));
       p->lkf = *p->kfc;
-      c = tan((double)(csound->pidsr * p->lkf));
+      c = (p->fct != NULL ?
+           fcoef_tanpi(p->fct, (double)(csound->onedsr * p->lkf)) :
+           tan((double)(csound->pidsr * p->lkf)));
 
       a[1] = 1.0 / ( 1.0 + ROOT2 * c + c * c);
       a[2] = -(a[1] + a[1]);
       a[3] = a[1];
       a[4] = 2.0 * ( c*c - 1.0) * a[1];
       a[5] = ( 1.0 - ROOT2 * c + c * c) * a[1];
+      if (ramp) {
+        butter_filter_ramp(nsmps, offset, in, out, p->a, old);
+        return OK;
+      }
     }
     butter_filter(nsmps, offset, in, out, p->a);
     return OK;
@@ -115,15 +127,23 @@ static int32_t lobut(CSOUND *csound, BFIL *p)       /*      Lopass filter
     }
 
     if (*p->kfc != p->lkf) {
-      double     *a, c;
+      double     *a, c, old[6];
+      int32_t    ramp = (p->fct != NULL && p->lkf > FL(0.0) && nsmps > offset);
       a = p->a;
+      if (ramp) memcpy(old, a, 6*sizeof(double));
       p->lkf = *p->kfc;
-      c = 1.0 / tan((double)(csound->pidsr * p->lkf));
+      c = 1.0 / (p->fct != NULL ?
+                 fcoef_tanpi(p->fct, (double)(csound->onedsr * p->lkf)) :
+                 tan((double)(csound->pidsr * p->lkf)));
       a[1] = 1.0 / ( 1.0 + ROOT2 * c + c * c);
       a[2] = a[1] + a[1];
       a[3] = a[1];
       a[4] = 2.0 * ( 1.0 - c*c) * a[1];
       a[5] = ( 1.0 - ROOT2 * c + c * c) * a[1];
+      if (ramp) {
+        butter_filter_ramp(nsmps, offset, in, out, p->a, old);
+        return OK;
+      }
     }
 
     butter_filter(nsmps, offset, in, out, p->a);
@@ -148,6 +168,28 @@ static void butter_filter(uint32_t n, uint32_t offset,
     }
 }
 
+/* Filter loop with the coefficients a[1..5] ramping from old[1..5] */
+
+static void butter_filter_ramp(uint32_t n, uint32_t offset,
+                               MYFLT *in, MYFLT *out, double *a, double *old)
+{
+    double t, y, r = 1.0 / (double) (n - offset);
+    double a1 = old[1], a2 = old[2], a3 = old[3], a4 = old[4], a5 = old[5];
+    double d1 = (a[1] - a1) * r, d2 = (a[2] - a2) * r, d3 = (a[3] - a3) * r;
+    double d4 = (a[4] - a4) * r, d5 = (a[5] - a5) * r;
+    uint32_t nn;
+
+    for (nn=offset; nn<n; nn++) {
+      a1 += d1; a2 += d2; a3 += d3; a4 += d4; a5 += d5;
+      t = (double)in[nn] - a4 * a[6] - a5 * a[7];
+      t = csoundUndenormalizeDouble(t); /* Not needed on AMD */
+      y = t * a1 + a2 * a[6] + a3 * a[7];
+      a[7] = a[6];
+      a[6] = t;
+      out[nn] = (MYFLT)y;
+    }
+}
+
 #define S(x)    sizeof(x)
 
 static OENTRY localops[] = {
@@ -168,12 +168,88 @@ static int32_t freeverb_init(CSOUND *csound, FREEVERB *p)
     return OK;
 }
 
+/* run the eight comb filters of one channel over n samples, summing
+   their outputs into out.  The combs are stepped together one sample at
+   a time, so that their independent filter recursions overlap; within a
+   span where no buffer wraps the lane loop carries no position tests.
+   The outputs are added in comb order, as when the combs ran one after
+   the other. */
+
+static void freeverb_combs(FREEVERB *p, int32_t ch, const MYFLT *in,
+                           MYFLT *out, int32_t n, double feedback,
+                           double damp1, double damp2)
+{
+    MYFLT   *buf[NR_COMB];
+    double  fs[NR_COMB];
+    int32_t pos[NR_COMB];
+    int32_t i, k = 0;
+
+    for (i = 0; i < NR_COMB; i++) {
+      buf[i] = p->Comb[i][ch]->buf;
+      pos[i] = p->Comb[i][ch]->bufPos;
+      fs[i] = p->Comb[i][ch]->filterState;
+    }
+    while (k < n) {
+      int32_t run = n - k, j;
+      for (i = 0; i < NR_COMB; i++)
+        if (p->Comb[i][ch]->nSamples - pos[i] < run)
+          run = p->Comb[i][ch]->nSamples - pos[i];
+      for (j = k; j < k + run; j++) {
+        MYFLT   sum = FL(0.0);
+        double  xin = (double) in[j];
+        for (i = 0; i < NR_COMB; i++) {
+          MYFLT   y = buf[i][pos[i] + j - k];
+          sum += y;
+          fs[i] = (fs[i] * damp1) + ((double) y * damp2);
+          buf[i][pos[i] + j - k] = (MYFLT) (fs[i] * feedback + xin);
+        }
+        out[j] = sum;
+      }
+      for (i = 0; i < NR_COMB; i++) {
+        pos[i] += run;
+        if (pos[i] >= p->Comb[i][ch]->nSamples)
+          pos[i] = 0;
+      }
+      k += run;
+    }
+    for (i = 0; i < NR_COMB; i++) {
+      p->Comb[i][ch]->bufPos = pos[i];
+      p->Comb[i][ch]->filterState = fs[i];
+    }
+}
+
+/* run the allpass filters of one channel in place on buf[0..n-1], in
+   spans between buffer wraps */
+
+static void freeverb_allpasses(FREEVERB *p, int32_t ch, MYFLT *io, int32_t n)
+{
+    int32_t i;
+
+    for (i = 0; i < NR_ALLPASS; i++) {
+      freeVerbAllPass *allpassp = p->AllPass[i][ch];
+      int32_t k = 0;
+      while (k < n) {
+        MYFLT   *buf = allpassp->buf + allpassp->bufPos;
+        MYFLT   *tmp = io + k;
+        int32_t run = allpassp->nSamples - allpassp->bufPos, j;
+        if (run > n - k) run = n - k;
+        for (j = 0; j < run; j++) {
+          double  x = (double) buf[j] - (double) tmp[j];
+          buf[j] *= (MYFLT) allPassFeedBack;
+          buf[j] += tmp[j];
+          tmp[j] = (MYFLT) x;
+        }
+        allpassp->bufPos += run;
+        if (allpassp->bufPos >= allpassp->nSamples)
+          allpassp->bufPos = 0;
+        k += run;
+      }
+    }
+}
+
 static int32_t freeverb_perf(CSOUND *csound, FREEVERB *p)
 {
-    double          feedback, damp1, damp2, x;
-    freeVerbComb    *combp;
-    freeVerbAllPass *allpassp;
-    int32_t             i;
+    double          feedback, damp1, damp2;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t n, nsmps = CS_KSMPS;
@@ -193,32 +269,9 @@ static int32_t freeverb_perf(CSOUND *csound, FREEVERB *p)
     else
       damp1 = p->dampValue;
     damp2 = 1.0 - damp1;
-    /* comb filters (left channel) */
-    memset(p->tmpBuf,0, sizeof(MYFLT)*nsmps);
-    for (i = 0; i < NR_COMB; i++) {
-      combp = p->Comb[i][0];
-      for (n = 0; n < nsmps; n++) {
-        p->tmpBuf[n] += combp->buf[combp->bufPos];
-        x = (double) combp->buf[combp->bufPos];
-        combp->filterState = (combp->filterState * damp1) + (x * damp2);
-        x = combp->filterState * feedback + (double) p->aInL[n];
-        combp->buf[combp->bufPos] = (MYFLT) x;
-        if (UNLIKELY(++(combp->bufPos) >= combp->nSamples))
-          combp->bufPos = 0;
-      }
-    }
-    /* allpass filters (left channel) */
-    for (i = 0; i < NR_ALLPASS; i++) {
-      allpassp = p->AllPass[i][0];
-      for (n = 0; n < nsmps; n++) {
-        x = (double) allpassp->buf[allpassp->bufPos] - (double) p->tmpBuf[n];
-        allpassp->buf[allpassp->bufPos] *= (MYFLT) allPassFeedBack;
-        allpassp->buf[allpassp->bufPos] += p->tmpBuf[n];
-        if (UNLIKELY(++(allpassp->bufPos) >= allpassp->nSamples))
-          allpassp->bufPos = 0;
-        p->tmpBuf[n] = (MYFLT) x;
-      }
-    }
+    /* comb and allpass filters (left channel) */
+    freeverb_combs(p, 0, p->aInL, p->tmpBuf, nsmps, feedback, damp1, damp2);
+    freeverb_allpasses(p, 0, p->tmpBuf, nsmps);
 
     /* write left channel output */
     if (UNLIKELY(offset)) memset(p->aOutL, '\0', offset*sizeof(MYFLT));
@@ -228,35 +281,10 @@ static int32_t freeverb_perf(CSOUND *csound, FREEVERB *p)
     }
     for (n = offset; n < nsmps; n++)
       p->aOutL[n] = p->tmpBuf[n] * (MYFLT) fixedGain;
-    /* comb filters (right channel) */
-    memset(p->tmpBuf, 0, sizeof(MYFLT)*nsmps);
-    /* for (n = 0; n < nsmps; n++) */
-    /*   p->tmpBuf[n] = FL(0.0); */
-    for (i = 0; i < NR_COMB; i++) {
-      combp = p->Comb[i][1];
-      for (n = 0; n < nsmps; n++) {
-        p->tmpBuf[n] += combp->buf[combp->bufPos];
-        x = (double) combp->buf[combp->bufPos];
-        combp->filterState = (combp->filterState * damp1) + (x * damp2);
-        x = combp->filterState * feedback + (double) p->aInR[n];
-        combp->buf[combp->bufPos] = (MYFLT) x;
-        if (UNLIKELY(++(combp->bufPos) >= combp->nSamples))
-          combp->bufPos = 0;
-      }
-    }
-    /* allpass filters (right channel) */
-    for (i = 0; i < NR_ALLPASS; i++) {
-      allpassp = p->AllPass[i][1];
-      for (n = 0; n < nsmps; n++) {
-        x = (double) allpassp->buf[allpassp->bufPos] - (double) p->tmpBuf[n];
-        allpassp->buf[allpassp->bufPos] *= (MYFLT) allPassFeedBack;
-        allpassp->buf[allpassp->bufPos] += p->tmpBuf[n];
-        if (UNLIKELY(++(allpassp->bufPos) >= allpassp->nSamples))
-          allpassp->bufPos = 0;
-        p->tmpBuf[n] = (MYFLT) x;
-      }
-    }
     nsmps = CS_KSMPS;
+    /* comb and allpass filters (right channel) */
+    freeverb_combs(p, 1, p->aInR, p->tmpBuf, nsmps, feedback, damp1, damp2);
+    freeverb_allpasses(p, 1, p->tmpBuf, nsmps);
     /* write right channel output */
     if (UNLIKELY(offset)) memset(p->aOutR, '\0', offset*sizeof(MYFLT));
     if (UNLIKELY(early)) {
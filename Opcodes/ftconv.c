@@ -25,6 +25,32 @@
 #include <math.h>
 
 #define FTCONV_MAXCHN   8
+/* non-uniform mode: each tail tier uses partitions FTCONV_TIERRATIO times
+   longer than the previous one, and is computed on its own thread */
+#define FTCONV_TIERRATIO 8
+#define FTCONV_MAXTIERS 3
+
+typedef struct {
+    CSOUND  *csound;
+    int32_t     nChannels;
+    int32_t     partSize;       /* partition length in sample frames        */
+    int32_t     nPartitions;    /* number of convolve partitions            */
+    int32_t     rbCnt;          /* ring buffer index, 0 to nPartitions - 1  */
+    int32_t     cnt;            /* input position, 0 to partSize - 1        */
+    uint32_t    outMask;        /* output ring length - 1                   */
+    uint32_t    jobPos;         /* output ring position of the current job  */
+    MYFLT   *inBuf;             /* input being collected by the perf pass   */
+    MYFLT   *jobBuf;            /* input block handed to the tier thread    */
+    MYFLT   *tmpBuf[FTCONV_MAXCHN];
+    MYFLT   *ringBuf;
+    MYFLT   *IR_Data[FTCONV_MAXCHN];
+    MYFLT   *outRing[FTCONV_MAXCHN];    /* delayed output, overlap-added    */
+    void    *fwdsetup, *invsetup;
+    void    *thread;
+    void    *jobReady, *jobDone;
+    volatile int32_t threadon;
+    AUXCH   auxData;
+} FTCONV_TIER;
 
 typedef struct {
     OPDS    h;
@@ -35,6 +61,7 @@ typedef struct {
     MYFLT   *iSkipSamples;
     MYFLT   *iTotLen;
     MYFLT   *iSkipInit;
+    MYFLT   *iNonUniform;
  /* ------------------------- */
     int32_t     initDone;
     int32_t     nChannels;
@@ -42,12 +69,16 @@ typedef struct {
     int32_t     nPartitions;    /* number of convolve partitions            */
     int32_t     partSize;       /* partition length in sample frames        */
     int32_t     rbCnt;          /* ring buffer index, 0 to nPartitions - 1  */
-    MYFLT   *tmpBuf;            /* temporary buffer for accumulating FFTs   */
+    MYFLT   *tmpBuf[FTCONV_MAXCHN]; /* buffers for accumulating FFTs      */
     MYFLT   *ringBuf;           /* ring buffer of FFTs of input partitions  */
     MYFLT   *IR_Data[FTCONV_MAXCHN];    /* impulse responses (scaled)       */
     MYFLT   *outBuffers[FTCONV_MAXCHN]; /* output buffer (size=partSize*2)  */
     void  *fwdsetup, *invsetup;
     AUXCH   auxData;
+    int32_t     nTiers;         /* number of tail tiers (non-uniform mode)  */
+    uint32_t    tailPos;        /* sample counter for the tier output rings */
+    FTCONV_TIER tier[FTCONV_MAXTIERS];
+    int32_t     deinitRegistered; /* ftconv_deinit() is due at note end */
 } FTCONV;
 
 static void multiply_fft_buffers(MYFLT *outBuf, MYFLT *ringBuf,
@@ -118,7 +149,7 @@ static inline int32_t buf_bytes_alloc(int32_t nChannels,
 {
     int32_t nSmps;
 
-    nSmps = (partSize << 1);                                /* tmpBuf     */
+    nSmps = ((partSize << 1) * nChannels);                  /* tmpBuf     */
     nSmps += ((partSize << 1) * nPartitions);               /* ringBuf    */
     nSmps += ((partSize << 1) * nChannels * nPartitions);   /* IR_Data    */
     nSmps += ((partSize << 1) * nChannels);                 /* outBuffers */
@@ -134,8 +165,10 @@ static void set_buf_pointers(FTCONV *p,
     int32_t   i;
 
     ptr = (MYFLT*) (p->auxData.auxp);
-    p->tmpBuf = ptr;
-    ptr += (partSize << 1);
+    for (i = 0; i < nChannels; i++) {
+      p->tmpBuf[i] = ptr;
+      ptr += (partSize << 1);
+    }
     p->ringBuf = ptr;
     ptr += ((partSize << 1) * nPartitions);
     for (i = 0; i < nChannels; i++) {
@@ -148,10 +181,192 @@ static void set_buf_pointers(FTCONV *p,
     }
 }
 
+/* copy IR partitions starting at sample frame 'irStart' of the table into
+   IR_Data (in reverse partition order, zero padded to double length), and
+   replace them with their FFTs, FTCONV_MAXCHN partitions at a time */
+
+static void load_ir_partitions(CSOUND *csound, FUNC *ftp, MYFLT **IR_Data,
+                               int32_t nChannels, int32_t partSize,
+                               int32_t nPartitions, int32_t irStart,
+                               void *fwdsetup)
+{
+    MYFLT   *bufs[FTCONV_MAXCHN];
+    int32_t     i, j, k, n, nbufs = 0;
+
+    for (j = 0; j < nChannels; j++) {
+      i = (irStart * nChannels) + j;                  /* table read position */
+      n = (partSize << 1) * (nPartitions - 1);        /* IR write position */
+      do {
+        for (k = 0; k < partSize; k++) {
+          if (i >= 0 && i < (int32_t) ftp->flen)
+            IR_Data[j][n + k] = ftp->ftable[i];
+          else
+            IR_Data[j][n + k] = FL(0.0);
+          i += nChannels;
+        }
+        /* pad second half of IR to zero */
+        for (k = partSize; k < (partSize << 1); k++)
+          IR_Data[j][n + k] = FL(0.0);
+        n -= (partSize << 1);
+      } while (n >= 0);
+    }
+    for (j = 0; j < nChannels; j++)
+      for (n = 0; n < nPartitions; n++) {
+        bufs[nbufs++] = &(IR_Data[j][(partSize << 1) * n]);
+        if (nbufs == FTCONV_MAXCHN) {
+          csound->RealFFT2Batch(csound, fwdsetup, bufs, nbufs);
+          nbufs = 0;
+        }
+      }
+    if (nbufs)
+      csound->RealFFT2Batch(csound, fwdsetup, bufs, nbufs);
+}
+
+/* tail tier thread: waits for a block of input from the perf pass,
+   convolves it with the tier's partitions, and mixes the result into the
+   output ring at t->jobPos, where the perf pass will read it no earlier
+   than one tier block later */
+
+static uintptr_t ftconv_tier_thread(void *data)
+{
+    FTCONV_TIER *t = (FTCONV_TIER*) data;
+    CSOUND      *csound = t->csound;
+    MYFLT       *rBuf, *x, *y;
+    int32_t     i, n, nSamples = t->partSize;
+    uint32_t    pos, mask = t->outMask;
+
+    for (;;) {
+      csound->WaitThreadLockNoTimeout(t->jobReady);
+      if (!t->threadon)
+        break;
+      rBuf = &(t->ringBuf[t->rbCnt * (nSamples << 1)]);
+      memcpy(rBuf, t->jobBuf, nSamples * sizeof(MYFLT));
+      memset(&rBuf[nSamples], 0, nSamples * sizeof(MYFLT));
+      csound->RealFFT2(csound, t->fwdsetup, rBuf);
+      if (++t->rbCnt >= t->nPartitions)
+        t->rbCnt = 0;
+      for (n = 0; n < t->nChannels; n++)
+        multiply_fft_buffers(t->tmpBuf[n], t->ringBuf, t->IR_Data[n],
+                             nSamples, t->nPartitions,
+                             t->rbCnt * (nSamples << 1));
+      csound->RealFFT2Batch(csound, t->invsetup, t->tmpBuf, t->nChannels);
+      for (n = 0; n < t->nChannels; n++) {
+        x = t->tmpBuf[n];
+        y = t->outRing[n];
+        pos = t->jobPos;
+        for (i = 0; i < (nSamples << 1); i++)
+          y[(pos + i) & mask] += x[i];
+      }
+      csound->NotifyThreadLock(t->jobDone);
+    }
+    return (uintptr_t) 0;
+}
+
+static void ftconv_tiers_stop(CSOUND *csound, FTCONV *p)
+{
+    int32_t i;
+
+    for (i = 0; i < FTCONV_MAXTIERS; i++) {
+      FTCONV_TIER *t = &(p->tier[i]);
+      if (t->thread != NULL) {
+        t->threadon = 0;
+        csound->NotifyThreadLock(t->jobReady);
+        csound->JoinThread(t->thread);
+        t->thread = NULL;
+      }
+      if (t->jobReady != NULL) {
+        csound->DestroyThreadLock(t->jobReady);
+        t->jobReady = NULL;
+      }
+      if (t->jobDone != NULL) {
+        csound->DestroyThreadLock(t->jobDone);
+        t->jobDone = NULL;
+      }
+    }
+    p->nTiers = 0;
+}
+
+static int32_t ftconv_deinit(CSOUND *csound, void *p)
+{
+    ftconv_tiers_stop(csound, (FTCONV*) p);
+    ((FTCONV*) p)->deinitRegistered = 0;
+    return OK;
+}
+
+/* set up a tail tier covering 'nPartitions' partitions of 'partSize'
+   frames, starting at IR frame 'irStart'; its output is delayed by
+   'delay' frames relative to the block it was computed from */
+
+static int32_t ftconv_tier_init(CSOUND *csound, FTCONV *p, FTCONV_TIER *t,
+                                FUNC *ftp, int32_t partSize,
+                                int32_t nPartitions, int32_t irStart,
+                                int32_t delay)
+{
+    MYFLT   *ptr;
+    int32_t     i, nSmps;
+
+    nSmps = (partSize << 1);                                /* inBuf, jobBuf */
+    nSmps += ((partSize << 1) * p->nChannels);              /* tmpBuf     */
+    nSmps += ((partSize << 1) * nPartitions);               /* ringBuf    */
+    nSmps += ((partSize << 1) * p->nChannels * nPartitions);/* IR_Data    */
+    nSmps += ((partSize << 2) * p->nChannels);              /* outRing    */
+    if ((size_t) nSmps * sizeof(MYFLT) != t->auxData.size)
+      csound->AuxAlloc(csound, (size_t) nSmps * sizeof(MYFLT), &(t->auxData));
+    ptr = (MYFLT*) t->auxData.auxp;
+    memset(ptr, 0, (size_t) nSmps * sizeof(MYFLT));
+    t->inBuf = ptr;
+    ptr += partSize;
+    t->jobBuf = ptr;
+    ptr += partSize;
+    for (i = 0; i < p->nChannels; i++) {
+      t->tmpBuf[i] = ptr;
+      ptr += (partSize << 1);
+    }
+    t->ringBuf = ptr;
+    ptr += ((partSize << 1) * nPartitions);
+    for (i = 0; i < p->nChannels; i++) {
+      t->IR_Data[i] = ptr;
+      ptr += ((partSize << 1) * nPartitions);
+    }
+    for (i = 0; i < p->nChannels; i++) {
+      t->outRing[i] = ptr;
+      ptr += (partSize << 2);
+    }
+    t->csound = csound;
+    t->nChannels = p->nChannels;
+    t->partSize = partSize;
+    t->nPartitions = nPartitions;
+    t->rbCnt = 0;
+    t->cnt = 0;
+    t->outMask = (uint32_t) (partSize << 2) - 1U;
+    /* blocks are aligned to the tail sample counter, which starts at zero;
+       block k is written at k * partSize + delay */
+    t->jobPos = (uint32_t) delay - (uint32_t) partSize;
+    t->fwdsetup = csound->RealFFT2Setup(csound, (partSize << 1), FFT_FWD);
+    t->invsetup = csound->RealFFT2Setup(csound, (partSize << 1), FFT_INV);
+    load_ir_partitions(csound, ftp, t->IR_Data, p->nChannels, partSize,
+                       nPartitions, irStart, t->fwdsetup);
+    /* jobReady starts cleared (no job yet), jobDone starts signalled */
+    t->jobReady = csound->CreateThreadLock();
+    t->jobDone = csound->CreateThreadLock();
+    if (UNLIKELY(t->jobReady == NULL || t->jobDone == NULL))
+      return csound->InitError(csound, Str("ftconv: could not create "
+                                           "thread lock"));
+    csound->WaitThreadLock(t->jobReady, (size_t) 0);
+    t->threadon = 1;
+    t->thread = csound->CreateThread(ftconv_tier_thread, (void*) t);
+    if (UNLIKELY(t->thread == NULL)) {
+      t->threadon = 0;
+      return csound->InitError(csound, Str("ftconv: could not create "
+                                           "convolution thread"));
+    }
+    return OK;
+}
+
 static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
 {
     FUNC    *ftp;
-    int32_t     i, j, k, n, nBytes, skipSamples;
+    int32_t     i, j, n, nBytes, skipSamples, nonUniform, irLen;
     //MYFLT   FFTscale;
 
     /* check parameters */
@@ -179,12 +394,21 @@ static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
                                Str("ftconv: invalid length, or insufficient"
                                    " IR data for convolution"));
     }
+    irLen = n;
     p->nPartitions = (n + (p->partSize - 1)) / p->partSize;
+    /* in non-uniform mode, the head partitions only cover the part of the
+       IR that the first tail tier cannot compute in time */
+    nonUniform = (*(p->iNonUniform) != FL(0.0) &&
+                  p->nPartitions > 2 * FTCONV_TIERRATIO);
+    if (nonUniform)
+      p->nPartitions = 2 * FTCONV_TIERRATIO;
+    /* tail tier threads from a previous init pass must not outlive it */
+    ftconv_tiers_stop(csound, p);
     /* calculate the amount of aux space to allocate (in bytes) */
     nBytes = buf_bytes_alloc(p->nChannels, p->partSize, p->nPartitions);
     if (nBytes != (int32_t) p->auxData.size)
       csound->AuxAlloc(csound, (int32) nBytes, &(p->auxData));
-    else if (p->initDone > 0 && *(p->iSkipInit) != FL(0.0))
+    else if (p->initDone > 0 && *(p->iSkipInit) != FL(0.0) && !nonUniform)
       return OK;    /* skip initialisation if requested */
     /* if skipping samples: check for possible truncation of IR */
     /*
@@ -216,36 +440,84 @@ static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
     //FFTscale = csound->GetInverseRealFFTScale(csound, (p->partSize << 1));
     p->fwdsetup = csound->RealFFT2Setup(csound,(p->partSize << 1), FFT_FWD);
     p->invsetup = csound->RealFFT2Setup(csound,(p->partSize << 1), FFT_INV);
-    for (j = 0; j < p->nChannels; j++) {
-      i = (skipSamples * p->nChannels) + j;           /* table read position */
-      n = (p->partSize << 1) * (p->nPartitions - 1);  /* IR write position */
-      do {
-        for (k = 0; k < p->partSize; k++) {
-          if (i >= 0 && i < (int32_t) ftp->flen)
-            p->IR_Data[j][n + k] = ftp->ftable[i];// * FFTscale;
-          else
-            p->IR_Data[j][n + k] = FL(0.0);
-          i += p->nChannels;
-        }
-        /* pad second half of IR to zero */
-        for (k = p->partSize; k < (p->partSize << 1); k++)
-          p->IR_Data[j][n + k] = FL(0.0);
-        /* calculate FFT */
-        csound->RealFFT2(csound, p->fwdsetup, &(p->IR_Data[j][n]));
-        n -= (p->partSize << 1);
-      } while (n >= 0);
-    }
+    load_ir_partitions(csound, ftp, p->IR_Data, p->nChannels, p->partSize,
+                       p->nPartitions, skipSamples, p->fwdsetup);
     /* clear output buffers to zero */
     /*memset(p->outBuffers, 0, p->nChannels*(p->partSize << 1)*sizeof(MYFLT));*/
     for (j = 0; j < p->nChannels; j++) {
       for (i = 0; i < (p->partSize << 1); i++)
         p->outBuffers[j][i] = FL(0.0);
     }
+    p->tailPos = 0U;
+    if (nonUniform) {
+      /* tier t has partitions of partSize * TIERRATIO^t frames, and covers
+         the IR from twice its partition length to twice the partition
+         length of the next tier; the last tier takes the rest of the IR */
+      int32_t irPos = p->partSize * p->nPartitions, tierSize = p->partSize;
+      /* once per note: a reinit starts the tiers again, and the
+         callback registered by the first init stops them */
+      if (!p->deinitRegistered) {
+        csound->RegisterDeinitCallback(csound, (void*) p, ftconv_deinit);
+        p->deinitRegistered = 1;
+      }
+      while (irPos < irLen && p->nTiers < FTCONV_MAXTIERS) {
+        int32_t nParts;
+        tierSize *= FTCONV_TIERRATIO;
+        if (p->nTiers == FTCONV_MAXTIERS - 1)
+          nParts = (irLen - irPos + (tierSize - 1)) / tierSize;
+        else {
+          nParts = 2 * FTCONV_TIERRATIO - 2;
+          if (irPos + nParts * tierSize > irLen)
+            nParts = (irLen - irPos + (tierSize - 1)) / tierSize;
+        }
+        /* the head output is delayed by partSize, so the tail is too */
+        if (ftconv_tier_init(csound, p, &(p->tier[p->nTiers]), ftp,
+                             tierSize, nParts, skipSamples + irPos,
+                             irPos + p->partSize) != OK) {
+          ftconv_tiers_stop(csound, p);
+          return NOTOK;
+        }
+        p->nTiers++;
+        irPos += nParts * tierSize;
+      }
+    }
     p->initDone = 1;
 
     return OK;
 }
 
+/* feed one input sample to the tail tiers, and mix their delayed output
+   into sample 'nn' of the outputs; at the end of each tier block, wait for
+   the tier thread to finish the previous block before handing it the
+   next one */
+
+static inline void ftconv_tiers_sample(CSOUND *csound, FTCONV *p,
+                                       MYFLT x, uint32_t nn)
+{
+    int32_t     i, n;
+    uint32_t    pos = p->tailPos++;
+
+    for (i = 0; i < p->nTiers; i++) {
+      FTCONV_TIER *t = &(p->tier[i]);
+      uint32_t    rpos = pos & t->outMask;
+      for (n = 0; n < p->nChannels; n++) {
+        p->aOut[n][nn] += t->outRing[n][rpos];
+        t->outRing[n][rpos] = FL(0.0);
+      }
+      t->inBuf[t->cnt] = x;
+      if (++t->cnt >= t->partSize) {
+        MYFLT *tmp;
+        t->cnt = 0;
+        csound->WaitThreadLockNoTimeout(t->jobDone);
+        tmp = t->jobBuf;
+        t->jobBuf = t->inBuf;
+        t->inBuf = tmp;
+        t->jobPos += (uint32_t) t->partSize;
+        csound->NotifyThreadLock(t->jobReady);
+      }
+    }
+}
+
 static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
 {
     MYFLT         *x, *rBuf;
@@ -271,6 +543,8 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
       /* copy output signals from buffer */
       for (n = 0; n < p->nChannels; n++)
         p->aOut[n][nn] = p->outBuffers[n][p->cnt];
+      if (p->nTiers)
+        ftconv_tiers_sample(csound, p, p->aIn[nn], nn);
       /* is input buffer full ? */
       if (++p->cnt < nSamples)
         continue;                   /* no, continue with next sample */
@@ -286,18 +560,18 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
         p->rbCnt = 0;
       rBufPos = p->rbCnt * (nSamples << 1);
       rBuf = &(p->ringBuf[rBufPos]);
-      /* for each channel: */
-      for (n = 0; n < p->nChannels; n++) {
-        /* multiply complex arrays */
-        multiply_fft_buffers(p->tmpBuf, p->ringBuf, p->IR_Data[n],
+      /* for each channel: multiply complex arrays */
+      for (n = 0; n < p->nChannels; n++)
+        multiply_fft_buffers(p->tmpBuf[n], p->ringBuf, p->IR_Data[n],
                              nSamples, p->nPartitions, rBufPos);
-        /* inverse FFT */
-        csound->RealFFT2(csound, p->invsetup, p->tmpBuf);
+      /* inverse FFT of all channels */
+      csound->RealFFT2Batch(csound, p->invsetup, p->tmpBuf, p->nChannels);
+      for (n = 0; n < p->nChannels; n++) {
         /* copy to output buffer, overlap with "tail" of previous block */
         x = &(p->outBuffers[n][0]);
         for (i = 0; i < nSamples; i++) {
-          x[i] = p->tmpBuf[i] + x[i + nSamples];
-          x[i + nSamples] = p->tmpBuf[i + nSamples];
+          x[i] = p->tmpBuf[n][i] + x[i + nSamples];
+          x[i + nSamples] = p->tmpBuf[n][i + nSamples];
         }
       }
     }
@@ -313,7 +587,7 @@ int32_t ftconv_init_(CSOUND *csound)
 {
     return csound->AppendOpcode(csound, "ftconv",
                                 (int32_t) sizeof(FTCONV), TR, 3,
-                                "mmmmmmmm", "aiiooo",
+                                "mmmmmmmm", "aiioooo",
                                 (int32_t (*)(CSOUND *, void *)) ftconv_init,
                                 (int32_t (*)(CSOUND *, void *)) ftconv_perf,
                                 NULL);
@@ -54,10 +54,17 @@ static double TanH(double x)
   return sign*fast_tanh(x);
 }
 
+/* exp(-2 pi f fcr) of the tuning, from the cache with --smooth-filters */
+
+static inline double moog_exp(moogladder *p, double f, double fcr)
+{
+  return (p->fct != NULL ? fcoef_exp2pi(p->fct, f*fcr) : exp(-(TWOPI*f*fcr)));
+}
+
 static int32_t moogladder_init(CSOUND *csound, moogladder *p)
 {
   /* int32_t i; */
-  IGN(csound);
+  p->fct = fcoef_tables(csound);
   if (LIKELY(*p->istor == FL(0.0))) {
     /* for (i = 0; i < 6; i++) */
     /*   p->delay[i] = 0.0; */
@@ -81,7 +88,9 @@ static int32_t moogladder_process(CSOUND *csound, moogladder *p)
   double  *delay = p->delay;
   double  *tanhstg = p->tanhstg;
   double  stg[4], input;
-  double  acr, tune;
+  double  acr, tune, dtune = 0.0, dres4 = 0.0;
+  double  otune = p->oldtune, ores4 = 4.0*(double)p->oldres*p->oldacr;
+  int32_t ramp = (p->fct != NULL && p->oldres >= FL(0.0));
   double vt = 1./(1.22070315*csound->Get0dBFS(csound)); /* (1.0 / 40000.0) transistor thermal voltage  */
   int32_t     j;
   uint32_t offset = p->h.insdshead->ksmps_offset;
@@ -101,7 +110,7 @@ static int32_t moogladder_process(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = res;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -118,7 +127,14 @@ static int32_t moogladder_process(CSOUND *csound, moogladder *p)
     nsmps -= early;
     memset(&out[nsmps], '\0', early*sizeof(MYFLT));
   }
+  if (ramp && (tune != otune || res4 != ores4) && nsmps > offset) {
+    /* --smooth-filters: ramp from the previous values */
+    double r = 1.0 / (double) (nsmps - offset);
+    dtune = (tune - otune) * r; dres4 = (res4 - ores4) * r;
+    tune = otune; res4 = ores4;
+  }
   for (i = offset; i < nsmps; i++) {
+    tune += dtune; res4 += dres4;
     /* oversampling  */
     for (j = 0; j < 2; j++) {
 
@@ -183,7 +199,7 @@ static int32_t moogladder_process_aa(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = cres;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -212,7 +228,7 @@ static int32_t moogladder_process_aa(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldres = cres;
       p->oldacr = acr;
       p->oldtune = tune;
@@ -282,7 +298,7 @@ static int32_t moogladder_process_ak(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = res;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -311,7 +327,7 @@ static int32_t moogladder_process_ak(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldacr = acr;
       p->oldtune = tune;
       res4 = 4.0*(double)res*acr;
@@ -381,7 +397,7 @@ static int32_t moogladder_process_ka(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = cres;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -409,7 +425,7 @@ static int32_t moogladder_process_ka(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldres = cres = res[i];
       p->oldacr = acr;
       p->oldtune = tune;
@@ -459,7 +475,9 @@ static int32_t moogladder2_process(CSOUND *csound, moogladder *p)
   double  *delay = p->delay;
   double  *tanhstg = p->tanhstg;
   double  stg[4], input;
-  double  acr, tune;
+  double  acr, tune, dtune = 0.0, dres4 = 0.0;
+  double  otune = p->oldtune, ores4 = 4.0*(double)p->oldres*p->oldacr;
+  int32_t ramp = (p->fct != NULL && p->oldres >= FL(0.0));
   double vt = 1./(1.22070315*csound->Get0dBFS(csound)); /* (1.0 / 40000.0) transistor thermal voltage  */
   int32_t     j;
   uint32_t offset = p->h.insdshead->ksmps_offset;
@@ -479,7 +497,7 @@ static int32_t moogladder2_process(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = res;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -496,7 +514,14 @@ static int32_t moogladder2_process(CSOUND *csound, moogladder *p)
     nsmps -= early;
     memset(&out[nsmps], '\0', early*sizeof(MYFLT));
   }
+  if (ramp && (tune != otune || res4 != ores4) && nsmps > offset) {
+    /* --smooth-filters: ramp from the previous values */
+    double r = 1.0 / (double) (nsmps - offset);
+    dtune = (tune - otune) * r; dres4 = (res4 - ores4) * r;
+    tune = otune; res4 = ores4;
+  }
   for (i = offset; i < nsmps; i++) {
+    tune += dtune; res4 += dres4;
     /* oversampling  */
     for (j = 0; j < 2; j++) {
       /* filter stages  */
@@ -560,7 +585,7 @@ static int32_t moogladder2_process_aa(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = cres;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -589,7 +614,7 @@ static int32_t moogladder2_process_aa(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldres = cres;
       p->oldacr = acr;
       p->oldtune = tune;
@@ -659,7 +684,7 @@ static int32_t moogladder2_process_ak(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = res;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -688,7 +713,7 @@ static int32_t moogladder2_process_ak(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldacr = acr;
       p->oldtune = tune;
       res4 = 4.0*(double)res*acr;
@@ -758,7 +783,7 @@ static int32_t moogladder2_process_ka(CSOUND *csound, moogladder *p)
     /* frequency & amplitude correction  */
     fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
     acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-    tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+    tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
     p->oldres = cres;
     p->oldacr = acr;
     p->oldtune = tune;
@@ -786,7 +811,7 @@ static int32_t moogladder2_process_ka(CSOUND *csound, moogladder *p)
       /* frequency & amplitude correction  */
       fcr = 1.8730*fc3 + 0.4955*fc2 - 0.6490*fc + 0.9988;
       acr = -3.9364*fc2 + 1.8409*fc + 0.9968;
-      tune = (1.0 - exp(-(TWOPI*f*fcr))) / vt;   /* filter tuning  */
+      tune = (1.0 - moog_exp(p, f, fcr)) / vt;   /* filter tuning  */
       p->oldres = cres = res[i];
       p->oldacr = acr;
       p->oldtune = tune;
@@ -828,7 +853,7 @@ static int32_t moogladder2_process_ka(CSOUND *csound, moogladder *p)
 
 static int32_t statevar_init(CSOUND *csound,statevar *p)
 {
-  IGN(csound);
+  p->fct = fcoef_tables(csound);
   if (*p->istor==FL(0.0)) {
     p->bpd = p->lpd = p->lp = 0.0;
     p->oldfreq = FL(0.0);
@@ -851,7 +876,7 @@ static int32_t statevar_process(CSOUND *csound,statevar *p)
   double  lpd = p->lpd;
   double  bpd = p->bpd;
   double  lp  = p->lp, hp = 0.0, bp = 0.0, br = 0.0;
-  double  f,q,lim;
+  double  f,q,lim, df = 0.0, dq = 0.0;
   int32_t ostimes = p->ostimes,j;
   uint32_t offset = p->h.insdshead->ksmps_offset;
   uint32_t early  = p->h.insdshead->ksmps_no_end;
@@ -873,12 +898,31 @@ static int32_t statevar_process(CSOUND *csound,statevar *p)
   }
   q = p->oldq;
   f = p->oldf;
+  if (p->fct != NULL && !asgfr && !asgrs && nsmps > offset &&
+      p->oldfreq > FL(0.0) &&
+      (p->oldfreq != *freq || p->oldres != *res)) {
+    /* --smooth-filters: ramp f and q to the new values */
+    double r = 1.0 / (double) (nsmps - offset);
+    f = 2.0*fcoef_sinpi(p->fct, *freq*(double)csound->onedsr/ostimes);
+    q = 1.0/ *res;
+    lim = ((2.0 - f) *0.05)/ostimes;
+    if (q < lim) q = lim;
+    df = (f - p->oldf) * r; dq = (q - p->oldq) * r;
+    f = p->oldf; q = p->oldq;
+    p->oldf = f + df * (double) (nsmps - offset);
+    p->oldq = q + dq * (double) (nsmps - offset);
+    p->oldfreq = *freq;
+    p->oldres = *res;
+  }
 
   for (i=offset; i<nsmps; i++) {
     MYFLT fr = (asgfr ? freq[i] : *freq);
     MYFLT rs = (asgrs ? res[i] : *res);
+    f += df; q += dq;
     if (p->oldfreq != fr|| p->oldres != rs) {
-      f = 2.0*sin(fr*(double)csound->pidsr/ostimes);
+      f = 2.0*(p->fct != NULL ?
+               fcoef_sinpi(p->fct, fr*(double)csound->onedsr/ostimes) :
+               sin(fr*(double)csound->pidsr/ostimes));
       q = 1.0/rs;
       lim = ((2.0 - f) *0.05)/ostimes;
       /* csound->Message(csound, "lim: %f, q: %f \n", lim, q); */
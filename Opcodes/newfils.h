@@ -110,6 +110,8 @@ on startup. 0 means no initialisation.
 #define _NEWFILS_H
 #define DIM 4
 
+#include "fcoef.h"
+
 typedef struct _moogladder {
   OPDS    h;
   MYFLT   *out;
@@ -124,6 +126,7 @@ typedef struct _moogladder {
   MYFLT   oldres;
   double  oldacr;
   double  oldtune;
+  FCOEF_TABLES *fct;
 } moogladder;
 
 static int32_t moogladder_init(CSOUND *csound,moogladder *p);
@@ -149,6 +152,7 @@ typedef struct _statevar {
   MYFLT   oldres;
   double  oldq;
   double  oldf;
+  FCOEF_TABLES *fct;
 } statevar;
 
 static int32_t statevar_init(CSOUND *csound,statevar *p);
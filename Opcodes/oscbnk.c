@@ -23,6 +23,7 @@
 
 #include "stdopcod.h"
 #include "oscbnk.h"
+#include "oscsimd.h"
 #include <math.h>
 
 static inline STDOPCOD_GLOBALS *get_oscbnk_globals(CSOUND *csound)
@@ -272,6 +273,11 @@ static void oscbnk_lfo(OSCBNK *p, OSCBNK_OSC *o)
     //printf("**** (%d) a1, a2 = %f, %f\n", __LINE__, o->a1, o->a2);
 }
 
+/* vco2 waveform mode, defined with the vco2 opcodes */
+
+static int32_t oscbnk_vco2set(CSOUND *, OSCBNK *);
+static void oscbnk_vco2(OSCBNK *, uint32_t, uint32_t);
+
 /* ---------------- oscbnk set-up ---------------- */
 
 static int32_t oscbnkset(CSOUND *csound, OSCBNK *p)
@@ -367,6 +373,9 @@ static int32_t oscbnkset(CSOUND *csound, OSCBNK *p)
       p->outft = NULL; p->outft_len = 0L;
     }
 
+    if (UNLIKELY(oscbnk_vco2set(csound, p) != OK))   /* vco2 waveform */
+      return NOTOK;
+
     /* allocate space */
 
     if (p->nr_osc < 1) return OK;
@@ -425,12 +434,14 @@ static int32_t oscbnk(CSOUND *csound, OSCBNK *p)
     }
     else if (UNLIKELY((p->seed == 0L) || (p->osc == NULL))) goto err1;
 
-    /* check oscillator ftable */
+    /* check oscillator ftable (not used with a vco2 waveform) */
 
-    ftp = csound->FTFindP(csound, p->args[19]);
-    if (UNLIKELY((ftp == NULL) || ((ft = ftp->ftable) == NULL)))
-      return NOTOK;
-    oscbnk_flen_setup(ftp->flen, &(mask), &(lobits), &(pfrac));
+    if (p->vco2_tabs == NULL) {
+      ftp = csound->FTFindP(csound, p->args[19]);
+      if (UNLIKELY((ftp == NULL) || ((ft = ftp->ftable) == NULL)))
+        return NOTOK;
+      oscbnk_flen_setup(ftp->flen, &(mask), &(lobits), &(pfrac));
+    }
 
     /* some constants */
     pm_enabled = (p->ilfomode & 0x22 ? 1 : 0);
@@ -453,6 +464,11 @@ static int32_t oscbnk(CSOUND *csound, OSCBNK *p)
     }
 
     if (UNLIKELY(early)) nsmps -= early;
+    if (p->vco2_tabs != NULL) {     /* band-limited, four oscs at a time */
+      oscbnk_vco2(p, offset, nsmps);
+      p->init_k = 0;
+      return OK;
+    }
     for (osc_cnt = 0, o = p->osc; osc_cnt < p->nr_osc; osc_cnt++, o++) {
       if (p->init_k) oscbnk_lfo(p, o);
       ph = o->osc_phs;                        /* phase        */
@@ -2186,6 +2202,399 @@ static int32_t vco2(CSOUND *csound, VCO2 *p)
     return OK;
 }
 
+/* ---- band-limited oscillator banks (oscbnk vco2 mode, vco2bank) ---- */
+
+/* The voices of a bank are processed four at a time, one voice per SIMD
+   lane.  Each voice reads the vco2 table selected for its own frequency;
+   when the four voices of a group share a table, the lookups of the
+   whole group use one shift and mask.  The voices are mixed into a
+   four-lane buffer, which is summed once per sample after all groups. */
+
+/* table array for a vco2 waveform (imode of vco2, PWM and ramp excluded) */
+
+static VCO2_TABLE_ARRAY *vco2_bank_tables(CSOUND *csound, int32_t mode)
+{
+    STDOPCOD_GLOBALS  *pp = get_oscbnk_globals(csound);
+    int32_t tnums[8] = { 0, 0, 1, 2, 1, 3, 4, 5 };
+    int32_t tnum = tnums[(mode & 14) >> 1];
+
+    if (tnum >= pp->vco2_nr_table_arrays || pp->vco2_tables[tnum] == NULL) {
+      if (tnum >= 5) return NULL;       /* user defined waveform missing */
+      vco2_tables_create(csound, tnum, -1, NULL);
+    }
+    return pp->vco2_tables[tnum];
+}
+
+/* best table for the frequency f (cycles per sample), as in vco2 */
+
+static inline VCO2_TABLE *vco2_bank_table(VCO2_TABLE_ARRAY *ta,
+                                          MYFLT p_min, MYFLT p_scl, MYFLT f)
+{
+    MYFLT   npart;
+
+    npart = (MYFLT)fabs(f); if (npart < p_min) npart = p_min;
+#ifdef VCO2FT_USE_TABLE
+    return ta->nparts_tabl[(int32_t) (p_scl / npart)];
+#else
+    {
+      int32_t i = 0;
+      npart = p_scl / npart;
+      while (i < (ta->ntabl - 1) && npart >= (MYFLT) ta->tables[i + 1].npart)
+        i++;
+      return &(ta->tables[i]);
+    }
+#endif
+}
+
+/* render the four voices of g, adding voice l at sample nn to
+   acc[4 * nn + l]; am enables the amplitude ramp, eq the oscbnk EQ */
+
+static void vco2_lanes(VCO2_LANES *g, int32_t am, int32_t eq, MYFLT *acc,
+                       uint32_t offset, uint32_t nsmps)
+{
+    uint32_t nn;
+    int32_t  l;
+#if defined(__SSE2__)
+    VCO2_TABLE  *t = g->tabl[0];
+    int32_t uniform = (g->tabl[1] == t && g->tabl[2] == t && g->tabl[3] == t);
+    __m128i ph = _mm_loadu_si128((__m128i*) g->phs);
+    __m128i frq = _mm_loadu_si128((__m128i*) g->frq);
+    __m128i phsmsk = _mm_set1_epi32((int32_t) OSCBNK_PHSMSK);
+    __m128i mask = _mm_set1_epi32((int32_t) t->mask);
+    __m128i lobits = _mm_cvtsi32_si128((int32_t) t->lobits);
+    OSCV    pfrac = oscv_set1(t->pfrac), k, yn;
+    OSCV    a = oscv_load(g->amp), a_d = oscv_load(g->amp_d);
+    OSCV    a1, a2, b0, b1, b2, a1_d, a2_d, b0_d, b1_d, b2_d;
+    OSCV    xnm1, xnm2, ynm1, ynm2;
+
+    if (eq) {
+      a1 = oscv_load(g->a1); a2 = oscv_load(g->a2);
+      b0 = oscv_load(g->b0); b1 = oscv_load(g->b1); b2 = oscv_load(g->b2);
+      a1_d = oscv_load(g->a1_d); a2_d = oscv_load(g->a2_d);
+      b0_d = oscv_load(g->b0_d); b1_d = oscv_load(g->b1_d);
+      b2_d = oscv_load(g->b2_d);
+      xnm1 = oscv_load(g->xnm1); xnm2 = oscv_load(g->xnm2);
+      ynm1 = oscv_load(g->ynm1); ynm2 = oscv_load(g->ynm2);
+    }
+    for (nn = offset; nn < nsmps; nn++) {
+      /* read from table */
+      if (uniform) {
+        __m128i n = _mm_srl_epi32(ph, lobits);
+        OSCV    v0 = oscv_gather(t->ftable, n);
+        OSCV    v1 = oscv_gather(t->ftable + 1, n);
+        k = oscv_add(v0, oscv_mul(oscv_mul(oscv_sub(v1, v0),
+                                           oscv_cvti(_mm_and_si128(ph, mask))),
+                                  pfrac));
+      }
+      else {
+        uint32  phs[4];
+        MYFLT   v[4];
+        _mm_storeu_si128((__m128i*) phs, ph);
+        for (l = 0; l < 4; l++) {
+          VCO2_TABLE  *tl = g->tabl[l];
+          uint32      n = phs[l] >> tl->lobits;
+          v[l] = tl->ftable[n];
+          v[l] += (tl->ftable[n + 1] - v[l])
+                  * (MYFLT) ((int32) (phs[l] & tl->mask)) * tl->pfrac;
+        }
+        k = oscv_load(v);
+      }
+      /* amplitude modulation */
+      if (am) k = oscv_mul(k, (a = oscv_add(a, a_d)));
+      /* EQ */
+      if (eq) {
+        a1 = oscv_add(a1, a1_d); a2 = oscv_add(a2, a2_d);
+        b0 = oscv_add(b0, b0_d); b1 = oscv_add(b1, b1_d);
+        b2 = oscv_add(b2, b2_d);
+        yn = oscv_mul(b2, xnm2);
+        yn = oscv_add(yn, oscv_mul(b1, (xnm2 = xnm1)));
+        yn = oscv_add(yn, oscv_mul(b0, (xnm1 = k)));
+        yn = oscv_sub(yn, oscv_mul(a2, ynm2));
+        yn = oscv_sub(yn, oscv_mul(a1, (ynm2 = ynm1)));
+        k = ynm1 = yn;
+      }
+      /* mix */
+      oscv_store(acc + 4 * nn, oscv_add(oscv_load(acc + 4 * nn), k));
+      /* update phase */
+      ph = _mm_and_si128(_mm_add_epi32(ph, frq), phsmsk);
+    }
+    _mm_storeu_si128((__m128i*) g->phs, ph);
+    oscv_store(g->amp, a);
+    if (eq) {
+      oscv_store(g->a1, a1); oscv_store(g->a2, a2);
+      oscv_store(g->b0, b0); oscv_store(g->b1, b1); oscv_store(g->b2, b2);
+      oscv_store(g->xnm1, xnm1); oscv_store(g->xnm2, xnm2);
+      oscv_store(g->ynm1, ynm1); oscv_store(g->ynm2, ynm2);
+    }
+#else
+    for (l = 0; l < 4; l++) {
+      VCO2_TABLE  *t = g->tabl[l];
+      uint32  n, ph = g->phs[l], frq = g->frq[l];
+      MYFLT   k, yn, a = g->amp[l], a_d = g->amp_d[l];
+      MYFLT   a1 = g->a1[l], a2 = g->a2[l];
+      MYFLT   b0 = g->b0[l], b1 = g->b1[l], b2 = g->b2[l];
+      MYFLT   xnm1 = g->xnm1[l], xnm2 = g->xnm2[l];
+      MYFLT   ynm1 = g->ynm1[l], ynm2 = g->ynm2[l];
+
+      for (nn = offset; nn < nsmps; nn++) {
+        n = ph >> t->lobits; k = t->ftable[n++];
+        k += (t->ftable[n] - k) * (MYFLT) ((int32) (ph & t->mask)) * t->pfrac;
+        if (am) k *= (a += a_d);
+        if (eq) {
+          a1 += g->a1_d[l]; a2 += g->a2_d[l];
+          b0 += g->b0_d[l]; b1 += g->b1_d[l]; b2 += g->b2_d[l];
+          yn = b2 * xnm2; yn += b1 * (xnm2 = xnm1); yn += b0 * (xnm1 = k);
+          yn -= a2 * ynm2; yn -= a1 * (ynm2 = ynm1); k = ynm1 = yn;
+        }
+        acc[4 * nn + l] += k;
+        ph = (ph + frq) & OSCBNK_PHSMSK;
+      }
+      g->phs[l] = ph; g->amp[l] = a;
+      if (eq) {
+        g->a1[l] = a1; g->a2[l] = a2;
+        g->b0[l] = b0; g->b1[l] = b1; g->b2[l] = b2;
+        g->xnm1[l] = xnm1; g->xnm2[l] = xnm2;
+        g->ynm1[l] = ynm1; g->ynm2[l] = ynm2;
+      }
+    }
+#endif
+}
+
+/* sum the four lanes of acc to ar, and clear acc for the next cycle */
+
+static void vco2_lanes_mix(MYFLT *ar, MYFLT *acc,
+                           uint32_t offset, uint32_t nsmps)
+{
+    uint32_t nn;
+
+    for (nn = offset; nn < nsmps; nn++) {
+      ar[nn] = (acc[4 * nn] + acc[4 * nn + 1])
+               + (acc[4 * nn + 2] + acc[4 * nn + 3]);
+      acc[4 * nn] = acc[4 * nn + 1] = acc[4 * nn + 2] = acc[4 * nn + 3]
+        = FL(0.0);
+    }
+}
+
+/* oscbnk with a vco2 waveform (optional last argument, -1: use kfn) */
+
+static int32_t oscbnk_vco2set(CSOUND *csound, OSCBNK *p)
+{
+    int32_t mode;
+    size_t  n;
+
+    p->vco2_tabs = NULL;
+    if (*(p->args[27]) < FL(0.0)) return OK;
+    mode = (int32_t) MYFLT2LONG(*(p->args[27])) & 0x1F;
+    if (UNLIKELY((mode & 14) == 2 || (mode & 14) == 4 || (mode & 16))) {
+      return csound->InitError(csound, Str("oscbnk: vco2 waveform %d "
+                                           "not supported"), mode);
+    }
+    p->vco2_tabs = vco2_bank_tables(csound, mode);
+    if (UNLIKELY(p->vco2_tabs == NULL)) {
+      return csound->InitError(csound, Str("oscbnk: table array not found "
+                                           "for user defined waveform"));
+    }
+    p->vco2_pscl = FL(0.5);
+    p->vco2_pmin = FL(0.5) / (MYFLT) VCO2_MAX_NPART;
+    n = (size_t) CS_KSMPS * 4 * sizeof(MYFLT);
+    if (p->vco2_acc.auxp == NULL || p->vco2_acc.size < n)
+      csound->AuxAlloc(csound, n, &(p->vco2_acc));
+    else
+      memset(p->vco2_acc.auxp, 0, n);
+    return OK;
+}
+
+static void oscbnk_vco2(OSCBNK *p, uint32_t offset, uint32_t nsmps)
+{
+    VCO2_LANES  g;
+    OSCBNK_OSC  *o;
+    MYFLT   *acc = (MYFLT*) p->vco2_acc.auxp;
+    MYFLT   f, pm, nrm = (MYFLT) (nsmps - offset);
+    uint32  ph;
+    int32_t i, l, nl, am, eq = (p->ieqmode >= 0);
+    int32_t pm_enabled = (p->ilfomode & 0x22 ? 1 : 0);
+    int32_t am_enabled = (p->ilfomode & 0x44 ? 1 : 0);
+
+    for (i = 0; i < p->nr_osc; i += 4) {
+      nl = (p->nr_osc - i < 4 ? p->nr_osc - i : 4);
+      /* unused lanes of the last group are silenced by their amplitude */
+      am = (am_enabled || nl < 4);
+      for (l = 0, o = p->osc + i; l < nl; l++, o++) {
+        if (p->init_k) oscbnk_lfo(p, o);
+        ph = o->osc_phs;                      /* phase        */
+        pm = o->osc_phm;                      /* phase mod.   */
+        if ((p->init_k) && (pm_enabled)) {
+          f = pm - (MYFLT) ((int32) pm);
+          ph = (ph + OSCBNK_PHS2INT(f)) & OSCBNK_PHSMSK;
+        }
+        g.amp[l] = o->osc_amp;                /* amplitude    */
+        f = o->osc_frq;                       /* frequency    */
+        if (eq) {
+          g.a1[l] = o->a1; g.a2[l] = o->a2;   /* EQ coeffs    */
+          g.b0[l] = o->b0; g.b1[l] = o->b1; g.b2[l] = o->b2;
+          g.xnm1[l] = o->xnm1; g.xnm2[l] = o->xnm2;
+          g.ynm1[l] = o->ynm1; g.ynm2[l] = o->ynm2;
+        }
+        oscbnk_lfo(p, o);
+        /* initialise ramps */
+        f = ((o->osc_frq + f) * FL(0.5) + *(p->args[1])) * p->frq_scl;
+        if (pm_enabled) {
+          f += (MYFLT) ((double) o->osc_phm - (double) pm) / nrm;
+          f -= (MYFLT) ((int32) f);
+        }
+        g.tabl[l] = vco2_bank_table(p->vco2_tabs, p->vco2_pmin,
+                                    p->vco2_pscl, f);
+        g.phs[l] = ph;
+        g.frq[l] = OSCBNK_PHS2INT(f);
+        g.amp_d[l] = (am_enabled ? (o->osc_amp - g.amp[l]) / nrm : FL(0.0));
+        if (eq) {
+          if (p->eq_interp) {
+            g.a1_d[l] = (o->a1 - g.a1[l]) / nrm;
+            g.a2_d[l] = (o->a2 - g.a2[l]) / nrm;
+            g.b0_d[l] = (o->b0 - g.b0[l]) / nrm;
+            g.b1_d[l] = (o->b1 - g.b1[l]) / nrm;
+            g.b2_d[l] = (o->b2 - g.b2[l]) / nrm;
+          }
+          else {
+            g.a1[l] = o->a1; g.a2[l] = o->a2;
+            g.b0[l] = o->b0; g.b1[l] = o->b1; g.b2[l] = o->b2;
+            g.a1_d[l] = g.a2_d[l] = FL(0.0);
+            g.b0_d[l] = g.b1_d[l] = g.b2_d[l] = FL(0.0);
+          }
+        }
+      }
+      for ( ; l < 4; l++) {                   /* unused lanes */
+        g.tabl[l] = g.tabl[0];
+        g.phs[l] = g.frq[l] = 0UL;
+        g.amp[l] = g.amp_d[l] = FL(0.0);
+        g.a1[l] = g.a2[l] = g.b0[l] = g.b1[l] = g.b2[l] = FL(0.0);
+        g.a1_d[l] = g.a2_d[l] = FL(0.0);
+        g.b0_d[l] = g.b1_d[l] = g.b2_d[l] = FL(0.0);
+        g.xnm1[l] = g.xnm2[l] = g.ynm1[l] = g.ynm2[l] = FL(0.0);
+      }
+      vco2_lanes(&g, am, eq, acc, offset, nsmps);
+      for (l = 0, o = p->osc + i; l < nl; l++, o++) {
+        o->osc_phs = g.phs[l];                /* save phase, amplitude */
+        o->osc_amp = g.amp[l];
+        if (eq) {                             /* and EQ */
+          o->a1 = g.a1[l]; o->a2 = g.a2[l];
+          o->b0 = g.b0[l]; o->b1 = g.b1[l]; o->b2 = g.b2[l];
+          o->xnm1 = g.xnm1[l]; o->xnm2 = g.xnm2[l];
+          o->ynm1 = g.ynm1[l]; o->ynm2 = g.ynm2[l];
+        }
+      }
+    }
+    vco2_lanes_mix(p->args[0], acc, offset, nsmps);
+}
+
+/* ---- vco2bank opcode ---- */
+
+static int32_t vco2bankset(CSOUND *csound, VCO2BANK *p)
+{
+    int32_t mode, i;
+    int32   seed;
+    size_t  n;
+    MYFLT   x;
+
+    if (UNLIKELY(p->kcps->dimensions != 1 || p->kcps->sizes == NULL ||
+                 p->kcps->sizes[0] < 1)) {
+      return csound->InitError(csound, Str("vco2bank: frequency array must "
+                                           "be one-dimensional and "
+                                           "non-empty"));
+    }
+    mode = (int32_t) MYFLT2LONG(*(p->imode)) & 0x1F;
+    if (UNLIKELY((mode & 14) == 2 || (mode & 14) == 4 || (mode & 16))) {
+      return csound->InitError(csound, Str("vco2bank: waveform %d "
+                                           "not supported"), mode);
+    }
+    p->tables = vco2_bank_tables(csound, mode);
+    if (UNLIKELY(p->tables == NULL)) {
+      return csound->InitError(csound, Str("vco2bank: table array not found "
+                                           "for user defined waveform"));
+    }
+    p->f_scl = csound->onedsr;
+    x = *(p->inyx);
+    if (x < FL(0.001)) x = FL(0.001);
+    if (x > FL(0.5)) x = FL(0.5);
+    p->p_min = x / (MYFLT) VCO2_MAX_NPART;
+    p->p_scl = x;
+    /* voice phases, then the mix buffer */
+    p->nvoices = p->kcps->sizes[0];
+    n = (size_t) p->nvoices * sizeof(uint32)
+        + (size_t) CS_KSMPS * 4 * sizeof(MYFLT) + sizeof(MYFLT);
+    if (p->auxdata.auxp == NULL || p->auxdata.size < n)
+      csound->AuxAlloc(csound, n, &(p->auxdata));
+    else
+      memset(p->auxdata.auxp, 0, n);
+    p->phs = (uint32*) p->auxdata.auxp;
+    p->acc = (MYFLT*) p->auxdata.auxp
+             + ((size_t) p->nvoices * sizeof(uint32) + sizeof(MYFLT) - 1)
+               / sizeof(MYFLT);
+    /* start phases: zero, or random with iseed (< 0: seed from time) */
+    if (*(p->iseed) != FL(0.0)) {
+      oscbnk_seedrand(csound, &seed,
+                      *(p->iseed) < FL(0.0) ? FL(0.0) : *(p->iseed));
+      for (i = 0; i < p->nvoices; i++)
+        p->phs[i] = oscbnk_rnd_phase(&seed);
+    }
+    return OK;
+}
+
+static int32_t vco2bank_perf(CSOUND *csound, VCO2BANK *p,
+                             MYFLT *amp, int32_t namp)
+{
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t nsmps = CS_KSMPS;
+    VCO2_LANES  g;
+    MYFLT   f, *ar = p->ar, *cps = p->kcps->data;
+    int32_t i, l, v, nv;
+    IGN(csound);
+
+    if (UNLIKELY(offset)) memset(ar, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&ar[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    /* voices added to the array after init are not played */
+    nv = p->kcps->sizes[0] < p->nvoices ? p->kcps->sizes[0] : p->nvoices;
+    for (i = 0; i < nv; i += 4) {
+      for (l = 0, v = i; l < 4; l++, v++) {
+        if (v < nv) {
+          f = cps[v] * p->f_scl;
+          g.tabl[l] = vco2_bank_table(p->tables, p->p_min, p->p_scl, f);
+          g.phs[l] = p->phs[v];
+          g.frq[l] = OSCBNK_PHS2INT(f);
+          g.amp[l] = (namp < 0 ? *amp : (v < namp ? amp[v] : FL(0.0)));
+        }
+        else {
+          g.tabl[l] = g.tabl[0];
+          g.phs[l] = g.frq[l] = 0UL;
+          g.amp[l] = FL(0.0);
+        }
+        g.amp_d[l] = FL(0.0);
+      }
+      vco2_lanes(&g, 1, 0, p->acc, offset, nsmps);
+      for (l = 0, v = i; l < 4 && v < nv; l++, v++)
+        p->phs[v] = g.phs[l];
+    }
+    vco2_lanes_mix(ar, p->acc, offset, nsmps);
+    return OK;
+}
+
+static int32_t vco2bank(CSOUND *csound, VCO2BANK *p)
+{
+    return vco2bank_perf(csound, p, p->kamp, -1);
+}
+
+static int32_t vco2bank_arr(CSOUND *csound, VCO2BANK *p)
+{
+    ARRAYDAT    *kamp = (ARRAYDAT*) p->kamp;
+
+    return vco2bank_perf(csound, p, kamp->data,
+                         kamp->sizes == NULL ? 0 : kamp->sizes[0]);
+}
+
 /* ---- denorm opcode ---- */
 
 #ifndef USE_DOUBLE
@@ -2586,7 +2995,7 @@ static int32_t rbjeq(CSOUND *csound, RBJEQ *p)
 
 static const OENTRY localops[] =
   {
-   { "oscbnk",     sizeof(OSCBNK),     TR, 3,  "a",  "kkkkiikkkkikkkkkkikooooooo",
+   { "oscbnk",     sizeof(OSCBNK),     TR, 3,  "a",  "kkkkiikkkkikkkkkkikoooooooj",
      (SUBR) oscbnkset, (SUBR) oscbnk                },
    { "grain2",     sizeof(GRAIN2),     TR, 3,      "a",    "kkkikiooo",
             (SUBR) grain2set, (SUBR) grain2                },
@@ -2624,6 +3033,10 @@ static const OENTRY localops[] =
 //    { "vco2",       sizeof(VCO2),       TR, 3,      "a",    "kkoM",
    { "vco2",       sizeof(VCO2),       TR, 3,      "a",    "kkoOOo",
      (SUBR) vco2set, (SUBR) vco2                    },
+   { "vco2bank",   sizeof(VCO2BANK),   TR, 3,      "a",    "kk[]ovo",
+     (SUBR) vco2bankset, (SUBR) vco2bank            },
+   { "vco2bank.A", sizeof(VCO2BANK),   TR, 3,      "a",    "k[]k[]ovo",
+     (SUBR) vco2bankset, (SUBR) vco2bank_arr        },
     { "denorm",     sizeof(DENORMS),   WI,  2,      "",     "y",
             (SUBR) NULL, (SUBR) denorms                    },
     { "delayk",     sizeof(DELAYK),    0,  3,      "k",    "kio",
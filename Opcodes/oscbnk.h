@@ -66,7 +66,7 @@ typedef struct {
 
 typedef struct {
         OPDS    h;
-        MYFLT   *args[27];              /* opcode args (see manual)     */
+        MYFLT   *args[28];              /* opcode args (see manual)     */
         int32_t     init_k;                 /* 1st k-cycle (0: no, 1: yes)  */
         int32_t     nr_osc;                 /* number of oscillators        */
         int32   seed;                   /* random seed                  */
@@ -95,6 +95,9 @@ typedef struct {
         int32    tabl_cnt;               /* current param in table       */
         AUXCH   auxdata;
         OSCBNK_OSC      *osc;           /* oscillator array             */
+        VCO2_TABLE_ARRAY *vco2_tabs;    /* vco2 waveform (NULL: kfn)    */
+        MYFLT   vco2_pmin, vco2_pscl;   /* vco2 table selection         */
+        AUXCH   vco2_acc;               /* four-lane mix buffer         */
 } OSCBNK;
 
 /* grain2 types */
@@ -265,6 +268,30 @@ typedef struct {
     int32_t                 base_ftnum;
 } VCO2FT;
 
+/* four voices of a band-limited oscillator bank, one per SIMD lane */
+
+typedef struct {
+    VCO2_TABLE  *tabl[4];       /* table selected for each voice             */
+    uint32  phs[4], frq[4];     /* phase and phase increment                 */
+    MYFLT   amp[4], amp_d[4];   /* amplitude and its per-sample ramp         */
+    MYFLT   a1[4], a2[4], b0[4], b1[4], b2[4];          /* oscbnk EQ coeffs  */
+    MYFLT   a1_d[4], a2_d[4], b0_d[4], b1_d[4], b2_d[4];
+    MYFLT   xnm1[4], xnm2[4], ynm1[4], ynm2[4];         /* EQ state          */
+} VCO2_LANES;
+
+typedef struct {        /* ar vco2bank xamp, kcps[][, imode[, inyx[, iseed]]] */
+    OPDS    h;
+    MYFLT   *ar, *kamp;         /* kamp is an ARRAYDAT in the array version  */
+    ARRAYDAT    *kcps;
+    MYFLT   *imode, *inyx, *iseed;
+    int32_t     nvoices;            /* number of voices (kcps at init time)      */
+    MYFLT   f_scl, p_min, p_scl;
+    VCO2_TABLE_ARRAY    *tables;
+    AUXCH   auxdata;
+    uint32  *phs;               /* voice phases                              */
+    MYFLT   *acc;               /* four-lane mix buffer                      */
+} VCO2BANK;
+
 typedef struct {                /* denorm a1[, a2[, a3[, ... ]]] */
     OPDS    h;
     MYFLT   *ar[256];
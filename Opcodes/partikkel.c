@@ -217,6 +217,10 @@ static inline MYFLT dsf(FUNC *tab, GRAIN *grain, double beta, MYFLT zscale,
     return result;
 }
 
+static void partikkel_workers_stop(CSOUND *csound, PARTIKKEL *p);
+static int32_t partikkel_workers_init(CSOUND *csound, PARTIKKEL *p,
+                                      uint32_t nthreads, uint32_t max_grains);
+
 static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
 {
     uint32_t size;
@@ -303,8 +307,8 @@ static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
     p->synced = 0;
     p->graininc = 0.0;
 
-    /* allocate memory for the grain mix buffer */
-    size = CS_KSMPS*sizeof(MYFLT);
+    /* allocate memory for the grain mix buffer and the envelopes */
+    size = 3*CS_KSMPS*sizeof(MYFLT);
     if (p->aux.auxp == NULL || p->aux.size < size)
         csound->AuxAlloc(csound, size, &p->aux);
     else
@@ -320,6 +324,19 @@ static int32_t partikkel_init(CSOUND *csound, PARTIKKEL *p)
     p->gpool.mempool = p->aux2.auxp;
     init_pool(&p->gpool, (uint32_t)*p->max_grains);
 
+    /* start the rendering threads, if any were asked for */
+    partikkel_workers_stop(csound, p);
+    if (*p->threads >= FL(1.0)) {
+        uint32_t nthreads = *p->threads < FL(PARTIKKEL_MAXTHREADS)
+                            ? (uint32_t)*p->threads : PARTIKKEL_MAXTHREADS;
+
+        if ((ret = partikkel_workers_init(csound, p, nthreads,
+                                          (uint32_t)*p->max_grains)) != OK) {
+            partikkel_workers_stop(csound, p);
+            return ret;
+        }
+    }
+
     /* find out which of the xrate parameters are arate */
     p->grainfreq_arate = IS_ASIG_ARG(p->grainfreq) ? 1 : 0;
     p->out_of_voices_warning = 0; /* reset user warning indicator */
@@ -659,138 +676,337 @@ static int32_t schedule_grains(CSOUND *csound, PARTIKKEL *p)
 }
 
 /* Main synthesis loops */
-/* NOTE: the main synthesis loop is duplicated for both wavetable and
- * trainlet synthesis for speed */
-static inline void render_wave(PARTIKKEL *p, GRAIN *grain, WAVEDATA *wav,
-                               MYFLT *buf, uint32_t stop)
+/* The wavetable waveforms of a grain are rendered together, one sample at
+ * a time, with the active waveforms as lanes: their phase accumulators are
+ * independent, so the lanes overlap, and the fm envelope is looked up once
+ * per sample for all of them. The trainlet is added last, so each output
+ * sample is summed in the same order as when the waveforms were rendered
+ * one after the other. */
+static inline void render_waves(PARTIKKEL *p, GRAIN *grain, MYFLT *buf,
+                                uint32_t stop)
 {
-    uint32_t n;
+    const MYFLT *ftab[4];
+    double phase[4], delta[4], tablen[4], sweepdecay[4], sweepoffset[4];
+    MYFLT gain[4];
+    uint32_t lane[4];
+    uint32_t i, k, nw = 0, n;
+    WAVEDATA *tw = grain->wav[WAV_TRAINLET].table != NULL
+                   ? &grain->wav[WAV_TRAINLET] : NULL;
+    const FUNC *fmenvtab = grain->fmenvtab;
+    const MYFLT fmamp = grain->fmamp;
+    const double envinc = grain->envinc;
     double fmenvphase = grain->envphase;
 
-    /* wavetable synthesis */
-    for (n = grain->start; n < stop; ++n) {
-        double tablen = (double)wav->table->flen;
-        uint32_t x0;
-        MYFLT frac, fmenv;
-
-        /* make sure phase accumulator stays within bounds */
-        while (UNLIKELY(wav->phase >= tablen))
-            wav->phase -= tablen;
-        while (UNLIKELY(wav->phase < 0.0))
-            wav->phase += tablen;
-
-        /* sample table lookup with linear interpolation */
-        x0 = (uint32_t)wav->phase;
-        frac = (MYFLT)(wav->phase - x0);
-        buf[n] += lrp(wav->table->ftable[x0], wav->table->ftable[x0 + 1],
-                      frac)*wav->gain;
-
-        fmenv = grain->fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
-                                        >> grain->fmenvtab->lobits];
-        fmenvphase += grain->envinc;
-        wav->phase += wav->delta + wav->delta*p->fm[n]*grain->fmamp*fmenv;
-        /* apply sweep */
-        wav->delta = wav->delta*wav->sweepdecay + wav->sweepoffset;
-     }
-}
+    for (i = 0; i < 4; ++i) {
+        WAVEDATA *wav = &grain->wav[i];
 
-static inline void render_trainlet(PARTIKKEL *p, GRAIN *grain, WAVEDATA *wav,
-                                   MYFLT *buf, uint32_t stop)
-{
-    uint32_t n;
-    double fmenvphase = grain->envphase;
+        /* check if ftable is to be rendered */
+        if (wav->table == NULL)
+            continue;
+        lane[nw] = i;
+        ftab[nw] = wav->table->ftable;
+        tablen[nw] = (double)wav->table->flen;
+        phase[nw] = wav->phase;
+        delta[nw] = wav->delta;
+        sweepdecay[nw] = wav->sweepdecay;
+        sweepoffset[nw] = wav->sweepoffset;
+        gain[nw] = wav->gain;
+        nw++;
+    }
+    if (nw == 0 && tw == NULL)
+        return;
 
-    /* trainlet synthesis */
     for (n = grain->start; n < stop; ++n) {
-        MYFLT fmenv;
-
-        while (UNLIKELY(wav->phase >= 1.0))
-            wav->phase -= 1.0;
-        while (UNLIKELY(wav->phase < 0.0))
-            wav->phase += 1.0;
-
+        MYFLT fmenv, fm = p->fm[n];
+        MYFLT sum = buf[n];
+
+        fmenv = fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
+                                 >> fmenvtab->lobits];
+        fmenvphase += envinc;
+        /* wavetable synthesis */
+        for (k = 0; k < nw; ++k) {
+            uint32_t x0;
+            MYFLT frac;
+
+            /* make sure phase accumulator stays within bounds */
+            while (UNLIKELY(phase[k] >= tablen[k]))
+                phase[k] -= tablen[k];
+            while (UNLIKELY(phase[k] < 0.0))
+                phase[k] += tablen[k];
+
+            /* sample table lookup with linear interpolation */
+            x0 = (uint32_t)phase[k];
+            frac = (MYFLT)(phase[k] - x0);
+            sum += lrp(ftab[k][x0], ftab[k][x0 + 1], frac)*gain[k];
+
+            phase[k] += delta[k] + delta[k]*fm*fmamp*fmenv;
+            /* apply sweep */
+            delta[k] = delta[k]*sweepdecay[k] + sweepoffset[k];
+        }
         /* dsf/trainlet synthesis */
-        buf[n] += wav->gain*dsf(p->costab, grain, wav->phase, p->zscale,
+        if (tw != NULL) {
+            while (UNLIKELY(tw->phase >= 1.0))
+                tw->phase -= 1.0;
+            while (UNLIKELY(tw->phase < 0.0))
+                tw->phase += 1.0;
+            sum += tw->gain*dsf(p->costab, grain, tw->phase, p->zscale,
                                 p->cosineshift);
+            tw->phase += tw->delta + tw->delta*fm*fmamp*fmenv;
+            tw->delta = tw->delta*tw->sweepdecay + tw->sweepoffset;
+        }
+        buf[n] = sum;
+    }
+    for (k = 0; k < nw; ++k) {
+        grain->wav[lane[k]].phase = phase[k];
+        grain->wav[lane[k]].delta = delta[k];
+    }
+}
 
-        fmenv = grain->fmenvtab->ftable[(size_t)(fmenvphase*FMAXLEN)
-                                        >> grain->fmenvtab->lobits];
-        fmenvphase += grain->envinc;
-        wav->phase += wav->delta + wav->delta*p->fm[n]*grain->fmamp*fmenv;
-        wav->delta = wav->delta*wav->sweepdecay + wav->sweepoffset;
+/* evaluate the grain envelopes for samples start..stop-1 into env and env2.
+ * the envelope phase only grows, so its segments are visited in order and
+ * each is filled by its own loop */
+static inline void render_envelopes(PARTIKKEL *p, GRAIN *grain, MYFLT *env,
+                                    MYFLT *env2, uint32_t stop)
+{
+    const FUNC *atab = p->env_attack_tab, *dtab = p->env_decay_tab;
+    const FUNC *e2tab = p->env2_tab;
+    const double attacklen = grain->envattacklen;
+    const double decaystart = grain->envdecaystart;
+    const double envinc = grain->envinc;
+    const MYFLT env2amount = grain->env2amount;
+    double envphase = grain->envphase;
+    uint32_t n = grain->start;
+
+/* env2 for the current phase, and advance the phase */
+#define ENV2_STEP()                                                     \
+    env2[n] = FL(1.0) - env2amount                                      \
+              + env2amount*e2tab->ftable[(size_t)(envphase*FMAXLEN)     \
+                                         >> e2tab->lobits];             \
+    envphase += envinc
+
+    /* attack */
+    for ( ; n < stop && envphase < attacklen; ++n) {
+        env[n] = atab->ftable[(size_t)((envphase/attacklen)*FMAXLEN)
+                              >> atab->lobits];
+        ENV2_STEP();
+    }
+    /* for sustain, use last sample in attack table */
+    for ( ; n < stop && envphase < decaystart; ++n) {
+        env[n] = atab->ftable[(size_t)(1.0*FMAXLEN) >> atab->lobits];
+        ENV2_STEP();
+    }
+    /* decay */
+    for ( ; n < stop && envphase < 1.0; ++n) {
+        env[n] = dtab->ftable[(size_t)(((envphase - decaystart)/
+                                        (1.0 - decaystart))*FMAXLEN)
+                              >> dtab->lobits];
+        ENV2_STEP();
+    }
+    /* clamp envelope phase because of round-off errors */
+    if (n < stop) {
+        const FUNC *tab = decaystart < 1.0 ? dtab : atab;
+        for ( ; n < stop; ++n) {
+            env[n] = tab->ftable[(size_t)(1.0*FMAXLEN) >> tab->lobits];
+            envphase = 1.0;
+            ENV2_STEP();
+        }
     }
+#undef ENV2_STEP
+    grain->envphase = envphase;
 }
 
-/* do the actual waveform synthesis */
-static inline void render_grain(CSOUND *csound, PARTIKKEL *p, GRAIN *grain)
+/* do the actual waveform synthesis. buf holds three k-periods of scratch
+ * space: the waveform mix and the two envelopes */
+static inline void render_grain(PARTIKKEL *p, GRAIN *grain, MYFLT *buf,
+                                MYFLT **outs)
 {
-    IGN(csound);
-    int32_t i;
     uint32_t n;
-    MYFLT *out1 = *(&(p->output1) + grain->chan1);
-    MYFLT *out2 = *(&(p->output1) + grain->chan2);
+    MYFLT *out1 = outs[grain->chan1];
+    MYFLT *out2 = outs[grain->chan2];
+    const MYFLT gain1 = grain->gain1, gain2 = grain->gain2;
     uint32_t stop = grain->stop > CS_KSMPS
                     ? CS_KSMPS : grain->stop;
-    MYFLT *buf = (MYFLT *)p->aux.auxp;
+    MYFLT *env = buf + CS_KSMPS, *env2 = buf + 2*CS_KSMPS;
 
     if (grain->start >= CS_KSMPS)
         return; /* grain starts at a later kperiod */
-    for (i = 0; i < 5; ++i) {
-        WAVEDATA *curwav = &grain->wav[i];
-
-        /* check if ftable is to be rendered */
-        if (curwav->table == NULL)
-            continue;
-
-        if (i != WAV_TRAINLET)
-            render_wave(p, grain, curwav, buf, stop);
-        else
-            render_trainlet(p, grain, curwav, buf, stop);
-    }
+    render_waves(p, grain, buf, stop);
+    render_envelopes(p, grain, env, env2, stop);
 
     /* apply envelopes */
     for (n = grain->start; n < stop; ++n) {
-        MYFLT env, env2, output;
-        double envphase;
-        FUNC *envtable;
-
-        /* apply envelopes */
-        if (grain->envphase < grain->envattacklen) {
-            envtable = p->env_attack_tab;
-            envphase = grain->envphase/grain->envattacklen;
-        } else if (grain->envphase < grain->envdecaystart) {
-            /* for sustain, use last sample in attack table */
-            envtable = p->env_attack_tab;
-            envphase = 1.0;
-        } else if (grain->envphase < 1.0) {
-            envtable = p->env_decay_tab;
-            envphase = (grain->envphase - grain->envdecaystart)/(1.0 -
-                       grain->envdecaystart);
-        } else {
-            /* clamp envelope phase because of round-off errors */
-            envtable = grain->envdecaystart < 1.0 ?
-                       p->env_decay_tab : p->env_attack_tab;
-            envphase = grain->envphase = 1.0;
-        }
-
-        /* fetch envelope values */
-        env = envtable->ftable[(size_t)(envphase*FMAXLEN)
-                                >> envtable->lobits];
-        env2 = p->env2_tab->ftable[(size_t)(grain->envphase*FMAXLEN)
-                                   >> p->env2_tab->lobits];
-        env2 = FL(1.0) - grain->env2amount + grain->env2amount*env2;
-        grain->envphase += grain->envinc;
         /* generate grain output sample */
-        output = buf[n]*env*env2;
+        MYFLT output = buf[n]*env[n]*env2[n];
         /* now distribute this grain to the output channels it's supposed to
          * end up in, as decided by the channel mask */
-        out1[n] += output*grain->gain1;
-        out2[n] += output*grain->gain2;
+        out1[n] += output*gain1;
+        out2[n] += output*gain2;
     }
     /* now clear the area we just worked in */
     memset(buf + grain->start, 0, (stop - grain->start)*sizeof(MYFLT));
 }
 
+/* worker thread: renders its share of the grain list into its own output
+ * buffers, which partikkel() then mixes into the opcode outputs */
+static uintptr_t partikkel_worker_thread(void *data)
+{
+    PARTIKKEL_WORKER *w = (PARTIKKEL_WORKER *)data;
+    PARTIKKEL *p = w->p;
+    CSOUND *csound = w->csound;
+    uint32_t i;
+
+    for (;;) {
+        csound->WaitThreadLockNoTimeout(w->jobReady);
+        if (!w->threadon)
+            break;
+        for (i = 0; i < p->num_outputs; ++i)
+            memset(w->outs[i], 0, sizeof(MYFLT)*CS_KSMPS);
+        for (i = 0; i < w->ngrains; ++i)
+            render_grain(p, w->grains[i], w->buf, w->outs);
+        csound->NotifyThreadLock(w->jobDone);
+    }
+    return (uintptr_t)0;
+}
+
+static void partikkel_workers_stop(CSOUND *csound, PARTIKKEL *p)
+{
+    uint32_t i;
+
+    for (i = 0; i < PARTIKKEL_MAXTHREADS; ++i) {
+        PARTIKKEL_WORKER *w = &p->workers[i];
+
+        if (w->thread != NULL) {
+            w->threadon = 0;
+            csound->NotifyThreadLock(w->jobReady);
+            csound->JoinThread(w->thread);
+            w->thread = NULL;
+        }
+        if (w->jobReady != NULL) {
+            csound->DestroyThreadLock(w->jobReady);
+            w->jobReady = NULL;
+        }
+        if (w->jobDone != NULL) {
+            csound->DestroyThreadLock(w->jobDone);
+            w->jobDone = NULL;
+        }
+    }
+    p->num_workers = 0;
+}
+
+static int32_t partikkel_deinit(CSOUND *csound, void *p)
+{
+    partikkel_workers_stop(csound, (PARTIKKEL *)p);
+    ((PARTIKKEL *)p)->deinit_registered = 0;
+    return OK;
+}
+
+/* start nthreads worker threads, each with a grain pointer list of
+ * max_grains entries and scratch and output buffers */
+static int32_t partikkel_workers_init(CSOUND *csound, PARTIKKEL *p,
+                                      uint32_t nthreads, uint32_t max_grains)
+{
+    uint32_t i, j;
+    size_t size;
+    char *ptr;
+
+    size = max_grains*sizeof(GRAIN *)
+           + nthreads*(max_grains*sizeof(GRAIN *)
+                       + (3 + p->num_outputs)*CS_KSMPS*sizeof(MYFLT));
+    if (p->aux3.auxp == NULL || p->aux3.size < size)
+        csound->AuxAlloc(csound, size, &p->aux3);
+    ptr = (char *)p->aux3.auxp;
+    memset(ptr, 0, size);
+    p->grainlist = (GRAIN **)ptr;
+    ptr += max_grains*sizeof(GRAIN *);
+    /* once per note: a reinit restarts the threads but keeps the
+     * callback registered by the first init */
+    if (!p->deinit_registered) {
+        csound->RegisterDeinitCallback(csound, (void *)p, partikkel_deinit);
+        p->deinit_registered = 1;
+    }
+    for (i = 0; i < nthreads; ++i) {
+        PARTIKKEL_WORKER *w = &p->workers[i];
+
+        w->p = p;
+        w->csound = csound;
+        w->grains = (GRAIN **)ptr;
+        ptr += max_grains*sizeof(GRAIN *);
+        w->buf = (MYFLT *)ptr;
+        ptr += 3*CS_KSMPS*sizeof(MYFLT);
+        for (j = 0; j < p->num_outputs; ++j) {
+            w->outs[j] = (MYFLT *)ptr;
+            ptr += CS_KSMPS*sizeof(MYFLT);
+        }
+        w->ngrains = 0;
+        /* both locks start cleared: no job yet, and none done */
+        w->jobReady = csound->CreateThreadLock();
+        w->jobDone = csound->CreateThreadLock();
+        if (UNLIKELY(w->jobReady == NULL || w->jobDone == NULL))
+            return INITERROR("could not create thread lock");
+        csound->WaitThreadLock(w->jobReady, (size_t)0);
+        csound->WaitThreadLock(w->jobDone, (size_t)0);
+        w->threadon = 1;
+        w->thread = csound->CreateThread(partikkel_worker_thread, (void *)w);
+        if (UNLIKELY(w->thread == NULL)) {
+            w->threadon = 0;
+            return INITERROR("could not create rendering thread");
+        }
+        p->num_workers++;
+    }
+    return OK;
+}
+
+/* render the grain list, sharing it out between this thread and the
+ * workers when there are enough grains to make it worthwhile. the workers
+ * take the later parts of the list, and their outputs are mixed in worker
+ * order */
+static void render_grains(CSOUND *csound, PARTIKKEL *p)
+{
+    MYFLT **outputs = &p->output1;
+    MYFLT *buf = (MYFLT *)p->aux.auxp;
+    uint32_t i, j, n, ngrains = 0, nshares, share;
+    NODE *node;
+
+    if (p->num_workers == 0) {
+        for (node = p->grainroot; node; node = node->next)
+            render_grain(p, &node->grain, buf, outputs);
+        return;
+    }
+    for (node = p->grainroot; node; node = node->next)
+        if (node->grain.start < CS_KSMPS)
+            p->grainlist[ngrains++] = &node->grain;
+    nshares = ngrains/PARTIKKEL_MINGRAINS;
+    if (nshares > p->num_workers + 1)
+        nshares = p->num_workers + 1;
+    if (nshares < 2) {
+        for (i = 0; i < ngrains; ++i)
+            render_grain(p, p->grainlist[i], buf, outputs);
+        return;
+    }
+    share = (ngrains + nshares - 1)/nshares;
+    for (i = 1; i < nshares; ++i) {
+        PARTIKKEL_WORKER *w = &p->workers[i - 1];
+        uint32_t first = i*share;
+
+        w->ngrains = first + share > ngrains ? ngrains - first : share;
+        memcpy(w->grains, p->grainlist + first, w->ngrains*sizeof(GRAIN *));
+        csound->NotifyThreadLock(w->jobReady);
+    }
+    for (i = 0; i < share; ++i)
+        render_grain(p, p->grainlist[i], buf, outputs);
+    for (i = 1; i < nshares; ++i) {
+        PARTIKKEL_WORKER *w = &p->workers[i - 1];
+
+        csound->WaitThreadLockNoTimeout(w->jobDone);
+        for (j = 0; j < p->num_outputs; ++j) {
+            MYFLT *out = outputs[j];
+            const MYFLT *wout = w->outs[j];
+            for (n = 0; n < CS_KSMPS; ++n)
+                out[n] += wout[n];
+        }
+    }
+}
+
 static int32_t partikkel(CSOUND *csound, PARTIKKEL *p)
 {
     int32_t ret;
@@ -808,13 +1024,14 @@ static int32_t partikkel(CSOUND *csound, PARTIKKEL *p)
     for (n = 0; n < p->num_outputs; ++n)
         memset(outputs[n], 0, sizeof(MYFLT)*CS_KSMPS);
 
-    /* prepare to traverse grain list */
+    /* render all grains to outputs */
+    render_grains(csound, p);
+
+    /* traverse grain list */
     nodeptr = &p->grainroot;
     while (*nodeptr) {
         GRAIN *grain = &((*nodeptr)->grain);
 
-        /* render current grain to outputs */
-        render_grain(csound, p, grain);
         /* check if grain is finished */
         if (grain->stop <= CS_KSMPS) {
             /* grain is finished, deactivate it */
@@ -964,7 +1181,7 @@ static OENTRY partikkel_localops[] = {
     {
      "partikkel", sizeof(PARTIKKEL), TR, 3,
         "ammmmmmm",
-        "xkiakiiikkkkikkiiaikikkkikkkkkiaaaakkkkioj",
+        "xkiakiiikkkkikkiiaikikkkikkkkkiaaaakkkkiojo",
         (SUBR)partikkel_init,
         (SUBR)partikkel
     },
@@ -59,6 +59,23 @@ typedef struct {
 
 struct PARTIKKEL;
 
+/* optional rendering threads. a k-period's grains are only shared out
+ * when each thread gets at least PARTIKKEL_MINGRAINS of them */
+#define PARTIKKEL_MAXTHREADS 16
+#define PARTIKKEL_MINGRAINS 32
+
+typedef struct {
+    struct PARTIKKEL *p;
+    CSOUND *csound;
+    void *thread;
+    void *jobReady, *jobDone;
+    volatile int32_t threadon;
+    GRAIN **grains;         /* grains to render in this k-period */
+    uint32_t ngrains;
+    MYFLT *buf;             /* scratch space, as the opcode's own aux */
+    MYFLT *outs[8];         /* outputs, mixed into the opcode's outputs */
+} PARTIKKEL_WORKER;
+
 typedef struct PARTIKKEL_GLOBALS_ENTRY {
     MYFLT id;
     MYFLT *synctab;
@@ -117,6 +134,7 @@ typedef struct PARTIKKEL {
     MYFLT *max_grains;
     MYFLT *opcodeid;
     MYFLT *pantable;
+    MYFLT *threads;
 
     /* internal variables */
     PARTIKKEL_GLOBALS *globals;
@@ -150,6 +168,11 @@ typedef struct PARTIKKEL {
     uint32_t wavgainindex;
     double grainphase, graininc;
     FUNC *pantab;
+    PARTIKKEL_WORKER workers[PARTIKKEL_MAXTHREADS];
+    uint32_t num_workers;
+    int deinit_registered;  /* partikkel_deinit() is due at note end */
+    GRAIN **grainlist;
+    AUXCH aux3;
 } PARTIKKEL;
 
 typedef struct {
@@ -29,6 +29,7 @@
 
 #include "stdopcod.h"
 #include "uggab.h"
+#include "oscsimd.h"
 #include <math.h>
 
 static int32_t wrap(CSOUND *csound, WRAP *p)
@@ -250,6 +251,74 @@ static int32_t posc_set(CSOUND *csound, POSC *p)
     return OK;
 }
 
+#if defined(__SSE2__)
+static inline double posc_step(double phs, double inc, int32_t tablen)
+{
+    phs += inc;
+    while (UNLIKELY(phs >= tablen))
+      phs -= tablen;
+    while (UNLIKELY(phs < 0.0))
+      phs += tablen;
+    return phs;
+}
+
+/* Four samples at a time for poscil3.  The double precision phase keeps
+   its serial recurrence, with the wrap after every step, so that the
+   phase and output are exactly those of the scalar loop; index, fraction
+   and the cubic interpolation are done in lanes.  poscil itself stays
+   scalar, as there the phase recurrence is the whole cost.  With freq
+   NULL the increment is si, otherwise freq[n] * tablenUPsr.  Returns the
+   first sample left for the scalar loop. */
+static uint32_t posc3_simd(POSC *p, double *pphs, double si, MYFLT *freq,
+                           MYFLT amp, MYFLT *ampp, MYFLT *out,
+                           uint32_t n, uint32_t nsmps)
+{
+    MYFLT    *ftab = p->ftp->ftable, m1[4], p2[4];
+    double   phs = *pphs, ph0, ph1, ph2, ph3, upsr = p->tablenUPsr;
+    int32_t  tablen = p->tablen, x[4], k;
+    __m128i  one = _mm_set1_epi32(1);
+    OSCV     vamp = oscv_set1(amp);
+
+    for (; n + 4 <= nsmps; n += 4) {
+      __m128d lo, hi;
+      __m128i ndx;
+      OSCV    fract, v;
+      ph0 = phs;
+      if (freq != NULL) {
+        ph1 = posc_step(ph0, freq[n] * upsr, tablen);
+        ph2 = posc_step(ph1, freq[n + 1] * upsr, tablen);
+        ph3 = posc_step(ph2, freq[n + 2] * upsr, tablen);
+        phs = posc_step(ph3, freq[n + 3] * upsr, tablen);
+      }
+      else {
+        ph1 = posc_step(ph0, si, tablen);
+        ph2 = posc_step(ph1, si, tablen);
+        ph3 = posc_step(ph2, si, tablen);
+        phs = posc_step(ph3, si, tablen);
+      }
+      lo = _mm_set_pd(ph1, ph0);
+      hi = _mm_set_pd(ph3, ph2);
+      ndx = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+      fract = oscv_frompd(_mm_sub_pd(lo, _mm_cvtepi32_pd(ndx)),
+                          _mm_sub_pd(hi, _mm_cvtepi32_pd(
+                             _mm_shuffle_epi32(ndx, _MM_SHUFFLE(1, 0, 3, 2)))));
+      _mm_storeu_si128((__m128i*) x, ndx);
+      for (k = 0; k < 4; k++) {
+        m1[k] = (x[k] > 0 ? ftab[x[k] - 1] : ftab[tablen - 1]);
+        p2[k] = (x[k] + 2 > tablen ? ftab[1] : ftab[x[k] + 2]);
+      }
+      v = oscv_cubic(oscv_set4(m1[0], m1[1], m1[2], m1[3]),
+                     oscv_gather(ftab, ndx),
+                     oscv_gather(ftab, _mm_add_epi32(ndx, one)),
+                     oscv_set4(p2[0], p2[1], p2[2], p2[3]), fract);
+      oscv_store(&out[n], oscv_mul(v, ampp != NULL ?
+                                   oscv_load(&ampp[n]) : vamp));
+    }
+    *pphs = phs;
+    return n;
+}
+#endif
+
 static int32_t posckk(CSOUND *csound, POSC *p)
 {
     FUNC        *ftp = p->ftp;
@@ -432,7 +501,11 @@ static int32_t posc3kk(CSOUND *csound, POSC *p)
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = posc3_simd(p, &phs, si, NULL, amp, NULL, out, n, nsmps);
+#endif
+    for (; n<nsmps; n++) {
       x0    = (int32)phs;
       fract = (MYFLT)(phs - (double)x0);
       x0--;
@@ -487,7 +560,11 @@ static int32_t posc3ak(CSOUND *csound, POSC *p)
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = posc3_simd(p, &phs, si, NULL, FL(0.0), ampp, out, n, nsmps);
+#endif
+    for (; n<nsmps; n++) {
       x0    = (int32)phs;
       fract = (MYFLT)(phs - (double)x0);
       x0--;
@@ -543,7 +620,11 @@ static int32_t posc3ka(CSOUND *csound, POSC *p)
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = posc3_simd(p, &phs, 0.0, freq, amp, NULL, out, n, nsmps);
+#endif
+    for (; n<nsmps; n++) {
       MYFLT ff = freq[n];
       x0    = (int32)phs;
       fract = (MYFLT)(phs - (double)x0);
@@ -600,7 +681,11 @@ static int32_t posc3aa(CSOUND *csound, POSC *p)
       nsmps -= early;
       memset(&out[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
+    n = offset;
+#if defined(__SSE2__)
+    n = posc3_simd(p, &phs, 0.0, freq, FL(0.0), ampp, out, n, nsmps);
+#endif
+    for (; n<nsmps; n++) {
       MYFLT ff = freq[n];
       x0    = (int32)phs;
       fract = (MYFLT)(phs - (double)x0);
@@ -318,6 +318,21 @@ static const char *longUsageList[] = {
   Str_noop("--aft-zero              set aftertouch to zero, not 127 (default)"),
   Str_noop("--limiter[=num]         include clipping in audio output"),
   Str_noop("--vbr                   set MPEG encoding to variable bitrate"),
+  Str_noop("--sf-writer=N           write output sound file from a separate\n"
+           "                        thread, queueing up to N buffers (0: off)"),
+  Str_noop("--sf-sync=MODE          flush output sound file to disk: never\n"
+           "                        (none, default), at close, or every block"),
+  Str_noop("--scalar-spout          use scalar (not SIMD) conversion of audio\n"
+           "                        output, for testing"),
+  Str_noop("--no-udo-inline         do not inline calls of user defined\n"
+           "                        opcodes at compile time"),
+  Str_noop("--smooth-filters        reson, butterlp/hp, moogvcf, moogladder\n"
+           "                        and statevar: table lookup of coefficients\n"
+           "                        and per-sample ramps of k-rate changes"),
+  Str_noop("--pvs-fast-math         pvsanal, pvsynth: polynomial arctangent,\n"
+           "                        sine and cosine in the frame conversions"),
+  Str_noop("--score-window=N        sort the score in windows of N statements,\n"
+           "                        as it is played (0: whole sections, default)"),
   " ",
   Str_noop("--help                  long help"),
   NULL
@@ -1254,6 +1269,55 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
     else if (!(strcmp(s, "limiter"))) {
       O->limiter = 0.5;
       return 1;
+    }
+    else if (!(strncmp(s, "sf-writer=", 10))) {
+      s += 10;
+      O->sfwriter = atoi(s);
+      if (O->sfwriter < 0) {
+        csound->MessageS(csound, CSOUNDMSG_STDOUT,
+                         Str("Ignoring invalid sf-writer queue depth\n"));
+        O->sfwriter = 0;
+      }
+      return 1;
+    }
+    else if (!(strncmp(s, "sf-sync=", 8))) {
+      s += 8;
+      if (!strcmp(s, "none"))
+        O->sfsync = 0;
+      else if (!strcmp(s, "close"))
+        O->sfsync = 1;
+      else if (!strcmp(s, "block"))
+        O->sfsync = 2;
+      else
+        csound->MessageS(csound, CSOUNDMSG_STDOUT,
+                         Str("Ignoring invalid sf-sync mode '%s'\n"), s);
+      return 1;
+    }
+    else if (!(strcmp(s, "scalar-spout"))) {
+      O->scalarspout = 1;
+      return 1;
+    }
+    else if (!(strcmp(s, "no-udo-inline"))) {
+      O->noudoinline = 1;
+      return 1;
+    }
+    else if (!(strcmp(s, "smooth-filters"))) {
+      O->smoothfilters = 1;
+      return 1;
+    }
+    else if (!(strcmp(s, "pvs-fast-math"))) {
+      O->pvsfastmath = 1;
+      return 1;
+    }
+    else if (!(strncmp(s, "score-window=", 13))) {
+      s += 13;
+      O->scorewindow = atoi(s);
+      if (O->scorewindow < 0) {
+        csound->MessageS(csound, CSOUNDMSG_STDOUT,
+                         Str("Ignoring invalid score window\n"));
+        O->scorewindow = 0;
+      }
+      return 1;
     }
      else if (!(strcmp(s, "vbr"))) {
   #ifdef SNDFILE_MP3    
@@ -536,10 +536,11 @@ static const CSOUND cenviron_ = {
     csoundCepsLP,
     csoundLPrms,
     csoundCreateThread2,
+    csoundRealFFT2Batch,
     {
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL
+      NULL
     },
     /* ------- private data (not to be used by hosts or externals) ------- */
     /* callback function pointers */
@@ -746,7 +747,7 @@ static const CSOUND cenviron_ = {
     0, 0,           /*  rngflg, multichan   */
     NULL,           /*  evtFuncChain        */
     NULL,           /*  OrcTrigEvts         */
-    NULL,           /*  freeEvtNodes        */
+    NULL,           /*  evtPool             */
     1,              /*  csoundIsScorePending_ */
     0,              /*  advanceCnt          */
     0,              /*  initonly            */
@@ -806,7 +807,9 @@ static const CSOUND cenviron_ = {
       "",          /*  repeat_name[NAMELEN] */
       0,0,1,        /*  repeat_cnt, repeat_point, repeat_inc */
       NULL,         /*  repeat_mm */
-      0
+      0,            /*  nocarry */
+      0, 0,         /*  window, inwindow */
+      NULL, NULL, NULL /* hist, histmem, histend */
     },
     {
       NULL,
@@ -823,13 +826,18 @@ static const CSOUND cenviron_ = {
       NULL,        /* Linebuf              */
       0,            /* linebufsiz */
       NULL, NULL,
-      0
+      0,
+      NULL, NULL,   /* binbuf, binbuf2      */
+      0, 0, 0,      /* binlen, binsiz, binsiz2 */
+      0,            /* binreg               */
+      SPINLOCK_INIT /* binlock              */
     },
     {
       {0,0}, {0,0},  /* srngcnt, orngcnt    */
       0, 0, 0, 0, 0, /* srngflg, sectno, lplayed, segamps, sormsg */
       NULL, NULL,    /* ep, epend           */
-      NULL           /* lsect               */
+      NULL,          /* lsect               */
+      0              /* evtseqno            */
     },
     //NULL,           /*  musmonGlobals       */
     {
@@ -848,6 +856,7 @@ static const CSOUND cenviron_ = {
       1U,           /*  nframes             */
       NULL, NULL,   /*  pin, pout           */
       0,            /*dither                */
+      NULL          /*  writer              */
     },
     0,              /*  warped              */
     0,              /*  sstrlen             */
@@ -944,7 +953,14 @@ static const CSOUND cenviron_ = {
       0,             /*    fft_lib */
       0,             /* echo */
       0.0,           /* limiter */
-      DFLT_SR, DFLT_KR  /* defaults */
+      DFLT_SR, DFLT_KR,  /* defaults */
+      0,             /* sfwriter */
+      0,             /* sfsync */
+      0,             /* scalarspout */
+      0,             /* noudoinline */
+      0,             /* smoothfilters */
+      0,             /* pvsfastmath */
+      0              /* scorewindow */
     },
     {0, 0, {0}}, /* REMOT_BUF */
     NULL,           /* remoteGlobals        */
@@ -1020,7 +1036,11 @@ static const CSOUND cenviron_ = {
     0,              /* mode */
     NULL,           /* opcodedir */
     NULL,           /* score_srt */
-    0               /* mp3 mode */
+    0,              /* mp3 mode */
+    NULL,           /* fftPlanCache */
+    1,              /* instrNameGen */
+    NULL,           /* scoreStream */
+    NULL            /* scoreBin */
 };
 
 void csound_aops_init_tables(CSOUND *cs);
@@ -1559,7 +1579,8 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
          /* VL: the validity of icurTime needs to be checked */
         time_end = (csound->ksmps+csound->icurTime)/csound->esr;
         insds = task_map[which_task];
-        if (insds->offtim > 0 && time_end > insds->offtim){
+        if (insds->no_end && insds->offtim > 0 &&
+            time_end > insds->offtim) {
             /* this is the last cycle of performance */
             insds->ksmps_no_end = insds->no_end;
           }
@@ -1777,8 +1798,9 @@ int kperf_nodebug(CSOUND *csound)
 
         while (ip != NULL) {                /* for each instr active:  */
           INSDS *nxt = ip->nxtact;
-          if (UNLIKELY(csound->oparms->sampleAccurate &&
-                       ip->offtim > 0                 &&
+          /* no_end is only set for sample-accurate notes that end
+             within a k-period, other instances skip the time test */
+          if (UNLIKELY(ip->no_end && ip->offtim > 0 &&
                        time_end > ip->offtim)) {
             /* this is the last cycle of performance */
             //   csound->Message(csound, "last cycle %d: %f %f %d\n",
@@ -2056,8 +2078,9 @@ int kperf_debug(CSOUND *csound)
         double time_end = (csound->ksmps+csound->icurTime)/csound->esr;
 
         while (ip != NULL) {                /* for each instr active:  */
-          if (UNLIKELY(csound->oparms->sampleAccurate &&
-                       ip->offtim > 0                 &&
+          /* no_end is only set for sample-accurate notes that end
+             within a k-period, other instances skip the time test */
+          if (UNLIKELY(ip->no_end && ip->offtim > 0 &&
                        time_end > ip->offtim)) {
             /* this is the last cycle of performance */
             //   csound->Message(csound, "last cycle %d: %f %f %d\n",
@@ -3557,6 +3580,7 @@ PUBLIC void csoundReset(CSOUND *csound)
 
 
       init_pvsys(csound);
+      csoundFFTPlanCacheInit(csound);
       /* utilities depend on this as well as orchs; may get changed by an orch */
       dbfs_init(csound, DFLT_DBFS);
       csound->csRtClock = (RTCLOCK*) csound->Calloc(csound, sizeof(RTCLOCK));
@@ -4573,6 +4597,18 @@ MYFLT csoundGetA4(CSOUND *csound) { return (MYFLT) csound->A4; }
 
 int csoundErrCnt(CSOUND *csound) { return csound->perferrcnt; }
 
+PUBLIC int64_t csoundGetInstrumentHandle(CSOUND *csound, const char *name)
+{
+    int32 insno;
+    int64_t handle = 0;
+    csoundLockMutex(csound->API_lock);
+    insno = (int32) named_instr_find(csound, (char *) name);
+    if (insno > 0)
+      handle = ((int64_t) csound->instrNameGen << 32) | insno;
+    csoundUnlockMutex(csound->API_lock);
+    return handle;
+}
+
 INSTRTXT *csoundGetInstrument(CSOUND *csound, int insno, const char *name) {
   if (name != NULL)
     insno = named_instr_find(csound, (char *)name);
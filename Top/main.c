@@ -345,6 +345,17 @@ PUBLIC int csoundCompileArgs(CSOUND *csound, int argc, const char **argv)
       csound->scorestr = NULL;
       csound->scorestr = copy_to_corefile(csound, csound->scorename, NULL, 1);
     }
+    else if (csound->scorename != NULL && csound->scorestr == NULL &&
+             (n = scobin_open(csound, csound->scorename)) != 0) {
+      if (UNLIKELY(n < 0))
+        csoundDie(csound, Str("cannot read binary score %s"),
+                  csound->scorename);
+      if (UNLIKELY(O->usingcscore || csound->xfilename != NULL))
+        csoundDie(csound, Str("a binary score cannot be used with cscore "
+                              "or extracted"));
+      csound->Message(csound, Str("playing binary score %s\n"),
+                      csound->scorename);
+    }
     else {
       //sortedscore = NULL;
       if (csound->scorestr==NULL) {
@@ -272,6 +272,31 @@ PUBLIC int csoundScoreSort(CSOUND *csound, FILE *inFile, FILE *outFile)
     return 0;
 }
 
+/**
+ * Sorts score file 'inFile' and writes the result to 'outFile' as a
+ * binary score, which Csound can play without reading it as text.
+ * 'outFile' should be opened in binary mode. As with csoundScoreSort(),
+ * csoundReset() should be called afterwards. On success, zero is returned.
+ */
+
+PUBLIC int csoundScoreSortBinary(CSOUND *csound, FILE *inFile, FILE *outFile)
+{
+    int   err;
+    CORFIL *inf = corfile_create_w(csound);
+    int c;
+    if ((err = setjmp(csound->exitjmp)) != 0) {
+      return ((err - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
+    }
+    while ((c=getc(inFile))!=EOF) corfile_putc(csound, c, inf);
+    corfile_puts(csound, "\ne\n#exit\n", inf);
+    corfile_rewind(inf);
+    csound->scorestr = inf;
+    scsortstr(csound, inf);
+    err = scobin_write(csound, csound->scstr, outFile);
+    corfile_rm(csound, &csound->scstr);
+    return err;
+}
+
 /**
  * Extracts from 'inFile', controlled by 'extractFile', and writes
  * the result to 'outFile'. The Csound instance should be initialised
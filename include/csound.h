@@ -1458,6 +1458,19 @@ extern "C" {
   PUBLIC void csoundSetExternalMidiErrorStringCallback(CSOUND *,
                                                        const char *(*func)(int));
 
+  /**
+   * Queues a MIDI channel message of nbytes (1 to 3) bytes, time stamped
+   * on arrival, to be read with the real time MIDI input.  It can be
+   * called from any thread without locking, for example from a driver
+   * callback; MIDI input must be enabled (-M, or host implemented MIDI
+   * I/O).  Messages are read in the k-period after they arrive, and with
+   * --sample-accurate, notes start at the offset within the k-period
+   * that corresponds to their time of arrival.  Returns CSOUND_ERROR if
+   * the queue is full or MIDI input is not open, else CSOUND_SUCCESS.
+   */
+  PUBLIC int csoundPushMidiMessage(CSOUND *csound,
+                                   const unsigned char *msg, int nbytes);
+
 
   /**
    * Sets a function that is called to obtain a list of MIDI devices.
@@ -1548,6 +1561,15 @@ extern "C" {
    */
   PUBLIC int csoundScoreSort(CSOUND *, FILE *inFile, FILE *outFile);
 
+  /**
+   * Sorts score file 'inFile' and writes the result to 'outFile' as a
+   * binary score, which can be given to Csound as its score and is played
+   * without being read as text. 'outFile' should be opened in binary mode.
+   * csoundReset() should be called after sorting the score to clean up.
+   * On success, zero is returned.
+   */
+  PUBLIC int csoundScoreSortBinary(CSOUND *, FILE *inFile, FILE *outFile);
+
   /**
    * Extracts from 'inFile', controlled by 'extractFile', and writes
    * the result to 'outFile'. The Csound instance should be initialised
@@ -1884,6 +1906,30 @@ extern "C" {
    */
   PUBLIC void csoundInputMessageAsync(CSOUND *, const char *message);
 
+  /**
+   * Returns a handle for the instrument called 'name', for use with
+   * csoundInputEvent(), or zero if there is no such instrument.
+   * The name is resolved once. The handle stays valid until a later
+   * compilation numbers named instruments again; after that, events
+   * sent with it are rejected and a new handle should be requested.
+   */
+  PUBLIC int64_t csoundGetInstrumentHandle(CSOUND *, const char *name);
+
+  /**
+   * Input a realtime event in binary form: the counterpart of
+   * csoundInputMessage() for hosts that generate many events, which
+   * bypasses the text parser. 'type' and 'pFields' are as for
+   * csoundScoreEvent(). If 'handle' is not zero, it names the
+   * instrument, and pFields[0] only gives the sign and fractional part
+   * of p1 (zero for a plain note).
+   * The event is queued without taking the API lock, and is inserted at
+   * the start of the next control period, after any queued before it.
+   * Returns CSOUND_SUCCESS, or CSOUND_ERROR if the event is malformed or
+   * the handle is no longer valid.
+   */
+  PUBLIC int csoundInputEvent(CSOUND *, char type, int64_t handle,
+                              const MYFLT *pFields, long numFields);
+
   /**
    * Kills off one or more running instances of an instrument identified
    * by instr (number) or instrName (name). If instrName is NULL, the
@@ -270,6 +270,13 @@ typedef struct CORFIL {
     int     echo;
     MYFLT   limiter;
     float   sr_default, kr_default;
+    int     sfwriter;       /* sound file writer thread queue depth (0: off) */
+    int     sfsync;         /* fsync output file: 0: no, 1: at close, 2: all */
+    int     scalarspout;    /* use the scalar spout conversion and dither */
+    int     noudoinline;    /* do not inline UDOs at compile time */
+    int     smoothfilters;  /* cached, ramped k-rate filter coefficients */
+    int     pvsfastmath;    /* polynomial atan2, sin, cos in pvsanal/pvsynth */
+    int     scorewindow;    /* sort the score in windows of this many lines */
   } OPARMS;
 
   typedef struct arglst {
@@ -828,12 +835,27 @@ typedef struct CORFIL {
     unsigned char mbuf[MBUFSIZ];
     unsigned char *bufp, *endatp;
     int16   datreq, datcnt;
+    void    *midiRing;      /* queue of csoundPushMidiMessage() */
+    int     evtOffset;      /* sample offset of message being read */
   } MGLOBAL;
 
+  /* A queued realtime event: the used part of an EVTBLK, allocated to
+     length from a pool in musmon.c.  The p-fields are followed by any
+     beyond PMAX (extra) and by the string arguments (strarg). */
   typedef struct eventnode {
     struct eventnode  *nxt;
+    struct eventnode  *child;   /* first child in the OrcTrigEvts heap */
+    uint64_t          seqno;    /* insertion order, for equal start_kcnt */
     uint32     start_kcnt;
-    EVTBLK            evt;
+    uint32     size;            /* bytes allocated for this record */
+    char       *strarg;
+    int        scnt;
+    char       opcod;
+    int16      pcnt;
+    void       *pinstance;
+    MYFLT      *extra;
+    MYFLT      p2orig, p3orig;
+    MYFLT      p[1];            /* p[0] to p[3], or to p[min(pcnt, PMAX)] */
   } EVTNODE;
 
   typedef struct {
@@ -944,6 +966,8 @@ typedef struct NAME__ {
     CS_VAR_POOL* in_arg_pool;
     INSTRTXT *ip;
     struct opcodinfo *prv;
+    TREE    *body;          /* unverified copy of the body, for inlining */
+    int     inlinable;      /* the body may be inlined at call sites */
   } OPCODINFO;
 
   /**
@@ -993,6 +1017,7 @@ typedef struct _alloc_data_ {
   MEVENT mep;
   INSDS *ip;
   OPDS *ids;
+  int offset;           /* sample offset of a MIDI note */
 } ALLOC_DATA;
 
 #define MAX_MESSAGE_STR 1024
@@ -1410,11 +1435,13 @@ typedef struct _message_queue_t_ {
     MYFLT* (*CepsLP)(CSOUND *, MYFLT *, MYFLT *, int, int);
     MYFLT (*LPrms)(CSOUND *, void *);
     void *(*CreateThread2)(uintptr_t (*threadRoutine)(void *), unsigned int, void *userdata);
+    void (*RealFFT2Batch)(CSOUND *csound,
+                          void *p, MYFLT **sigs, int nsigs);
     /**@}*/
     /** @name Placeholders
         To allow the API to grow while maintining backward binary compatibility. */
     /**@{ */
-    SUBR dummyfn_2[22];
+    SUBR dummyfn_2[21];
     /**@}*/
 #ifdef __BUILDING_LIBCSOUND
     /* ------- private data (not to be used by hosts or externals) ------- */
@@ -1562,8 +1589,8 @@ typedef struct _message_queue_t_ {
     int32         rngcnt[MAXCHNLS];
     int16         rngflg, multichan;
     void          *evtFuncChain;
-    EVTNODE       *OrcTrigEvts;             /* List of events to be started */
-    EVTNODE       *freeEvtNodes;
+    EVTNODE       *OrcTrigEvts;             /* Heap of events to be started */
+    void          *evtPool;        /* their records (was freeEvtNodes) */
     int           csoundIsScorePending_;
     int64_t       advanceCnt;
     int           initonly;
@@ -1642,6 +1669,10 @@ typedef struct _message_queue_t_ {
       int     unused_intA;
       MACRO   *unused_ptr1;
       int     nocarry;
+      int     window;                 /* statements per sorting window, or 0  */
+      int     inwindow;               /* the next window continues a section  */
+      SRTBLK  *hist;                  /* last of the notes kept for carrying  */
+      char    *histmem, *histend;
     } sread;
     struct onefileStatics__ {
       NAMELST *toremove;
@@ -1660,6 +1691,10 @@ typedef struct _message_queue_t_ {
       int     linebufsiz;
       char *orchestra, *orchestrab;
       int   oflag;
+      char    *binbuf, *binbuf2;  /* csoundInputEvent() records */
+      int32   binlen, binsiz, binsiz2;
+      int     binreg;
+      spin_lock_t binlock;
     } lineventStatics;
     struct musmonStatics__ {
       int32   srngcnt[MAXCHNLS], orngcnt[MAXCHNLS];
@@ -1669,6 +1704,7 @@ typedef struct _message_queue_t_ {
       int     segamps, sormsg;
       EVENT   **ep, **epend;      /* pointers for stepping through lplay list */
       EVENT   *lsect;
+      uint64_t evtseqno;          /* count of events queued to OrcTrigEvts */
     } musmonStatics;
     struct libsndStatics__ {
       SNDFILE       *outfile;
@@ -1687,6 +1723,7 @@ typedef struct _message_queue_t_ {
       uint32        nframes               /* = 1UL */;
       FILE          *pin, *pout;
       int           dither;
+      void          *writer;              /* sound file writer thread     */
     } libsndStatics;
 
     int           warped;               /* rdscor.c */
@@ -1839,6 +1876,10 @@ typedef struct _message_queue_t_ {
     char *opcodedir;
     char *score_srt;
     int mp3_mode;
+    void *fftPlanCache;         /* fftlib.c */
+    uint32_t instrNameGen;      /* bumped when named instrs are numbered */
+    void *scoreStream;          /* scsort.c, when sorting in windows */
+    void *scoreBin;             /* scobin.c, binary score being played */
     /*struct CSOUND_ **self;*/
     /**@}*/
 #endif  /* __BUILDING_LIBCSOUND */
@@ -167,6 +167,47 @@ void test_linenum(void)
 
 
 
+static int count_opcodes(CSOUND *csound, int insno, const char *name)
+{
+    OPTXT *op = (OPTXT *) csound->engineState.instrtxtp[insno];
+    int n = 0;
+
+    while ((op = op->nxtop) != NULL)
+      if (op->t.opcod != NULL && !strcmp(op->t.opcod, name))
+        n++;
+    return n;
+}
+
+void test_udo_inline_calls(void)
+{
+    CSOUND  *csound;
+    int     inl;
+    char  *orc =
+            "opcode Twice, k, k\n"
+            "kx xin\n"
+            "kx *= 2\n"
+            "xout kx\n"
+            "endop\n"
+            "instr 1\n"
+            "kv Twice 1\n"
+            "kw Twice kv\n"
+            "endin\n";
+
+    for (inl = 0; inl < 2; inl++) {
+      csound = csoundCreate(NULL);
+      csoundSetOption(csound, "-n");
+      if (!inl)
+        csoundSetOption(csound, "--no-udo-inline");
+      CU_ASSERT(csoundCompileOrc(csound, orc) == 0);
+      /* both calls are replaced by the body, with their own locals */
+      CU_ASSERT_EQUAL(count_opcodes(csound, 1, "Twice"), inl ? 0 : 2);
+      CU_ASSERT_EQUAL(csoundFindVariableWithName(csound,
+                        csound->engineState.instrtxtp[1]->varPool,
+                        "kx#1") != NULL, inl);
+      csoundDestroy(csound);
+    }
+}
+
 int main() {
     CU_pSuite pSuite = NULL;
     
@@ -186,7 +227,9 @@ int main() {
             (NULL == CU_add_test(pSuite, "Test splitArgs", test_split_args)) ||
             (NULL == CU_add_test(pSuite, "Test Compilation", test_compile)) ||
             (NULL == CU_add_test(pSuite, "Test Reuse Instance", test_reuse)) ||
-        (NULL == CU_add_test(pSuite, "Test Line Numbers", test_linenum))) {
+        (NULL == CU_add_test(pSuite, "Test Line Numbers", test_linenum)) ||
+        (NULL == CU_add_test(pSuite, "Test UDO Inlining",
+                             test_udo_inline_calls))) {
         CU_cleanup_registry();
         return CU_get_error();
     }
@@ -1,5 +1,7 @@
 #include "csound.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <CUnit/Basic.h>
 
 #include "time.h"
@@ -54,6 +56,1236 @@ void test_compile_async(void)
     csoundDestroy(csound);
 }
 
+static const char *udo_nested_orc =
+    "opcode Acc, k, kk\n"
+    "kx, kn xin\n"
+    "ks = 0\n"
+    "ki = 0\n"
+    "loop:\n"
+    "ks += kx\n"
+    "ki += 1\n"
+    "if ki < kn kgoto loop\n"
+    "xout ks\n"
+    "endop\n"
+    "opcode Twice, k, k\n"
+    "kx xin\n"
+    "xout Acc(kx, 2)\n"
+    "endop\n"
+    "instr 1\n"
+    "kx = 1.5\n"
+    "kv Twice kx\n"
+    "kw Twice kv\n"
+    "chnset kw, \"udo\"\n"
+    "endin\n";
+
+static const char *udo_args_orc =
+    "opcode Dbl, k, k\n"
+    "kx xin\n"
+    "kx *= 2\n"
+    "xout kx\n"
+    "endop\n"
+    "opcode Sum, k, k\n"
+    "kin xin\n"
+    "kacc init 0\n"
+    "kacc += kin\n"
+    "xout kacc\n"
+    "endop\n"
+    "instr 1\n"
+    "kv = 3\n"
+    "kd Dbl kv\n"
+    "ks Sum kv\n"
+    "chnset kv + kd * 10 + ks * 100, \"udo\"\n"
+    "endin\n";
+
+static const char *udo_write_input_orc =
+    "opcode Poke, k, a\n"
+    "ain xin\n"
+    "vaset 5, 0, ain\n"
+    "kv vaget 0, ain\n"
+    "xout kv\n"
+    "endop\n"
+    "instr 1\n"
+    "asig = 1\n"
+    "kr Poke asig\n"
+    "kc vaget 0, asig\n"
+    "chnset kr * 10 + kc, \"udo\"\n"
+    "endin\n";
+
+static MYFLT run_udo_orc(const char *orc, int inline_udos)
+{
+    CSOUND  *csound;
+    MYFLT res;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    if (!inline_udos)
+      csoundSetOption(csound, "--no-udo-inline");
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, "i 1 0 1\n");
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    res = csoundGetControlChannel(csound, "udo", NULL);
+    csoundDestroy(csound);
+    return res;
+}
+
+void test_udo_inline(void)
+{
+    CU_ASSERT_EQUAL(run_udo_orc(udo_nested_orc, 1), 6.0);
+    CU_ASSERT_EQUAL(run_udo_orc(udo_nested_orc, 0), 6.0);
+}
+
+void test_udo_args(void)
+{
+    /* inputs written in the body are copies, state in outputs survives */
+    CU_ASSERT_EQUAL(run_udo_orc(udo_args_orc, 0), 663.0);
+    CU_ASSERT_EQUAL(run_udo_orc(udo_args_orc, 1), 663.0);
+    /* an input written by an opcode flagged WI (vaset) is a copy too */
+    CU_ASSERT_EQUAL(run_udo_orc(udo_write_input_orc, 0), 51.0);
+    CU_ASSERT_EQUAL(run_udo_orc(udo_write_input_orc, 1), 51.0);
+}
+
+void test_scobin_extra_pfields(void)
+{
+    /* an f statement with more than PMAX p-fields, through a binary score */
+    CSOUND  *csound;
+    FILE    *f, *out;
+    MYFLT   *tab = NULL;
+    const char *argv[] = { "csound", "-n", "-d", "engine_test.orc",
+                           "engine_test.scb" };
+    int     i, len, ret;
+
+    f = fopen("engine_test.sco", "w");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    fprintf(f, "f 1 0 4096 -2");
+    for (i = 1; i <= 2500; i++)
+      fprintf(f, " %d", i);
+    fprintf(f, "\ni 1 0 0.1\n");
+    fclose(f);
+    f = fopen("engine_test.orc", "w");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    fprintf(f, "instr 1\nendin\n");
+    fclose(f);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-m0");
+    f = fopen("engine_test.sco", "r");
+    out = fopen("engine_test.scb", "wb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(out);
+    ret = csoundScoreSortBinary(csound, f, out);
+    fclose(f);
+    fclose(out);
+    csoundDestroy(csound);
+    CU_ASSERT_EQUAL(ret, 0);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-m0");
+    CU_ASSERT_EQUAL(csoundCompile(csound, 5, argv), 0);
+    csoundPerformKsmps(csound);
+    len = csoundGetTable(csound, &tab, 1);
+    CU_ASSERT_EQUAL(len, 4096);
+    if (tab != NULL && len >= 2500) {
+      CU_ASSERT_EQUAL(tab[0], 1.0);
+      CU_ASSERT_EQUAL(tab[1997], 1998.0);
+      CU_ASSERT_EQUAL(tab[2499], 2500.0);
+      CU_ASSERT_EQUAL(tab[2500], 0.0);
+    }
+    csoundDestroy(csound);
+    remove("engine_test.sco");
+    remove("engine_test.scb");
+    remove("engine_test.orc");
+}
+
+/* an instance performing orc and sco, with the options in opts (NULL
+   terminated, or NULL); NULL if it does not start */
+static CSOUND *start_orc(const char *orc, const char *sco,
+                         const char **opts)
+{
+    CSOUND  *csound;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    for ( ; opts != NULL && *opts != NULL; opts++)
+      csoundSetOption(csound, *opts);
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, sco) != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return NULL;
+    }
+    return csound;
+}
+
+/* performs n k-periods, adding up the squares of the output samples of
+   each channel in sum2 and keeping their largest magnitude in peak */
+static void perform_stats(CSOUND *csound, int n, double *sum2, double *peak)
+{
+    const MYFLT *spout = csoundGetSpout(csound);
+    int     nchnls = csoundGetNchnls(csound);
+    int     nsmps = csoundGetKsmps(csound) * nchnls;
+    int     i, j;
+    double  x;
+
+    for (j = 0; j < nchnls; j++)
+      sum2[j] = peak[j] = 0.0;
+    for (i = 0; i < n; i++) {
+      if (csoundPerformKsmps(csound) != 0)
+        break;
+      for (j = 0; j < nsmps; j++) {
+        x = spout[j];
+        sum2[j % nchnls] += x * x;
+        if (x < 0.0) x = -x;
+        if (x > peak[j % nchnls]) peak[j % nchnls] = x;
+      }
+    }
+}
+
+static const char *vco2bank_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 4\n"
+    "0dbfs = 1\n"
+    "gisine ftgen 0, 0, 4096, 10, 1\n"
+    "instr 1\n"
+    "k1[] fillarray 1000\n"
+    "k6[] fillarray 1000, 1000, 1000, 1000, 1000, 1000\n"
+    "k2[] fillarray 1000, 1000\n"
+    "ka[] fillarray 0.25, 0.75\n"
+    "aref vco2 0.5, 1000\n"
+    "a1 vco2bank 0.5, k1\n"
+    "a6 vco2bank 0.5, k6\n"
+    "a2 vco2bank ka, k2\n"
+    "outch 1, a1 - aref, 2, a6 - 6 * aref, 3, a2 - 2 * aref, 4, aref\n"
+    "endin\n"
+    "instr 2\n"
+    "; one oscillator without modulation or EQ, playing the vco2 saw\n"
+    "a1 oscbnk 1000, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, "
+    "gisine, 0, 0, 0, 0, 0, 0, 0, 0\n"
+    "a2 vco2 1, 1000\n"
+    "a3 poscil 1, 1000, gisine\n"
+    "outch 1, a1, 2, a2, 3, a3\n"
+    "endin\n";
+
+void test_vco2bank(void)
+{
+    CSOUND  *csound;
+    double  sum2[4], peak[4];
+
+    /* the voices of a bank play as vco2 does, in any group of lanes */
+    csound = start_orc(vco2bank_orc, "i 1 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_stats(csound, 100, sum2, peak);
+    CU_ASSERT(peak[3] > 0.4);
+    CU_ASSERT(peak[0] < 1.0e-6);
+    CU_ASSERT(peak[1] < 1.0e-5);
+    CU_ASSERT(peak[2] < 1.0e-5);
+    csoundDestroy(csound);
+
+    /* oscbnk with ivco2 plays the band-limited saw, not the sine of kfn;
+       the start phase is random, but not the power over whole periods */
+    csound = start_orc(vco2bank_orc, "i 2 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_stats(csound, 100, sum2, peak);
+    CU_ASSERT(sum2[1] > 0.0);
+    if (sum2[1] > 0.0) {
+      CU_ASSERT(sum2[0] / sum2[1] > 0.99 && sum2[0] / sum2[1] < 1.01);
+      CU_ASSERT(sum2[2] / sum2[1] > 1.4);
+    }
+    csoundDestroy(csound);
+}
+
+static const char *filterbank_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 3\n"
+    "0dbfs = 1\n"
+    "gisine ftgen 0, 0, 16384, 10, 1\n"
+    "instr 1\n"
+    "ain poscil 1, 440, gisine\n"
+    "kb0[] fillarray 0.2, 0.2, 0.2, 0.2, 0.2\n"
+    "kb1[] fillarray 0.4, 0.4, 0.4, 0.4, 0.4\n"
+    "kb2[] fillarray 0.2, 0.2, 0.2, 0.2, 0.2\n"
+    "ka0[] fillarray 1, 1, 1, 1, 1\n"
+    "ka1[] fillarray -0.5, -0.5, -0.5, -0.5, -0.5\n"
+    "ka2[] fillarray 0.3, 0.3, 0.3, 0.3, 0.3\n"
+    "aref biquad ain, 0.2, 0.4, 0.2, 1, -0.5, 0.3\n"
+    "ay[] biquadbank ain, kb0, kb1, kb2, ka0, ka1, ka2\n"
+    "a0 = ay[0]\n"
+    "a4 = ay[4]\n"
+    "outch 1, a0 - aref, 2, a4 - aref, 3, aref\n"
+    "endin\n"
+    "instr 2\n"
+    "ahi poscil 1, 12000, gisine\n"
+    "amid poscil 1, 1000, gisine\n"
+    "kf1[] fillarray 100\n"
+    "kq1[] fillarray 1\n"
+    "kf2[] fillarray 1000\n"
+    "kq2[] fillarray 5\n"
+    "ap[] svfbank ahi, kf1, kq1, 4\n"
+    "ab[] svfbank amid, kf2, kq2, 2\n"
+    "apk = ap[0]\n"
+    "abp = ab[0]\n"
+    "outch 1, apk - ahi, 2, abp, 3, amid\n"
+    "endin\n";
+
+void test_filterbanks(void)
+{
+    CSOUND  *csound;
+    double  sum2[3], peak[3];
+
+    /* each section of biquadbank is the biquad of its coefficients */
+    csound = start_orc(filterbank_orc, "i 1 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_stats(csound, 100, sum2, peak);
+    CU_ASSERT(peak[2] > 0.1);
+    CU_ASSERT(peak[0] < 1.0e-5);
+    CU_ASSERT(peak[1] < 1.0e-5);
+    csoundDestroy(csound);
+
+    /* once settled, the svfbank peak response (high-pass minus low-pass)
+       passes a tone far above the centre in phase, and the band-pass
+       response has unity gain at the centre */
+    csound = start_orc(filterbank_orc, "i 2 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_stats(csound, 100, sum2, peak);
+    perform_stats(csound, 100, sum2, peak);
+    CU_ASSERT(peak[0] < 0.02);
+    CU_ASSERT(sum2[2] > 0.0);
+    if (sum2[2] > 0.0)
+      CU_ASSERT(sum2[1] / sum2[2] > 0.98 && sum2[1] / sum2[2] < 1.02);
+    csoundDestroy(csound);
+}
+
+static const char *event_order_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "giorder init 0\n"
+    "gicount init 0\n"
+    "gibad init 0\n"
+    "giprvt init -1\n"
+    "giprvn init -1\n"
+    "instr 1\n"
+    "schedule 10, 0.03, 0.01, 1\n"
+    "schedule 10, 0.01, 0.01, 2\n"
+    "schedule 10, 0.02, 0.01, 3\n"
+    "schedule 10, 0.01, 0.01, 4\n"
+    "schedule 10, 0.01, 0.01, 5\n"
+    "schedule 10, 0.005, 0.01, 6\n"
+    "endin\n"
+    "instr 2\n"
+    "ii = 0\n"
+    "next:\n"
+    "schedule 11, 0.001 + ((ii * 37) % 50) * 0.001, 0.01, ii\n"
+    "loop_lt ii, 1, 200, next\n"
+    "endin\n"
+    "instr 10\n"
+    "giorder = giorder * 10 + p4\n"
+    "chnset giorder, \"order\"\n"
+    "endin\n"
+    "instr 11\n"
+    "it times\n"
+    "if it < giprvt || (it == giprvt && p4 < giprvn) then\n"
+    "gibad += 1\n"
+    "endif\n"
+    "giprvt = it\n"
+    "giprvn = p4\n"
+    "gicount += 1\n"
+    "chnset gicount, \"count\"\n"
+    "chnset gibad, \"bad\"\n"
+    "endin\n";
+
+void test_event_order(void)
+{
+    CSOUND  *csound;
+    int     i;
+
+    /* events queued from the orchestra start in time order, and those
+       with the same start time in the order they were queued */
+    csound = start_orc(event_order_orc, "i 1 0 0.2\ni 2 0 0.2\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 100; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "order", NULL),
+                    624531.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 200.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", NULL), 0.0);
+    csoundDestroy(csound);
+}
+
+static const char *input_event_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "gicount init 0\n"
+    "instr 1\n"
+    "chnset p4, \"num\"\n"
+    "endin\n"
+    "instr Synth\n"
+    "gicount += 1\n"
+    "chnset gicount, \"count\"\n"
+    "chnset p4, \"val\"\n"
+    "chnset frac(p1), \"frac\"\n"
+    "endin\n";
+
+void test_input_event(void)
+{
+    CSOUND  *csound;
+    int64_t handle, handle2;
+    MYFLT   note[4] = { 0.0, 0.0, 0.1, 7.0 };
+    MYFLT   num[4] = { 1.0, 0.0, 0.1, 3.0 };
+
+    csound = start_orc(input_event_orc, "f 0 10\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    csoundPerformKsmps(csound);
+    handle = csoundGetInstrumentHandle(csound, "Synth");
+    CU_ASSERT(handle != 0);
+    CU_ASSERT_EQUAL(csoundGetInstrumentHandle(csound, "Synht"), 0);
+
+    /* events through a handle, and by number; all queued events are
+       started at the next control period */
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'i', handle, note, 4),
+                    CSOUND_SUCCESS);
+    note[0] = 0.5;
+    note[3] = 8.0;
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'i', handle, note, 4),
+                    CSOUND_SUCCESS);
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'i', 0, num, 4),
+                    CSOUND_SUCCESS);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 2.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "val", NULL), 8.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "frac", NULL), 0.5);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "num", NULL), 3.0);
+
+    /* malformed events are refused */
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'x', 0, num, 4),
+                    CSOUND_ERROR);
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'f', handle, num, 4),
+                    CSOUND_ERROR);
+
+    /* a compilation numbers named instruments again: the old handle is
+       refused, a new one works */
+    CU_ASSERT_EQUAL(csoundCompileOrc(csound, "instr Other\nendin\n"), 0);
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'i', handle, note, 4),
+                    CSOUND_ERROR);
+    handle2 = csoundGetInstrumentHandle(csound, "Synth");
+    CU_ASSERT(handle2 != 0 && handle2 != handle);
+    note[0] = 0.0;
+    note[3] = 9.0;
+    CU_ASSERT_EQUAL(csoundInputEvent(csound, 'i', handle2, note, 4),
+                    CSOUND_SUCCESS);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 3.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "val", NULL), 9.0);
+    csoundDestroy(csound);
+}
+
+static const char *score_window_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "giorder init 0\n"
+    "gicount init 0\n"
+    "instr 1\n"
+    "giorder = giorder * 10 + p4\n"
+    "gicount += 1\n"
+    "chnset giorder, \"order\"\n"
+    "chnset gicount, \"count\"\n"
+    "it times\n"
+    "Sname sprintf \"t%d\", p4\n"
+    "chnset it, Sname\n"
+    "endin\n";
+
+/* note 5 belongs to the first window of three statements, but is read
+   in the second; notes 7 and 9 carry p2 and p3 across the windows */
+static const char *score_window_sco =
+    "i 1 0 0.01 1\n"
+    "i 1 0.01 . 2\n"
+    "i 1 0.02 . 3\n"
+    "i 1 0.03 . 4\n"
+    "i 1 0.005 . 5\n"
+    "i 1 0.04 . 6\n"
+    "i 1 + . 7\n"
+    "i 1 0.06 . 8\n"
+    "i 1 + . 9\n";
+
+void test_score_window(void)
+{
+    CSOUND  *csound;
+    const char *opts[] = { "--score-window=3", NULL };
+    double  t;
+    int     i;
+
+    /* the whole score is sorted at once */
+    csound = start_orc(score_window_orc, score_window_sco, NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 100; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "order", NULL),
+                    152346789.0);
+    csoundDestroy(csound);
+
+    /* in windows, the late note is played as soon as it is read, and
+       none is lost */
+    csound = start_orc(score_window_orc, score_window_sco, opts);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 100; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 9.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "order", NULL),
+                    123546789.0);
+    t = csoundGetControlChannel(csound, "t5", NULL);
+    CU_ASSERT(t >= csoundGetControlChannel(csound, "t3", NULL) && t < 0.03);
+    t = csoundGetControlChannel(csound, "t7", NULL);
+    CU_ASSERT(t > 0.05 - 1.0e-6 && t < 0.05 + 1.0e-6);
+    t = csoundGetControlChannel(csound, "t9", NULL);
+    CU_ASSERT(t > 0.07 - 1.0e-6 && t < 0.07 + 1.0e-6);
+    csoundDestroy(csound);
+}
+
+static const char *sample_accurate_orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "a1 init 1\n"
+    "outch p4, a1\n"
+    "endin\n"
+    "instr 2\n"
+    "schedule 1, 0.0105, 0.005, 2\n"
+    "endin\n";
+
+/* the first and last frame of the output in which each of two channels
+   is not silent, over n k-periods */
+static void sound_span(CSOUND *csound, int n, int *first, int *last)
+{
+    const MYFLT *spout = csoundGetSpout(csound);
+    int     ksmps = csoundGetKsmps(csound);
+    int     i, j, c;
+
+    first[0] = first[1] = last[0] = last[1] = -1;
+    for (i = 0; i < n; i++) {
+      if (csoundPerformKsmps(csound) != 0)
+        break;
+      for (j = 0; j < ksmps; j++)
+        for (c = 0; c < 2; c++)
+          if (spout[j * 2 + c] != 0.0) {
+            if (first[c] < 0)
+              first[c] = i * ksmps + j;
+            last[c] = i * ksmps + j;
+          }
+    }
+}
+
+void test_sample_accurate(void)
+{
+    CSOUND  *csound;
+    const char *opts[] = { "--sample-accurate", NULL };
+    const char *sco = "i 1 0.01 0.005 1\ni 2 0 0.001\n";
+    int     first[2], last[2];
+
+    /* notes from the score and from the orchestra start and end at
+       their samples, inside the k-period */
+    csound = start_orc(sample_accurate_orc, sco, opts);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    sound_span(csound, 20, first, last);
+    CU_ASSERT_EQUAL(first[0], 480);
+    CU_ASSERT_EQUAL(last[0], 719);
+    CU_ASSERT_EQUAL(first[1], 504);
+    CU_ASSERT_EQUAL(last[1], 743);
+    csoundDestroy(csound);
+
+    /* otherwise at the start of a k-period */
+    csound = start_orc(sample_accurate_orc, sco, NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    sound_span(csound, 20, first, last);
+    CU_ASSERT(first[0] > 0 && first[0] % 64 == 0);
+    CU_ASSERT(first[1] > 0 && first[1] % 64 == 0);
+    csoundDestroy(csound);
+}
+
+static const char *midifile_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "giorder init 0\n"
+    "instr 1, 2\n"
+    "it times\n"
+    "giorder = giorder * 10 + p1\n"
+    "chnset giorder, \"order\"\n"
+    "Sname sprintf \"t%d\", p1\n"
+    "chnset it, Sname\n"
+    "endin\n";
+
+/* a type 1 file of 96 ticks per quarter note: a tempo track going from
+   120 to 240 beats per minute at tick 96 (0.5 s), and a track each for
+   channels 1 and 2, with notes at ticks 48 and 144 (0.25 s, 0.625 s),
+   and 48 and 120 (0.25 s, 0.5625 s) */
+static const unsigned char midifile[] = {
+    'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 3, 0, 96,
+    'M', 'T', 'r', 'k', 0, 0, 0, 18,
+    0, 0xFF, 0x51, 3, 0x07, 0xA1, 0x20,
+    96, 0xFF, 0x51, 3, 0x03, 0xD0, 0x90,
+    0, 0xFF, 0x2F, 0,
+    'M', 'T', 'r', 'k', 0, 0, 0, 20,
+    48, 0x90, 60, 100, 12, 0x80, 60, 0,
+    84, 0x90, 60, 100, 12, 0x80, 60, 0,
+    0, 0xFF, 0x2F, 0,
+    'M', 'T', 'r', 'k', 0, 0, 0, 20,
+    48, 0x91, 62, 100, 12, 0x81, 62, 0,
+    60, 0x91, 62, 100, 12, 0x81, 62, 0,
+    0, 0xFF, 0x2F, 0
+};
+
+void test_midifile(void)
+{
+    CSOUND  *csound;
+    FILE    *f;
+    const char *opts[] = { "-Fengine_test.mid", NULL };
+    double  t;
+    int     i;
+
+    f = fopen("engine_test.mid", "wb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    fwrite(midifile, 1, sizeof(midifile), f);
+    fclose(f);
+
+    /* the tracks are merged in time order, the first track first at the
+       same time, and the ticks timed by the tempo track */
+    csound = start_orc(midifile_orc, "f 0 1\n", opts);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 800; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "order", NULL), 1221.0);
+    t = csoundGetControlChannel(csound, "t1", NULL);
+    CU_ASSERT(t > 0.625 - 0.0015 && t < 0.625 + 0.0015);
+    t = csoundGetControlChannel(csound, "t2", NULL);
+    CU_ASSERT(t > 0.5625 - 0.0015 && t < 0.5625 + 0.0015);
+    csoundDestroy(csound);
+    remove("engine_test.mid");
+}
+
+static const char *push_midi_orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "a1 init 1\n"
+    "out a1\n"
+    "endin\n";
+
+static int midi_open(CSOUND *csound, void **userData, const char *dev)
+{
+    (void) csound; (void) dev;
+    *userData = NULL;
+    return 0;
+}
+
+static int midi_read(CSOUND *csound, void *userData,
+                     unsigned char *buf, int nbytes)
+{
+    (void) csound; (void) userData; (void) buf; (void) nbytes;
+    return 0;
+}
+
+static int midi_close(CSOUND *csound, void *userData)
+{
+    (void) csound; (void) userData;
+    return 0;
+}
+
+/* performs a k-period, and returns the first sample of it that is not
+   silent, or -1 */
+static int perform_onset(CSOUND *csound)
+{
+    const MYFLT *spout = csoundGetSpout(csound);
+    int     j, ksmps = csoundGetKsmps(csound);
+
+    csoundPerformKsmps(csound);
+    for (j = 0; j < ksmps; j++)
+      if (spout[j] != 0.0)
+        return j;
+    return -1;
+}
+
+void test_push_midi(void)
+{
+    CSOUND  *csound;
+    unsigned char ctl[3] = { 0xB0, 1, 0 };
+    unsigned char on[3] = { 0x90, 60, 100 }, off[3] = { 0x80, 60, 0 };
+    int     i, j;
+
+    csound = csoundCreate(NULL);
+    csoundSetHostImplementedMIDIIO(csound, 1);
+    csoundSetExternalMidiInOpenCallback(csound, midi_open);
+    csoundSetExternalMidiReadCallback(csound, midi_read);
+    csoundSetExternalMidiInCloseCallback(csound, midi_close);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-M0");
+    csoundSetOption(csound, "--sample-accurate");
+    CU_ASSERT_EQUAL(csoundCompileOrc(csound, push_midi_orc), 0);
+    CU_ASSERT_EQUAL(csoundReadScore(csound, "f 0 10\n"), 0);
+    /* MIDI input is not open yet */
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, ctl, 3), CSOUND_ERROR);
+    CU_ASSERT_EQUAL_FATAL(csoundStart(csound), 0);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, ctl, 0), CSOUND_ERROR);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, ctl + 1, 2), CSOUND_ERROR);
+
+    /* the queue holds 1024 messages until they are read */
+    for (i = 0; i < 1024; i++)
+      if (csoundPushMidiMessage(csound, ctl, 3) != CSOUND_SUCCESS)
+        break;
+    CU_ASSERT_EQUAL(i, 1024);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, ctl, 3), CSOUND_ERROR);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, ctl, 3), CSOUND_SUCCESS);
+    csoundPerformKsmps(csound);
+
+    /* a note that arrives late in a k-period starts late in the next,
+       and one that arrives early, early */
+    csoundSleep(10);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, on, 3), CSOUND_SUCCESS);
+    j = perform_onset(csound);
+    CU_ASSERT(j > 32);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, off, 3), CSOUND_SUCCESS);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(perform_onset(csound), -1);
+    CU_ASSERT_EQUAL(csoundPushMidiMessage(csound, on, 3), CSOUND_SUCCESS);
+    csoundSleep(10);
+    j = perform_onset(csound);
+    CU_ASSERT(j >= 0 && j < 32);
+    csoundDestroy(csound);
+}
+
+/* performs n k-periods, keeping all the output frames in out */
+static void perform_frames(CSOUND *csound, int n, double *out)
+{
+    const MYFLT *spout = csoundGetSpout(csound);
+    int     nsmps = csoundGetKsmps(csound) * csoundGetNchnls(csound);
+    int     i, j;
+
+    for (i = 0; i < n; i++) {
+      csoundPerformKsmps(csound);
+      for (j = 0; j < nsmps; j++)
+        *out++ = spout[j];
+    }
+}
+
+/* the weight of a sample at t samples from the read position in linear
+   or cubic (Lagrange) interpolation */
+static double interp_weight(double t, int cubic)
+{
+    int     v, j;
+    double  w = 1.0;
+
+    if (!cubic) {
+      if (t < 0.0) t = -t;
+      return (t < 1.0 ? 1.0 - t : 0.0);
+    }
+    v = (int) t;
+    if (v > t) v--;
+    if (v < -2 || v > 1)
+      return 0.0;
+    for (j = v - 1; j <= v + 2; j++)
+      if (j != 0)
+        w *= (t - j) / (0 - j);
+    return w;
+}
+
+/* the largest difference between channel c of the n frames of nch
+   channels in x and channel 0 delayed by d samples */
+static double delay_error(const double *x, int n, int nch, int c, double d,
+                          int cubic)
+{
+    double  y, e, emax = 0.0;
+    int     i, m;
+
+    for (i = 0; i < n; i++) {
+      for (y = 0.0, m = 0; m < n; m++)
+        if (x[m * nch] != 0.0)
+          y += x[m * nch] * interp_weight(i - m - d, cubic);
+      e = x[i * nch + c] - y;
+      if (e < 0.0) e = -e;
+      if (e > emax) emax = e;
+    }
+    return emax;
+}
+
+/* an impulse every 97 samples through the delay opcodes at 1000 Hz, so
+   that a millisecond is a sample; the lines of 50 samples wrap between
+   impulses */
+static const char *delay_orc =
+    "sr = 1000\n"
+    "ksmps = 8\n"
+    "nchnls = 18\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "ain mpulse 1, 0.097\n"
+    "a2 vdelay ain, 10, 50\n"
+    "a3 vdelay ain, a(10.25), 50\n"
+    "a4 vdelay ain, 50, 50\n"
+    "a5 vdelay3 ain, 10.25, 50\n"
+    "a6 vdelay3 ain, a(23.5), 50\n"
+    "a7 vdelayx ain, a(0.01), 0.05, 8\n"
+    "a8 vdelayx ain, a(0.0105), 0.05, 8\n"
+    "a9, ab vdelayxs ain, ain, a(0.0105), 0.05, 8\n"
+    "a10, ac, ad, ae vdelayxq ain, ain, ain, ain, a(0.0105), 0.05, 8\n"
+    "a11 vdelayx ain, a(0.05), 0.05, 8\n"
+    "a12 vdelayxw ain, a(0.01), 0.05, 8\n"
+    "a13 multitap ain, 0.005, 0.5, 0.02, 0.25\n"
+    "a14 delayr 0.05\n"
+    "a15 deltapi 0.05\n"
+    "a16 deltap3 0.05\n"
+    "a17 deltapi a(0.01025)\n"
+    "a18 deltap3 0.01025\n"
+    "delayw ain\n"
+    "outch 1, ain, 2, a2, 3, a3, 4, a4, 5, a5, 6, a6, 7, a7, 8, a8, "
+    "9, a9, 10, a10, 11, a11, 12, a12, 13, a13, 14, a14, 15, a15, "
+    "16, a16, 17, a17, 18, a18\n"
+    "endin\n";
+
+void test_delays(void)
+{
+    CSOUND  *csound;
+    double  x[400 * 18], e, y;
+    int     i, n = 400, nimp = 0;
+
+    csound = start_orc(delay_orc, "i 1 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_frames(csound, n / 8, x);
+    csoundDestroy(csound);
+    for (i = 0; i < n; i++)
+      if (x[i * 18] != 0.0) nimp++;
+    CU_ASSERT(nimp >= 4);
+
+    /* vdelay and vdelay3 at whole and fractional delays, and a delay of
+       the maximum, which wraps to none */
+    CU_ASSERT(delay_error(x, n, 18, 1, 10.0, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 2, 10.25, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 3, 0.0, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 4, 10.25, 1) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 5, 23.5, 1) < 1.0e-6);
+
+    /* vdelayx: a whole delay, and the maximum; vdelayxw: a whole delay */
+    CU_ASSERT(delay_error(x, n, 18, 6, 10.0, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 10, 0.0, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 11, 10.0, 0) < 1.0e-6);
+
+    /* a sinc interpolated delay of 10.5 is symmetric about it, and the
+       same for one, two and four channels */
+    for (i = 0; i + 20 < n; i++) {
+      if (x[i * 18] == 0.0)
+        continue;
+      y = x[(i + 10) * 18 + 7];
+      CU_ASSERT(y > 0.5);
+      e = y - x[(i + 11) * 18 + 7];
+      CU_ASSERT(e < 1.0e-6 && e > -1.0e-6);
+      e = x[(i + 9) * 18 + 7] - x[(i + 12) * 18 + 7];
+      CU_ASSERT(e < 1.0e-6 && e > -1.0e-6);
+    }
+    for (i = 0, e = 0.0; i < n; i++) {
+      y = x[i * 18 + 8] - x[i * 18 + 7];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+      y = x[i * 18 + 9] - x[i * 18 + 7];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+    }
+    CU_ASSERT(e < 1.0e-9);
+
+    /* multitap: a tap of d samples is d - 1 samples late */
+    for (i = 0, e = 0.0; i < n; i++) {
+      y = x[i * 18 + 12];
+      if (i >= 4) y -= 0.5 * x[(i - 4) * 18];
+      if (i >= 19) y -= 0.25 * x[(i - 19) * 18];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+    }
+    CU_ASSERT(e < 1.0e-6);
+
+    /* deltapi and deltap3 at the length of the delayr line read what
+       delayr does; and at fractional delays */
+    CU_ASSERT(delay_error(x, n, 18, 13, 50.0, 0) < 1.0e-6);
+    for (i = 0, e = 0.0; i < n; i++) {
+      y = x[i * 18 + 14] - x[i * 18 + 13];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+      y = x[i * 18 + 15] - x[i * 18 + 13];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+    }
+    CU_ASSERT(e < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 16, 10.25, 0) < 1.0e-6);
+    CU_ASSERT(delay_error(x, n, 18, 17, 10.25, 1) < 1.0e-6);
+}
+
+/* at sr = 32768 a 128 Hz grain clock and 3.90625 ms grains give grains of
+   128 samples every 256, and a 512 Hz waveform steps 64 points through a
+   table of 4096; instr 1 plays such grains with a triangle envelope, and
+   instr 2 a dense stream with sweeps, fm, a trainlet and panning, rendered
+   with p4 threads into outputs p5 and p5 + 1 */
+static const char *partikkel_orc =
+    "sr = 32768\n"
+    "ksmps = 64\n"
+    "nchnls = 4\n"
+    "0dbfs = 1\n"
+    "gisine ftgen 1, 0, 4096, 10, 1\n"
+    "giatt ftgen 2, 0, 1025, 7, 0, 1024, 1\n"
+    "gidec ftgen 3, 0, 1025, 7, 1, 1024, 0\n"
+    "gicos ftgen 4, 0, 8193, 11, 1\n"
+    "giamp ftgen 5, 0, 8, -2, 0, 0, 1, 0, 0, 0, 0\n"
+    "giamp2 ftgen 6, 0, 8, -2, 0, 0, 0.5, 0.3, 0, 0, 0.2\n"
+    "gichn ftgen 7, 0, 8, -2, 0, 2, 0, 0.5, 1\n"
+    "gistart ftgen 8, 0, 4, -2, 0, 1, 1, 2\n"
+    "giend ftgen 9, 0, 4, -2, 0, 1, 0.5, 1\n"
+    "instr 1\n"
+    "a1 partikkel 128, 0, -1, a(0), 0, -1, giatt, gidec, 0, 0.5, 3.90625, "
+    "1, -1, 512, 0, -1, -1, a(0), -1, -1, gicos, 1, 1, 0.5, -1, 0, "
+    "gisine, -1, -1, -1, giamp, a(0), a(0), a(0), a(0), 1, 1, 1, 1, 10\n"
+    "outch 1, a1\n"
+    "endin\n"
+    "instr 2\n"
+    "afm oscili 0.3, 300, gisine\n"
+    "a1, a2 partikkel 4096, 0, -1, a(0), 0.5, -1, giatt, gidec, 0.2, 0.3, "
+    "48.828125, 0.01, -1, 440, 0.7, gistart, giend, afm, -1, -1, gicos, "
+    "200, 20, 0.7, gichn, 0, gisine, gisine, -1, -1, giamp2, a(0), "
+    "a(0.25), a(0), a(0), 1, 1.5, 1, 1, 300, 0, -1, p4\n"
+    "outch p5, a1, p5 + 1, a2\n"
+    "endin\n";
+
+void test_partikkel(void)
+{
+    CSOUND  *csound;
+    const MYFLT *spout;
+    double  x[40 * 64 * 4], y, e;
+    int     i, j, k;
+
+    /* the grains of instr 1 against the table and envelope they read */
+    csound = start_orc(partikkel_orc, "i 1 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_frames(csound, 40, x);
+    for (i = 0, e = 0.0; i < 40 * 64; i++) {
+      k = i % 256;
+      y = 0.0;
+      if (k <= 128)
+        y = (k < 64 ? k : 128 - k) / 64.0
+            * csoundTableGet(csound, 1, (64 * k) % 4096);
+      y -= x[i * 4];
+      if (y < 0.0) y = -y;
+      if (y > e) e = y;
+    }
+    CU_ASSERT(e < 1.0e-9);
+    CU_ASSERT(x[72 * 4] > 0.5);
+    csoundDestroy(csound);
+
+    /* about 200 grains overlap in instr 2, so with 4 threads they are
+       shared out 5 ways; the sums differ only in their order */
+    csound = start_orc(partikkel_orc, "i 2 0 1 0 1\ni 2 0 1 4 3\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    spout = csoundGetSpout(csound);
+    for (i = 0, e = y = 0.0; i < 200; i++) {
+      csoundPerformKsmps(csound);
+      for (j = 0; j < 64 * 4; j += 4) {
+        for (k = 0; k < 2; k++) {
+          double d = spout[j + k] - spout[j + k + 2];
+          if (d < 0.0) d = -d;
+          if (d > e) e = d;
+          if (spout[j + k] > y) y = spout[j + k];
+        }
+      }
+    }
+    csoundDestroy(csound);
+    CU_ASSERT(y > 0.001);
+    CU_ASSERT(e < 1.0e-9);
+}
+
+/* impulses every 480 samples into reverbsc and freeverb, at 1 on the
+   left and 0.5 on the right, half way between */
+static const char *reverb_orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 4\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "aL mpulse 1, -480\n"
+    "aR mpulse 0.5, -480, 0.005\n"
+    "a1, a2 reverbsc aL, aR, 0.85, 8000\n"
+    "a3, a4 freeverb aL, aR, 0.8, 0.35, 48000\n"
+    "outch 1, a1, 2, a2, 3, a3, 4, a4\n"
+    "endin\n";
+
+void test_reverbs(void)
+{
+    /* the output of reverbsc and freeverb as they were before their delay
+       lines ran as lanes: for each channel the sum of the squares of the
+       first 19200 frames, the first frame that is not silent, and frames
+       5000, 10000 and 15000 */
+    static const double ref_sum2[4] = {
+      7.5414515355397098, 2.9304547126814708,
+      2.2309562683482569, 1.2039301408184944
+    };
+    static const int ref_first[4] = { 2403, 2356, 1215, 1480 };
+    static const double ref_at[4][3] = {
+      { 6.8240576869290636e-08, 0.00047130144480192644, 0.016651589428133298 },
+      { -0.00034132346700994649, 0.080959392282029696, 0.015661087068019722 },
+      { 0.0065144843094031984, -0.022314746437995178, -0.0061501861313500977 },
+      { 0.0018308944166871642, 0.016422936487037906, 0.0072988204126766326 }
+    };
+    static double x[300 * 64 * 4];
+    CSOUND  *csound;
+    double  sum2, e;
+    int     c, i, first;
+
+    csound = start_orc(reverb_orc, "i 1 0 1\n", NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    perform_frames(csound, 300, x);
+    csoundDestroy(csound);
+    for (c = 0; c < 4; c++) {
+      for (i = 0, sum2 = 0.0, first = -1; i < 300 * 64; i++) {
+        sum2 += x[i * 4 + c] * x[i * 4 + c];
+        if (first < 0 && x[i * 4 + c] != 0.0)
+          first = i;
+      }
+      CU_ASSERT_EQUAL(first, ref_first[c]);
+      e = sum2 / ref_sum2[c] - 1.0;
+      CU_ASSERT(e < 1.0e-5 && e > -1.0e-5);
+      for (i = 0; i < 3; i++) {
+        e = x[(i + 1) * 5000 * 4 + c] - ref_at[c][i];
+        CU_ASSERT(e < 1.0e-6 && e > -1.0e-6);
+      }
+    }
+}
+
+/* the k-rate filters on impulses every 97 samples; with p4 = 1 reson
+   sweeps up from 20 Hz by 6 Hz a second and the others from 100 Hz by
+   6 kHz a second, with p4 = 0 they stay there */
+static const char *smooth_filter_orc =
+    "sr = 48000\n"
+    "ksmps = 16\n"
+    "nchnls = 6\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "ain mpulse 1, -97\n"
+    "kj init 0\n"
+    "klo init 20\n"
+    "kcf init 100\n"
+    "klo = 20 + kj / 8 * p4\n"
+    "kcf = 100 + 2 * kj * p4\n"
+    "kj += 1\n"
+    "a1 reson ain, klo, klo / 4\n"
+    "a2 butterlp ain, kcf\n"
+    "a3 moogvcf ain, kcf, 0.5\n"
+    "a4 moogladder ain, kcf, 0.5\n"
+    "ahp, alp, abp, abr statevar ain, kcf, 2\n"
+    "outch 1, a1, 2, a2, 3, a3, 4, a4, 5, alp, 6, abp\n"
+    "endin\n";
+
+/* renders 800 k-periods of smooth_filter_orc without and with
+   --smooth-filters, keeping the sum of the squares of each channel of
+   the first in sum2, and of the difference between the two in diff2 */
+static void smooth_filter_diff(const char *sco, double *sum2, double *diff2)
+{
+    const char *opts[] = { "--smooth-filters", NULL };
+    CSOUND  *exact, *smooth;
+    const MYFLT *x, *y;
+    double  d;
+    int     i, j;
+
+    exact = start_orc(smooth_filter_orc, sco, NULL);
+    smooth = start_orc(smooth_filter_orc, sco, opts);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(exact);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(smooth);
+    x = csoundGetSpout(exact);
+    y = csoundGetSpout(smooth);
+    for (j = 0; j < 6; j++)
+      sum2[j] = diff2[j] = 0.0;
+    for (i = 0; i < 800; i++) {
+      csoundPerformKsmps(exact);
+      csoundPerformKsmps(smooth);
+      for (j = 0; j < 16 * 6; j++) {
+        d = x[j] - y[j];
+        sum2[j % 6] += x[j] * x[j];
+        diff2[j % 6] += d * d;
+      }
+    }
+    csoundDestroy(exact);
+    csoundDestroy(smooth);
+}
+
+void test_smooth_filters(void)
+{
+    /* the sums of the squares of the swept outputs of reson, butterlp,
+       moogvcf, moogladder and statevar (low and band pass) as they were
+       before --smooth-filters */
+    static const double ref_sum2[6] = {
+      2317802580.7904797, 5.4959045661373587, 2.2266790412866113,
+      1.0106198736759273, 16.922017480402346, 17.131508225906764
+    };
+    double  sum2[6], diff2[6], e;
+    int     j;
+
+    /* without the option the output is unchanged; with it, the ramps
+       spread each step of a sweep over its k-period, which moves the
+       output by well under 2 % */
+    smooth_filter_diff("i 1 0 1 1\n", sum2, diff2);
+    for (j = 0; j < 6; j++) {
+      e = sum2[j] / ref_sum2[j] - 1.0;
+      CU_ASSERT(e < 1.0e-6 && e > -1.0e-6);
+      CU_ASSERT(diff2[j] < 4.0e-4 * sum2[j]);
+    }
+
+    /* at fixed frequencies only the tables differ, by less than 1e-4,
+       also for reson at 20 Hz, where 1 - cos(2 pi f / sr) is small */
+    smooth_filter_diff("i 1 0 1 0\n", sum2, diff2);
+    for (j = 0; j < 6; j++) {
+      CU_ASSERT(sum2[j] > 0.0);
+      CU_ASSERT(diff2[j] < 1.0e-8 * sum2[j]);
+    }
+}
+
+/* sorts engine_test.sco into name with the option opt; returns the sorted
+   text, which the caller frees, or NULL */
+static char *sort_score(const char *opt, const char *name)
+{
+    CSOUND  *csound;
+    FILE    *f, *out;
+    char    *text = NULL;
+    long    len;
+    int     ret;
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, opt);
+    f = fopen("engine_test.sco", "r");
+    out = fopen(name, "w");
+    if (f == NULL || out == NULL) {
+      if (f != NULL) fclose(f);
+      if (out != NULL) fclose(out);
+      csoundDestroy(csound);
+      return NULL;
+    }
+    ret = csoundScoreSort(csound, f, out);
+    fclose(f);
+    fclose(out);
+    csoundDestroy(csound);
+    if (ret != 0 || (f = fopen(name, "r")) == NULL)
+      return NULL;
+    fseek(f, 0L, SEEK_END);
+    len = ftell(f);
+    rewind(f);
+    if ((text = (char*) malloc(len + 1)) != NULL) {
+      len = (long) fread(text, 1, len, f);
+      text[len] = '\0';
+    }
+    fclose(f);
+    remove(name);
+    return text;
+}
+
+void test_sort_threads(void)
+{
+    /* a section of 12401 statements is written in three runs with -j 3;
+       it has ramps and np/pp references, also across the runs */
+    FILE    *f;
+    char    *one, *three;
+    int     i;
+
+    f = fopen("engine_test.sco", "w");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    for (i = 0; i < 3100; i++) {
+      fprintf(f, "i 1 %g 0.5 %d 0.125\n", i * 0.25, i);
+      if (i == 0)
+        fprintf(f, "i 2 0 1 0 np4 -1\n");
+      else if (i == 3099)
+        fprintf(f, "i 2 %g 1 %d 3100 pp4\n", i * 0.25, i);
+      else fprintf(f, "i 2 %g 1 %d np4 pp4\n", i * 0.25, i);
+      if (i % 3 == 0)
+        fprintf(f, "i 3 %g 1 %d\n", i * 0.25, i);
+      else fprintf(f, "i 3 %g 1 <\n", i * 0.25);
+      fprintf(f, "i 4 %g 1 %.17g\n", i * 0.25, i / 7.0);
+    }
+    fprintf(f, "i 3 775 1 0\n");
+    fclose(f);
+
+    one = sort_score("-j1", "engine_test_1.srt");
+    three = sort_score("-j3", "engine_test_3.srt");
+    remove("engine_test.sco");
+    CU_ASSERT_PTR_NOT_NULL(one);
+    CU_ASSERT_PTR_NOT_NULL(three);
+    if (one != NULL && three != NULL) {
+      CU_ASSERT_STRING_EQUAL(one, three);
+      CU_ASSERT_PTR_NOT_NULL(strstr(three, "i 3 0x1p-2 0x1p-2 0x1p+0 0x1p+0 "
+                                    "0x1p+0\n"));
+      CU_ASSERT_PTR_NOT_NULL(strstr(three, "i 2 0x1.76ep+9 0x1.76ep+9 "
+                                    "0x1p+0 0x1p+0 2999 3000 2998\n"));
+      CU_ASSERT_PTR_NOT_NULL(strstr(three, "i 3 0x1.834p+9 0x1.834p+9 "
+                                    "0x1p+0 0x1p+0 0x1.834p+11\n"));
+    }
+    free(one);
+    free(three);
+}
+
+static const char *pvs_orc =
+    "sr = 48000\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "ain1 oscili 0.3, 440\n"
+    "ain2 vco2 0.2, 1234.5\n"
+    "fs pvsanal ain1 + ain2, p4, p4 / 4, p4, 1\n"
+    "aout pvsynth fs\n"
+    "outch p5, aout\n"
+    "endin\n";
+
+void test_pvs_fast_math(void)
+{
+    const char *opts[] = { "--pvs-fast-math", NULL };
+    const char *sco = "i 1 0 2 256 1\ni 1 0 2 1024 2\n";
+    CSOUND  *exact, *fast;
+    const MYFLT *x, *y;
+    double  d, diff = 0.0, peak = 0.0;
+    int     i, j;
+
+    /* a second of pvsanal/pvsynth at N = 256 and 1024 with the polynomial
+       arctangent, sine and cosine stays within the 2e-7 of full scale
+       that pvsmath.h gives for the first second */
+    exact = start_orc(pvs_orc, sco, NULL);
+    fast = start_orc(pvs_orc, sco, opts);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(exact);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(fast);
+    x = csoundGetSpout(exact);
+    y = csoundGetSpout(fast);
+    for (i = 0; i < 750; i++) {
+      csoundPerformKsmps(exact);
+      csoundPerformKsmps(fast);
+      for (j = 0; j < 64 * 2; j++) {
+        d = x[j] - y[j];
+        if (d < 0.0)
+          d = -d;
+        if (d > diff)
+          diff = d;
+        if (x[j] > peak)
+          peak = x[j];
+      }
+    }
+    CU_ASSERT(peak > 0.1);
+    CU_ASSERT(diff < 2.0e-7);
+    csoundDestroy(exact);
+    csoundDestroy(fast);
+}
+
 int main()
 {
     CU_pSuite pSuite = NULL;
@@ -73,6 +1305,35 @@ int main()
     if ((NULL == CU_add_test(pSuite, "Test daemon mode", test_daemon))
         || (NULL == CU_add_test(pSuite, "Test evalcode", test_eval_code))
 	|| (NULL == CU_add_test(pSuite, "Test compileAsync", test_compile_async)) 
+        || (NULL == CU_add_test(pSuite, "Test UDO inlining", test_udo_inline))
+        || (NULL == CU_add_test(pSuite, "Test UDO arguments", test_udo_args))
+        || (NULL == CU_add_test(pSuite, "Test binary score overflow p-fields",
+                                test_scobin_extra_pfields))
+        || (NULL == CU_add_test(pSuite, "Test vco2bank and oscbnk ivco2",
+                                test_vco2bank))
+        || (NULL == CU_add_test(pSuite, "Test biquadbank and svfbank",
+                                test_filterbanks))
+        || (NULL == CU_add_test(pSuite, "Test realtime event order",
+                                test_event_order))
+        || (NULL == CU_add_test(pSuite, "Test binary input events",
+                                test_input_event))
+        || (NULL == CU_add_test(pSuite, "Test score sorting windows",
+                                test_score_window))
+        || (NULL == CU_add_test(pSuite, "Test sample-accurate onsets",
+                                test_sample_accurate))
+        || (NULL == CU_add_test(pSuite, "Test MIDI file tracks and tempo",
+                                test_midifile))
+        || (NULL == CU_add_test(pSuite, "Test queued MIDI messages",
+                                test_push_midi))
+        || (NULL == CU_add_test(pSuite, "Test the delay lines", test_delays))
+        || (NULL == CU_add_test(pSuite, "Test partikkel", test_partikkel))
+        || (NULL == CU_add_test(pSuite, "Test the reverbs", test_reverbs))
+        || (NULL == CU_add_test(pSuite, "Test --smooth-filters",
+                                test_smooth_filters))
+        || (NULL == CU_add_test(pSuite, "Test sorting on threads",
+                                test_sort_threads))
+        || (NULL == CU_add_test(pSuite, "Test pvsanal with --pvs-fast-math",
+                                test_pvs_fast_math))
 	)
     {
         CU_cleanup_registry();
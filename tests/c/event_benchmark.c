@@ -0,0 +1,74 @@
+/*
+    event_benchmark.c:
+
+    Compares the CPU cost of sending realtime events to a named
+    instrument as text lines through csoundInputMessage() and in binary
+    form through csoundInputEvent(), with a handle obtained once from
+    csoundGetInstrumentHandle().  The events are sent a control period
+    at a time, at the given rate, and are a millisecond long.
+
+    usage: event_benchmark [events per second]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define KR          750
+#define DURATION    10
+
+static double run(int rate, int binary)
+{
+    CSOUND  *csound;
+    MYFLT   pf[4];
+    int64_t handle;
+    char    line[64];
+    int     i, k, n = rate / KR;
+    clock_t t0, t1;
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (csoundCompileOrc(csound,
+                         "sr = 48000\n"
+                         "ksmps = 64\n"
+                         "nchnls = 1\n"
+                         "instr tone\n"
+                         "endin\n") != 0 ||
+        csoundStart(csound) != 0 ||
+        (handle = csoundGetInstrumentHandle(csound, "tone")) == 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    pf[0] = 0.0; pf[1] = 0.0; pf[2] = 0.001;
+    t0 = clock();
+    for (k = 0; k < KR * DURATION; k++) {
+      for (i = 0; i < n; i++) {
+        pf[3] = (MYFLT) i;
+        if (binary)
+          csoundInputEvent(csound, 'i', handle, pf, 4);
+        else {
+          snprintf(line, sizeof(line), "i \"tone\" 0 0.001 %d\n", i);
+          csoundInputMessage(csound, line);
+        }
+      }
+      if (csoundPerformKsmps(csound) != 0)
+        break;
+    }
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC / DURATION;
+}
+
+int main(int argc, char **argv)
+{
+    int rate = (argc > 1 ? atoi(argv[1]) : 20000);
+
+    printf("%d events per second to a named instrument,\n", rate);
+    printf("CPU seconds per second of audio:\n");
+    printf("%14s %14s\n", "text", "binary");
+    printf("%14.4f %14.4f\n", run(rate, 0), run(rate, 1));
+    return 0;
+}
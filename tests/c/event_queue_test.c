@@ -0,0 +1,298 @@
+/*
+ * Tests of the queue of realtime events, and of the pool its records
+ * are allocated from (Engine/musmon.c).
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csoundCore.h"
+#include <CUnit/Basic.h>
+
+int init_suite1(void)
+{
+    return 0;
+}
+
+int clean_suite1(void)
+{
+    return 0;
+}
+
+/* instr 1 counts its notes and keeps its last p40; instr 2 keeps its
+   string p-fields, p5 and p60; instr 3 and 4 count their notes, and instr 10
+   removes the queued notes of instr 3 */
+static const char *queue_orc =
+    "sr = 48000\n"
+    "ksmps = 16\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "icount chnget \"count\"\n"
+    "chnset icount + 1, \"count\"\n"
+    "chnset p40, \"last\"\n"
+    "endin\n"
+    "instr 2\n"
+    "S1 strget p4\n"
+    "S2 strget p6\n"
+    "chnset S1, \"s1\"\n"
+    "chnset S2, \"s2\"\n"
+    "chnset p5, \"p5\"\n"
+    "chnset p60, \"p60\"\n"
+    "endin\n"
+    "instr 3\n"
+    "icount chnget \"n3\"\n"
+    "chnset icount + 1, \"n3\"\n"
+    "endin\n"
+    "instr 4\n"
+    "icount chnget \"n4\"\n"
+    "chnset icount + 1, \"n4\"\n"
+    "endin\n"
+    "instr 10\n"
+    "turnoff3 3\n"
+    "turnoff\n"
+    "endin\n";
+
+static char log_text[16384];
+
+static void log_message(CSOUND *csound, int attr, const char *format,
+                        va_list args)
+{
+    size_t  n = strlen(log_text);
+    (void) csound; (void) attr;
+    vsnprintf(log_text + n, sizeof(log_text) - n, format, args);
+}
+
+/* -m128 has csoundCleanup() report the peak use of the event pool */
+static CSOUND *start_queue(void)
+{
+    CSOUND  *csound;
+
+    csoundSetGlobalEnv("OPCODE6DIR64", "../../");
+    csound = csoundCreate(NULL);
+    csoundSetMessageCallback(csound, log_message);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m128");
+    if (csoundCompileOrc(csound, queue_orc) != 0 ||
+        csoundReadScore(csound, "f 0 3600\n") != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return NULL;
+    }
+    return csound;
+}
+
+/* the number of events in the heap from e on, of which n are of instr */
+static int heap_count(const EVTNODE *e, MYFLT instr, int *n)
+{
+    int     count = 0;
+
+    for ( ; e != NULL; e = e->nxt) {
+      count += 1 + heap_count(e->child, instr, n);
+      if (e->p[1] == instr)
+        (*n)++;
+    }
+    return count;
+}
+
+/* cleans up, reading the peak number of records in use and the bytes
+   allocated for the pool from the report of csoundCleanup() */
+static int pool_stats(CSOUND *csound, int *peak, unsigned long *allocated)
+{
+    const char *s;
+    unsigned long bytes;
+
+    log_text[0] = '\0';
+    csoundCleanup(csound);
+    s = strstr(log_text, "realtime event queue: peak ");
+    return (s != NULL &&
+            sscanf(s, "realtime event queue: peak %d events, %lu bytes "
+                   "(%lu allocated)", peak, &bytes, allocated) == 3);
+}
+
+void test_event_pool_reuse(void)
+{
+    CSOUND  *csound;
+    MYFLT   pf[40];
+    unsigned long allocated;
+    int     i, j, n = 0, peak;
+
+    /* ten rounds of 100 notes of 40 p-fields, each played before the
+       next is queued: the records of a round, under 512 bytes each, are
+       those freed by the one before, all cut from a single chunk */
+    csound = start_queue();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    memset(pf, 0, sizeof(pf));
+    pf[0] = FL(1.0);
+    pf[2] = FL(0.001);
+    for (i = 0; i < 10; i++) {
+      for (j = 0; j < 100; j++) {
+        pf[39] = (MYFLT) (i * 100 + j);
+        CU_ASSERT_EQUAL(csoundScoreEvent(csound, 'i', pf, 40), 0);
+      }
+      CU_ASSERT_EQUAL(heap_count(csound->OrcTrigEvts, FL(1.0), &n), 100);
+      csoundPerformKsmps(csound);
+      CU_ASSERT_PTR_NULL(csound->OrcTrigEvts);
+    }
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 1000.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "last", NULL), 999.0);
+    CU_ASSERT_FATAL(pool_stats(csound, &peak, &allocated));
+    CU_ASSERT_EQUAL(peak, 100);
+    CU_ASSERT_EQUAL(allocated, 65536UL);
+    csoundDestroy(csound);
+}
+
+void test_event_pool_fields(void)
+{
+    CSOUND  *csound;
+    EVTBLK  *evt;
+    MYFLT   *extra, *table;
+    char    line[512], s[64];
+    int     i, len, n;
+
+    csound = start_queue();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+
+    /* string p-fields, and p60, of a note held in the queue for a few
+       k-periods while other notes are queued and freed around it */
+    n = snprintf(line, sizeof(line),
+                 "i 2 0.002 0.001 \"first\" 7 \"second string\"");
+    for (i = 7; i <= 60; i++)
+      n += snprintf(line + n, sizeof(line) - n, " %d", i * 10);
+    snprintf(line + n, sizeof(line) - n, "\n");
+    csoundInputMessage(csound, line);
+    for (i = 0; i < 8; i++) {
+      csoundInputMessage(csound, "i 3 0 0.001 \"x\"\n");
+      csoundPerformKsmps(csound);
+    }
+    csoundGetStringChannel(csound, "s1", s);
+    CU_ASSERT_STRING_EQUAL(s, "first");
+    csoundGetStringChannel(csound, "s2", s);
+    CU_ASSERT_STRING_EQUAL(s, "second string");
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "p5", NULL), 7.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "p60", NULL), 600.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "n3", NULL), 8.0);
+
+    /* a GEN02 table of PMAX - 4 + 100 values, the last 100 of them from
+       the p-fields beyond PMAX in c.extra; the event and its extra
+       p-fields are cleared once queued */
+    evt = (EVTBLK*) calloc(1, sizeof(EVTBLK));
+    extra = (MYFLT*) calloc(101, sizeof(MYFLT));
+    CU_ASSERT_FATAL(evt != NULL && extra != NULL);
+    evt->opcod = 'f';
+    evt->pcnt = PMAX + 100;
+    evt->p[1] = FL(1.0);
+    evt->p[2] = FL(0.002);
+    evt->p[3] = FL(0.0);
+    evt->p[4] = -FL(2.0);
+    for (i = 5; i <= PMAX; i++)
+      evt->p[i] = (MYFLT) (i - 4);
+    extra[0] = FL(100.0);
+    for (i = 1; i <= 100; i++)
+      extra[i] = (MYFLT) (10000 + i);
+    evt->c.extra = extra;
+    n = csound->insert_score_event_at_sample(csound, evt, csound->icurTime);
+    CU_ASSERT_EQUAL(n, 0);
+    memset(evt, 0, sizeof(EVTBLK));
+    memset(extra, 0, 101 * sizeof(MYFLT));
+    free(evt);
+    free(extra);
+    for (i = 0; i < 8; i++)
+      csoundPerformKsmps(csound);
+    len = csoundGetTable(csound, &table, 1);
+    CU_ASSERT_EQUAL_FATAL(len, PMAX - 4 + 100);
+    /* p[PMAX] itself is not passed on by hfgens() */
+    for (i = 0; i < PMAX - 5; i++)
+      if (table[i] != (MYFLT) (i + 1))
+        break;
+    CU_ASSERT_EQUAL(i, PMAX - 5);
+    for (i = 0; i < 100; i++)
+      if (table[PMAX - 4 + i] != (MYFLT) (10001 + i))
+        break;
+    CU_ASSERT_EQUAL(i, 100);
+    csoundDestroy(csound);
+}
+
+void test_event_delete_selected(void)
+{
+    CSOUND  *csound;
+    MYFLT   pf[3] = { FL(3.0), FL(0.0), FL(0.001) };
+    unsigned long allocated;
+    int     i, n, peak;
+
+    /* turnoff3 frees the 50 queued notes of instr 3 and leaves the 50 of
+       instr 4 in the heap */
+    csound = start_queue();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 100; i++) {
+      pf[0] = (MYFLT) (3 + (i & 1));
+      pf[1] = FL(0.1) + FL(0.001) * i;
+      csoundScoreEvent(csound, 'i', pf, 3);
+    }
+    csoundInputMessage(csound, "i 10 0 1\n");
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    n = 0;
+    CU_ASSERT_EQUAL(heap_count(csound->OrcTrigEvts, FL(4.0), &n), 50);
+    CU_ASSERT_EQUAL(n, 50);
+
+    /* the freed records take 50 new notes of instr 3, which play once
+       each, as do those of instr 4 */
+    pf[0] = FL(3.0);
+    for (i = 0; i < 50; i++) {
+      pf[1] = FL(0.1) + FL(0.001) * i;
+      csoundScoreEvent(csound, 'i', pf, 3);
+    }
+    n = 0;
+    CU_ASSERT_EQUAL(heap_count(csound->OrcTrigEvts, FL(3.0), &n), 100);
+    CU_ASSERT_EQUAL(n, 50);
+    for (i = 0; i < 600; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_PTR_NULL(csound->OrcTrigEvts);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "n3", NULL), 50.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "n4", NULL), 50.0);
+    CU_ASSERT_FATAL(pool_stats(csound, &peak, &allocated));
+    CU_ASSERT_EQUAL(peak, 101);
+    CU_ASSERT_EQUAL(allocated, 65536UL);
+    csoundDestroy(csound);
+}
+
+int main()
+{
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Realtime event queue tests", init_suite1,
+                          clean_suite1);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test reuse of event records",
+                             test_event_pool_reuse))
+        || (NULL == CU_add_test(pSuite, "Test p-fields of queued events",
+                                test_event_pool_fields))
+        || (NULL == CU_add_test(pSuite, "Test turnoff3 on queued events",
+                                test_event_delete_selected))
+        )
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,71 @@
+/*
+    ftconv_benchmark.c:
+
+    Measures the CPU time used by ftconv per channel and per second of
+    audio, for a range of impulse response lengths, in uniform and in
+    non-uniform partitioning mode. The CPU time includes the tail tier
+    threads of the non-uniform mode.
+
+    usage: ftconv_benchmark [partition length]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SR          96000
+#define NCHNLS      2
+#define DURATION    2
+
+static double run(int irSeconds, int partLen, int nonUniform)
+{
+    CSOUND  *csound;
+    char    orc[1024], sco[64];
+    clock_t t0, t1;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = 64\n"
+             "nchnls = %d\n"
+             "0dbfs = 1\n"
+             "giIR ftgen 1, 0, %d, 21, 1, 0.01\n"
+             "instr 1\n"
+             "a1 rand 0.5\n"
+             "aL, aR ftconv a1, 1, %d, 0, 0, 0, p4\n"
+             "outs aL, aR\n"
+             "endin\n",
+             SR, NCHNLS, SR * irSeconds * NCHNLS, partLen);
+    snprintf(sco, sizeof(sco), "i 1 0 %d %d\n", DURATION, nonUniform);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, sco) != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    t0 = clock();
+    csoundPerform(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC / DURATION / NCHNLS;
+}
+
+int main(int argc, char **argv)
+{
+    int irSeconds[] = { 1, 2, 5, 10 };
+    int i, partLen = (argc > 1 ? atoi(argv[1]) : 128);
+
+    printf("ftconv, %d Hz, partition length %d\n", SR, partLen);
+    printf("CPU seconds per channel per second of audio:\n");
+    printf("%8s %12s %12s\n", "IR (s)", "uniform", "non-uniform");
+    for (i = 0; i < (int) (sizeof(irSeconds) / sizeof(int)); i++) {
+      printf("%8d %12.4f %12.4f\n", irSeconds[i],
+             run(irSeconds[i], partLen, 0), run(irSeconds[i], partLen, 1));
+      fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+    midi_jitter_benchmark.c:
+
+    Plays notes pushed with csoundPushMidiMessage() from a second thread at
+    random times, with the performance paced to real time, and measures
+    the latency from each note on to the first sample of the note in the
+    output (taking output sample j of k-period k to be played j samples
+    after the end of the period), with and without --sample-accurate.
+
+    usage: midi_jitter_benchmark [ksmps] [notes]
+*/
+
+#include "csound.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SR          48000
+#define MAXNOTES    1000
+
+typedef struct {
+    CSOUND  *csound;
+    int     notes;
+    volatile int done;
+    double  pushed[MAXNOTES];
+} PRODUCER;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+static void sleepUntil(double t)
+{
+    struct timespec ts;
+    double  d = t - now();
+
+    if (d <= 0.0)
+      return;
+    ts.tv_sec = (time_t) d;
+    ts.tv_nsec = (long) ((d - ts.tv_sec) * 1.0e9);
+    nanosleep(&ts, NULL);
+}
+
+static int midiOpen(CSOUND *csound, void **userData, const char *dev)
+{
+    (void) csound; (void) dev;
+    *userData = NULL;
+    return 0;
+}
+
+static int midiRead(CSOUND *csound, void *userData,
+                    unsigned char *buf, int nbytes)
+{
+    (void) csound; (void) userData; (void) buf; (void) nbytes;
+    return 0;
+}
+
+static int midiClose(CSOUND *csound, void *userData)
+{
+    (void) csound; (void) userData;
+    return 0;
+}
+
+static void *producer(void *arg)
+{
+    PRODUCER *p = (PRODUCER*) arg;
+    unsigned char on[3] = { 0x90, 60, 100 }, off[3] = { 0x80, 60, 0 };
+    double  t = now() + 0.2;
+    int     i;
+
+    for (i = 0; i < p->notes; i++) {
+      sleepUntil(t);
+      p->pushed[i] = now();
+      csoundPushMidiMessage(p->csound, on, 3);
+      sleepUntil(p->pushed[i] + 0.02);
+      csoundPushMidiMessage(p->csound, off, 3);
+      t = p->pushed[i] + 0.04 + (rand() % 1000) * 0.00004;
+    }
+    p->done = 1;
+    return NULL;
+}
+
+static int run(int ksmps, int notes, int sampleAccurate,
+               double *mean, double *dev)
+{
+    PRODUCER prod;
+    pthread_t thread;
+    CSOUND  *csound;
+    const MYFLT *spout;
+    char    orc[256];
+    double  start, played[MAXNOTES], sum = 0.0, sum2 = 0.0, d;
+    MYFLT   prv = FL(0.0);
+    long    k;
+    int     i, j, n = 0;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = %d\n"
+             "nchnls = 1\n"
+             "0dbfs = 1\n"
+             "instr 1\n"
+             "a1 line 1, 1, 1\n"
+             "out a1\n"
+             "endin\n",
+             SR, ksmps);
+    csound = csoundCreate(NULL);
+    csoundSetHostImplementedMIDIIO(csound, 1);
+    csoundSetExternalMidiInOpenCallback(csound, midiOpen);
+    csoundSetExternalMidiReadCallback(csound, midiRead);
+    csoundSetExternalMidiInCloseCallback(csound, midiClose);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-M0");
+    if (sampleAccurate)
+      csoundSetOption(csound, "--sample-accurate");
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, "f 0 3600\n") != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1;
+    }
+    spout = csoundGetSpout(csound);
+    prod.csound = csound;
+    prod.notes = notes;
+    prod.done = 0;
+    srand(1);
+    start = now();
+    pthread_create(&thread, NULL, producer, &prod);
+    for (k = 0; n < notes; k++) {
+      sleepUntil(start + (double) k * ksmps / SR);
+      if (csoundPerformKsmps(csound) != 0)
+        break;
+      for (j = 0; j < ksmps; j++) {
+        if (prv == FL(0.0) && spout[j] != FL(0.0) && n < notes)
+          played[n++] = start + ((double) (k + 1) * ksmps + j) / SR;
+        prv = spout[j];
+      }
+      if (prod.done && now() > prod.pushed[notes - 1] + 1.0)
+        break;                          /* a note was lost */
+    }
+    pthread_join(thread, NULL);
+    csoundDestroy(csound);
+    if (n < notes)
+      return -1;
+    for (i = 0; i < notes; i++) {
+      d = played[i] - prod.pushed[i];
+      sum += d;
+      sum2 += d * d;
+    }
+    *mean = sum / notes;
+    *dev = sqrt(sum2 / notes - *mean * *mean);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int     ksmps = (argc > 1 ? atoi(argv[1]) : 256);
+    int     notes = (argc > 2 ? atoi(argv[2]) : 200);
+    double  mean[2], dev[2];
+
+    if (notes > MAXNOTES)
+      notes = MAXNOTES;
+    if (run(ksmps, notes, 0, &mean[0], &dev[0]) != 0 ||
+        run(ksmps, notes, 1, &mean[1], &dev[1]) != 0) {
+      fprintf(stderr, "missing notes in the output\n");
+      return 1;
+    }
+    printf("%d notes, ksmps = %d, %d Hz (k-period %.2f ms)\n",
+           notes, ksmps, SR, 1000.0 * ksmps / SR);
+    printf("note on to sound, ms:\n");
+    printf("%16s %10s %10s\n", "", "mean", "std. dev.");
+    printf("%16s %10.3f %10.3f\n", "k-period", 1000.0 * mean[0],
+           1000.0 * dev[0]);
+    printf("%16s %10.3f %10.3f\n", "sample-accurate", 1000.0 * mean[1],
+           1000.0 * dev[1]);
+    return 0;
+}
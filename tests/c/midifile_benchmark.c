@@ -0,0 +1,127 @@
+/*
+    midifile_benchmark.c:
+
+    Writes a multi-track MIDI file of control changes and notes, and
+    measures the CPU time used to open it (csoundStart) and to play it
+    through to the end.
+
+    usage: midifile_benchmark [tracks] [events per track]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static FILE *out;
+
+static void putVLen(unsigned int v)
+{
+    unsigned char b[5];
+    int     n = 0;
+
+    b[n++] = v & 0x7F;
+    while (v >>= 7)
+      b[n++] = 0x80 | (v & 0x7F);
+    while (n--)
+      putc(b[n], out);
+}
+
+static void put32(unsigned int v)
+{
+    putc(v >> 24, out); putc((v >> 16) & 0xFF, out);
+    putc((v >> 8) & 0xFF, out); putc(v & 0xFF, out);
+}
+
+static int writeFile(const char *name, int tracks, int events)
+{
+    int     t, i;
+
+    if ((out = fopen(name, "wb")) == NULL)
+      return -1;
+    fwrite("MThd", 1, 4, out);
+    put32(6);
+    putc(0, out); putc(1, out);                 /* format 1 */
+    putc(tracks >> 8, out); putc(tracks & 0xFF, out);
+    putc(480 >> 8, out); putc(480 & 0xFF, out); /* ticks per beat */
+    srand(1);
+    for (t = 0; t < tracks; t++) {
+      long  start, end;
+      fwrite("MTrk", 1, 4, out);
+      start = ftell(out);
+      put32(0);
+      if (t == 0) {                             /* tempo changes */
+        for (i = 0; i < 100; i++) {
+          putVLen(1920);
+          putc(0xFF, out); putc(0x51, out); putc(3, out);
+          putc(0x07, out); putc(0xA1, out); putc(0x20 + i, out);
+        }
+      }
+      else {
+        for (i = 0; i < events; i++) {
+          putVLen(rand() % 12);
+          if (i % 16 == 0) {
+            putc(0x90 | (t & 15), out);
+            putc(36 + rand() % 48, out); putc(rand() % 128, out);
+          }
+          else {
+            putc(0xB0 | (t & 15), out);
+            putc(1 + rand() % 8, out); putc(rand() % 128, out);
+          }
+        }
+      }
+      putVLen(0);
+      putc(0xFF, out); putc(0x2F, out); putc(0, out);
+      end = ftell(out);
+      fseek(out, start, SEEK_SET);
+      put32((unsigned int) (end - start - 4));
+      fseek(out, end, SEEK_SET);
+    }
+    fclose(out);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    CSOUND  *csound;
+    int     tracks = (argc > 1 ? atoi(argv[1]) : 32);
+    int     events = (argc > 2 ? atoi(argv[2]) : 100000);
+    const char *name = "midifile_benchmark.mid";
+    char    opt[64];
+    clock_t t0, t1, t2;
+
+    if (writeFile(name, tracks, events) != 0)
+      return 1;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-T");
+    snprintf(opt, sizeof(opt), "-F%s", name);
+    csoundSetOption(csound, opt);
+    if (csoundCompileOrc(csound,
+                         "sr = 48000\n"
+                         "ksmps = 64\n"
+                         "nchnls = 1\n"
+                         "massign 0, 1\n"
+                         "instr 1\n"
+                         "endin\n") != 0) {
+      csoundDestroy(csound);
+      return 1;
+    }
+    t0 = clock();
+    if (csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return 1;
+    }
+    t1 = clock();
+    csoundPerform(csound);
+    t2 = clock();
+    csoundDestroy(csound);
+    remove(name);
+    printf("%d tracks of %d events, CPU seconds:\n", tracks, events);
+    printf("%14s %14s\n", "open", "play");
+    printf("%14.3f %14.3f\n", (double) (t1 - t0) / CLOCKS_PER_SEC,
+           (double) (t2 - t1) / CLOCKS_PER_SEC);
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+    osc_benchmark.c:
+
+    Sends OSC messages to an OSClisten opcode over the loopback interface
+    at a fixed rate, with the performance paced to real time, and reports
+    the messages received per second, the messages lost (in the socket or
+    with the opcode's queue full) and the CPU time used per second, for
+    single messages and for messages sent in bundles of one millisecond.
+    Needs the osc plugin.
+
+    usage: osc_benchmark [messages per second] [seconds] [port]
+*/
+
+#include "csound.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SR          48000
+#define KSMPS       64
+#define MSGSIZE     20          /* "/ctl" ",if" int32 float32 */
+
+typedef struct {
+    int     port, rate, bundle;
+    double  seconds;
+    long    sent;
+    volatile int done;
+} SENDER;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+static void sleepUntil(double t)
+{
+    struct timespec ts;
+    double  d = t - now();
+
+    if (d <= 0.0)
+      return;
+    ts.tv_sec = (time_t) d;
+    ts.tv_nsec = (long) ((d - ts.tv_sec) * 1.0e9);
+    nanosleep(&ts, NULL);
+}
+
+static void put32(unsigned char *b, uint32_t v)
+{
+    b[0] = v >> 24; b[1] = (v >> 16) & 0xFF; b[2] = (v >> 8) & 0xFF;
+    b[3] = v & 0xFF;
+}
+
+static void putMessage(unsigned char *b, int32_t i, float f)
+{
+    uint32_t u;
+
+    memcpy(b, "/ctl\0\0\0\0,if\0", 12);
+    put32(b + 12, (uint32_t) i);
+    memcpy(&u, &f, 4);
+    put32(b + 16, u);
+}
+
+/* every millisecond, sends rate/1000 messages, singly or in one bundle */
+static void *sender(void *arg)
+{
+    SENDER  *s = (SENDER*) arg;
+    struct sockaddr_in addr;
+    unsigned char buf[16 + 256 * (4 + MSGSIZE)];
+    int     sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int     i, n, per = s->rate / 1000;
+    double  t, start = now() + 0.1;
+    long    tick;
+
+    if (per > 256)
+      per = 256;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(s->port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    s->sent = 0;
+    for (tick = 0; (t = tick * 0.001) < s->seconds; tick++) {
+      sleepUntil(start + t);
+      if (s->bundle) {
+        memcpy(buf, "#bundle\0", 8);
+        put32(buf + 8, 0); put32(buf + 12, 1);  /* immediately */
+        for (i = 0, n = 16; i < per; i++, n += 4 + MSGSIZE) {
+          put32(buf + n, MSGSIZE);
+          putMessage(buf + n + 4, (int32_t) s->sent + i, 0.5f);
+        }
+        sendto(sock, buf, n, 0, (struct sockaddr*) &addr, sizeof(addr));
+        s->sent += per;
+      }
+      else {
+        for (i = 0; i < per; i++) {
+          putMessage(buf, (int32_t) s->sent, 0.5f);
+          sendto(sock, buf, MSGSIZE, 0, (struct sockaddr*) &addr,
+                 sizeof(addr));
+          s->sent++;
+        }
+      }
+    }
+    close(sock);
+    s->done = 1;
+    return NULL;
+}
+
+static int run(int port, int rate, double seconds, int bundle,
+               long *sent, long *received, double *cpu)
+{
+    SENDER  snd;
+    pthread_t thread;
+    CSOUND  *csound;
+    char    orc[512];
+    double  start, end = 0.0;
+    clock_t t0, t1;
+    long    k;
+    int     err;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = %d\n"
+             "nchnls = 1\n"
+             "0dbfs = 1\n"
+             "giport OSCinit %d\n"
+             "instr 1\n"
+             "kn init 0\n"
+             "ki init 0\n"
+             "kf init 0\n"
+             "next:\n"
+             "kk OSClisten giport, \"/ctl\", \"if\", ki, kf\n"
+             "if kk == 0 goto done\n"
+             "kn += 1\n"
+             "kgoto next\n"
+             "done:\n"
+             "chnset kn, \"received\"\n"
+             "endin\n",
+             SR, KSMPS, port);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, "i 1 0 3600\n") != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1;
+    }
+    snd.port = port;
+    snd.rate = rate;
+    snd.bundle = bundle;
+    snd.seconds = seconds;
+    snd.done = 0;
+    start = now();
+    t0 = clock();
+    pthread_create(&thread, NULL, sender, &snd);
+    for (k = 0; ; k++) {
+      sleepUntil(start + (double) k * KSMPS / SR);
+      if (csoundPerformKsmps(csound) != 0)
+        break;
+      if (snd.done && end == 0.0)
+        end = now() + 0.5;              /* let the last messages arrive */
+      if (end > 0.0 && now() > end)
+        break;
+    }
+    t1 = clock();
+    pthread_join(thread, NULL);
+    *sent = snd.sent;
+    *received = (long) csoundGetControlChannel(csound, "received", &err);
+    *cpu = (double) (t1 - t0) / CLOCKS_PER_SEC / (now() - start);
+    csoundDestroy(csound);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int     rate = (argc > 1 ? atoi(argv[1]) : 50000);
+    double  seconds = (argc > 2 ? atof(argv[2]) : 5.0);
+    int     port = (argc > 3 ? atoi(argv[3]) : 7770);
+    long    sent, received;
+    double  cpu;
+    int     bundle;
+
+    printf("%d messages per second for %.1f s, ksmps = %d, %d Hz\n",
+           rate, seconds, KSMPS, SR);
+    printf("%10s %12s %12s %12s %10s\n",
+           "", "sent", "lost", "received/s", "CPU s/s");
+    for (bundle = 0; bundle < 2; bundle++) {
+      if (run(port + bundle, rate, seconds, bundle,
+              &sent, &received, &cpu) != 0) {
+        fprintf(stderr, "cannot start the OSC listener\n");
+        return 1;
+      }
+      printf("%10s %12ld %12ld %12.0f %10.3f\n",
+             bundle ? "bundles" : "messages", sent, sent - received,
+             received / seconds, cpu);
+    }
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <CUnit/Basic.h>
+#include "csound.h"
+
+int init_suite1(void)
+{
+    return 0;
+}
+
+int clean_suite1(void)
+{
+    return 0;
+}
+
+/* listens on the port given with %d; instr 1 reports OSCcount, and
+   instr 2 reads /ctl messages when p4 or the "read" channel is not 0,
+   counting them and keeping their values */
+static const char *osc_orc =
+    "sr = 48000\n"
+    "ksmps = 48\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "giport OSCinit %d\n"
+    "instr 1\n"
+    "kc OSCcount\n"
+    "chnset kc, \"count\"\n"
+    "endin\n"
+    "instr 2\n"
+    "kn init 0\n"
+    "ki init 0\n"
+    "korder init 0\n"
+    "kread chnget \"read\"\n"
+    "if kread == 0 && p4 == 0 kgoto done\n"
+    "next:\n"
+    "kk OSClisten giport, \"/ctl\", \"i\", ki\n"
+    "if kk == 0 goto done\n"
+    "kn += 1\n"
+    "korder = korder * 10 + ki\n"
+    "chnset ki, \"last\"\n"
+    "kgoto next\n"
+    "done:\n"
+    "chnset kn, \"received\"\n"
+    "chnset korder, \"order\"\n"
+    "endin\n";
+
+#define MSGSIZE     16                  /* "/ctl" ",i" int32 */
+
+static char log_text[4096];
+
+static void log_message(CSOUND *csound, int attr, const char *format,
+                        va_list args)
+{
+    size_t  n = strlen(log_text);
+    (void) csound; (void) attr;
+    vsnprintf(log_text + n, sizeof(log_text) - n, format, args);
+}
+
+static void put32(unsigned char *b, uint32_t v)
+{
+    b[0] = v >> 24; b[1] = (v >> 16) & 0xFF; b[2] = (v >> 8) & 0xFF;
+    b[3] = v & 0xFF;
+}
+
+static void put_message(unsigned char *b, int32_t i)
+{
+    memcpy(b, "/ctl\0\0\0\0,i\0\0", 12);
+    put32(b + 12, (uint32_t) i);
+}
+
+/* sends n messages with the values from i on to port, in a bundle with
+   the time tag sec, frac, or without a bundle if n is 0 */
+static void osc_send(int port, uint32_t sec, uint32_t frac, int i, int n)
+{
+    struct sockaddr_in addr;
+    unsigned char buf[16 + 100 * (4 + MSGSIZE)];
+    int     sock = socket(AF_INET, SOCK_DGRAM, 0), len;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (n == 0) {
+      put_message(buf, i);
+      len = MSGSIZE;
+    }
+    else {
+      memcpy(buf, "#bundle\0", 8);
+      put32(buf + 8, sec); put32(buf + 12, frac);
+      for (len = 16; n > 0; n--, i++, len += 4 + MSGSIZE) {
+        put32(buf + len, MSGSIZE);
+        put_message(buf + len + 4, i);
+      }
+    }
+    sendto(sock, buf, len, 0, (struct sockaddr*) &addr, sizeof(addr));
+    close(sock);
+}
+
+static CSOUND *start_osc(int port, int read)
+{
+    CSOUND  *csound;
+    char    orc[1024], sco[64];
+
+    csoundSetGlobalEnv("OPCODE6DIR64", "../../");
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m4");
+    snprintf(orc, sizeof(orc), osc_orc, port);
+    snprintf(sco, sizeof(sco), "i 1 0 3600\ni 2 0 -1 %d\n", read);
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, sco) != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return NULL;
+    }
+    csoundPerformKsmps(csound);
+    return csound;
+}
+
+/* performs k-periods until the value of channel is val, for at most a
+   second */
+static void wait_for(CSOUND *csound, const char *channel, MYFLT val)
+{
+    int     i;
+
+    for (i = 0; i < 200; i++) {
+      csoundSleep(5);
+      csoundPerformKsmps(csound);
+      if (csoundGetControlChannel(csound, channel, NULL) == val)
+        break;
+    }
+}
+
+void test_osc_drops(void)
+{
+    CSOUND  *csound;
+    int     i;
+
+    /* messages that arrive with the ring of 1024 full are dropped, and
+       the drops are reported when the listener ends */
+    csound = start_osc(7773, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    for (i = 0; i < 11; i++)
+      osc_send(7773, 0, 1, i * 100, 100);
+    wait_for(csound, "count", 1024.0);
+    csoundSleep(50);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 1024.0);
+    csoundSetControlChannel(csound, "read", 1.0);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "received", NULL),
+                    1024.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "last", NULL), 1023.0);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 0.0);
+    log_text[0] = '\0';
+    csoundSetMessageCallback(csound, log_message);
+    csoundInputMessage(csound, "i -2 0 0\n");
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_PTR_NOT_NULL(strstr(log_text, "76 messages dropped"));
+    csoundDestroy(csound);
+}
+
+void test_osc_bundles(void)
+{
+    CSOUND  *csound;
+    uint32_t now;
+
+    /* a bundle for a minute from now is held, and the messages after it
+       that are due are read past it */
+    csound = start_osc(7774, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(csound);
+    now = (uint32_t) time(NULL) + 2208988800U;  /* seconds since 1900 */
+    osc_send(7774, now + 60, 0, 1, 1);
+    osc_send(7774, 0, 0, 2, 0);
+    osc_send(7774, 0, 1, 3, 1);
+    wait_for(csound, "received", 2.0);
+    csoundSleep(50);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "received", NULL), 2.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "order", NULL), 23.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 1.0);
+
+    /* the message still held is taken off the count when the listener
+       ends */
+    csoundInputMessage(csound, "i -2 0 0\n");
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", NULL), 0.0);
+    csoundDestroy(csound);
+}
+
+int main()
+{
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("OSC listener tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test OSClisten drops",
+                             test_osc_drops))
+        || (NULL == CU_add_test(pSuite, "Test OSC bundle times",
+                                test_osc_bundles))
+        )
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,104 @@
+/*
+    oscil_benchmark.c:
+
+    Measures the CPU time of the table oscillators, per opcode and
+    argument rate, as nanoseconds per oscillator and sample.  Each run
+    plays one instrument with a bank of oscillators reading a sine
+    table, so the figure is dominated by the oscillator inner loops.
+
+    usage: oscil_benchmark [number of oscillators]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SR          48000
+#define KSMPS       64
+#define DURATION    4
+
+static const struct {
+    const char *opcode, *amp, *cps;
+} cases[] = {
+    { "oscil",   "kamp", "kcps" },
+    { "oscil",   "kamp", "acps" },
+    { "oscil",   "aamp", "kcps" },
+    { "oscil",   "aamp", "acps" },
+    { "oscili",  "kamp", "kcps" },
+    { "oscili",  "kamp", "acps" },
+    { "oscili",  "aamp", "kcps" },
+    { "oscili",  "aamp", "acps" },
+    { "oscil3",  "kamp", "kcps" },
+    { "oscil3",  "kamp", "acps" },
+    { "oscil3",  "aamp", "kcps" },
+    { "oscil3",  "aamp", "acps" },
+    { "poscil",  "kamp", "kcps" },
+    { "poscil",  "kamp", "acps" },
+    { "poscil3", "kamp", "kcps" },
+    { "poscil3", "kamp", "acps" }
+};
+
+static double run(const char *opcode, const char *amp, const char *cps,
+                  int nosc)
+{
+    CSOUND  *csound;
+    char    orc[2048], ev[64];
+    int     i;
+    clock_t t0, t1;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = %d\n"
+             "nchnls = 1\n"
+             "0dbfs = 1\n"
+             "giSine ftgen 1, 0, 4096, 10, 1\n"
+             "instr 1\n"
+             "kamp = 0.5 / %d\n"
+             "aamp = kamp\n"
+             "kcps = 100 + p4 * 7\n"
+             "acps = kcps\n"
+             "a1 %s %s, %s, 1\n"
+             "out a1\n"
+             "endin\n",
+             SR, KSMPS, nosc, opcode, amp, cps);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (csoundCompileOrc(csound, orc) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    /* one note per oscillator, each at its own frequency */
+    for (i = 0; i < nosc; i++) {
+      snprintf(ev, sizeof(ev), "i 1 0 %d %d\n", DURATION, i);
+      csoundReadScore(csound, ev);
+    }
+    if (csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    t0 = clock();
+    csoundPerform(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return 1e9 * (double) (t1 - t0) / CLOCKS_PER_SEC /
+      ((double) nosc * SR * DURATION);
+}
+
+int main(int argc, char **argv)
+{
+    int i, nosc = (argc > 1 ? atoi(argv[1]) : 200);
+
+    printf("table oscillators, %d Hz, ksmps %d, %d oscillators\n",
+           SR, KSMPS, nosc);
+    printf("ns per oscillator per sample (includes instrument overhead):\n");
+    for (i = 0; i < (int) (sizeof(cases) / sizeof(cases[0])); i++) {
+      printf("%-8s %-5s %-5s %8.2f\n", cases[i].opcode, cases[i].amp,
+             cases[i].cps, run(cases[i].opcode, cases[i].amp, cases[i].cps,
+                               nosc));
+      fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+    pvs_benchmark.c:
+
+    Measures the CPU time of a pvsanal/pvsynth round trip, per second of
+    audio, for FFT sizes of 1024, 4096 and 16384 with an overlap of a
+    quarter of the FFT size, with and without --pvs-fast-math.  The time
+    includes the FFTs, which are the same in both modes.
+
+    usage: pvs_benchmark [number of instances]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SR          48000
+#define DURATION    4
+
+static double run(int fftSize, int ninst, int fast)
+{
+    CSOUND  *csound;
+    char    orc[1024], ev[64];
+    int     i;
+    clock_t t0, t1;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = 64\n"
+             "nchnls = 1\n"
+             "0dbfs = 1\n"
+             "instr 1\n"
+             "a1 vco2 0.2, 110 + p4 * 13\n"
+             "fs pvsanal a1, %d, %d, %d, 1\n"
+             "a2 pvsynth fs\n"
+             "out a2\n"
+             "endin\n",
+             SR, fftSize, fftSize / 4, fftSize);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (fast)
+      csoundSetOption(csound, "--pvs-fast-math");
+    if (csoundCompileOrc(csound, orc) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    for (i = 0; i < ninst; i++) {
+      snprintf(ev, sizeof(ev), "i 1 0 %d %d\n", DURATION, i);
+      csoundReadScore(csound, ev);
+    }
+    if (csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    t0 = clock();
+    csoundPerform(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC / DURATION / ninst;
+}
+
+int main(int argc, char **argv)
+{
+    int fftSizes[] = { 1024, 4096, 16384 };
+    int i, ninst = (argc > 1 ? atoi(argv[1]) : 8);
+
+    printf("pvsanal + pvsynth, %d Hz, overlap N/4, %d instances\n",
+           SR, ninst);
+    printf("CPU seconds per instance per second of audio:\n");
+    printf("%8s %12s %12s\n", "N", "libm", "fast math");
+    for (i = 0; i < (int) (sizeof(fftSizes) / sizeof(int)); i++) {
+      printf("%8d %12.5f %12.5f\n", fftSizes[i],
+             run(fftSizes[i], ninst, 0), run(fftSizes[i], ninst, 1));
+      fflush(stdout);
+    }
+    return 0;
+}
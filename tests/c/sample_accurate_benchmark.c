@@ -0,0 +1,83 @@
+/*
+    sample_accurate_benchmark.c:
+
+    Measures the CPU time per second of audio for a score of short,
+    overlapping notes whose onsets fall between control periods, played
+    with ksmps = 16 and with ksmps = 256, with and without sample-accurate
+    timing (--sample-accurate).
+
+    usage: sample_accurate_benchmark [notes per second]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SR          48000
+#define DURATION    20
+
+static char *makeScore(int rate)
+{
+    int     i, notes = rate * DURATION;
+    char    *sco = (char*) malloc((size_t) notes * 48 + 16);
+    size_t  len = 0;
+
+    srand(1);
+    for (i = 0; i < notes; i++)
+      len += sprintf(sco + len, "i 1 %.6f %.4f %d\n",
+                     (double) (i + (rand() % 1000) / 1000.0) / rate,
+                     0.05 + (rand() % 100) / 1000.0, 200 + rand() % 800);
+    sprintf(sco + len, "e\n");
+    return sco;
+}
+
+static double run(const char *sco, int ksmps, int sampleAccurate)
+{
+    CSOUND  *csound;
+    char    orc[512];
+    clock_t t0, t1;
+
+    snprintf(orc, sizeof(orc),
+             "sr = %d\n"
+             "ksmps = %d\n"
+             "nchnls = 1\n"
+             "0dbfs = 1\n"
+             "instr 1\n"
+             "a1 poscil 0.05, p4\n"
+             "a2 linen a1, 0.005, p3, 0.02\n"
+             "out a2\n"
+             "endin\n",
+             SR, ksmps);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (sampleAccurate)
+      csoundSetOption(csound, "--sample-accurate");
+    if (csoundCompileOrc(csound, orc) != 0 ||
+        csoundReadScore(csound, sco) != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    t0 = clock();
+    csoundPerform(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC / DURATION;
+}
+
+int main(int argc, char **argv)
+{
+    int     rate = (argc > 1 ? atoi(argv[1]) : 200);
+    char    *sco = makeScore(rate);
+
+    printf("%d notes per second, %d Hz\n", rate, SR);
+    printf("CPU seconds per second of audio:\n");
+    printf("%8s %14s %14s\n", "ksmps", "k-period", "sample-acc.");
+    printf("%8d %14.4f %14.4f\n", 16, run(sco, 16, 0), run(sco, 16, 1));
+    printf("%8d %14.4f %14.4f\n", 256, run(sco, 256, 0), run(sco, 256, 1));
+    free(sco);
+    return 0;
+}
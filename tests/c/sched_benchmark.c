@@ -0,0 +1,69 @@
+/*
+    sched_benchmark.c:
+
+    Measures the rates at which realtime events are queued and started.
+    The given number of notes is queued through csoundScoreEvent() with
+    start times spread at random over the next minute, then the minute
+    is performed.  The notes are a millisecond long and do nothing, so
+    the dispatch time is mostly that of starting and ending instances.
+
+    usage: sched_benchmark [maximum number of pending events]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SPAN        60
+
+static void run(int nevents)
+{
+    CSOUND  *csound;
+    MYFLT   pf[3];
+    int     i;
+    clock_t t0, t1, t2;
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (csoundCompileOrc(csound,
+                         "sr = 48000\n"
+                         "ksmps = 64\n"
+                         "nchnls = 1\n"
+                         "instr 1\n"
+                         "endin\n") != 0 ||
+        csoundReadScore(csound, "f 0 61\n") != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return;
+    }
+    srand(1);
+    pf[0] = 1.0;
+    pf[2] = 0.001;
+    t0 = clock();
+    for (i = 0; i < nevents; i++) {
+      pf[1] = (MYFLT) SPAN * rand() / RAND_MAX;
+      csoundScoreEvent(csound, 'i', pf, 3);
+    }
+    t1 = clock();
+    csoundPerform(csound);
+    t2 = clock();
+    csoundDestroy(csound);
+    printf("%8d %14.0f %14.0f\n", nevents,
+           nevents / ((double) (t1 - t0) / CLOCKS_PER_SEC + 1.0e-9),
+           nevents / ((double) (t2 - t1) / CLOCKS_PER_SEC + 1.0e-9));
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    int n, nmax = (argc > 1 ? atoi(argv[1]) : 1000000);
+
+    printf("realtime events over %d s, events per CPU second:\n", SPAN);
+    printf("%8s %14s %14s\n", "pending", "queued", "started");
+    for (n = 10000; n <= nmax; n *= 10)
+      run(n);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+    score_window_benchmark.c:
+
+    Measures the time from loading a long score to the first control
+    period performed, with the score sorted as a whole and in windows
+    (--score-window).  The score has the given number of notes, mostly
+    in time order, for seven instruments.
+
+    usage: score_window_benchmark [number of notes] [window]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static char *makeScore(int notes)
+{
+    char    *sco = (char*) malloc((size_t) notes * 48 + 64);
+    size_t  len = 0;
+    int     i;
+
+    len += sprintf(sco + len, "t 0 90 1000 120\n");
+    for (i = 0; i < notes; i++)
+      len += sprintf(sco + len, "i %d %d.%03d 0.25 %d\n",
+                     1 + i % 7, i / 10, (i % 10) * 100 + (i * 7) % 50, i);
+    sprintf(sco + len, "e\n");
+    return sco;
+}
+
+static double run(const char *sco, int window)
+{
+    CSOUND  *csound;
+    char    opt[32];
+    clock_t t0, t1;
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    snprintf(opt, sizeof(opt), "--score-window=%d", window);
+    csoundSetOption(csound, opt);
+    if (csoundCompileOrc(csound,
+                         "sr = 48000\n"
+                         "ksmps = 64\n"
+                         "nchnls = 1\n"
+                         "instr 1,2,3,4,5,6,7\n"
+                         "endin\n") != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    t0 = clock();
+    if (csoundReadScore(csound, sco) != 0 ||
+        csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    csoundPerformKsmps(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv)
+{
+    int     notes = (argc > 1 ? atoi(argv[1]) : 1000000);
+    int     window = (argc > 2 ? atoi(argv[2]) : 10000);
+    char    *sco = makeScore(notes);
+
+    printf("%d notes, CPU seconds to the first control period:\n", notes);
+    printf("%14s %14s\n", "whole", "windowed");
+    printf("%14.3f %14.3f\n", run(sco, 0), run(sco, window));
+    free(sco);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+    udo_inline_benchmark.c:
+
+    Measures the CPU time of an orchestra that calls five levels of
+    nested user defined opcodes from many instances, with the UDO calls
+    inlined at compile time (the default) and with --no-udo-inline.
+    Each level does a little k- and a-rate work of its own, so the
+    figure shows the call overhead relative to a realistic body.
+
+    usage: udo_inline_benchmark [number of instances]
+*/
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DURATION    10
+
+static const char *orc =
+    "sr = 44100\n"
+    "ksmps = 16\n"
+    "nchnls = 1\n"
+    "0dbfs = 1\n"
+    "opcode Level1, a, ak\n"
+    "ain, kg xin\n"
+    "xout ain * kg\n"
+    "endop\n"
+    "opcode Level2, a, ak\n"
+    "ain, kg xin\n"
+    "kg2 = kg * 0.5\n"
+    "xout Level1(ain, kg2) + ain\n"
+    "endop\n"
+    "opcode Level3, a, ak\n"
+    "ain, kg xin\n"
+    "ksq = kg * kg\n"
+    "xout Level2(ain, ksq)\n"
+    "endop\n"
+    "opcode Level4, a, ak\n"
+    "ain, kg xin\n"
+    "aout Level3 ain, kg + 0.1\n"
+    "xout aout\n"
+    "endop\n"
+    "opcode Level5, a, ak\n"
+    "ain, kg xin\n"
+    "xout Level4(ain, kg) * 0.5\n"
+    "endop\n"
+    "instr 1\n"
+    "asig = 0.001\n"
+    "kg line 0, p3, 1\n"
+    "aout Level5 asig, kg\n"
+    "out aout\n"
+    "endin\n";
+
+static double run(int instances, int inline_udos)
+{
+    CSOUND  *csound;
+    char    sco[64];
+    clock_t t0, t1;
+
+    snprintf(sco, sizeof(sco), "i 1 0 %d\n", DURATION);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-d");
+    csoundSetOption(csound, "-m0");
+    if (!inline_udos)
+      csoundSetOption(csound, "--no-udo-inline");
+    if (csoundCompileOrc(csound, orc) != 0 || csoundStart(csound) != 0) {
+      csoundDestroy(csound);
+      return -1.0;
+    }
+    while (instances-- > 0)
+      csoundReadScore(csound, sco);
+    t0 = clock();
+    csoundPerform(csound);
+    t1 = clock();
+    csoundDestroy(csound);
+    return (double) (t1 - t0) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv)
+{
+    int instances = (argc > 1 ? atoi(argv[1]) : 100);
+    double t_inline, t_call;
+
+    t_inline = run(instances, 1);
+    t_call = run(instances, 0);
+    printf("5 nested UDOs, %d instances, %d s of audio\n",
+           instances, DURATION);
+    printf("CPU seconds: inlined %.3f, called %.3f (%.2fx)\n",
+           t_inline, t_call, t_inline > 0.0 ? t_call / t_inline : 0.0);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+    scobin_main.c:
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* scobin: sort a score and write it as a binary score, which csound plays
+   without reading it as text.  usage: scobin score.sco score.scb */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+static void messageCallback_(CSOUND *csound, int attr,
+                             const char *fmt, va_list args)
+{
+    (void) csound;
+    (void) attr;
+    vfprintf(stderr, fmt, args);
+}
+
+int main(int argc, char **argv)
+{
+    CSOUND  *csound;
+    FILE    *in, *out;
+    int     n = -1;
+
+    if (argc != 3) {
+      fprintf(stderr, "usage: scobin score binary_score\n");
+      return 1;
+    }
+    if ((in = fopen(argv[1], "r")) == NULL) {
+      fprintf(stderr, "scobin: cannot open %s\n", argv[1]);
+      return 1;
+    }
+    if ((out = fopen(argv[2], "wb")) == NULL) {
+      fprintf(stderr, "scobin: cannot create %s\n", argv[2]);
+      fclose(in);
+      return 1;
+    }
+    if ((csound = csoundCreate(NULL)) != NULL) {
+      csoundSetMessageCallback(csound, messageCallback_);
+      n = csoundScoreSortBinary(csound, in, out);
+      csoundDestroy(csound);
+    }
+    fclose(in);
+    if (fclose(out) != 0)
+      n = -1;
+    if (n != 0) {
+      fprintf(stderr, "scobin: could not write %s\n", argv[2]);
+      remove(argv[2]);
+    }
+    return (n != 0);
+}